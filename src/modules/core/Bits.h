@@ -6,6 +6,9 @@
 
 #include "core/String.h"
 #include <stdint.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace core {
 
@@ -35,4 +38,25 @@ inline int countSetBits(uint32_t number) {
 	return count;
 }
 
+/**
+ * @brief Index of the lowest set bit
+ * @note The given value must not be @c 0
+ */
+inline int countTrailingZeros(uint64_t number) {
+#if defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, number);
+	return (int)index;
+#elif defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(number);
+#else
+	int count = 0;
+	while ((number & 1u) == 0u) {
+		number >>= 1;
+		++count;
+	}
+	return count;
+#endif
+}
+
 } // namespace core
@@ -3,6 +3,8 @@
  */
 
 #include "Hash.h"
+#include <SDL_endian.h>
+#include <SDL_stdinc.h>
 #include <random>
 
 namespace core {
@@ -69,6 +71,60 @@ uint32_t hash(const void *key, int len, uint32_t seed) {
 	return h1;
 }
 
+// MurmurHash64A was written by Austin Appleby, and is placed in the public
+// domain. The author hereby disclaims copyright to this source code.
+uint64_t hash64(const void *key, size_t len, uint64_t seed) {
+	const uint64_t m = 0xc6a4a7935bd1e995ULL;
+	const int r = 47;
+	uint64_t h = seed ^ (len * m);
+
+	const uint8_t *data = (const uint8_t *)key;
+	const uint8_t *end = data + (len / 8) * 8;
+	for (; data != end; data += 8) {
+		uint64_t k;
+		SDL_memcpy(&k, data, sizeof(k));
+		k = SDL_SwapLE64(k);
+
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+
+		h ^= k;
+		h *= m;
+	}
+
+	switch (len & 7) {
+	case 7:
+		h ^= uint64_t(data[6]) << 48;
+		// fallthrough
+	case 6:
+		h ^= uint64_t(data[5]) << 40;
+		// fallthrough
+	case 5:
+		h ^= uint64_t(data[4]) << 32;
+		// fallthrough
+	case 4:
+		h ^= uint64_t(data[3]) << 24;
+		// fallthrough
+	case 3:
+		h ^= uint64_t(data[2]) << 16;
+		// fallthrough
+	case 2:
+		h ^= uint64_t(data[1]) << 8;
+		// fallthrough
+	case 1:
+		h ^= uint64_t(data[0]);
+		h *= m;
+		break;
+	}
+
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+
+	return h;
+}
+
 // https://www.ietf.org/rfc/rfc4122.txt
 core::String generateUUID() {
 	std::random_device rd;
@@ -5,11 +5,16 @@
 #pragma once
 
 #include "core/String.h"
+#include <stddef.h>
 #include <stdint.h>
 
 namespace core {
 
 uint32_t hash(const void *key, int len, uint32_t seed = 0u);
+/**
+ * @brief 64 bit hash for large buffers - a single pass without a length limit
+ */
+uint64_t hash64(const void *key, size_t len, uint64_t seed = 0u);
 
 // Fowler–Noll–Vo hash function CC0
 // http://www.isthe.com/chongo/tech/comp/fnv/
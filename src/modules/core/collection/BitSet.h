@@ -36,10 +36,118 @@ public:
 		clear();
 	}
 
+	BitSet(const BitSet &other) : _bits(other._bits), _bytes(other._bytes) {
+		_buffer = (Type *)core_malloc(_bytes);
+		core_memcpy(_buffer, other._buffer, _bytes);
+	}
+
+	BitSet(BitSet &&other) noexcept : _bits(other._bits), _bytes(other._bytes), _buffer(other._buffer) {
+		other._bits = 0;
+		other._bytes = 0u;
+		other._buffer = nullptr;
+	}
+
 	~BitSet() {
 		core_free(_buffer);
 	}
 
+	BitSet &operator=(const BitSet &other) {
+		if (this == &other) {
+			return *this;
+		}
+		if (_bytes != other._bytes || _buffer == nullptr) {
+			core_free(_buffer);
+			_bytes = other._bytes;
+			_buffer = (Type *)core_malloc(_bytes);
+		}
+		_bits = other._bits;
+		core_memcpy(_buffer, other._buffer, _bytes);
+		return *this;
+	}
+
+	BitSet &operator=(BitSet &&other) noexcept {
+		if (this == &other) {
+			return *this;
+		}
+		core_free(_buffer);
+		_bits = other._bits;
+		_bytes = other._bytes;
+		_buffer = other._buffer;
+		other._bits = 0;
+		other._bytes = 0u;
+		other._buffer = nullptr;
+		return *this;
+	}
+
+	/**
+	 * @brief Bitwise or - both sets must have the same size
+	 */
+	BitSet &operator|=(const BitSet &other) {
+		core_assert_msg(_bits == other._bits, "size mismatch %i vs %i", _bits, other._bits);
+		const size_t n = _bytes / sizeof(Type);
+		for (size_t i = 0; i < n; ++i) {
+			_buffer[i] |= other._buffer[i];
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Bitwise and - both sets must have the same size
+	 */
+	BitSet &operator&=(const BitSet &other) {
+		core_assert_msg(_bits == other._bits, "size mismatch %i vs %i", _bits, other._bits);
+		const size_t n = _bytes / sizeof(Type);
+		for (size_t i = 0; i < n; ++i) {
+			_buffer[i] &= other._buffer[i];
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Toggles all bits
+	 */
+	void flip() {
+		const size_t n = _bytes / sizeof(Type);
+		for (size_t i = 0; i < n; ++i) {
+			_buffer[i] = ~_buffer[i];
+		}
+	}
+
+	/**
+	 * @return @c true if at least one bit is set
+	 */
+	bool any() const {
+		const size_t words = (size_t)_bits / bitsPerValue;
+		for (size_t i = 0; i < words; ++i) {
+			if (_buffer[i] != 0u) {
+				return true;
+			}
+		}
+		const size_t rest = (size_t)_bits % bitsPerValue;
+		if (rest == 0u) {
+			return false;
+		}
+		return (_buffer[words] & ((Type(1) << rest) - 1u)) != 0u;
+	}
+
+	/**
+	 * @return @c true if all bits are set
+	 */
+	bool all() const {
+		const size_t words = (size_t)_bits / bitsPerValue;
+		for (size_t i = 0; i < words; ++i) {
+			if (_buffer[i] != ~Type(0)) {
+				return false;
+			}
+		}
+		const size_t rest = (size_t)_bits % bitsPerValue;
+		if (rest == 0u) {
+			return true;
+		}
+		const Type mask = (Type(1) << rest) - 1u;
+		return (_buffer[words] & mask) == mask;
+	}
+
 	inline int bits() const {
 		return _bits;
 	}
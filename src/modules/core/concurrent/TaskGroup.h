@@ -0,0 +1,117 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/StandardLib.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/ConditionVariable.h"
+#include "core/concurrent/Lock.h"
+#include "core/concurrent/ThreadPool.h"
+
+namespace core {
+
+/**
+ * @brief Runs a set of tasks on the given thread pool and allows to wait for all of them
+ *
+ * @code
+ * core::TaskGroup group(pool);
+ * for (int i = 0; i < n; ++i) {
+ *   group.run([i, &results]() { results[i] = compute(i); });
+ * }
+ * group.wait();
+ * @endcode
+ *
+ * @note @c wait() executes queued tasks of the pool before it blocks. This means that it's safe to create task groups
+ * inside of tasks that are running on the same pool - the waiting worker doesn't block the pool while there is still
+ * work queued.
+ * @note Tasks that are removed by @c ThreadPool::abort() are not executed, but they still count as done for the group.
+ */
+class TaskGroup {
+private:
+	ThreadPool &_pool;
+	core::AtomicInt _pending{0};
+	core_trace_mutex(core::Lock, _lock, "TaskGroup");
+	core::ConditionVariable _done;
+
+	void finish() {
+		// the waiter only returns after it got the lock - the group must not be destroyed while it is signaled
+		core::ScopedLock lock(_lock);
+		if (_pending.decrement(1) == 1) {
+			_done.notify_all();
+		}
+	}
+
+	/**
+	 * @brief Marks the task as done when it's executed or when the task is destroyed without being executed
+	 */
+	class Completion {
+	private:
+		TaskGroup *_group;
+
+	public:
+		explicit Completion(TaskGroup *group) : _group(group) {
+		}
+		Completion(Completion &&other) noexcept : _group(other._group) {
+			other._group = nullptr;
+		}
+		Completion(const Completion &) = delete;
+		Completion &operator=(const Completion &) = delete;
+		Completion &operator=(Completion &&) = delete;
+		~Completion() {
+			complete();
+		}
+		void complete() {
+			if (_group != nullptr) {
+				_group->finish();
+				_group = nullptr;
+			}
+		}
+	};
+
+public:
+	explicit TaskGroup(ThreadPool &pool) : _pool(pool) {
+	}
+
+	~TaskGroup() {
+		wait();
+	}
+
+	TaskGroup(const TaskGroup &) = delete;
+	TaskGroup &operator=(const TaskGroup &) = delete;
+
+	/**
+	 * @note If the pool is not running, the functor is executed on the calling thread
+	 */
+	template<class F>
+	void run(F &&f) {
+		_pending.increment(1);
+		ThreadPoolTask task([completion = Completion(this), func = core::forward<F>(f)]() mutable {
+			func();
+			completion.complete();
+		});
+		if (!_pool.schedule(core::move(task))) {
+			task();
+		}
+	}
+
+	/**
+	 * @brief Blocks until all tasks of this group are executed
+	 */
+	void wait() {
+		core_trace_scoped(TaskGroupWait);
+		// help out with the queued tasks - they might belong to this group
+		while (_pending > 0 && _pool.runPendingTask()) {
+		}
+		// the remaining tasks of this group are running on other threads
+		core::ScopedLock lock(_lock);
+		_done.wait(_lock, [this] { return _pending <= 0; });
+	}
+
+	inline int pending() const {
+		return _pending;
+	}
+};
+
+} // namespace core
@@ -10,20 +10,238 @@
 
 namespace core {
 
+/**
+ * @brief Double ended ring buffer of tasks - the owner works on the back, thieves take from the front
+ */
+class ThreadPool::TaskDeque {
+private:
+	ThreadPoolTask *_tasks = nullptr;
+	size_t _capacity = 0u;
+	size_t _head = 0u;
+	size_t _size = 0u;
+
+public:
+	~TaskDeque() {
+		delete[] _tasks;
+	}
+
+	void reserve(size_t n) {
+		if (n <= _capacity) {
+			return;
+		}
+		ThreadPoolTask *tasks = new ThreadPoolTask[n];
+		for (size_t i = 0; i < _size; ++i) {
+			tasks[i] = core::move(_tasks[(_head + i) % _capacity]);
+		}
+		delete[] _tasks;
+		_tasks = tasks;
+		_capacity = n;
+		_head = 0u;
+	}
+
+	void pushBack(ThreadPoolTask &&task) {
+		if (_size == _capacity) {
+			reserve(_capacity == 0u ? 32u : _capacity * 2u);
+		}
+		_tasks[(_head + _size) % _capacity] = core::move(task);
+		++_size;
+	}
+
+	bool popBack(ThreadPoolTask &task) {
+		if (_size == 0u) {
+			return false;
+		}
+		--_size;
+		task = core::move(_tasks[(_head + _size) % _capacity]);
+		return true;
+	}
+
+	bool popFront(ThreadPoolTask &task) {
+		if (_size == 0u) {
+			return false;
+		}
+		task = core::move(_tasks[_head]);
+		_head = (_head + 1u) % _capacity;
+		--_size;
+		return true;
+	}
+
+	inline size_t size() const {
+		return _size;
+	}
+
+	void clear() {
+		ThreadPoolTask task;
+		while (popFront(task)) {
+			task.reset();
+		}
+	}
+};
+
+struct ThreadPool::Worker {
+	core_trace_mutex(core::Lock, lock, "ThreadPoolWorker");
+	ThreadPool::TaskDeque tasks core_thread_guarded_by(lock);
+};
+
+// the pool and the worker index of the current thread - used to push nested tasks to the local deque
+static thread_local const ThreadPool *tlsPool = nullptr;
+static thread_local int tlsWorkerIdx = -1;
+
 ThreadPool::ThreadPool(size_t threads, const char *name) :
 		_threads(threads), _name(name) {
 	if (_name == nullptr) {
 		_name = "ThreadPool";
 	}
+	_injection = new Worker();
+	_queues.reserve(_threads);
+	for (size_t i = 0; i < _threads; ++i) {
+		_queues.push_back(new Worker());
+	}
+}
+
+void ThreadPool::reserve(size_t n) {
+	core::ScopedLock lock(_injection->lock);
+	_injection->tasks.reserve(n);
+}
+
+bool ThreadPool::push(ThreadPoolTask &&task) {
+	// the counter is increased before the task is visible - it's never lower than the amount of queued tasks
+	_queued.increment(1);
+	if (tlsPool == this && tlsWorkerIdx >= 0) {
+		Worker *worker = _queues[tlsWorkerIdx];
+		core::ScopedLock lock(worker->lock);
+		worker->tasks.pushBack(core::move(task));
+	} else {
+		core::ScopedLock lock(_injection->lock);
+		if (_stop) {
+			_queued.decrement(1);
+			return false;
+		}
+		_injection->tasks.pushBack(core::move(task));
+	}
+	if (_sleeping > 0) {
+		// make sure that a worker that is about to sleep either sees the new task or gets the signal
+		{ core::ScopedLock lock(_sleepMutex); }
+		_sleepCondition.notify_one();
+	}
+	return true;
+}
+
+bool ThreadPool::pop(int workerIdx, ThreadPoolTask &task) {
+	if (_queued <= 0) {
+		return false;
+	}
+	if (workerIdx >= 0) {
+		Worker *worker = _queues[workerIdx];
+		core::ScopedLock lock(worker->lock);
+		if (worker->tasks.popBack(task)) {
+			_queued.decrement(1);
+			return true;
+		}
+	}
+	{
+		core::ScopedLock lock(_injection->lock);
+		if (_injection->tasks.popFront(task)) {
+			_queued.decrement(1);
+			return true;
+		}
+	}
+	// steal the oldest task of the other workers - the first pass skips the contended deques, the second pass blocks on
+	// their locks. Otherwise a worker would spin in the wait loop as long as the queued counter is not zero but all
+	// deques with tasks are locked by their owners.
+	const int n = (int)_queues.size();
+	const int start = workerIdx >= 0 ? workerIdx + 1 : 0;
+	bool contended = false;
+	for (int pass = 0; pass < 2; ++pass) {
+		for (int i = 0; i < n; ++i) {
+			const int victimIdx = (start + i) % n;
+			if (victimIdx == workerIdx) {
+				continue;
+			}
+			Worker *victim = _queues[victimIdx];
+			if (pass == 0) {
+				if (!victim->lock.try_lock()) {
+					contended = true;
+					continue;
+				}
+			} else {
+				victim->lock.lock();
+			}
+			const bool stolen = victim->tasks.popFront(task);
+			if (stolen) {
+				_queued.decrement(1);
+			}
+			victim->lock.unlock();
+			if (stolen) {
+				return true;
+			}
+		}
+		if (!contended) {
+			break;
+		}
+	}
+	return false;
+}
+
+bool ThreadPool::runPendingTask() {
+	ThreadPoolTask task;
+	const int workerIdx = tlsPool == this ? tlsWorkerIdx : -1;
+	if (!pop(workerIdx, task)) {
+		return false;
+	}
+	core_trace_scoped(ThreadPoolHelper);
+	task();
+	return true;
 }
 
 void ThreadPool::abort() {
-	core::ScopedLock lock(_queueMutex);
-	while (!_tasks.empty()) {
-		_tasks.pop();
+	{
+		core::ScopedLock lock(_injection->lock);
+		const int n = (int)_injection->tasks.size();
+		_injection->tasks.clear();
+		_queued.decrement(n);
+	}
+	for (Worker *worker : _queues) {
+		core::ScopedLock lock(worker->lock);
+		const int n = (int)worker->tasks.size();
+		worker->tasks.clear();
+		_queued.decrement(n);
 	}
 }
 
+void ThreadPool::workerLoop(int workerIdx) {
+	const core::String n = core::string::format("%s-%i", this->_name, workerIdx);
+	if (!setThreadName(n.c_str())) {
+		Log::debug("Failed to set thread name for pool thread %i", workerIdx);
+	}
+	core_trace_thread(n.c_str());
+	tlsPool = this;
+	tlsWorkerIdx = workerIdx;
+	for (;;) {
+		ThreadPoolTask task;
+		if (!(_stop && _force) && pop(workerIdx, task)) {
+			core_trace_begin_frame(n.c_str());
+			core_trace_scoped(ThreadPoolWorker);
+			Log::trace("Execute task in %i", workerIdx);
+			task();
+			Log::trace("End of task in %i", workerIdx);
+			core_trace_end_frame(n.c_str());
+			continue;
+		}
+		core::ScopedLock lock(_sleepMutex);
+		if (_stop && (_force || _queued <= 0)) {
+			Log::debug("Shutdown worker thread for %i", workerIdx);
+			break;
+		}
+		_sleeping.increment(1);
+		// predicate must return false if the waiting should continue
+		_sleepCondition.wait(_sleepMutex, [this] { return _stop || _queued > 0; });
+		_sleeping.decrement(1);
+	}
+	tlsPool = nullptr;
+	tlsWorkerIdx = -1;
+}
+
 void ThreadPool::init() {
 #ifdef __EMSCRIPTEN__
 #ifndef __EMSCRIPTEN_PTHREADS__
@@ -35,63 +253,40 @@ void ThreadPool::init() {
 	_stop = false;
 	_workers.reserve(_threads);
 	for (size_t i = 0; i < _threads; ++i) {
-		_workers.emplace_back([this, i] {
-			const core::String n = core::string::format("%s-%i", this->_name, (int)i);
-			if (!setThreadName(n.c_str())) {
-				Log::debug("Failed to set thread name for pool thread %i", (int)i);
-			}
-			core_trace_thread(n.c_str());
-			for (;;) {
-				std::function<void()> task;
-				{
-					core::ScopedLock lock(this->_queueMutex);
-					if (!this->_stop) {
-						this->_queueCondition.wait(this->_queueMutex, [this] {
-							// predicate must return false if the waiting should continue
-							if (this->_stop) {
-								return true;
-							}
-							core::ScopedLock queueLock(this->_queueMutex);
-							if (!this->_tasks.empty()) {
-								return true;
-							}
-							return false;
-						});
-					}
-					if (this->_stop && (this->_force || this->_tasks.empty())) {
-						Log::debug("Shutdown worker thread for %i", (int)i);
-						break;
-					}
-					task = core::move(this->_tasks.front());
-					this->_tasks.pop();
-				}
-
-				core_trace_begin_frame(n.c_str());
-				core_trace_scoped(ThreadPoolWorker);
-				Log::trace("Execute task in %i", (int)i);
-				task();
-				Log::trace("End of task in %i", (int)i);
-				core_trace_end_frame(n.c_str());
-			}
-		});
+		_workers.emplace_back([this, i] { workerLoop((int)i); });
 	}
 }
 
 ThreadPool::~ThreadPool() {
 	shutdown();
+	for (Worker *worker : _queues) {
+		delete worker;
+	}
+	_queues.clear();
+	delete _injection;
+	_injection = nullptr;
 }
 
 void ThreadPool::shutdown(bool wait) {
 	if (_stop) {
 		return;
 	}
-	_force = !wait;
-	_stop = true;
-	_queueCondition.notify_all();
+	{
+		core::ScopedLock lock(_injection->lock);
+		_force = !wait;
+		_stop = true;
+	}
+	{
+		core::ScopedLock lock(_sleepMutex);
+		_sleepCondition.notify_all();
+	}
 	for (std::thread &worker : _workers) {
 		worker.join();
 	}
 	_workers.clear();
+	if (_force) {
+		abort();
+	}
 }
 
 }
@@ -29,17 +29,137 @@
 
 #include <thread>
 #include <future>
+#include <new>
+#include <cstddef>
 #include <functional>
+#include <type_traits>
 #include "core/collection/DynamicArray.h"
-#include "core/collection/Queue.h"
 #include "core/concurrent/Atomic.h"
 #include "core/concurrent/Lock.h"
 #include "core/concurrent/ConditionVariable.h"
+#include "core/StandardLib.h"
 #include "core/Trace.h"
-#include "core/SharedPtr.h"
 
 namespace core {
 
+/**
+ * @brief Move-only callable wrapper with small buffer storage
+ *
+ * Callables that fit into the inline buffer (e.g. lambdas with a few captures or a @c std::packaged_task) don't need
+ * any heap allocation.
+ */
+class ThreadPoolTask {
+public:
+	static constexpr size_t InlineSize = 48u;
+
+	ThreadPoolTask() = default;
+
+	template<class F, typename = typename std::enable_if<
+						  !std::is_same<typename std::decay<F>::type, ThreadPoolTask>::value>::type>
+	ThreadPoolTask(F &&f) {
+		using Func = typename std::decay<F>::type;
+		if constexpr (sizeof(Func) <= InlineSize && alignof(Func) <= alignof(std::max_align_t) &&
+					  std::is_nothrow_move_constructible<Func>::value) {
+			new (_storage) Func(core::forward<F>(f));
+			_ops = &InlineOps<Func>::ops;
+		} else {
+			*(Func **)_storage = new Func(core::forward<F>(f));
+			_ops = &HeapOps<Func>::ops;
+		}
+	}
+
+	ThreadPoolTask(ThreadPoolTask &&other) noexcept {
+		moveFrom(other);
+	}
+
+	ThreadPoolTask &operator=(ThreadPoolTask &&other) noexcept {
+		if (this != &other) {
+			reset();
+			moveFrom(other);
+		}
+		return *this;
+	}
+
+	ThreadPoolTask(const ThreadPoolTask &) = delete;
+	ThreadPoolTask &operator=(const ThreadPoolTask &) = delete;
+
+	~ThreadPoolTask() {
+		reset();
+	}
+
+	inline void operator()() {
+		_ops->invoke(_storage);
+	}
+
+	inline bool valid() const {
+		return _ops != nullptr;
+	}
+
+	void reset() {
+		if (_ops != nullptr) {
+			_ops->destroy(_storage);
+			_ops = nullptr;
+		}
+	}
+
+private:
+	struct Ops {
+		void (*invoke)(void *storage);
+		void (*move)(void *dst, void *src);
+		void (*destroy)(void *storage);
+	};
+
+	template<class Func>
+	struct InlineOps {
+		static void invoke(void *storage) {
+			(*(Func *)storage)();
+		}
+		static void move(void *dst, void *src) {
+			new (dst) Func(core::move(*(Func *)src));
+			((Func *)src)->~Func();
+		}
+		static void destroy(void *storage) {
+			((Func *)storage)->~Func();
+		}
+		static constexpr Ops ops{invoke, move, destroy};
+	};
+
+	template<class Func>
+	struct HeapOps {
+		static void invoke(void *storage) {
+			(**(Func **)storage)();
+		}
+		static void move(void *dst, void *src) {
+			*(Func **)dst = *(Func **)src;
+		}
+		static void destroy(void *storage) {
+			delete *(Func **)storage;
+		}
+		static constexpr Ops ops{invoke, move, destroy};
+	};
+
+	void moveFrom(ThreadPoolTask &other) {
+		_ops = other._ops;
+		if (_ops != nullptr) {
+			_ops->move(_storage, other._storage);
+			other._ops = nullptr;
+		}
+	}
+
+	alignas(std::max_align_t) unsigned char _storage[InlineSize];
+	const Ops *_ops = nullptr;
+};
+
+/**
+ * @brief Work stealing thread pool
+ *
+ * Every worker has its own task deque. Tasks that are enqueued from a worker thread are pushed to the deque of that
+ * worker and popped in LIFO order (cache friendly for nested tasks). Tasks from other threads are put into a shared
+ * FIFO injection queue. Idle workers steal the oldest tasks from the other workers. There is no single lock that
+ * is shared by all producers and consumers.
+ *
+ * @sa TaskGroup
+ */
 class ThreadPool final {
 public:
 	explicit ThreadPool(size_t, const char *name = nullptr);
@@ -51,34 +171,70 @@ public:
 	template<class F, class ... Args>
 	auto enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type>;
 
+	/**
+	 * @brief Fire and forget version of @c enqueue() - there is no future and no extra allocation for small functors
+	 * @return @c false if the pool is not running - the functor is not executed in this case
+	 */
+	template<class F>
+	bool schedule(F &&f);
+	/**
+	 * @note The task is not moved if it couldn't get scheduled
+	 */
+	bool schedule(ThreadPoolTask &&task);
+
+	/**
+	 * @brief Executes one of the queued tasks on the calling thread
+	 * @return @c false if there was no task to execute
+	 * @note This is used to help out while waiting for other tasks - see @c TaskGroup::wait()
+	 */
+	bool runPendingTask();
+
 	size_t size() const;
 	void init();
 	/**
 	 * @brief Remove queued and not yet executed tasks
 	 * @note This does not abort the current running task
+	 * @note The removed tasks are destroyed without being executed - a @c TaskGroup counts them as done
 	 */
 	void abort();
 	void shutdown(bool wait = false);
 
 	void reserve(size_t n);
 private:
+	class TaskDeque;
+	struct Worker;
+
+	bool push(ThreadPoolTask &&task);
+	bool pop(int workerIdx, ThreadPoolTask &task);
+	void workerLoop(int workerIdx);
+
 	const size_t _threads;
 	const char *_name;
 	// need to keep track of threads so we can join them
 	core::DynamicArray<std::thread> _workers;
-	// the task queue
-	core::Queue<std::function<void()> > _tasks core_thread_guarded_by(_queueMutex);
+	core::DynamicArray<Worker *> _queues;
+	// tasks from threads that are not part of this pool
+	Worker *_injection = nullptr;
 
-	// synchronization
-	core_trace_mutex(core::Lock, _queueMutex, "ThreadPoolQueue");
-	core::ConditionVariable _queueCondition;
+	// synchronization for the idle workers
+	core_trace_mutex(core::Lock, _sleepMutex, "ThreadPoolSleep");
+	core::ConditionVariable _sleepCondition;
+	core::AtomicInt _queued { 0 };
+	core::AtomicInt _sleeping { 0 };
 	core::AtomicBool _stop { false };
 	core::AtomicBool _force { false };
 };
 
-inline void ThreadPool::reserve(size_t n) {
-	core::ScopedLock lock(_queueMutex);
-	_tasks.reserve(n);
+template<class F>
+bool ThreadPool::schedule(F &&f) {
+	if (_stop) {
+		return false;
+	}
+	return push(ThreadPoolTask(core::forward<F>(f)));
+}
+
+inline bool ThreadPool::schedule(ThreadPoolTask &&task) {
+	return push(core::move(task));
 }
 
 // add new work item to the pool
@@ -90,17 +246,11 @@ auto ThreadPool::enqueue(F&& f, Args&&... args)
 		return std::future<return_type>();
 	}
 
-	core::SharedPtr<std::packaged_task<return_type()> > task = core::make_shared<std::packaged_task<return_type()> >(std::bind(core::forward<F>(f), core::forward<Args>(args)...));
-
-	std::future<return_type> res = task->get_future();
-	{
-		core::ScopedLock lock(_queueMutex);
-		if (_stop) {
-			return std::future<return_type>();
-		}
-		_tasks.emplace([task]() {(*task.get())();});
+	std::packaged_task<return_type()> task(std::bind(core::forward<F>(f), core::forward<Args>(args)...));
+	std::future<return_type> res = task.get_future();
+	if (!push(ThreadPoolTask([t = core::move(task)]() mutable { t(); }))) {
+		return std::future<return_type>();
 	}
-	_queueCondition.notify_one();
 	return res;
 }
 
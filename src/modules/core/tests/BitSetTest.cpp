@@ -3,6 +3,7 @@
  */
 
 #include "core/collection/BitSet.h"
+#include "core/Common.h"
 #include <gtest/gtest.h>
 
 namespace core {
@@ -30,4 +31,57 @@ TEST(BitSetTest, testFillClear) {
     }
 }
 
+TEST(BitSetTest, testBitwiseOperations) {
+	BitSet a(100);
+	BitSet b(100);
+	EXPECT_FALSE(a.any());
+	a.set(1, true);
+	a.set(99, true);
+	b.set(1, true);
+	b.set(50, true);
+
+	BitSet c(a);
+	c |= b;
+	EXPECT_TRUE(c[1]);
+	EXPECT_TRUE(c[50]);
+	EXPECT_TRUE(c[99]);
+
+	c = a;
+	c &= b;
+	EXPECT_TRUE(c[1]);
+	EXPECT_FALSE(c[50]);
+	EXPECT_FALSE(c[99]);
+
+	c.flip();
+	EXPECT_FALSE(c[1]);
+	EXPECT_TRUE(c[0]);
+	EXPECT_TRUE(c[99]);
+	EXPECT_FALSE(c.all());
+	c.set(1, true);
+	EXPECT_TRUE(c.all());
+	c.clear();
+	EXPECT_FALSE(c.any());
+}
+
+TEST(BitSetTest, testAssignToMovedFrom) {
+	BitSet a(100);
+	a.set(42, true);
+	BitSet b(core::move(a));
+	EXPECT_EQ(0, a.bits());
+	EXPECT_EQ(0u, a.bytes());
+	EXPECT_TRUE(b[42]);
+
+	a = b;
+	EXPECT_EQ(100, a.bits());
+	EXPECT_TRUE(a[42]);
+	EXPECT_FALSE(a[41]);
+
+	BitSet c(10);
+	c = core::move(a);
+	EXPECT_EQ(0, a.bits());
+	a = c;
+	EXPECT_TRUE(a[42]);
+	EXPECT_TRUE(c[42]);
+}
+
 } // namespace core
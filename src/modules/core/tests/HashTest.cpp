@@ -11,4 +11,12 @@ TEST(HasTest, testUUID) {
 	ASSERT_EQ(36u, generateUUID().size());
 }
 
+TEST(HasTest, testHash64) {
+	const uint8_t data[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+	EXPECT_EQ(hash64(data, sizeof(data)), hash64(data, sizeof(data)));
+	EXPECT_NE(hash64(data, sizeof(data)), hash64(data, sizeof(data), 1u));
+	EXPECT_NE(hash64(data, sizeof(data)), hash64(data, sizeof(data) - 1));
+	EXPECT_NE(hash64(data, 8), hash64(data + 1, 8));
+}
+
 } // namespace core
@@ -5,6 +5,7 @@
 #include <gtest/gtest.h>
 #include "core/concurrent/ThreadPool.h"
 #include "core/concurrent/Atomic.h"
+#include "core/concurrent/TaskGroup.h"
 
 namespace core {
 
@@ -42,4 +43,110 @@ TEST_F(ThreadPoolTest, testMultiplePush) {
 	ASSERT_EQ(x, _count) << "Not all threads were executed";
 }
 
+TEST_F(ThreadPoolTest, testSchedule) {
+	const int x = 1000;
+	core::ThreadPool pool(4);
+	pool.init();
+	for (int i = 0; i < x; ++i) {
+		pool.schedule([this] () {
+			_count.increment(1);
+		});
+	}
+	pool.shutdown(true);
+	ASSERT_EQ(x, _count) << "Not all tasks were executed";
+}
+
+TEST_F(ThreadPoolTest, testTaskLargeCapture) {
+	// exceeds the inline buffer of the task and is stored on the heap
+	int values[64];
+	for (int i = 0; i < 64; ++i) {
+		values[i] = i;
+	}
+	int sum = 0;
+	core::ThreadPoolTask task([values, &sum] () {
+		for (int i = 0; i < 64; ++i) {
+			sum += values[i];
+		}
+	});
+	core::ThreadPoolTask moved(core::move(task));
+	ASSERT_FALSE(task.valid());
+	ASSERT_TRUE(moved.valid());
+	moved();
+	ASSERT_EQ(63 * 64 / 2, sum);
+}
+
+TEST_F(ThreadPoolTest, testTaskGroup) {
+	core::ThreadPool pool(4);
+	pool.init();
+	core::TaskGroup group(pool);
+	for (int i = 0; i < 100; ++i) {
+		group.run([this] () {
+			_count.increment(1);
+		});
+	}
+	group.wait();
+	ASSERT_EQ(0, group.pending());
+	ASSERT_EQ(100, _count);
+}
+
+TEST_F(ThreadPoolTest, testTaskGroupNested) {
+	// more nested groups than workers - the waiting workers must execute the queued tasks
+	core::ThreadPool pool(2);
+	pool.init();
+	core::TaskGroup outer(pool);
+	for (int i = 0; i < 16; ++i) {
+		outer.run([this, &pool] () {
+			core::TaskGroup inner(pool);
+			for (int j = 0; j < 16; ++j) {
+				inner.run([this] () {
+					_count.increment(1);
+				});
+			}
+			inner.wait();
+		});
+	}
+	outer.wait();
+	ASSERT_EQ(16 * 16, _count);
+}
+
+TEST_F(ThreadPoolTest, testTaskGroupWithoutRunningPool) {
+	core::ThreadPool pool(1);
+	pool.init();
+	pool.shutdown(true);
+	core::TaskGroup group(pool);
+	group.run([this] () {
+		_executed = true;
+	});
+	group.wait();
+	ASSERT_TRUE(_executed) << "Task wasn't executed on the calling thread";
+}
+
+TEST_F(ThreadPoolTest, testTaskGroupAbort) {
+	core::ThreadPool pool(1);
+	pool.init();
+	core::AtomicBool started{false};
+	core::AtomicBool release{false};
+	core::TaskGroup group(pool);
+	group.run([&] () {
+		started = true;
+		while (!release) {
+			std::this_thread::yield();
+		}
+	});
+	while (!started) {
+		std::this_thread::yield();
+	}
+	for (int i = 0; i < 10; ++i) {
+		group.run([this] () {
+			_count.increment(1);
+		});
+	}
+	// the queued tasks are dropped - they must not keep the group waiting
+	pool.abort();
+	release = true;
+	group.wait();
+	ASSERT_EQ(0, group.pending());
+	ASSERT_EQ(0, _count);
+}
+
 }
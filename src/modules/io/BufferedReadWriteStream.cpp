@@ -55,10 +55,12 @@ void BufferedReadWriteStream::resizeBuffer(int64_t size) {
 	if (_capacity >= size) {
 		return;
 	}
-	_capacity = align(size);
 	if (!_buffer) {
+		_capacity = align(size);
 		_buffer = (uint8_t*)core_malloc(_capacity);
 	} else {
+		// grow geometrically to keep the amount of reallocations low for many small writes
+		_capacity = align(core_max(size, _capacity * 2));
 		_buffer = (uint8_t*)core_realloc(_buffer, _capacity);
 	}
 }
@@ -6,6 +6,7 @@
 #include "core/Log.h"
 #include "core/StringUtil.h"
 #include "io/FormatDescription.h"
+#include "io/system/System.h"
 #include <SDL.h>
 #ifdef __EMSCRIPTEN__
 #include "system/emscripten_browser_file.h"
@@ -190,6 +191,10 @@ core::String File::extension() const {
 	return core::String(ext);
 }
 
+void *File::map(size_t &size) const {
+	return fs_mmap(_file, size);
+}
+
 long File::length() const {
 	if (!exists()) {
 		return -1l;
@@ -99,6 +99,13 @@ public:
 	const core::String& name() const;
 
 	SDL_RWops* createRWops(FileMode mode) const;
+	/**
+	 * @brief Maps the whole opened file read-only into memory
+	 * @param[out] size The size of the mapping
+	 * @return @c nullptr if the file could not get mapped - release the mapping with @c fs_munmap()
+	 * @sa fs_mmap()
+	 */
+	void *map(size_t &size) const;
 	long write(io::ReadStream &stream) const;
 	long write(const unsigned char *buf, size_t len) const;
 	/**
@@ -8,6 +8,7 @@
 #include "io/File.h"
 #include "io/FileStream.h"
 #include "io/Filesystem.h"
+#include "io/MappedReadStream.h"
 
 namespace io {
 
@@ -51,6 +52,11 @@ SeekableReadStream *FilesystemArchive::readStream(const core::String &filePath)
 		Log::error("Could not open file %s for reading: %s", file->name().c_str(), file->lastError().c_str());
 		return nullptr;
 	}
+	io::MappedReadStream *mapped = new io::MappedReadStream(file);
+	if (mapped->valid()) {
+		return mapped;
+	}
+	delete mapped;
 	io::FileStream *stream = new io::FileStream(file);
 	core_assert(stream->valid());
 	return stream;
@@ -0,0 +1,22 @@
+/**
+ * @file
+ */
+
+#include "MappedReadStream.h"
+#include "io/system/System.h"
+
+namespace io {
+
+MappedReadStream::MappedReadStream(const io::FilePtr &file) : Super(nullptr, 0) {
+	_mapping = file->map(_mappingSize);
+	if (_mapping != nullptr) {
+		_buf = (const uint8_t *)_mapping;
+		_size = (int64_t)_mappingSize;
+	}
+}
+
+MappedReadStream::~MappedReadStream() {
+	fs_munmap(_mapping, _mappingSize);
+}
+
+} // namespace io
@@ -0,0 +1,49 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "io/MemoryReadStream.h"
+#include "io/File.h"
+
+namespace io {
+
+/**
+ * @brief Maps an opened local file read-only into memory and serves the reads from the mapping
+ *
+ * This avoids the syscalls and the copies into the stdio buffers of the @c FileStream for every small read of the
+ * format loaders.
+ *
+ * @note The file must not get truncated while the stream is alive - reading the pages behind the new end of the file
+ * raises @c SIGBUS on posix systems. A file that is truncated while it gets mapped is detected and @c valid() returns
+ * @c false - the caller should use a @c FileStream then (see @c FilesystemArchive::readStream()).
+ *
+ * @ingroup IO
+ * @see MemoryReadStream
+ * @see FileStream
+ */
+class MappedReadStream : public MemoryReadStream {
+private:
+	using Super = MemoryReadStream;
+	void *_mapping = nullptr;
+	size_t _mappingSize = 0;
+
+public:
+	/**
+	 * @param[in] file The opened file - the stream doesn't need the file after it was constructed
+	 */
+	MappedReadStream(const io::FilePtr &file);
+	virtual ~MappedReadStream();
+
+	/**
+	 * @return @c false if the file could not get mapped - e.g. because it is empty or the platform doesn't support it
+	 */
+	bool valid() const;
+};
+
+inline bool MappedReadStream::valid() const {
+	return _mapping != nullptr;
+}
+
+} // namespace io
@@ -4,6 +4,8 @@
 
 #include "Stream.h"
 #include "core/String.h"
+#include "core/RGBA.h"
+#include "core/ArrayLength.h"
 #include "core/Assert.h"
 #include "core/UTF8.h"
 #include "core/collection/DynamicArray.h"
@@ -11,9 +13,78 @@
 #include <SDL_stdinc.h>
 #include <fcntl.h>
 #include <stdio.h>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace io {
 
+/**
+ * @brief Swaps the byte order of @c n 16 bit values - @c dst and @c src may be the same
+ */
+static void swapBytes16(uint16_t *dst, const uint16_t *src, size_t n) {
+	size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+	for (; i + 8 <= n; i += 8) {
+		const __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+	}
+#elif defined(__ARM_NEON)
+	for (; i + 8 <= n; i += 8) {
+		const uint8x16_t v = vld1q_u8((const uint8_t *)(src + i));
+		vst1q_u8((uint8_t *)(dst + i), vrev16q_u8(v));
+	}
+#endif
+	for (; i < n; ++i) {
+		dst[i] = SDL_Swap16(src[i]);
+	}
+}
+
+/**
+ * @brief Swaps the byte order of @c n 32 bit values - @c dst and @c src may be the same
+ */
+static void swapBytes32(uint32_t *dst, const uint32_t *src, size_t n) {
+	size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+	for (; i + 4 <= n; i += 4) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+		// swap the bytes of the 16 bit words - then the words of the 32 bit values
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+		v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+		_mm_storeu_si128((__m128i *)(dst + i), v);
+	}
+#elif defined(__ARM_NEON)
+	for (; i + 4 <= n; i += 4) {
+		const uint8x16_t v = vld1q_u8((const uint8_t *)(src + i));
+		vst1q_u8((uint8_t *)(dst + i), vrev32q_u8(v));
+	}
+#endif
+	for (; i < n; ++i) {
+		dst[i] = SDL_Swap32(src[i]);
+	}
+}
+
+/**
+ * @brief Writes the values with swapped byte order in chunks of a stack buffer
+ */
+template<class T, void (*SWAP)(T *, const T *, size_t)>
+static bool writeSwapped(WriteStream &stream, const T *vals, size_t n) {
+	T buf[256];
+	while (n > 0) {
+		const size_t chunk = core_min(n, lengthof(buf));
+		SWAP(buf, vals, chunk);
+		if (!stream.writeUInt8Array((const uint8_t *)buf, chunk * sizeof(T))) {
+			return false;
+		}
+		vals += chunk;
+		n -= chunk;
+	}
+	return true;
+}
+
 bool WriteStream::writeStream(ReadStream &stream) {
 	uint8_t buf[1024 * 32];
 	while (!stream.eos()) {
@@ -97,6 +168,53 @@ bool WriteStream::writeInt8(int8_t val) {
 	return write(&val, sizeof(val)) != -1;
 }
 
+bool WriteStream::writeUInt8Array(const uint8_t *vals, size_t n) {
+	if (n == 0) {
+		return true;
+	}
+	return write(vals, n) != -1;
+}
+
+bool WriteStream::writeUInt16Array(const uint16_t *vals, size_t n) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	return writeSwapped<uint16_t, swapBytes16>(*this, vals, n);
+#else
+	return writeUInt8Array((const uint8_t *)vals, n * sizeof(uint16_t));
+#endif
+}
+
+bool WriteStream::writeUInt16BEArray(const uint16_t *vals, size_t n) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	return writeUInt8Array((const uint8_t *)vals, n * sizeof(uint16_t));
+#else
+	return writeSwapped<uint16_t, swapBytes16>(*this, vals, n);
+#endif
+}
+
+bool WriteStream::writeInt32Array(const int32_t *vals, size_t n) {
+	return writeUInt32Array((const uint32_t *)vals, n);
+}
+
+bool WriteStream::writeUInt32Array(const uint32_t *vals, size_t n) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	return writeSwapped<uint32_t, swapBytes32>(*this, vals, n);
+#else
+	return writeUInt8Array((const uint8_t *)vals, n * sizeof(uint32_t));
+#endif
+}
+
+bool WriteStream::writeUInt32BEArray(const uint32_t *vals, size_t n) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	return writeUInt8Array((const uint8_t *)vals, n * sizeof(uint32_t));
+#else
+	return writeSwapped<uint32_t, swapBytes32>(*this, vals, n);
+#endif
+}
+
+bool WriteStream::writeRGBAArray(const core::RGBA *colors, size_t n) {
+	return writeUInt8Array((const uint8_t *)colors, n * sizeof(core::RGBA));
+}
+
 bool WriteStream::writeUInt8(uint8_t val) {
 	return write(&val, sizeof(val)) != -1;
 }
@@ -494,6 +612,70 @@ bool ReadStream::readBool() {
 	return boolean != 0;
 }
 
+int ReadStream::readUInt8Array(uint8_t *vals, size_t n) {
+	uint8_t *buf = vals;
+	size_t remaining = n;
+	// some streams (e.g. the zip streams) might return less bytes than requested
+	while (remaining > 0) {
+		const int bytes = read(buf, remaining);
+		if (bytes <= 0) {
+			return -1;
+		}
+		buf += bytes;
+		remaining -= (size_t)bytes;
+	}
+	return 0;
+}
+
+int ReadStream::readUInt16Array(uint16_t *vals, size_t n) {
+	if (readUInt8Array((uint8_t *)vals, n * sizeof(uint16_t)) == -1) {
+		return -1;
+	}
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	swapBytes16(vals, vals, n);
+#endif
+	return 0;
+}
+
+int ReadStream::readUInt16BEArray(uint16_t *vals, size_t n) {
+	if (readUInt8Array((uint8_t *)vals, n * sizeof(uint16_t)) == -1) {
+		return -1;
+	}
+#if SDL_BYTEORDER != SDL_BIG_ENDIAN
+	swapBytes16(vals, vals, n);
+#endif
+	return 0;
+}
+
+int ReadStream::readInt32Array(int32_t *vals, size_t n) {
+	return readUInt32Array((uint32_t *)vals, n);
+}
+
+int ReadStream::readUInt32Array(uint32_t *vals, size_t n) {
+	if (readUInt8Array((uint8_t *)vals, n * sizeof(uint32_t)) == -1) {
+		return -1;
+	}
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	swapBytes32(vals, vals, n);
+#endif
+	return 0;
+}
+
+int ReadStream::readUInt32BEArray(uint32_t *vals, size_t n) {
+	if (readUInt8Array((uint8_t *)vals, n * sizeof(uint32_t)) == -1) {
+		return -1;
+	}
+#if SDL_BYTEORDER != SDL_BIG_ENDIAN
+	swapBytes32(vals, vals, n);
+#endif
+	return 0;
+}
+
+int ReadStream::readRGBAArray(core::RGBA *colors, size_t n) {
+	static_assert(sizeof(core::RGBA) == 4, "Unexpected rgba size");
+	return readUInt8Array((uint8_t *)colors, n * sizeof(core::RGBA));
+}
+
 int ReadStream::readUInt16(uint16_t &val) {
 	if (read(&val, sizeof(val)) == sizeof(val)) {
 		const uint16_t swapped = SDL_SwapLE16(val);
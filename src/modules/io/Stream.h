@@ -18,6 +18,7 @@
 
 namespace core {
 class String;
+union RGBA;
 }
 
 namespace io {
@@ -119,6 +120,38 @@ public:
 	 * @return -1 on error - 0 on success
 	 */
 	int readDoubleBE(double &val);
+
+	/**
+	 * @brief Reads @c n values with one @c read() call instead of one call per value
+	 * @return -1 on error - 0 on success
+	 */
+	int readUInt8Array(uint8_t *vals, size_t n);
+	/**
+	 * @return -1 on error - 0 on success
+	 */
+	int readUInt16Array(uint16_t *vals, size_t n);
+	/**
+	 * @return -1 on error - 0 on success
+	 */
+	int readInt32Array(int32_t *vals, size_t n);
+	/**
+	 * @return -1 on error - 0 on success
+	 */
+	int readUInt32Array(uint32_t *vals, size_t n);
+	/**
+	 * @brief Big endian version of @c readUInt16Array() - the bytes are swapped with simd instructions if available
+	 * @return -1 on error - 0 on success
+	 */
+	int readUInt16BEArray(uint16_t *vals, size_t n);
+	/**
+	 * @return -1 on error - 0 on success
+	 */
+	int readUInt32BEArray(uint32_t *vals, size_t n);
+	/**
+	 * @brief Reads @c n colors with the byte order r, g, b and a
+	 * @return -1 on error - 0 on success
+	 */
+	int readRGBAArray(core::RGBA *colors, size_t n);
 	/**
 	 * @brief Read a fixed-width string from a file. It may be null-terminated, but
 	 * the position of the stream is still advanced by the given length
@@ -271,6 +304,20 @@ public:
 	bool writeFloatBE(float val);
 	bool writeDoubleBE(double val);
 
+	/**
+	 * @brief Writes @c n values with one @c write() call instead of one call per value
+	 */
+	bool writeUInt8Array(const uint8_t *vals, size_t n);
+	bool writeUInt16Array(const uint16_t *vals, size_t n);
+	bool writeInt32Array(const int32_t *vals, size_t n);
+	bool writeUInt32Array(const uint32_t *vals, size_t n);
+	bool writeUInt16BEArray(const uint16_t *vals, size_t n);
+	bool writeUInt32BEArray(const uint32_t *vals, size_t n);
+	/**
+	 * @brief Writes @c n colors with the byte order r, g, b and a
+	 */
+	bool writeRGBAArray(const core::RGBA *colors, size_t n);
+
 	bool writeStringFormat(bool terminate, CORE_FORMAT_STRING const char *fmt, ...) CORE_PRINTF_VARARG_FUNC(3);
 	/**
 	 * @param terminate If this is @c true the extra null byte is written to the stream
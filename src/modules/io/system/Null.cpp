@@ -6,6 +6,7 @@
 
 #if !defined(__LINUX__) && !defined(__MACOSX__) && !defined(__WINDOWS__) && !defined(__EMSCRIPTEN__)
 #include "io/Filesystem.h"
+#include "io/system/System.h"
 
 namespace io {
 
@@ -62,6 +63,14 @@ core::String fs_cwd() {
 	return "/";
 }
 
+void *fs_mmap(SDL_RWops *file, size_t &size) {
+	size = 0;
+	return nullptr;
+}
+
+void fs_munmap(void *ptr, size_t size) {
+}
+
 } // namespace io
 
 #endif
@@ -7,6 +7,8 @@
 #include "core/collection/DynamicArray.h"
 #include "io/FilesystemEntry.h"
 
+struct SDL_RWops;
+
 namespace io {
 
 bool fs_mkdir(const char *path);
@@ -21,5 +23,17 @@ bool fs_stat(const char *path, FilesystemEntry &entry);
 core::DynamicArray<FilesystemEntry> fs_scandir(const char *path);
 core::String fs_readlink(const char *path);
 core::String fs_cwd();
+/**
+ * @brief Maps the whole already opened file read-only into memory
+ * @param[in] file The opened file - only files that are backed by a file descriptor (or a file handle on windows) can
+ * get mapped
+ * @param[out] size The size of the mapping
+ * @return @c nullptr if the file could not get mapped (e.g. empty files or platforms without support)
+ * @note The mapping is private but not a copy - if the file gets truncated by another process while it is mapped,
+ * reading the pages behind the new end of the file raises @c SIGBUS on posix systems
+ * @sa fs_munmap()
+ */
+void *fs_mmap(SDL_RWops *file, size_t &size);
+void fs_munmap(void *ptr, size_t size);
 
 } // namespace io
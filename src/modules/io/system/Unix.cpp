@@ -6,6 +6,7 @@
 #include "core/collection/DynamicArray.h"
 #include "io/FilesystemEntry.h"
 #include <SDL_platform.h>
+#include <SDL_rwops.h>
 
 #if defined(__LINUX__) || defined(__MACOSX__) || defined(__EMSCRIPTEN__)
 #include "core/Log.h"
@@ -17,6 +18,8 @@
 #include <errno.h>
 #include <pwd.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -332,6 +335,46 @@ bool fs_hidden(const char *path) {
 	return path[0] == '.';
 }
 
+void *fs_mmap(SDL_RWops *file, size_t &size) {
+	size = 0;
+#ifdef HAVE_STDIO_H
+	if (file == nullptr || file->type != SDL_RWOPS_STDFILE) {
+		return nullptr;
+	}
+	const int fd = fileno((FILE *)file->hidden.stdio.fp);
+	if (fd == -1) {
+		return nullptr;
+	}
+	struct stat s;
+	if (fstat(fd, &s) != 0 || !S_ISREG(s.st_mode) || s.st_size <= 0) {
+		return nullptr;
+	}
+	void *ptr = mmap(nullptr, (size_t)s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (ptr == MAP_FAILED) {
+		Log::debug("Failed to map file: %s", strerror(errno));
+		return nullptr;
+	}
+	// the file might have been truncated since the size was queried - accessing the pages behind the end of the file
+	// would raise SIGBUS. The caller falls back to reading the file in this case.
+	struct stat after;
+	if (fstat(fd, &after) != 0 || after.st_size < s.st_size) {
+		Log::debug("File was truncated while mapping it");
+		munmap(ptr, (size_t)s.st_size);
+		return nullptr;
+	}
+	size = (size_t)s.st_size;
+	return ptr;
+#else
+	return nullptr;
+#endif
+}
+
+void fs_munmap(void *ptr, size_t size) {
+	if (ptr != nullptr) {
+		munmap(ptr, size);
+	}
+}
+
 } // namespace io
 
 #endif
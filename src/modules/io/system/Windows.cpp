@@ -12,6 +12,7 @@
 #include "core/StringUtil.h"
 #include "core/Log.h"
 #include "io/Filesystem.h"
+#include <SDL_rwops.h>
 #include <SDL_stdinc.h>
 
 #include "windirent.h"
@@ -247,6 +248,36 @@ core::DynamicArray<FilesystemEntry> fs_scandir(const char *path) {
 	return entries;
 }
 
+void *fs_mmap(SDL_RWops *rwops, size_t &size) {
+	size = 0;
+	if (rwops == nullptr || rwops->type != SDL_RWOPS_WINFILE) {
+		return nullptr;
+	}
+	HANDLE file = (HANDLE)rwops->hidden.windowsio.h;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+		return nullptr;
+	}
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		return nullptr;
+	}
+	// the view keeps a reference to the mapping
+	void *ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (ptr == nullptr) {
+		return nullptr;
+	}
+	size = (size_t)fileSize.QuadPart;
+	return ptr;
+}
+
+void fs_munmap(void *ptr, size_t size) {
+	if (ptr != nullptr) {
+		UnmapViewOfFile(ptr);
+	}
+}
+
 #undef io_StringToUTF8W
 #undef io_UTF8ToStringW
 
@@ -3,7 +3,9 @@
  */
 
 #include <gtest/gtest.h>
+#include "core/ArrayLength.h"
 #include "core/FourCC.h"
+#include "core/RGBA.h"
 #include "io/BufferedReadWriteStream.h"
 #include <limits.h>
 
@@ -57,6 +59,79 @@ TEST(BufferedReadWriteStreamTest, testWriteReadUInt64) {
 	EXPECT_EQ(previous - (int64_t)sizeof(readVal), stream.remaining());
 }
 
+TEST(BufferedReadWriteStreamTest, testWriteReadArrays) {
+	BufferedReadWriteStream stream;
+	const uint16_t shorts[]{0, 1, 0x1234, USHRT_MAX};
+	const int32_t ints[]{0, -1, 0x12345678, INT_MIN};
+	const core::RGBA colors[]{core::RGBA(1, 2, 3, 4), core::RGBA(255, 0, 128, 0)};
+	ASSERT_TRUE(stream.writeUInt16Array(shorts, lengthof(shorts)));
+	ASSERT_TRUE(stream.writeInt32Array(ints, lengthof(ints)));
+	ASSERT_TRUE(stream.writeRGBAArray(colors, lengthof(colors)));
+	EXPECT_EQ((int64_t)(sizeof(shorts) + sizeof(ints) + sizeof(colors)), stream.size());
+	stream.seek(0);
+
+	uint16_t readShort = 0;
+	EXPECT_EQ(0, stream.readUInt16(readShort));
+	EXPECT_EQ(shorts[0], readShort);
+	stream.seek(0);
+
+	uint16_t readShorts[lengthof(shorts)];
+	int32_t readInts[lengthof(ints)];
+	core::RGBA readColors[lengthof(colors)];
+	ASSERT_EQ(0, stream.readUInt16Array(readShorts, lengthof(readShorts)));
+	ASSERT_EQ(0, stream.readInt32Array(readInts, lengthof(readInts)));
+	ASSERT_EQ(0, stream.readRGBAArray(readColors, lengthof(readColors)));
+	for (int i = 0; i < lengthof(shorts); ++i) {
+		EXPECT_EQ(shorts[i], readShorts[i]);
+	}
+	for (int i = 0; i < lengthof(ints); ++i) {
+		EXPECT_EQ(ints[i], readInts[i]);
+	}
+	for (int i = 0; i < lengthof(colors); ++i) {
+		EXPECT_EQ(colors[i], readColors[i]);
+	}
+	EXPECT_EQ(-1, stream.readInt32Array(readInts, 1)) << "Reading past the end of the stream should fail";
+}
+
+TEST(BufferedReadWriteStreamTest, testWriteReadBEArrays) {
+	BufferedReadWriteStream stream;
+	// odd amounts to also cover the values behind the last full simd register
+	uint16_t shorts[19];
+	uint32_t ints[11];
+	for (int i = 0; i < lengthof(shorts); ++i) {
+		shorts[i] = (uint16_t)(0x0102 * (i + 1));
+	}
+	for (int i = 0; i < lengthof(ints); ++i) {
+		ints[i] = 0x01020304u * (uint32_t)(i + 1);
+	}
+	ASSERT_TRUE(stream.writeUInt16BEArray(shorts, lengthof(shorts)));
+	ASSERT_TRUE(stream.writeUInt32BEArray(ints, lengthof(ints)));
+	stream.seek(0);
+
+	for (int i = 0; i < lengthof(shorts); ++i) {
+		uint16_t val = 0;
+		ASSERT_EQ(0, stream.readUInt16BE(val));
+		EXPECT_EQ(shorts[i], val);
+	}
+	for (int i = 0; i < lengthof(ints); ++i) {
+		uint32_t val = 0;
+		ASSERT_EQ(0, stream.readUInt32BE(val));
+		EXPECT_EQ(ints[i], val);
+	}
+	stream.seek(0);
+
+	uint16_t readShorts[lengthof(shorts)];
+	uint32_t readInts[lengthof(ints)];
+	ASSERT_EQ(0, stream.readUInt16BEArray(readShorts, lengthof(readShorts)));
+	ASSERT_EQ(0, stream.readUInt32BEArray(readInts, lengthof(readInts)));
+	for (int i = 0; i < lengthof(shorts); ++i) {
+		EXPECT_EQ(shorts[i], readShorts[i]);
+	}
+	for (int i = 0; i < lengthof(ints); ++i) {
+		EXPECT_EQ(ints[i], readInts[i]);
+	}
+}
+
 TEST(BufferedReadWriteStreamTest, testWriteReadInt8) {
 	BufferedReadWriteStream stream;
 	int8_t writeVal = CHAR_MIN;
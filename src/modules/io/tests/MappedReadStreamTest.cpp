@@ -0,0 +1,56 @@
+/**
+ * @file
+ */
+
+#include "io/MappedReadStream.h"
+#include "core/FourCC.h"
+#include "io/Filesystem.h"
+#include <gtest/gtest.h>
+
+namespace io {
+
+class MappedReadStreamTest : public testing::Test {
+protected:
+	io::Filesystem _fs;
+
+public:
+	void SetUp() override {
+		_fs.init("test", "test");
+	}
+
+	void TearDown() override {
+		_fs.shutdown();
+	}
+};
+
+TEST_F(MappedReadStreamTest, testInvalidFile) {
+	const FilePtr &file = _fs.open("does-not-exist.txt");
+	MappedReadStream stream(file);
+	EXPECT_FALSE(stream.valid());
+	EXPECT_EQ(0, stream.size());
+	uint8_t val = 0;
+	EXPECT_EQ(-1, stream.readUInt8(val));
+}
+
+TEST_F(MappedReadStreamTest, testMappedReadStream) {
+	const FilePtr &file = _fs.open("iotest.txt");
+	ASSERT_TRUE(file->exists());
+
+	MappedReadStream stream(file);
+	ASSERT_TRUE(stream.valid());
+	EXPECT_EQ((int64_t)file->length(), stream.size());
+
+	uint32_t magic;
+	EXPECT_EQ(0, stream.peekUInt32(magic));
+	EXPECT_EQ(0, stream.pos());
+	EXPECT_EQ(FourCC('W', 'i', 'n', 'd'), magic);
+
+	core::String line;
+	EXPECT_TRUE(stream.readLine(line));
+	EXPECT_EQ("WindowInfo", line);
+	EXPECT_EQ(stream.size(), stream.seek(0, SEEK_END));
+	uint8_t chr;
+	EXPECT_EQ(-1, stream.readUInt8(chr));
+}
+
+} // namespace io
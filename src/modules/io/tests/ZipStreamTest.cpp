@@ -2,6 +2,7 @@
  * @file
  */
 
+#include "core/ArrayLength.h"
 #include "io/BufferedReadWriteStream.h"
 #include "io/ZipReadStream.h"
 #include "io/ZipWriteStream.h"
@@ -55,6 +56,32 @@ TEST_F(ZipStreamTest, testZipStreamWriteAndRead) {
 	}
 }
 
+TEST_F(ZipStreamTest, testZipStreamWriteArrays) {
+	uint32_t vals[1024];
+	for (int i = 0; i < lengthof(vals); ++i) {
+		vals[i] = (uint32_t)i;
+	}
+	BufferedReadWriteStream stream(1024);
+	{
+		// the zip stream returns the amount of compressed bytes - not the amount of consumed bytes
+		ZipWriteStream w(stream);
+		ASSERT_TRUE(w.writeUInt32Array(vals, lengthof(vals)));
+		ASSERT_TRUE(w.writeUInt8Array((const uint8_t *)vals, 3));
+		ASSERT_TRUE(w.flush());
+	}
+	const int size = (int)stream.size();
+	stream.seek(0);
+	ZipReadStream r(stream, size);
+	uint32_t readVals[lengthof(vals)];
+	ASSERT_EQ(0, r.readUInt32Array(readVals, lengthof(readVals)));
+	for (int i = 0; i < lengthof(vals); ++i) {
+		ASSERT_EQ(vals[i], readVals[i]) << "unexpected extracted value at " << i;
+	}
+	uint8_t bytes[3];
+	ASSERT_EQ(0, r.readUInt8Array(bytes, lengthof(bytes)));
+	EXPECT_EQ(0, memcmp(bytes, vals, sizeof(bytes)));
+}
+
 TEST_F(ZipStreamTest, testZipStreamNoSize) {
 	const int n = 64;
 	const int size = n * 4 * sizeof(uint32_t);
@@ -11,17 +11,21 @@
 #include "core/ScopedPtr.h"
 #include "core/StandardLib.h"
 #include "core/StringUtil.h"
+#include "core/Trace.h"
 #include "io/BufferedReadWriteStream.h"
 #include "io/MemoryReadStream.h"
 #include "io/ZipReadStream.h"
 #include "io/ZipWriteStream.h"
 #include "palette/NormalPalette.h"
 #include "scenegraph/SceneGraphNode.h"
+#include "voxel/PaletteVolume.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Region.h"
 #include "voxel/Voxel.h"
 #include "voxelutil/VoxelUtil.h"
+#include "lzfse.h"
 #include <inttypes.h>
+#include <thread>
 
 namespace memento {
 
@@ -125,8 +129,99 @@ MementoState::MementoState(MementoType _type, const core::DynamicArray<core::Str
 	: type(_type), stringList(_stringList) {
 }
 
-MementoData::MementoData(uint8_t *buf, size_t bufSize, const voxel::Region &region)
-	: _compressedSize(bufSize), _region(region) {
+MementoCompressionJob::MementoCompressionJob(uint8_t *_voxels, size_t _voxelsSize, const voxel::Region &_region,
+											 MementoCompression _compression)
+	: voxels(_voxels), voxelsSize(_voxelsSize), region(_region), compression(_compression) {
+}
+
+MementoCompressionJob::~MementoCompressionJob() {
+	core_free(voxels);
+	core_free(buffer);
+}
+
+static uint8_t *compressLZFSE(const uint8_t *voxels, size_t voxelsSize, size_t &compressedSize) {
+	void *scratch = core_malloc(lzfse_encode_scratch_size());
+	size_t bufferSize = voxelsSize + 1024;
+	uint8_t *buffer = (uint8_t *)core_malloc(bufferSize);
+	for (;;) {
+		compressedSize = lzfse_encode_buffer(buffer, bufferSize, voxels, voxelsSize, scratch);
+		if (compressedSize != 0) {
+			break;
+		}
+		// the buffer was too small
+		bufferSize *= 2;
+		buffer = (uint8_t *)core_realloc(buffer, bufferSize);
+	}
+	core_free(scratch);
+	return buffer;
+}
+
+static uint8_t *compressZip(const uint8_t *voxels, size_t voxelsSize, size_t &compressedSize) {
+	io::BufferedReadWriteStream outStream((int64_t)voxelsSize);
+	io::ZipWriteStream stream(outStream);
+	stream.write(voxels, voxelsSize);
+	stream.flush();
+	compressedSize = (size_t)outStream.size();
+	return outStream.release();
+}
+
+static uint8_t *compress(const uint8_t *data, size_t dataSize, MementoCompression compression,
+						 size_t &compressedSize) {
+	if (compression == MementoCompression::LZFSE) {
+		return compressLZFSE(data, dataSize, compressedSize);
+	}
+	return compressZip(data, dataSize, compressedSize);
+}
+
+// the voxels of the palette indices are in front of the air index and the palette indices
+static constexpr size_t PaletteIndicesHeaderSize = 256 * sizeof(voxel::Voxel) + 1;
+
+static uint8_t *compressVoxels(const voxel::Voxel *voxels, const voxel::Region &region,
+							   MementoCompression compression, size_t &compressedSize, bool &paletteIndices) {
+	const size_t voxelCount = (size_t)region.voxels();
+	const size_t voxelsSize = voxelCount * sizeof(voxel::Voxel);
+	paletteIndices = false;
+	// small deltas are not worth the header
+	if (voxelsSize <= PaletteIndicesHeaderSize + voxelCount) {
+		return compress((const uint8_t *)voxels, voxelsSize, compression, compressedSize);
+	}
+	const voxel::PaletteVolume paletteVolume(voxels, region);
+	paletteIndices = paletteVolume.isCompact();
+	if (!paletteIndices) {
+		return compress((const uint8_t *)voxels, voxelsSize, compression, compressedSize);
+	}
+	const size_t size = PaletteIndicesHeaderSize + voxelCount;
+	uint8_t *data = (uint8_t *)core_malloc(size);
+	core_memcpy(data, paletteVolume.indexVoxels(), 256 * sizeof(voxel::Voxel));
+	data[PaletteIndicesHeaderSize - 1] = paletteVolume.airIndex();
+	core_memcpy(data + PaletteIndicesHeaderSize, paletteVolume.data(), voxelCount);
+	uint8_t *buffer = compress(data, size, compression, compressedSize);
+	core_free(data);
+	return buffer;
+}
+
+void MementoCompressionJob::execute() {
+	if (claimed.exchange(true)) {
+		return;
+	}
+	core_trace_scoped(MementoCompression);
+	buffer = compressVoxels((const voxel::Voxel *)voxels, region, compression, compressedSize, paletteIndices);
+	core_free(voxels);
+	voxels = nullptr;
+	done = true;
+}
+
+void MementoCompressionJob::wait() {
+	execute();
+	while (!done) {
+		std::this_thread::yield();
+	}
+}
+
+MementoData::MementoData(uint8_t *buf, size_t bufSize, const voxel::Region &region,
+						 const voxel::Region &modifiedRegion, MementoCompression compression, bool paletteIndices)
+	: _compressedSize(bufSize), _compression(compression), _paletteIndices(paletteIndices), _region(region),
+	  _modifiedRegion(modifiedRegion) {
 	if (buf != nullptr) {
 		core_assert(_compressedSize > 0);
 		_buffer = buf;
@@ -135,8 +230,13 @@ MementoData::MementoData(uint8_t *buf, size_t bufSize, const voxel::Region &regi
 	}
 }
 
+MementoData::MementoData(const core::SharedPtr<MementoCompressionJob> &job, const voxel::Region &region,
+						 const voxel::Region &modifiedRegion)
+	: _job(job), _compression(job->compression), _region(region), _modifiedRegion(modifiedRegion) {
+}
+
 MementoData::MementoData(const uint8_t *buf, size_t bufSize, const voxel::Region &region)
-	: _compressedSize(bufSize), _region(region) {
+	: _compressedSize(bufSize), _region(region), _modifiedRegion(region) {
 	if (buf != nullptr) {
 		core_assert(_compressedSize > 0);
 		_buffer = (uint8_t *)core_malloc(_compressedSize);
@@ -147,7 +247,8 @@ MementoData::MementoData(const uint8_t *buf, size_t bufSize, const voxel::Region
 }
 
 MementoData::MementoData(MementoData &&o) noexcept
-	: _compressedSize(o._compressedSize), _buffer(o._buffer), _region(o._region) {
+	: _compressedSize(o._compressedSize), _buffer(o._buffer), _job(core::move(o._job)), _compression(o._compression),
+	  _paletteIndices(o._paletteIndices), _region(o._region), _modifiedRegion(o._modifiedRegion) {
 	o._compressedSize = 0;
 	o._buffer = nullptr;
 }
@@ -159,7 +260,10 @@ MementoData::~MementoData() {
 	}
 }
 
-MementoData::MementoData(const MementoData &o) : _compressedSize(o._compressedSize), _region(o._region) {
+// a pending compression job is shared with the copy - the copy doesn't block until the compression is done
+MementoData::MementoData(const MementoData &o)
+	: _compressedSize(o._compressedSize), _job(o._job), _compression(o._compression),
+	  _paletteIndices(o._paletteIndices), _region(o._region), _modifiedRegion(o._modifiedRegion) {
 	if (o._buffer != nullptr) {
 		core_assert(_compressedSize > 0);
 		_buffer = (uint8_t *)core_malloc(_compressedSize);
@@ -178,7 +282,11 @@ MementoData &MementoData::operator=(MementoData &&o) noexcept {
 		}
 		_buffer = o._buffer;
 		o._buffer = nullptr;
+		_job = core::move(o._job);
+		_compression = o._compression;
+		_paletteIndices = o._paletteIndices;
 		_region = o._region;
+		_modifiedRegion = o._modifiedRegion;
 	}
 	return *this;
 }
@@ -197,38 +305,93 @@ MementoData &MementoData::operator=(const MementoData &o) noexcept {
 		} else {
 			core_assert(_compressedSize == 0);
 		}
+		_job = o._job;
+		_compression = o._compression;
+		_paletteIndices = o._paletteIndices;
 		_region = o._region;
+		_modifiedRegion = o._modifiedRegion;
 	}
 	return *this;
 }
 
-MementoData MementoData::fromVolume(const voxel::RawVolume *volume, const voxel::Region &region) {
+void MementoData::sync() const {
+	if (!_job) {
+		return;
+	}
+	_job->wait();
+	core_assert(_buffer == nullptr);
+	_compressedSize = _job->compressedSize;
+	_paletteIndices = _job->paletteIndices;
+	if (*_job.refCnt() == 1) {
+		_buffer = _job->buffer;
+		_job->buffer = nullptr;
+	} else {
+		// the job is still shared with copies of this memento data
+		_buffer = (uint8_t *)core_malloc(_compressedSize);
+		core_memcpy(_buffer, _job->buffer, _compressedSize);
+	}
+	_job = nullptr;
+}
+
+size_t MementoData::memoryUsage() const {
+	if (_job) {
+		return _job->done ? _job->compressedSize : 0u;
+	}
+	return _compressedSize;
+}
+
+size_t MementoData::pendingMemoryUsage() const {
+	if (_job && !_job->done) {
+		return _job->voxelsSize;
+	}
+	return 0u;
+}
+
+MementoData MementoData::fromVolume(const voxel::RawVolume *volume, const voxel::Region &region,
+									MementoCompression compression, core::ThreadPool *pool, core::AtomicBool *completed) {
 	if (volume == nullptr) {
 		return MementoData();
 	}
-	voxel::Region mementoRegion = region;
-	// TODO: MEMENTO: see issue https://github.com/vengi-voxel/vengi/issues/200
-	// const bool partialMemento = mementoRegion.isValid();
-	const bool partialMemento = false;
-	if (!partialMemento) {
-		mementoRegion = volume->region();
+	core_trace_scoped(MementoDataFromVolume);
+	const voxel::Region &mementoRegion = volume->region();
+	voxel::Region modifiedRegion = region;
+	if (!modifiedRegion.isValid() || !modifiedRegion.cropTo(mementoRegion)) {
+		modifiedRegion = mementoRegion;
 	}
-
-	const int allVoxels = volume->region().voxels();
-	io::BufferedReadWriteStream outStream(allVoxels * sizeof(voxel::Voxel));
-	io::ZipWriteStream stream(outStream);
+	const bool partialMemento = modifiedRegion != mementoRegion;
+
+	const size_t voxelsSize = (size_t)modifiedRegion.voxels() * sizeof(voxel::Voxel);
+	if (pool == nullptr) {
+		size_t compressedSize = 0;
+		bool paletteIndices = false;
+		core::ScopedPtr<voxel::RawVolume> v(partialMemento ? new voxel::RawVolume(*volume, modifiedRegion) : nullptr);
+		const voxel::Voxel *voxels = (const voxel::Voxel *)(partialMemento ? v->data() : volume->data());
+		uint8_t *buffer = compressVoxels(voxels, modifiedRegion, compression, compressedSize, paletteIndices);
+		return {buffer, compressedSize, mementoRegion, modifiedRegion, compression, paletteIndices};
+	}
+	// the copy of the voxels is handed over to the compression job - the volume can be modified again right away
+	uint8_t *voxels = (uint8_t *)core_malloc(voxelsSize);
 	if (partialMemento) {
-		voxel::RawVolume v(volume, region);
-		stream.write(v.data(), allVoxels * sizeof(voxel::Voxel));
+		const voxel::RawVolume v(*volume, modifiedRegion);
+		core_memcpy(voxels, v.data(), voxelsSize);
 	} else {
-		stream.write(volume->data(), allVoxels * sizeof(voxel::Voxel));
+		core_memcpy(voxels, volume->data(), voxelsSize);
 	}
-	stream.flush();
-	const size_t size = (size_t)outStream.size();
-	return {outStream.release(), size, mementoRegion};
+	core::SharedPtr<MementoCompressionJob> job =
+		core::make_shared<MementoCompressionJob>(voxels, voxelsSize, modifiedRegion, compression);
+	if (!pool->schedule([job, completed]() {
+			job->execute();
+			if (completed != nullptr) {
+				*completed = true;
+			}
+		})) {
+		job->execute();
+	}
+	return {job, mementoRegion, modifiedRegion};
 }
 
 bool MementoData::toVolume(voxel::RawVolume *volume, const MementoData &mementoData) {
+	mementoData.sync();
 	if (mementoData._buffer == nullptr) {
 		return false;
 	}
@@ -236,17 +399,40 @@ bool MementoData::toVolume(voxel::RawVolume *volume, const MementoData &mementoD
 	if (volume == nullptr) {
 		return false;
 	}
-	const size_t uncompressedBufferSize = mementoData.region().voxels() * sizeof(voxel::Voxel);
-	io::MemoryReadStream dataStream(mementoData._buffer, mementoData._compressedSize);
-	io::ZipReadStream stream(dataStream, (int)dataStream.size());
+	core_trace_scoped(MementoDataToVolume);
+	const voxel::Region &modifiedRegion = mementoData.modifiedRegion();
+	const size_t voxelCount = (size_t)modifiedRegion.voxels();
+	const size_t uncompressedBufferSize = mementoData._paletteIndices ? PaletteIndicesHeaderSize + voxelCount
+																	  : voxelCount * sizeof(voxel::Voxel);
 	uint8_t *uncompressedBuf = (uint8_t *)core_malloc(uncompressedBufferSize);
-	if (stream.read(uncompressedBuf, uncompressedBufferSize) == -1) {
+	if (mementoData._compression == MementoCompression::LZFSE) {
+		void *scratch = core_malloc(lzfse_decode_scratch_size());
+		const size_t size = lzfse_decode_buffer(uncompressedBuf, uncompressedBufferSize, mementoData._buffer,
+												mementoData._compressedSize, scratch);
+		core_free(scratch);
+		if (size != uncompressedBufferSize) {
+			core_free(uncompressedBuf);
+			return false;
+		}
+	} else {
+		io::MemoryReadStream dataStream(mementoData._buffer, mementoData._compressedSize);
+		io::ZipReadStream stream(dataStream, (int)dataStream.size());
+		if (stream.read(uncompressedBuf, uncompressedBufferSize) == -1) {
+			core_free(uncompressedBuf);
+			return false;
+		}
+	}
+	core::ScopedPtr<voxel::RawVolume> v;
+	if (mementoData._paletteIndices) {
+		const voxel::PaletteVolume paletteVolume(modifiedRegion, (const voxel::Voxel *)uncompressedBuf,
+												 uncompressedBuf[PaletteIndicesHeaderSize - 1],
+												 uncompressedBuf + PaletteIndicesHeaderSize);
 		core_free(uncompressedBuf);
-		return false;
+		v = paletteVolume.toRawVolume();
+	} else {
+		v = voxel::RawVolume::createRaw((voxel::Voxel *)uncompressedBuf, modifiedRegion);
 	}
-	core::ScopedPtr<voxel::RawVolume> v(
-		voxel::RawVolume::createRaw((voxel::Voxel *)uncompressedBuf, mementoData.region()));
-	voxelutil::copyIntoRegion(*v, *volume, mementoData.region());
+	voxelutil::copyIntoRegion(*v, *volume, modifiedRegion);
 	return true;
 }
 
@@ -257,11 +443,16 @@ MementoHandler::~MementoHandler() {
 }
 
 bool MementoHandler::init() {
+	_compressionPool.init();
+	_asyncCompression = true;
 	return true;
 }
 
 void MementoHandler::shutdown() {
+	_asyncCompression = false;
 	clearStates();
+	// the states that are still referencing a compression job are already gone
+	_compressionPool.shutdown();
 }
 
 void MementoHandler::lock() {
@@ -281,6 +472,8 @@ void MementoHandler::beginGroup(const core::String &name) {
 	Log::debug("Begin memento group: %i (%s)", _groupState, name.c_str());
 	if (_groupState <= 0) {
 		cutFromGroupStatePosition();
+		enforceMemoryBudget();
+		prepareAddGroup();
 		_groups.emplace_back(MementoStateGroup{name, {}});
 		_groupStatePosition = stateSize() - 1;
 	}
@@ -325,7 +518,7 @@ void MementoHandler::printState(const MementoState &state) const {
 	Log::info("%s: node id: %s", typeToString(state.type), state.nodeUUID.c_str());
 	Log::info(" - parent: %s", state.parentUUID.c_str());
 	Log::info(" - name: %s", state.name.c_str());
-	Log::info(" - volume: %s", state.data._buffer == nullptr ? "empty" : "volume");
+	Log::info(" - volume: %s", state.hasVolumeData() ? "volume" : "empty");
 	const glm::ivec3 &mins = state.dataRegion().getLowerCorner();
 	const glm::ivec3 &maxs = state.dataRegion().getUpperCorner();
 	Log::info(" - region: mins(%i:%i:%i)/maxs(%i:%i:%i)", mins.x, mins.y, mins.z, maxs.x, maxs.y, maxs.z);
@@ -378,33 +571,83 @@ void MementoHandler::construct() {
 
 void MementoHandler::clearStates() {
 	core_assert_msg(_groupState <= 0, "You should not clear the states while you are recording a group state");
+	// the ring buffer doesn't destroy the removed elements
+	for (MementoStateGroup &group : _groups) {
+		group.states.clear();
+	}
 	_groups.clear();
 	_groupStatePosition = 0u;
+	_evictionUsage = 0u;
 }
 
-void MementoHandler::undoModification(MementoState &s) {
-	core_assert(s.hasVolumeData());
-	for (int i = _groupStatePosition; i >= 0; --i) {
+static inline bool isVolumeState(const MementoState &state) {
+	return state.type == MementoType::Modification || state.type == MementoType::SceneNodeAdded;
+}
+
+bool MementoHandler::collectVolumeStates(const core::String &nodeUUID, int groupIdx, int stateIdx,
+										 core::DynamicArray<const MementoState *> &states) const {
+	states.clear();
+	for (int i = groupIdx; i >= 0; --i) {
 		const MementoStateGroup &group = _groups[i];
-		for (const MementoState &prevS : group.states) {
-			if (prevS.nodeUUID != s.nodeUUID) {
+		const int start = (i == groupIdx && stateIdx >= 0) ? stateIdx : (int)group.states.size() - 1;
+		for (int j = start; j >= 0; --j) {
+			const MementoState &state = group.states[j];
+			if (state.nodeUUID != nodeUUID || !isVolumeState(state)) {
 				continue;
 			}
-			if (prevS.type == MementoType::Modification || prevS.type == MementoType::SceneNodeAdded) {
-				core_assert(prevS.hasVolumeData() || !prevS.referenceUUID.empty());
-				s.data = prevS.data;
-				// undo for un-reference node - so we have to make it a reference node again
-				if (s.nodeType != prevS.nodeType) {
-					core_assert(prevS.nodeType == scenegraph::SceneGraphNodeType::ModelReference);
-					s.nodeType = prevS.nodeType;
-					s.referenceUUID = prevS.referenceUUID;
-				}
-				return;
+			states.push_back(&state);
+			if (state.data.isDelta()) {
+				continue;
 			}
+			// bring them into the order they were recorded in
+			for (size_t a = 0, b = states.size() - 1; a < b; ++a, --b) {
+				core::exchange(states[a], states[b]);
+			}
+			return true;
 		}
 	}
+	return false;
+}
 
-	Log::warn("No previous modification state found for node %s", s.nodeUUID.c_str());
+MementoData MementoHandler::compress(const voxel::RawVolume *volume, const voxel::Region &region) {
+	return MementoData::fromVolume(volume, region, _compression, _asyncCompression ? &_compressionPool : nullptr,
+								   &_compressionDone);
+}
+
+MementoData MementoHandler::reconstruct(const core::DynamicArray<const MementoState *> &states,
+										const voxel::Region &region) {
+	core_assert(!states.empty());
+	const MementoData &base = states[0]->data;
+	if (states.size() == 1u && (!region.isValid() || region == base.region())) {
+		return base;
+	}
+	core_trace_scoped(MementoReconstruct);
+	voxel::RawVolume volume(base.region());
+	MementoData::toVolume(&volume, base);
+	for (size_t i = 1; i < states.size(); ++i) {
+		core_assert(states[i]->data.region() == base.region());
+		MementoData::toVolume(&volume, states[i]->data);
+	}
+	return compress(&volume, region);
+}
+
+void MementoHandler::undoModification(MementoState &s) {
+	core_assert(s.hasVolumeData());
+	core::DynamicArray<const MementoState *> states;
+	if (!collectVolumeStates(s.nodeUUID, _groupStatePosition, -1, states)) {
+		Log::warn("No previous modification state found for node %s", s.nodeUUID.c_str());
+		return;
+	}
+	const MementoState &prevS = *states.back();
+	core_assert(prevS.hasVolumeData() || !prevS.referenceUUID.empty());
+	// a delta only has to restore the voxels of the region it modified
+	s.data = reconstruct(states, s.data.isDelta() ? s.modifiedRegion() : voxel::Region::InvalidRegion);
+	// undo for un-reference node - so we have to make it a reference node again
+	if (s.nodeType != prevS.nodeType) {
+		core_assert(prevS.nodeType == scenegraph::SceneGraphNodeType::ModelReference);
+		s.nodeType = prevS.nodeType;
+		s.referenceUUID = prevS.referenceUUID;
+	}
 }
 
 void MementoHandler::undoPaletteChange(MementoState &s) {
@@ -727,16 +970,172 @@ bool MementoHandler::markUndo(const core::String &parentId, const core::String &
 		!recordVolumeStates(volume)) {
 		volume = nullptr;
 	}
-	const MementoData &data = MementoData::fromVolume(volume, modifiedRegion);
+	voxel::Region mementoRegion = voxel::Region::InvalidRegion;
+	if (type == MementoType::Modification) {
+		mementoRegion = deltaRegion(nodeId, volume, modifiedRegion);
+	}
+	const MementoData &data = compress(volume, mementoRegion);
 	MementoState state(type, data, parentId, nodeId, referenceId, name, nodeType, pivot, allKeyFrames, palette,
 					   normalPalette, properties);
 	addState(core::move(state));
 	return true;
 }
 
+voxel::Region MementoHandler::deltaRegion(const core::String &nodeUUID, const voxel::RawVolume *volume,
+										  const voxel::Region &modifiedRegion) const {
+	if (volume == nullptr || !modifiedRegion.isValid() || _groups.empty()) {
+		return voxel::Region::InvalidRegion;
+	}
+	core::DynamicArray<const MementoState *> states;
+	if (!collectVolumeStates(nodeUUID, (int)_groups.size() - 1, -1, states)) {
+		return voxel::Region::InvalidRegion;
+	}
+	// the first entry is the whole volume - all others are deltas
+	if ((int)states.size() > MaxDeltaStates) {
+		return voxel::Region::InvalidRegion;
+	}
+	const MementoData &prevData = states.back()->data;
+	if (!prevData.hasVolume() || prevData.region() != volume->region()) {
+		return voxel::Region::InvalidRegion;
+	}
+	return modifiedRegion;
+}
+
+void MementoHandler::removeOldestGroup() {
+	core_assert(!_groups.empty());
+	core::DynamicArray<const MementoState *> states;
+	for (const MementoState &state : _groups[0].states) {
+		if (!isVolumeState(state)) {
+			continue;
+		}
+		for (int i = 1; i < (int)_groups.size(); ++i) {
+			MementoStateGroup &group = _groups[i];
+			int stateIdx = -1;
+			for (int j = 0; j < (int)group.states.size(); ++j) {
+				if (group.states[j].nodeUUID == state.nodeUUID && isVolumeState(group.states[j])) {
+					stateIdx = j;
+					break;
+				}
+			}
+			if (stateIdx == -1) {
+				continue;
+			}
+			MementoState &next = group.states[stateIdx];
+			if (next.data.isDelta() && collectVolumeStates(next.nodeUUID, i, stateIdx, states)) {
+				Log::debug("Convert the delta of node %s into a full volume state", next.nodeUUID.c_str());
+				next.data = reconstruct(states, voxel::Region::InvalidRegion);
+			}
+			break;
+		}
+	}
+	// the ring buffer doesn't destroy the removed elements - free the memory of the states
+	_groups[0].states.clear();
+	_groups.pop();
+}
+
+void MementoHandler::prepareAddGroup() {
+	if (_groups.size() >= _groups.capacity()) {
+		removeOldestGroup();
+	}
+}
+
+void MementoHandler::enforceMemoryBudget() {
+	if (_maxMemory == 0u) {
+		return;
+	}
+	// pending compressions are not accounted - the budget is checked again once they are done
+	size_t usage = memoryUsage();
+	if (_evictionUsage > 0u) {
+		if (pendingMemoryUsage() > 0u) {
+			// the states of the last removal are not yet compressed
+			return;
+		}
+		const size_t evictionUsage = _evictionUsage;
+		_evictionUsage = 0u;
+		if (usage >= evictionUsage) {
+			Log::debug("Removing memento groups doesn't free any memory");
+			return;
+		}
+	}
+	// the current state and the group that is currently recorded are never removed
+	while (usage > _maxMemory && _groupStatePosition > 0 && _groups.size() > 1) {
+		Log::debug("Remove the oldest memento group to stay in the memory budget (%i bytes)", (int)usage);
+		const size_t pending = pendingMemoryUsage();
+		removeOldestGroup();
+		--_groupStatePosition;
+		if (pendingMemoryUsage() > pending) {
+			// deltas were converted into whole volume states - continue once their compressed size is known
+			_evictionUsage = usage;
+			return;
+		}
+		const size_t newUsage = memoryUsage();
+		if (newUsage >= usage) {
+			// removing more groups would only promote more deltas - keep the remaining history
+			Log::debug("Removing memento groups doesn't free any memory");
+			break;
+		}
+		usage = newUsage;
+	}
+}
+
+size_t MementoHandler::memoryUsage() const {
+	size_t usage = 0u;
+	for (const MementoStateGroup &group : _groups) {
+		for (const MementoState &state : group.states) {
+			usage += state.data.memoryUsage();
+		}
+	}
+	return usage;
+}
+
+size_t MementoHandler::pendingMemoryUsage() const {
+	size_t usage = 0u;
+	for (const MementoStateGroup &group : _groups) {
+		for (const MementoState &state : group.states) {
+			usage += state.data.pendingMemoryUsage();
+		}
+	}
+	return usage;
+}
+
+void MementoHandler::update() {
+	if (_compressionDone.exchange(false)) {
+		enforceMemoryBudget();
+	}
+}
+
+void MementoHandler::waitForCompression() const {
+	for (const MementoStateGroup &group : _groups) {
+		for (const MementoState &state : group.states) {
+			state.data.sync();
+		}
+	}
+}
+
+void MementoHandler::setMaxMemory(size_t bytes) {
+	_maxMemory = bytes;
+	enforceMemoryBudget();
+}
+
+size_t MementoHandler::maxMemory() const {
+	return _maxMemory;
+}
+
+void MementoHandler::setCompression(MementoCompression compression) {
+	core_assert(compression != MementoCompression::Max);
+	_compression = compression;
+}
+
+MementoCompression MementoHandler::compression() const {
+	return _compression;
+}
+
 void MementoHandler::cutFromGroupStatePosition() {
 	const int cutOff = core_max(0, (int)(stateSize() - _groupStatePosition - 1));
 	Log::debug("Cut off %i states", cutOff);
+	for (int i = 0; i < cutOff; ++i) {
+		_groups[stateSize() - 1 - i].states.clear();
+	}
 	_groups.erase_back(cutOff);
 }
 
@@ -750,6 +1149,8 @@ void MementoHandler::addState(MementoState &&state) {
 	group.name = "single";
 	group.states.emplace_back(state);
 	cutFromGroupStatePosition();
+	enforceMemoryBudget();
+	prepareAddGroup();
 	_groups.emplace_back(core::move(group));
 	_groupStatePosition = stateSize() - 1;
 }
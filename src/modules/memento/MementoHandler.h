@@ -6,8 +6,11 @@
 
 #include "core/IComponent.h"
 #include "core/Optional.h"
+#include "core/SharedPtr.h"
 #include "core/String.h"
 #include "core/collection/RingBuffer.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/ThreadPool.h"
 #include "palette/NormalPalette.h"
 #include "palette/Palette.h"
 #include "scenegraph/SceneGraph.h"
@@ -42,10 +45,74 @@ enum class MementoType {
 	Max
 };
 
+/**
+ * @brief The codec that is used to compress the voxels of the memento states
+ */
+enum class MementoCompression {
+	/**
+	 * better compression ratio
+	 */
+	Zip,
+	/**
+	 * faster compression and decompression
+	 */
+	LZFSE,
+
+	Max
+};
+
+/**
+ * @brief Compresses a copy of the voxels of a memento state - this might run on a worker thread
+ *
+ * Either the worker or the thread that needs the compressed data first claims the job - so nobody has to wait for
+ * a job that is still queued.
+ */
+struct MementoCompressionJob {
+	/**
+	 * @brief The uncompressed voxels - released once the compression is done
+	 */
+	uint8_t *voxels = nullptr;
+	size_t voxelsSize = 0;
+	voxel::Region region;
+	MementoCompression compression = MementoCompression::Zip;
+	/**
+	 * @brief The compressed voxels - ownership is transferred to the @c MementoData
+	 */
+	uint8_t *buffer = nullptr;
+	size_t compressedSize = 0;
+	/**
+	 * @brief @c true if the palette indices instead of the voxels were compressed
+	 */
+	bool paletteIndices = false;
+	core::AtomicBool claimed{false};
+	core::AtomicBool done{false};
+
+	MementoCompressionJob(uint8_t *_voxels, size_t _voxelsSize, const voxel::Region &_region,
+						  MementoCompression _compression);
+	~MementoCompressionJob();
+
+	/**
+	 * @brief Performs the compression if nobody else claimed the job already
+	 */
+	void execute();
+	/**
+	 * @brief Blocks until the compression is done - executes the job if it was not yet claimed
+	 */
+	void wait();
+};
+
 /**
  * @brief Holds the data of a memento state
  *
- * The given buffer is owned by this class and represents a compressed volume
+ * The given buffer is owned by this class and represents a compressed volume. The buffer either contains the whole
+ * volume or - for a delta - only the voxels of the modified region. A delta can only be applied on top of the volume
+ * state it was recorded for.
+ *
+ * If the voxels can be expressed by their palette index alone (see @c voxel::PaletteVolume::isCompact()), only the
+ * palette indices and the voxel for each index are compressed - this is a quarter of the data.
+ *
+ * If the compression is performed asynchronously, the compressed buffer is taken from the compression job the first
+ * time it's needed.
  */
 class MementoData {
 	friend struct MementoState;
@@ -55,18 +122,39 @@ private:
 	/**
 	 * @brief How big is the buffer with the compressed volume data
 	 */
-	size_t _compressedSize = 0;
+	mutable size_t _compressedSize = 0;
 	/**
 	 * @brief The compressed volume data
 	 */
-	uint8_t *_buffer = nullptr;
+	mutable uint8_t *_buffer = nullptr;
+	/**
+	 * @brief The pending compression of the volume data
+	 */
+	mutable core::SharedPtr<MementoCompressionJob> _job;
+	MementoCompression _compression = MementoCompression::Zip;
+	/**
+	 * @brief The buffer contains the data of a compact @c voxel::PaletteVolume instead of the voxels
+	 */
+	mutable bool _paletteIndices = false;
 	/**
 	 * The region the given volume data is for
 	 */
 	voxel::Region _region{};
+	/**
+	 * The region of the voxels in the buffer - this is the same as @c _region if the whole volume is stored
+	 */
+	voxel::Region _modifiedRegion{};
 
 	MementoData(const uint8_t *buf, size_t bufSize, const voxel::Region &region);
-	MementoData(uint8_t *buf, size_t bufSize, const voxel::Region &region);
+	MementoData(uint8_t *buf, size_t bufSize, const voxel::Region &region, const voxel::Region &modifiedRegion,
+				MementoCompression compression, bool paletteIndices);
+	MementoData(const core::SharedPtr<MementoCompressionJob> &job, const voxel::Region &region,
+				const voxel::Region &modifiedRegion);
+
+	/**
+	 * @brief Takes the compressed buffer from a pending compression job - blocks until the compression is done
+	 */
+	void sync() const;
 
 public:
 	MementoData() {
@@ -75,19 +163,66 @@ public:
 	MementoData(const MementoData &o);
 	~MementoData();
 
+	/**
+	 * @brief The size of the compressed volume data
+	 * @note This blocks until a pending compression is done
+	 */
 	inline size_t size() const {
+		sync();
 		return _compressedSize;
 	}
 
+	/**
+	 * @brief The amount of bytes of the compressed volume data - @c 0 as long as the compression is pending. This
+	 * doesn't block.
+	 * @sa pendingMemoryUsage()
+	 */
+	size_t memoryUsage() const;
+	/**
+	 * @brief The amount of bytes of the uncompressed voxels that are waiting for the compression. This doesn't block.
+	 */
+	size_t pendingMemoryUsage() const;
+
+	inline MementoCompression compression() const {
+		return _compression;
+	}
+
+	/**
+	 * @return @c true if the palette indices of a compact @c voxel::PaletteVolume were compressed instead of the voxels
+	 * @note This blocks until a pending compression is done
+	 */
+	inline bool paletteIndices() const {
+		sync();
+		return _paletteIndices;
+	}
+
 	MementoData &operator=(MementoData &&o) noexcept;
 	MementoData &operator=(const MementoData &o) noexcept;
 
+	/**
+	 * @brief The region of the whole volume
+	 */
 	inline const voxel::Region &region() const {
 		return _region;
 	}
 
+	/**
+	 * @brief The region of the voxels that are stored in this memento data
+	 * @sa isDelta()
+	 */
+	inline const voxel::Region &modifiedRegion() const {
+		return _modifiedRegion;
+	}
+
 	inline bool hasVolume() const {
-		return _buffer != nullptr;
+		return _buffer != nullptr || _job;
+	}
+
+	/**
+	 * @return @c true if only a part of the volume is stored
+	 */
+	inline bool isDelta() const {
+		return hasVolume() && _modifiedRegion != _region;
 	}
 
 	/**
@@ -99,9 +234,16 @@ public:
 	 * @brief Converts the given volume into a @c MementoData structure (and perform the compression)
 	 * @param[in] volume The volume to create the memento state for. This might be @c null.
 	 * @param[in] region The region of the volume to create the memento data for - if this is not a valid region,
-	 * the whole volume is going to added to the memento data.
+	 * the whole volume is going to added to the memento data. Otherwise only the voxels of this region are stored
+	 * and the memento data is a delta.
+	 * @param[in] compression The codec to compress the voxels with
+	 * @param[in] pool If this is not @c null, the voxels are copied and compressed on this pool - otherwise the
+	 * compression is performed on the calling thread.
+	 * @param[in] completed If this is not @c null, it's set to @c true after the compression was done on the pool
 	 */
-	static MementoData fromVolume(const voxel::RawVolume *volume, const voxel::Region &region);
+	static MementoData fromVolume(const voxel::RawVolume *volume, const voxel::Region &region,
+								  MementoCompression compression = MementoCompression::Zip,
+								  core::ThreadPool *pool = nullptr, core::AtomicBool *completed = nullptr);
 };
 
 struct MementoState {
@@ -148,12 +290,19 @@ struct MementoState {
 	 * Some types (@c MementoType) don't have a volume attached.
 	 */
 	inline bool hasVolumeData() const {
-		return data._buffer != nullptr;
+		return data.hasVolume();
 	}
 
 	inline const voxel::Region &dataRegion() const {
 		return data._region;
 	}
+
+	/**
+	 * @brief The region that the volume data of this state changes
+	 */
+	inline const voxel::Region &modifiedRegion() const {
+		return data._modifiedRegion;
+	}
 };
 
 struct MementoStateGroup {
@@ -168,15 +317,81 @@ using MementoStates = core::RingBuffer<MementoStateGroup, 64u>;
  * @note For the volumes only the dirty regions are stored in a compressed form.
  */
 class MementoHandler : public core::IComponent {
+public:
+	/**
+	 * @brief The max amount of deltas that are recorded for a volume before the whole volume is stored again. The
+	 * deltas are replayed on top of the last full volume state to reconstruct the previous state on undo.
+	 */
+	static constexpr int MaxDeltaStates = 16;
+
 private:
 	MementoStates _groups;
 	int _groupState = 0;
 	uint8_t _groupStatePosition = 0u;
 	int _locked = 0;
 	voxel::Region _maxUndoRegion = voxel::Region::InvalidRegion;
+	MementoCompression _compression = MementoCompression::Zip;
+	/**
+	 * @brief The max amount of bytes for all states - @c 0 means no limit
+	 */
+	size_t _maxMemory = 0u;
+	/**
+	 * @brief The worker that compresses the volume states
+	 */
+	core::ThreadPool _compressionPool{1, "memento"};
+	bool _asyncCompression = false;
+	/**
+	 * @brief Set by the compression worker - the memory budget is enforced again in @c update()
+	 */
+	core::AtomicBool _compressionDone{false};
+	/**
+	 * @brief The memory usage before the last removed group if that converted deltas into whole volume states that
+	 * are still compressed in the background - @c 0 otherwise
+	 */
+	size_t _evictionUsage = 0u;
 
 	void cutFromGroupStatePosition();
 	void addState(MementoState &&state);
+	/**
+	 * @brief Collects the volume states of the given node backwards from the given group and state index until a
+	 * state with the whole volume is found.
+	 * @param[in] stateIdx The index of the state in the group to start at - @c -1 for the last state of the group
+	 * @param[out] states The state with the whole volume followed by the deltas in the order they were recorded
+	 * @return @c false if there is no state with the whole volume
+	 */
+	bool collectVolumeStates(const core::String &nodeUUID, int groupIdx, int stateIdx,
+							 core::DynamicArray<const MementoState *> &states) const;
+	/**
+	 * @brief Replays the deltas on top of the first state
+	 * @param region The region to create the memento data for - an invalid region returns the whole volume
+	 */
+	MementoData reconstruct(const core::DynamicArray<const MementoState *> &states, const voxel::Region &region);
+	MementoData compress(const voxel::RawVolume *volume, const voxel::Region &region);
+	/**
+	 * @brief Removes the oldest group. The deltas of the following groups might need the whole volume states of this
+	 * group - so the next state of these volumes is converted into a whole volume state.
+	 */
+	void removeOldestGroup();
+	/**
+	 * @brief Makes room for a new group in the ring buffer
+	 */
+	void prepareAddGroup();
+	/**
+	 * @brief Removes the oldest groups until the compressed states fit into the memory budget again
+	 *
+	 * This doesn't wait for pending compressions - states are only removed because of their compressed size. If the
+	 * removal of a group converts deltas into whole volume states, the removal is continued in @c update() once they
+	 * are compressed.
+	 * @sa setMaxMemory()
+	 */
+	void enforceMemoryBudget();
+	/**
+	 * @return The region for the memento data of a modification. This is the modified region if the previous state
+	 * of the volume is known and the amount of deltas doesn't exceed @c MaxDeltaStates - otherwise an invalid region
+	 * to store the whole volume.
+	 */
+	voxel::Region deltaRegion(const core::String &nodeUUID, const voxel::RawVolume *volume,
+							  const voxel::Region &modifiedRegion) const;
 	/**
 	 * @return @c true if it's allowed to create an undo state
 	 */
@@ -232,6 +447,35 @@ public:
 	 */
 	bool recordVolumeStates(const voxel::RawVolume *volume) const;
 
+	/**
+	 * @brief The max amount of bytes all memento states may use - the oldest states are removed if this is exceeded.
+	 * @c 0 disables the limit.
+	 * @note Only the compressed states are taken into account - states that are still compressed are checked in
+	 * @c update(). The removal stops if it doesn't free memory anymore because the deltas of the next states are
+	 * converted into whole volume states.
+	 */
+	void setMaxMemory(size_t bytes);
+	size_t maxMemory() const;
+	/**
+	 * @return The amount of bytes that are used by the compressed volume data of all memento states
+	 */
+	size_t memoryUsage() const;
+	/**
+	 * @return The amount of bytes of the uncompressed voxels that are waiting for their compression
+	 */
+	size_t pendingMemoryUsage() const;
+	/**
+	 * @brief Enforces the memory budget for the states that were compressed in the background since the last call
+	 */
+	void update();
+
+	void setCompression(MementoCompression compression);
+	MementoCompression compression() const;
+	/**
+	 * @brief Blocks until all pending compressions are done
+	 */
+	void waitForCompression() const;
+
 	/**
 	 * @brief Locks the handler for accepting new states or perform undo() or redo() steps
 	 * @sa @c unlock()
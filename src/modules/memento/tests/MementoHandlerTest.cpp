@@ -10,6 +10,9 @@
 #include "scenegraph/SceneGraphNode.h"
 #include "scenegraph/SceneGraphTransform.h"
 #include "voxel/RawVolume.h"
+#include "voxel/Voxel.h"
+#include <chrono>
+#include <thread>
 
 namespace memento {
 
@@ -70,6 +73,19 @@ protected:
 		core_assert(!group.states.empty());
 		return group.states[0];
 	}
+
+	static void expectSameVoxels(const voxel::RawVolume &expected, const voxel::RawVolume &volume, int step) {
+		ASSERT_EQ(expected.region(), volume.region());
+		const voxel::Region &region = expected.region();
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					ASSERT_EQ(expected.voxel(x, y, z), volume.voxel(x, y, z))
+						<< "voxel " << x << ":" << y << ":" << z << " differs at step " << step;
+				}
+			}
+		}
+	}
 };
 
 TEST_F(MementoHandlerTest, testMarkUndo) {
@@ -777,4 +793,232 @@ TEST_F(MementoHandlerTest, testAllAnimations) {
 	_sceneGraph.setAnimations(*stateRedo.stringList.value());
 }
 
+TEST_F(MementoHandlerTest, testDeltaModification) {
+	voxel::RawVolume volume(voxel::Region(0, 7));
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+										 MementoType::Modification));
+	const size_t fullSize = _mementoHandler.stateGroup().states[0].data.size();
+	EXPECT_FALSE(_mementoHandler.stateGroup().states[0].data.isDelta());
+
+	const voxel::Region modifiedRegion(1, 1);
+	volume.setVoxel(1, 1, 1, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+										 MementoType::Modification, modifiedRegion));
+	{
+		const MementoState &state = _mementoHandler.stateGroup().states[0];
+		EXPECT_TRUE(state.data.isDelta());
+		EXPECT_EQ(modifiedRegion, state.modifiedRegion());
+		EXPECT_EQ(volume.region(), state.dataRegion());
+		EXPECT_LT(state.data.size(), fullSize);
+	}
+
+	{
+		const MementoState &state = firstState(_mementoHandler.undo());
+		EXPECT_TRUE(state.data.isDelta());
+		EXPECT_EQ(modifiedRegion, state.modifiedRegion());
+		ASSERT_TRUE(MementoData::toVolume(&volume, state.data));
+		EXPECT_TRUE(voxel::isAir(volume.voxel(1, 1, 1).getMaterial()));
+	}
+	{
+		const MementoState &state = firstState(_mementoHandler.redo());
+		ASSERT_TRUE(MementoData::toVolume(&volume, state.data));
+		EXPECT_EQ(1, volume.voxel(1, 1, 1).getColor());
+	}
+}
+
+TEST_F(MementoHandlerTest, testDeltaFullVolumeState) {
+	voxel::RawVolume volume(voxel::Region(0, 7));
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+										 MementoType::Modification));
+	for (int i = 0; i < MementoHandler::MaxDeltaStates; ++i) {
+		ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+											 MementoType::Modification, voxel::Region(0, 0)));
+		EXPECT_TRUE(_mementoHandler.stateGroup().states[0].data.isDelta());
+	}
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+										 MementoType::Modification, voxel::Region(0, 0)));
+	EXPECT_FALSE(_mementoHandler.stateGroup().states[0].data.isDelta())
+		<< "After " << MementoHandler::MaxDeltaStates << " deltas the whole volume should be stored again";
+
+	// a changed volume size needs the whole volume
+	voxel::RawVolume resized(voxel::Region(0, 8));
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &resized,
+										 MementoType::Modification, voxel::Region(0, 0)));
+	EXPECT_FALSE(_mementoHandler.stateGroup().states[0].data.isDelta());
+}
+
+TEST_F(MementoHandlerTest, testDeltaUndoRedoReplay) {
+	voxel::RawVolume volume(voxel::Region(0, 7));
+	// more states than the memento handler can hold to also test the removal of the oldest states
+	const int steps = (int)MementoStates().capacity() + 2 * MementoHandler::MaxDeltaStates;
+	core::DynamicArray<voxel::RawVolume> expected;
+	expected.reserve(steps + 1);
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+										 MementoType::Modification));
+	expected.emplace_back(volume);
+	for (int i = 0; i < steps; ++i) {
+		const glm::ivec3 pos(i % 8, (i / 8) % 8, (i * 3) % 8);
+		const voxel::Region modifiedRegion(pos, glm::min(pos + 1, glm::ivec3(7)));
+		for (int z = modifiedRegion.getLowerZ(); z <= modifiedRegion.getUpperZ(); ++z) {
+			for (int y = modifiedRegion.getLowerY(); y <= modifiedRegion.getUpperY(); ++y) {
+				for (int x = modifiedRegion.getLowerX(); x <= modifiedRegion.getUpperX(); ++x) {
+					volume.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (i % 254) + 1));
+				}
+			}
+		}
+		ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+											 MementoType::Modification, modifiedRegion));
+		expected.emplace_back(volume);
+	}
+	const int states = (int)_mementoHandler.stateSize();
+	ASSERT_EQ((int)MementoStates().capacity(), states);
+	const int first = (int)expected.size() - states;
+
+	for (int i = states - 2; i >= 0; --i) {
+		const MementoState &state = firstState(_mementoHandler.undo());
+		ASSERT_TRUE(MementoData::toVolume(&volume, state.data));
+		expectSameVoxels(expected[first + i], volume, i);
+	}
+	EXPECT_FALSE(_mementoHandler.canUndo());
+	for (int i = 1; i < states; ++i) {
+		const MementoState &state = firstState(_mementoHandler.redo());
+		ASSERT_TRUE(MementoData::toVolume(&volume, state.data));
+		expectSameVoxels(expected[first + i], volume, i);
+	}
+	EXPECT_FALSE(_mementoHandler.canRedo());
+}
+
+TEST_F(MementoHandlerTest, testCompressionLZFSE) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	volume.setVoxel(3, 4, 5, voxel::createVoxel(voxel::VoxelType::Generic, 42));
+	const MementoData &data = MementoData::fromVolume(&volume, voxel::Region::InvalidRegion, MementoCompression::LZFSE);
+	EXPECT_EQ(MementoCompression::LZFSE, data.compression());
+	EXPECT_LT(data.size(), (size_t)volume.region().voxels() * sizeof(voxel::Voxel));
+	voxel::RawVolume restored(volume.region());
+	ASSERT_TRUE(MementoData::toVolume(&restored, data));
+	expectSameVoxels(volume, restored, 0);
+}
+
+TEST_F(MementoHandlerTest, testCompressPaletteIndices) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	volume.setVoxel(3, 4, 5, voxel::createVoxel(voxel::VoxelType::Generic, 42, 3));
+	volume.setVoxel(6, 4, 5, voxel::createVoxel(voxel::VoxelType::Transparent, 255, 4, 1));
+	volume.setVoxel(7, 4, 5, voxel::createVoxel(voxel::VoxelType::Generic, 42, 3));
+	const MementoData &data = MementoData::fromVolume(&volume, voxel::Region::InvalidRegion);
+	EXPECT_TRUE(data.paletteIndices());
+	voxel::RawVolume restored(volume.region());
+	ASSERT_TRUE(MementoData::toVolume(&restored, data));
+	expectSameVoxels(volume, restored, 0);
+	EXPECT_TRUE(restored.voxel(7, 4, 5).isSame(volume.voxel(7, 4, 5)));
+	EXPECT_TRUE(restored.voxel(6, 4, 5).isSame(volume.voxel(6, 4, 5)));
+	EXPECT_EQ(1, restored.voxel(6, 4, 5).getFlags());
+}
+
+TEST_F(MementoHandlerTest, testCompressVoxelsIfNotCompact) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	volume.setVoxel(3, 4, 5, voxel::createVoxel(voxel::VoxelType::Generic, 42, 3));
+	// same palette index with a different normal
+	volume.setVoxel(4, 4, 5, voxel::createVoxel(voxel::VoxelType::Generic, 42, 4));
+	const MementoData &data = MementoData::fromVolume(&volume, voxel::Region::InvalidRegion);
+	EXPECT_FALSE(data.paletteIndices());
+	voxel::RawVolume restored(volume.region());
+	ASSERT_TRUE(MementoData::toVolume(&restored, data));
+	expectSameVoxels(volume, restored, 0);
+	EXPECT_EQ(4, restored.voxel(4, 4, 5).getNormal());
+}
+
+TEST_F(MementoHandlerTest, testAsyncCompressionCopiesVoxels) {
+	core::ThreadPool pool(1, "test");
+	pool.init();
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	volume.setVoxel(1, 2, 3, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	const voxel::RawVolume expected(volume);
+	const MementoData data = MementoData::fromVolume(&volume, voxel::Region::InvalidRegion, MementoCompression::Zip, &pool);
+	EXPECT_TRUE(data.hasVolume());
+	EXPECT_FALSE(data.isDelta());
+	// the compression works on a copy of the voxels
+	volume.setVoxel(1, 2, 3, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	const MementoData copy(data);
+	voxel::RawVolume restored(volume.region());
+	ASSERT_TRUE(MementoData::toVolume(&restored, copy));
+	expectSameVoxels(expected, restored, 0);
+	ASSERT_TRUE(MementoData::toVolume(&restored, data));
+	expectSameVoxels(expected, restored, 1);
+	pool.shutdown(true);
+}
+
+TEST_F(MementoHandlerTest, testMemoryBudget) {
+	_mementoHandler.setCompression(MementoCompression::LZFSE);
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	for (int i = 0; i < 10; ++i) {
+		volume.setVoxel(i, i, i, voxel::createVoxel(voxel::VoxelType::Generic, i + 1));
+		ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model,
+											 &volume, MementoType::Modification));
+	}
+	ASSERT_EQ(10u, _mementoHandler.stateSize());
+	_mementoHandler.waitForCompression();
+	size_t budget = 0u;
+	for (size_t i = _mementoHandler.stateSize() - 4; i < _mementoHandler.stateSize(); ++i) {
+		budget += _mementoHandler.states()[i].states[0].data.size();
+	}
+	ASSERT_GT(budget, 0u);
+
+	_mementoHandler.setMaxMemory(budget);
+	EXPECT_LE(_mementoHandler.memoryUsage(), _mementoHandler.maxMemory());
+	EXPECT_EQ(4u, _mementoHandler.stateSize());
+	EXPECT_EQ(3, _mementoHandler.statePosition());
+
+	// the oldest states are removed - the remaining ones can still get undone
+	for (int i = 9; i > 6; --i) {
+		const MementoState &state = firstState(_mementoHandler.undo());
+		ASSERT_TRUE(state.hasVolumeData());
+		voxel::RawVolume restored(volume.region());
+		ASSERT_TRUE(MementoData::toVolume(&restored, state.data));
+		EXPECT_TRUE(voxel::isAir(restored.voxel(i, i, i).getMaterial()));
+		EXPECT_EQ(i, restored.voxel(i - 1, i - 1, i - 1).getColor());
+	}
+	EXPECT_FALSE(_mementoHandler.canUndo());
+}
+
+TEST_F(MementoHandlerTest, testMemoryBudgetPendingCompression) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	for (int i = 0; i < 10; ++i) {
+		volume.setVoxel(i, i, i, voxel::createVoxel(voxel::VoxelType::Generic, i + 1));
+		ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model,
+											 &volume, MementoType::Modification));
+	}
+	// less than the uncompressed voxels of the first state - but enough for all compressed states
+	const size_t budget = (size_t)volume.region().voxels() * sizeof(voxel::Voxel) / 2u;
+	_mementoHandler.setMaxMemory(budget);
+	EXPECT_LE(_mementoHandler.memoryUsage(), _mementoHandler.maxMemory());
+	EXPECT_EQ(10u, _mementoHandler.stateSize());
+	EXPECT_EQ(9, _mementoHandler.statePosition());
+}
+
+TEST_F(MementoHandlerTest, testMemoryBudgetAfterCompression) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	for (int i = 0; i < 10; ++i) {
+		volume.setVoxel(i, i, i, voxel::createVoxel(voxel::VoxelType::Generic, i + 1));
+		ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model,
+											 &volume, MementoType::Modification));
+	}
+	_mementoHandler.waitForCompression();
+	const size_t budget = _mementoHandler.states()[9].states[0].data.size();
+	_mementoHandler.clearStates();
+
+	_mementoHandler.setMaxMemory(budget);
+	for (int i = 0; i < 10; ++i) {
+		volume.setVoxel(i, i, i, voxel::createVoxel(voxel::VoxelType::Generic, i + 2));
+		ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model,
+											 &volume, MementoType::Modification));
+	}
+	// the states are compressed in the background - they are checked against the budget once this is done
+	for (int i = 0; i < 1000 && _mementoHandler.stateSize() >= 10u; ++i) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		_mementoHandler.update();
+	}
+	EXPECT_LT(_mementoHandler.stateSize(), 10u);
+	EXPECT_TRUE(_mementoHandler.canUndo());
+}
+
 } // namespace memento
@@ -0,0 +1,116 @@
+/**
+ * @file
+ */
+
+#include "ClosestColorGrid.h"
+#include "core/Color.h"
+#include "core/StandardLib.h"
+#include "core/Trace.h"
+#include "palette/Palette.h"
+#include <float.h>
+#include <glm/common.hpp>
+
+namespace palette {
+
+/**
+ * @brief The distance of the value to the closest and to the farthest value of the given range
+ */
+static inline void channelDistance(int value, int lower, int upper, int &minDist, int &maxDist) {
+	if (value < lower) {
+		minDist = lower - value;
+	} else if (value > upper) {
+		minDist = value - upper;
+	} else {
+		minDist = 0;
+	}
+	maxDist = glm::max(glm::abs(value - lower), glm::abs(value - upper));
+}
+
+ClosestColorGrid::ClosestColorGrid(const core::RGBA *colors, int colorCount, uint64_t hash)
+	: _colorCount(colorCount), _hash(hash) {
+	core_trace_scoped(BuildClosestColorGrid);
+	core_memcpy(_colors, colors, colorCount * sizeof(core::RGBA));
+	for (int i = 0; i < _colorCount; ++i) {
+		if (_colors[i].a == 0) {
+			_transparent.push_back(i);
+		}
+	}
+	_candidates.reserve(Cells * 8);
+
+	// see core::Color::getDistance() with core::Color::Distance::Approximation - the weight of the red and blue
+	// channels is between 512/256 and 767/256 - depending on the mean red value of both colors
+	const int cellSize = 256 / CellsPerAxis;
+	int64_t lowerBounds[256];
+	for (int r = 0; r < CellsPerAxis; ++r) {
+		for (int g = 0; g < CellsPerAxis; ++g) {
+			for (int b = 0; b < CellsPerAxis; ++b) {
+				const int cellIdx = (r << (2 * CellBits)) | (g << CellBits) | b;
+				_offsets[cellIdx] = (uint32_t)_candidates.size();
+				int64_t bestUpperBound = INT64_MAX;
+				for (int i = 0; i < _colorCount; ++i) {
+					const core::RGBA c = _colors[i];
+					if (c.a == 0) {
+						continue;
+					}
+					int minR, maxR, minG, maxG, minB, maxB;
+					channelDistance(c.r, r * cellSize, r * cellSize + cellSize - 1, minR, maxR);
+					channelDistance(c.g, g * cellSize, g * cellSize + cellSize - 1, minG, maxG);
+					channelDistance(c.b, b * cellSize, b * cellSize + cellSize - 1, minB, maxB);
+					// the -2 and +2 cover the rounding of the integer shifts
+					lowerBounds[i] = ((512 * minR * minR) >> 8) + 4 * minG * minG + ((512 * minB * minB) >> 8) - 2;
+					const int64_t upperBound =
+						((767 * maxR * maxR) >> 8) + 4 * maxG * maxG + ((767 * maxB * maxB) >> 8) + 2;
+					bestUpperBound = glm::min(bestUpperBound, upperBound);
+				}
+				for (int i = 0; i < _colorCount; ++i) {
+					if (_colors[i].a != 0 && lowerBounds[i] <= bestUpperBound) {
+						_candidates.push_back(i);
+					}
+				}
+			}
+		}
+	}
+	_offsets[Cells] = (uint32_t)_candidates.size();
+}
+
+bool ClosestColorGrid::matches(const core::RGBA *colors, int colorCount, uint64_t hash) const {
+	return _hash == hash && _colorCount == colorCount &&
+		   core_memcmp(_colors, colors, colorCount * sizeof(core::RGBA)) == 0;
+}
+
+int ClosestColorGrid::candidates(core::RGBA rgba) const {
+	const int cellIdx = cell(rgba);
+	return (int)(_offsets[cellIdx + 1] - _offsets[cellIdx]);
+}
+
+int ClosestColorGrid::closest(core::RGBA rgba) const {
+	if (rgba.a == 0) {
+		for (uint8_t i : _transparent) {
+			if (_colors[i] == rgba) {
+				return i;
+			}
+		}
+		return _transparent.empty() ? PaletteColorNotFound : _transparent[0];
+	}
+	// an exact match has the distance 0 and is always one of the candidates
+	const int cellIdx = cell(rgba);
+	const uint8_t *begin = _candidates.data() + _offsets[cellIdx];
+	const uint8_t *end = _candidates.data() + _offsets[cellIdx + 1];
+	for (const uint8_t *i = begin; i != end; ++i) {
+		if (_colors[*i] == rgba) {
+			return *i;
+		}
+	}
+	float minDistance = FLT_MAX;
+	int minIndex = PaletteColorNotFound;
+	for (const uint8_t *i = begin; i != end; ++i) {
+		const float val = core::Color::getDistance(_colors[*i], rgba, core::Color::Distance::Approximation);
+		if (val < minDistance) {
+			minDistance = val;
+			minIndex = *i;
+		}
+	}
+	return minIndex;
+}
+
+} // namespace palette
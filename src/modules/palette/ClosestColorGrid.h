@@ -0,0 +1,76 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/RGBA.h"
+#include "core/collection/DynamicArray.h"
+#include <stdint.h>
+
+namespace palette {
+
+/**
+ * @brief Acceleration structure for the nearest color search of @c Palette::getClosestMatch()
+ *
+ * The rgb color cube is split into a grid of cells. For every cell the palette colors are stored that can be the
+ * closest match for any color inside of that cell - all other palette colors are rejected by comparing the lower
+ * bound of their distance to the cell against the smallest upper bound of all colors. A query only has to evaluate
+ * the few remaining candidates of its cell instead of all palette colors.
+ *
+ * The candidates are kept in palette index order and the same distance function is used - so the results are
+ * identical to the linear search.
+ */
+class ClosestColorGrid {
+public:
+	static constexpr int CellBits = 4;
+	static constexpr int CellsPerAxis = 1 << CellBits;
+	static constexpr int Cells = CellsPerAxis * CellsPerAxis * CellsPerAxis;
+
+private:
+	core::RGBA _colors[256];
+	int _colorCount = 0;
+	uint64_t _hash = 0;
+	/**
+	 * @brief Start of the candidates of each cell in @c _candidates - the last entry is the end of the last cell
+	 */
+	uint32_t _offsets[Cells + 1];
+	core::DynamicArray<uint8_t> _candidates;
+	/**
+	 * @brief The indices of all colors with an alpha value of @c 0
+	 */
+	core::DynamicArray<uint8_t> _transparent;
+
+	static inline int cell(core::RGBA rgba) {
+		const int shift = 8 - CellBits;
+		return ((rgba.r >> shift) << (2 * CellBits)) | ((rgba.g >> shift) << CellBits) | (rgba.b >> shift);
+	}
+
+public:
+	/**
+	 * @param hash The hash of the palette the colors belong to
+	 */
+	ClosestColorGrid(const core::RGBA *colors, int colorCount, uint64_t hash);
+
+	/**
+	 * @return @c true if the grid was built for the given palette colors
+	 */
+	bool matches(const core::RGBA *colors, int colorCount, uint64_t hash) const;
+
+	/**
+	 * @return The index of the closest palette color or @c PaletteColorNotFound
+	 * @sa Palette::getClosestMatch()
+	 */
+	int closest(core::RGBA rgba) const;
+
+	inline uint64_t hash() const {
+		return _hash;
+	}
+
+	/**
+	 * @return The amount of candidates in the cell of the given color
+	 */
+	int candidates(core::RGBA rgba) const;
+};
+
+} // namespace palette
@@ -3,15 +3,18 @@
  */
 
 #include "Palette.h"
+#include "ClosestColorGrid.h"
 #include "app/App.h"
 #include "core/ArrayLength.h"
 #include "core/Color.h"
 #include "core/Common.h"
 #include "core/Log.h"
 #include "core/RGBA.h"
+#include "core/ScopedPtr.h"
 #include "core/StandardLib.h"
 #include "core/String.h"
 #include "core/StringUtil.h"
+#include "core/Trace.h"
 #include "core/Var.h"
 #include "core/collection/Buffer.h"
 #include "core/collection/Set.h"
@@ -358,10 +361,82 @@ core::String Palette::print(const Palette &palette, bool colorAsHex) {
 	return palStr;
 }
 
+/**
+ * @brief The amount of queries for the same palette until the nearest color search grid is built
+ */
+static constexpr int ClosestColorGridQueries = 64;
+
+/**
+ * @brief The nearest color search grid of the palette that was queried last on this thread
+ *
+ * Every thread builds its own grid - this way the lookup doesn't need any locking. The grid is invalidated by the
+ * palette hash and by comparing the palette colors.
+ */
+struct ClosestColorGridCache {
+	core::ScopedPtr<ClosestColorGrid> grid;
+	uint64_t hash = 0;
+	int queries = 0;
+	int threshold = ClosestColorGridQueries;
+};
+static thread_local ClosestColorGridCache tlsClosestColorGrid;
+
+static const ClosestColorGrid *closestColorGrid(const core::RGBA *colors, int colorCount, uint64_t hash,
+												int queries) {
+	ClosestColorGridCache &cache = tlsClosestColorGrid;
+	if (cache.grid && cache.grid->matches(colors, colorCount, hash)) {
+		return cache.grid;
+	}
+	if (cache.hash != hash) {
+		cache.hash = hash;
+		cache.queries = 0;
+		cache.threshold = ClosestColorGridQueries;
+	}
+	cache.queries += queries;
+	if (cache.queries < cache.threshold) {
+		return nullptr;
+	}
+	if (cache.grid && cache.grid->hash() == hash) {
+		// the colors were changed without updating the hash - don't rebuild the grid for every query
+		cache.threshold *= 4;
+	}
+	cache.queries = 0;
+	cache.grid = new ClosestColorGrid(colors, colorCount, hash);
+	return cache.grid;
+}
+
+void Palette::getClosestMatches(const core::RGBA *rgba, int *indices, size_t n) const {
+	core_trace_scoped(GetClosestMatches);
+	if (n == 0) {
+		return;
+	}
+	const ClosestColorGrid *grid = closestColorGrid(_colors, _colorCount, _hash._hash, (int)n);
+	if (grid == nullptr || size() == 0) {
+		for (size_t i = 0; i < n; ++i) {
+			indices[i] = getClosestMatch(rgba[i]);
+		}
+		return;
+	}
+	// neighbouring input colors are often the same
+	core::RGBA last = rgba[0];
+	int lastIndex = grid->closest(last);
+	for (size_t i = 0; i < n; ++i) {
+		if (rgba[i] != last) {
+			last = rgba[i];
+			lastIndex = grid->closest(last);
+		}
+		indices[i] = lastIndex;
+	}
+}
+
 int Palette::getClosestMatch(core::RGBA rgba, int skipPaletteColorIdx) const {
 	if (size() == 0) {
 		return PaletteColorNotFound;
 	}
+	if (skipPaletteColorIdx < 0) {
+		if (const ClosestColorGrid *grid = closestColorGrid(_colors, _colorCount, _hash._hash, 1)) {
+			return grid->closest(rgba);
+		}
+	}
 	for (int i = 0; i < _colorCount; ++i) {
 		if (i == skipPaletteColorIdx) {
 			continue;
@@ -262,6 +262,13 @@ public:
 	 * @return int The index to the palette color or @c PaletteColorNotFound if no match was found
 	 */
 	int getClosestMatch(core::RGBA rgba, int skipPaletteColorIdx = -1) const;
+	/**
+	 * @brief Maps a whole buffer of colors to the closest palette color indices
+	 * @note This is a lot faster than calling @c getClosestMatch() for every color of a large buffer
+	 * @param[out] indices Receives the palette color index or @c PaletteColorNotFound for every input color
+	 * @sa getClosestMatch()
+	 */
+	void getClosestMatches(const core::RGBA *rgba, int *indices, size_t n) const;
 	uint8_t findReplacement(uint8_t paletteColorIdx) const;
 	/**
 	 * @brief Will add the given color to the palette - and if the max colors are reached it will try
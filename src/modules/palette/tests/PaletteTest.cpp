@@ -7,6 +7,7 @@
 #include "core/ArrayLength.h"
 #include "core/GameConfig.h"
 #include "core/Var.h"
+#include "palette/ClosestColorGrid.h"
 #include "palette/PaletteLookup.h"
 
 namespace palette {
@@ -255,4 +256,44 @@ TEST_F(PaletteTest, testMaterialPropertyByName) {
 	EXPECT_FLOAT_EQ(palette.materialProperty(0, "emit"), 0.5f);
 }
 
+TEST_F(PaletteTest, testClosestColorGrid) {
+	palette::Palette pal;
+	ASSERT_TRUE(pal.magicaVoxel());
+	pal.setColor(3, core::RGBA(12, 200, 40, 0));
+	core::RGBA palColors[PaletteMaxColors];
+	for (int i = 0; i < pal.colorCount(); ++i) {
+		palColors[i] = pal.color(i);
+	}
+	const ClosestColorGrid grid(palColors, pal.colorCount(), pal.hash());
+	uint32_t seed = 1234u;
+	for (int i = 0; i < 20000; ++i) {
+		seed = seed * 1664525u + 1013904223u;
+		core::RGBA rgba(seed);
+		if (i % 7 == 0) {
+			rgba = pal.color(i % pal.colorCount());
+		} else if (i % 11 == 0) {
+			rgba.a = 0;
+		}
+		// the skipped color index is out of range - this forces the linear search
+		const int expected = pal.getClosestMatch(rgba, PaletteMaxColors);
+		ASSERT_EQ(expected, grid.closest(rgba)) << "color: " << core::Color::print(rgba);
+		ASSERT_LT(grid.candidates(rgba), pal.colorCount());
+	}
+}
+
+TEST_F(PaletteTest, testGetClosestMatches) {
+	palette::Palette pal;
+	ASSERT_TRUE(pal.nippon());
+	core::DynamicArray<core::RGBA> colors;
+	for (int i = 0; i < 1024; ++i) {
+		colors.push_back(core::RGBA(i * 7, i * 13, i / 4, 255));
+	}
+	core::DynamicArray<int> indices;
+	indices.resize(colors.size());
+	pal.getClosestMatches(colors.data(), indices.data(), colors.size());
+	for (size_t i = 0; i < colors.size(); ++i) {
+		EXPECT_EQ(pal.getClosestMatch(colors[i], PaletteMaxColors), indices[i]);
+	}
+}
+
 } // namespace palette
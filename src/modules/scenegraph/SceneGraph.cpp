@@ -697,6 +697,58 @@ bool SceneGraph::empty(SceneGraphNodeType type) const {
 	return true;
 }
 
+static size_t volumeBytes(const voxel::Region &region) {
+	return (size_t)region.voxels() * sizeof(voxel::Voxel);
+}
+
+size_t SceneGraph::volumeMemoryUsage() const {
+	size_t bytes = 0u;
+	for (const auto &entry : _nodes) {
+		const SceneGraphNode &node = entry->value;
+		if (node.isModelNode() && node.owns() && !node.isVolumeCompressed()) {
+			bytes += volumeBytes(node.region());
+		}
+	}
+	return bytes;
+}
+
+int SceneGraph::compressInactiveVolumes(size_t budget) {
+	size_t bytes = volumeMemoryUsage();
+	if (bytes <= budget) {
+		return 0;
+	}
+	core::DynamicArray<SceneGraphNode *> candidates;
+	for (const auto &entry : _nodes) {
+		SceneGraphNode &node = entry->value;
+		if (node.id() == _activeNodeId || !node.isModelNode() || !node.owns() || node.isVolumeCompressed()) {
+			continue;
+		}
+		candidates.push_back(&node);
+	}
+	// hidden and locked nodes first - then the least recently used ones
+	core::sort(candidates.begin(), candidates.end(), [](const SceneGraphNode *lhs, const SceneGraphNode *rhs) {
+		const bool lhsInactive = !lhs->visible() || lhs->locked();
+		const bool rhsInactive = !rhs->visible() || rhs->locked();
+		if (lhsInactive != rhsInactive) {
+			return lhsInactive;
+		}
+		return lhs->volumeAccess() < rhs->volumeAccess();
+	});
+	int compressed = 0;
+	for (SceneGraphNode *node : candidates) {
+		if (bytes <= budget) {
+			break;
+		}
+		const size_t nodeBytes = volumeBytes(node->region());
+		if (node->compressVolume()) {
+			bytes -= nodeBytes;
+			++compressed;
+		}
+	}
+	Log::debug("Compressed %i volumes - %i bytes of uncompressed volumes left", compressed, (int)bytes);
+	return compressed;
+}
+
 size_t SceneGraph::size(SceneGraphNodeType type) const {
 	if (type == SceneGraphNodeType::All) {
 		return _nodes.size();
@@ -87,6 +87,26 @@ public:
 	void fixErrors();
 	bool validate() const;
 
+	/**
+	 * @brief Moves the volumes of the least recently used model nodes into the cold storage until the uncompressed
+	 * volumes fit into the given budget. Hidden and locked nodes are compressed first, the active node is never
+	 * compressed. The volumes are decompressed again on the next access via @c SceneGraphNode::volume()
+	 * @note All pointers to the compressed volumes get invalid - only call this if nobody is holding on to the volumes
+	 * of the nodes (e.g. the renderer or a pending task)
+	 * @note The least recently used order is only known if @c SceneGraphNode::setColdStorage() was enabled before the
+	 * volumes were accessed
+	 * @note voxedit doesn't use this - its renderer accesses the volumes of all model nodes every frame, which would
+	 * decompress them right away again
+	 * @param[in] budget The max amount of bytes for the uncompressed volumes
+	 * @return The amount of volumes that were compressed
+	 * @sa SceneGraphNode::compressVolume()
+	 */
+	int compressInactiveVolumes(size_t budget);
+	/**
+	 * @return The amount of bytes of the uncompressed volumes that are owned by the model nodes
+	 */
+	size_t volumeMemoryUsage() const;
+
 	/**
 	 * @brief Merge the palettes of all scene graph model nodes
 	 * @param[in] removeUnused If the colors exceed the max palette colors, this will remove the unused colors
@@ -8,6 +8,8 @@
 #include "core/GLM.h"
 #include "core/Hash.h"
 #include "core/Log.h"
+#include "core/StandardLib.h"
+#include "core/concurrent/Lock.h"
 #include "core/StringUtil.h"
 #include "palette/NormalPalette.h"
 #include "palette/Palette.h"
@@ -20,9 +22,71 @@
 
 namespace scenegraph {
 
+/**
+ * @brief The run length encoded voxels of a volume that is not in use
+ */
+struct SceneGraphColdVolume {
+	voxel::Voxel borderValue;
+	/**
+	 * pairs of the run length and the voxel value
+	 */
+	uint32_t *runs = nullptr;
+	size_t runsSize = 0u;
+
+	~SceneGraphColdVolume() {
+		core_free(runs);
+	}
+};
+
+static std::atomic<uint64_t> s_volumeAccessTick{0u};
+static core::AtomicBool s_coldStorage{false};
+
+/**
+ * @return @c nullptr if the encoded voxels wouldn't be smaller than the given voxels
+ */
+static uint32_t *encodeRuns(const voxel::Voxel *voxels, size_t amount, size_t &runsSize) {
+	static_assert(sizeof(voxel::Voxel) == sizeof(uint32_t), "Voxel size doesn't match the run value size");
+	const size_t maxRunsSize = amount;
+	uint32_t *runs = (uint32_t *)core_malloc(maxRunsSize * sizeof(uint32_t));
+	size_t n = 0u;
+	size_t i = 0u;
+	while (i < amount) {
+		uint32_t value;
+		core_memcpy(&value, &voxels[i], sizeof(value));
+		size_t run = 1u;
+		while (i + run < amount && run < UINT32_MAX && core_memcmp(&voxels[i + run], &value, sizeof(value)) == 0) {
+			++run;
+		}
+		if (n + 2u >= maxRunsSize) {
+			core_free(runs);
+			return nullptr;
+		}
+		runs[n++] = (uint32_t)run;
+		runs[n++] = value;
+		i += run;
+	}
+	runsSize = n;
+	return (uint32_t *)core_realloc(runs, n * sizeof(uint32_t));
+}
+
+static void decodeRuns(const uint32_t *runs, size_t runsSize, voxel::Voxel *voxels) {
+	for (size_t i = 0u; i + 1u < runsSize; i += 2u) {
+		const uint32_t run = runs[i];
+		voxel::Voxel voxel;
+		core_memcpy((void *)&voxel, &runs[i + 1u], sizeof(voxel));
+		for (uint32_t r = 0u; r < run; ++r) {
+			*voxels++ = voxel;
+		}
+	}
+}
+
 SceneGraphNode::SceneGraphNode(SceneGraphNode &&move) noexcept {
 	_volume = move._volume;
 	move._volume = nullptr;
+	_coldVolume = (SceneGraphColdVolume *)move._coldVolume;
+	move._coldVolume = nullptr;
+	_coldRegion = move._coldRegion;
+	_volumeAccess.store(move._volumeAccess.load(std::memory_order_relaxed), std::memory_order_relaxed);
 	_name = core::move(move._name);
 	_id = move._id;
 	move._id = InvalidNodeId;
@@ -56,6 +120,10 @@ SceneGraphNode &SceneGraphNode::operator=(SceneGraphNode &&move) noexcept {
 	}
 	setVolume(move._volume, move._flags & VolumeOwned);
 	move._volume = nullptr;
+	_coldVolume = (SceneGraphColdVolume *)move._coldVolume;
+	move._coldVolume = nullptr;
+	_coldRegion = move._coldRegion;
+	_volumeAccess.store(move._volumeAccess.load(std::memory_order_relaxed), std::memory_order_relaxed);
 	_name = core::move(move._name);
 	_id = move._id;
 	move._id = InvalidNodeId;
@@ -184,7 +252,7 @@ palette::Palette &SceneGraphNode::palette() const {
 
 void SceneGraphNode::fixErrors() {
 	if (_type == SceneGraphNodeType::Model) {
-		if (_volume == nullptr) {
+		if (_volume == nullptr && !isVolumeCompressed()) {
 			setVolume(new voxel::RawVolume(voxel::Region(0, 0)), true);
 		}
 	}
@@ -202,7 +270,7 @@ void SceneGraphNode::fixErrors() {
 
 bool SceneGraphNode::validate() const {
 	if (_type == SceneGraphNodeType::Model) {
-		if (_volume == nullptr) {
+		if (_volume == nullptr && !isVolumeCompressed()) {
 			Log::error("Model node %s (%i) has no volume", _name.c_str(), _id);
 			return false;
 		}
@@ -286,6 +354,66 @@ void SceneGraphNode::release() {
 		releaseOwnership();
 	}
 	_volume = nullptr;
+	releaseColdVolume();
+}
+
+void SceneGraphNode::releaseColdVolume() {
+	delete (SceneGraphColdVolume *)_coldVolume.exchange(nullptr);
+}
+
+bool SceneGraphNode::compressVolume() {
+	if (_type != SceneGraphNodeType::Model || _volume == nullptr || !(_flags & VolumeOwned)) {
+		return false;
+	}
+	const size_t voxels = (size_t)_volume->region().voxels();
+	size_t runsSize = 0u;
+	uint32_t *runs = encodeRuns((const voxel::Voxel *)_volume->data(), voxels, runsSize);
+	if (runs == nullptr) {
+		Log::debug("Volume of node %i is not compressible", _id);
+		return false;
+	}
+	SceneGraphColdVolume *coldVolume = new SceneGraphColdVolume();
+	coldVolume->borderValue = _volume->borderValue();
+	coldVolume->runs = runs;
+	coldVolume->runsSize = runsSize;
+	_coldRegion = _volume->region();
+	delete _volume;
+	_volume = nullptr;
+	_coldVolume = coldVolume;
+	return true;
+}
+
+void SceneGraphNode::setColdStorage(bool enabled) {
+	s_coldStorage = enabled;
+}
+
+bool SceneGraphNode::coldStorage() {
+	return s_coldStorage;
+}
+
+void SceneGraphNode::touchVolume() const {
+	if (s_coldStorage) {
+		_volumeAccess.store(s_volumeAccessTick.fetch_add(1u, std::memory_order_relaxed) + 1u,
+							std::memory_order_relaxed);
+	}
+	if (!isVolumeCompressed()) {
+		return;
+	}
+	core::ScopedLock lock(_coldVolumeLock);
+	SceneGraphColdVolume *coldVolume = _coldVolume;
+	if (coldVolume == nullptr) {
+		// another thread was faster
+		return;
+	}
+	const size_t voxels = (size_t)_coldRegion.voxels();
+	voxel::Voxel *data = (voxel::Voxel *)core_malloc(voxels * sizeof(voxel::Voxel));
+	decodeRuns(coldVolume->runs, coldVolume->runsSize, data);
+	voxel::RawVolume *volume = voxel::RawVolume::createRaw(data, _coldRegion);
+	volume->setBorderValue(coldVolume->borderValue);
+	_volume = volume;
+	// the volume must be set before other threads see that the cold volume is gone
+	_coldVolume = nullptr;
+	delete coldVolume;
 }
 
 void SceneGraphNode::releaseOwnership() {
@@ -378,6 +506,9 @@ bool SceneGraphNode::unreferenceModelNode(const SceneGraphNode &node) {
 }
 
 const voxel::Region &SceneGraphNode::region() const {
+	if (isVolumeCompressed()) {
+		return _coldRegion;
+	}
 	if (_volume == nullptr) {
 		return voxel::Region::InvalidRegion;
 	}
@@ -10,8 +10,13 @@
 #include "core/ArrayLength.h"
 #include "core/collection/Buffer.h"
 #include "core/collection/StringMap.h"
+#include "core/Trace.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/Lock.h"
 #include "SceneGraphKeyFrame.h"
 #include "palette/NormalPalette.h"
+#include "voxel/Region.h"
+#include <atomic>
 
 namespace voxel {
 class RawVolume;
@@ -60,6 +65,8 @@ using SceneGraphNodeProperties = core::StringMap<core::String>;
 
 #define InvalidNodeId (-1)
 
+struct SceneGraphColdVolume;
+
 /**
  * @brief Struct that holds the metadata and the volume
  * @sa SceneGraph
@@ -91,7 +98,26 @@ protected:
 
 	core::String _uuid;
 	core::String _name;
-	voxel::RawVolume *_volume = nullptr;
+	mutable voxel::RawVolume *_volume = nullptr;
+	/**
+	 * @brief The compressed volume data - if this is set, @c _volume is @c nullptr until the volume is accessed again
+	 * @sa compressVolume()
+	 */
+	mutable core::AtomicPtr<SceneGraphColdVolume> _coldVolume;
+	/**
+	 * @brief Serializes the decompression of the cold volume of this node
+	 */
+	core_trace_mutex(core::Lock, _coldVolumeLock, "SceneGraphColdVolume");
+	/**
+	 * @brief The region of the compressed volume - this stays valid even if the volume is decompressed by another thread
+	 */
+	voxel::Region _coldRegion;
+	/**
+	 * @brief Tick of the last volume access - used to find the least recently used volumes. This is only updated if
+	 * the cold storage is enabled.
+	 * @sa setColdStorage()
+	 */
+	mutable std::atomic<uint64_t> _volumeAccess{0u};
 	SceneGraphKeyFramesMap _keyFramesMap;
 	SceneGraphKeyFrames *_keyFrames = nullptr;
 	core::Buffer<int, 32> _children;
@@ -105,6 +131,11 @@ protected:
 	void setParent(int id);
 	void setId(int id);
 	void sortKeyFrames();
+	/**
+	 * @brief Decompresses the volume if it was compressed and marks the volume as recently used
+	 */
+	void touchVolume() const;
+	void releaseColdVolume();
 
 public:
 	~SceneGraphNode();
@@ -118,6 +149,29 @@ public:
 	void releaseOwnership();
 	bool owns() const;
 
+	/**
+	 * @brief Moves the owned volume into the cold storage. The volume gets decompressed again on the next call to
+	 * @c volume()
+	 * @note All pointers to the volume of this node get invalid - don't call this while anybody is holding on to the
+	 * volume of this node
+	 * @return @c false if the volume isn't owned by this node, is already compressed, or the compressed data wouldn't be
+	 * smaller than the volume
+	 * @sa SceneGraph::compressInactiveVolumes()
+	 */
+	bool compressVolume();
+	bool isVolumeCompressed() const;
+	/**
+	 * @return The tick of the last call to @c volume() - a higher value means a more recent access. This is @c 0 if
+	 * the cold storage was never enabled.
+	 */
+	uint64_t volumeAccess() const;
+	/**
+	 * @brief Enables the tracking of the volume accesses for all nodes - this is only needed if the volumes are
+	 * moved into the cold storage by @c SceneGraph::compressInactiveVolumes()
+	 */
+	static void setColdStorage(bool enabled);
+	static bool coldStorage();
+
 	bool isReference() const;
 	bool isReferenceable() const;
 	bool isAnyModelNode() const;
@@ -359,7 +413,15 @@ inline const SceneGraphNodeCamera& toCameraNode(const SceneGraphNode& node) {
 }
 
 inline bool SceneGraphNode::owns() const {
-	return _volume;
+	return _volume || isVolumeCompressed();
+}
+
+inline bool SceneGraphNode::isVolumeCompressed() const {
+	return (const SceneGraphColdVolume *)_coldVolume != nullptr;
+}
+
+inline uint64_t SceneGraphNode::volumeAccess() const {
+	return _volumeAccess.load(std::memory_order_relaxed);
 }
 
 inline core::RGBA SceneGraphNode::color() const {
@@ -394,6 +456,7 @@ inline const voxel::RawVolume *SceneGraphNode::volume() const {
 	if (_type != SceneGraphNodeType::Model) {
 		return nullptr;
 	}
+	touchVolume();
 	return _volume;
 }
 
@@ -401,6 +464,7 @@ inline voxel::RawVolume *SceneGraphNode::volume() {
 	if (_type != SceneGraphNodeType::Model) {
 		return nullptr;
 	}
+	touchVolume();
 	return _volume;
 }
 
@@ -10,6 +10,7 @@
 #include "voxel/Region.h"
 #include "voxel/Voxel.h"
 #include <glm/gtc/quaternion.hpp>
+#include <thread>
 
 namespace scenegraph {
 
@@ -646,4 +647,108 @@ TEST_F(SceneGraphTest, testSceneRegion) {
 	EXPECT_EQ(15, maxs.z);
 }
 
+TEST_F(SceneGraphTest, testCompressVolume) {
+	SceneGraphNode node(SceneGraphNodeType::Model);
+	voxel::RawVolume *v = new voxel::RawVolume(voxel::Region(0, 31));
+	v->setVoxel(1, 2, 3, voxel::createVoxel(voxel::VoxelType::Generic, 7));
+	v->setVoxel(31, 31, 31, voxel::createVoxel(voxel::VoxelType::Generic, 8));
+	node.setVolume(v, true);
+	ASSERT_TRUE(node.compressVolume());
+	EXPECT_TRUE(node.isVolumeCompressed());
+	EXPECT_FALSE(node.compressVolume());
+	EXPECT_TRUE(node.owns());
+	EXPECT_EQ(voxel::Region(0, 31), node.region()) << "The region must be available without decompression";
+	EXPECT_TRUE(node.isVolumeCompressed());
+
+	const voxel::RawVolume *decompressed = node.volume();
+	ASSERT_NE(nullptr, decompressed);
+	EXPECT_FALSE(node.isVolumeCompressed());
+	EXPECT_EQ(voxel::Region(0, 31), decompressed->region());
+	EXPECT_EQ(7, decompressed->voxel(1, 2, 3).getColor());
+	EXPECT_EQ(8, decompressed->voxel(31, 31, 31).getColor());
+	EXPECT_TRUE(voxel::isAir(decompressed->voxel(0, 0, 0).getMaterial()));
+}
+
+TEST_F(SceneGraphTest, testDecompressVolumeConcurrently) {
+	SceneGraphNode node(SceneGraphNodeType::Model);
+	voxel::RawVolume *v = new voxel::RawVolume(voxel::Region(0, 31));
+	v->setVoxel(1, 2, 3, voxel::createVoxel(voxel::VoxelType::Generic, 7));
+	node.setVolume(v, true);
+	ASSERT_TRUE(node.compressVolume());
+	// all threads must see the same decompressed volume
+	const voxel::RawVolume *volumes[4]{};
+	std::thread threads[4];
+	for (int i = 0; i < 4; ++i) {
+		threads[i] = std::thread([&node, &volumes, i]() { volumes[i] = node.volume(); });
+	}
+	for (int i = 0; i < 4; ++i) {
+		threads[i].join();
+	}
+	ASSERT_NE(nullptr, volumes[0]);
+	for (int i = 1; i < 4; ++i) {
+		EXPECT_EQ(volumes[0], volumes[i]);
+	}
+	EXPECT_EQ(7, volumes[0]->voxel(1, 2, 3).getColor());
+}
+
+TEST_F(SceneGraphTest, testCompressVolumeNotOwned) {
+	voxel::RawVolume v(voxel::Region(0, 31));
+	SceneGraphNode node(SceneGraphNodeType::Model);
+	node.setVolume(&v, false);
+	EXPECT_FALSE(node.compressVolume());
+	EXPECT_FALSE(node.isVolumeCompressed());
+}
+
+TEST_F(SceneGraphTest, testCompressInactiveVolumes) {
+	SceneGraphNode::setColdStorage(true);
+	SceneGraph sceneGraph;
+	const voxel::Region region(0, 15);
+	int nodeIds[4];
+	for (int i = 0; i < 4; ++i) {
+		SceneGraphNode node(SceneGraphNodeType::Model);
+		node.setVolume(new voxel::RawVolume(region), true);
+		nodeIds[i] = sceneGraph.emplace(core::move(node));
+	}
+	const size_t volumeSize = (size_t)region.voxels() * sizeof(voxel::Voxel);
+	EXPECT_EQ(4u * volumeSize, sceneGraph.volumeMemoryUsage());
+
+	sceneGraph.setActiveNode(nodeIds[0]);
+	sceneGraph.node(nodeIds[3]).setVisible(false);
+	// node 1 is the least recently used visible node
+	sceneGraph.node(nodeIds[1]).volume();
+	sceneGraph.node(nodeIds[2]).volume();
+	sceneGraph.node(nodeIds[3]).volume();
+
+	EXPECT_EQ(0, sceneGraph.compressInactiveVolumes(4u * volumeSize));
+	EXPECT_EQ(1, sceneGraph.compressInactiveVolumes(3u * volumeSize));
+	EXPECT_TRUE(sceneGraph.node(nodeIds[3]).isVolumeCompressed()) << "Hidden nodes should get compressed first";
+	EXPECT_EQ(1, sceneGraph.compressInactiveVolumes(2u * volumeSize));
+	EXPECT_TRUE(sceneGraph.node(nodeIds[1]).isVolumeCompressed());
+	EXPECT_FALSE(sceneGraph.node(nodeIds[2]).isVolumeCompressed());
+	EXPECT_EQ(1, sceneGraph.compressInactiveVolumes(0u));
+	EXPECT_FALSE(sceneGraph.node(nodeIds[0]).isVolumeCompressed()) << "The active node should never get compressed";
+	EXPECT_EQ(volumeSize, sceneGraph.volumeMemoryUsage());
+
+	EXPECT_NE(nullptr, sceneGraph.node(nodeIds[1]).volume());
+	EXPECT_FALSE(sceneGraph.node(nodeIds[1]).isVolumeCompressed());
+	EXPECT_EQ(2u * volumeSize, sceneGraph.volumeMemoryUsage());
+	EXPECT_TRUE(sceneGraph.validate());
+	SceneGraphNode::setColdStorage(false);
+}
+
+TEST_F(SceneGraphTest, testVolumeAccessWithoutColdStorage) {
+	ASSERT_FALSE(SceneGraphNode::coldStorage());
+	SceneGraphNode node(SceneGraphNodeType::Model);
+	node.setVolume(new voxel::RawVolume(voxel::Region(0, 1)), true);
+	node.volume();
+	EXPECT_EQ(0u, node.volumeAccess());
+	SceneGraphNode::setColdStorage(true);
+	node.volume();
+	const uint64_t access = node.volumeAccess();
+	EXPECT_GT(access, 0u);
+	node.volume();
+	EXPECT_GT(node.volumeAccess(), access);
+	SceneGraphNode::setColdStorage(false);
+}
+
 } // namespace scenegraph
@@ -62,6 +62,10 @@ WindowedApp::~WindowedApp() {
 
 void WindowedApp::onAfterRunning() {
 	core_trace_scoped(WindowedAppAfterRunning);
+	if (_headless) {
+		Super::onAfterRunning();
+		return;
+	}
 	video::endFrame(_window);
 }
 
@@ -103,6 +107,9 @@ bool WindowedApp::handleSDLEvent(SDL_Event& event) {
 }
 
 app::AppState WindowedApp::onRunning() {
+	if (_headless) {
+		return Super::onRunning();
+	}
 	video_trace_scoped(Frame);
 	core_trace_scoped(WindowedAppOnRunning);
 	if (isPressed(util::button::CUSTOM_SDLK_MOUSE_WHEEL_UP)) {
@@ -256,7 +263,7 @@ SDL_Window *WindowedApp::createWindow(int width, int height, int displayIndex, u
 
 app::AppState WindowedApp::onInit() {
 	app::AppState state = Super::onInit();
-	if (state != app::AppState::Running) {
+	if (state != app::AppState::Running || _headless) {
 		return state;
 	}
 
@@ -456,6 +463,9 @@ app::AppState WindowedApp::onConstruct() {
 }
 
 app::AppState WindowedApp::onCleanup() {
+	if (_headless) {
+		return Super::onCleanup();
+	}
 	core::Singleton<video::EventHandler>::getInstance().removeObserver(this);
 	video::destroyContext(_rendererContext);
 	if (_window != nullptr) {
@@ -42,6 +42,11 @@ protected:
 	 * Allows to create hidden windows
 	 */
 	bool _showWindow = true;
+	/**
+	 * Skips the video subsystem, the window and the graphics context - the application runs the lifecycle of a
+	 * plain @c app::App. Must be set before @c onInit() is called.
+	 */
+	bool _headless = false;
 	/**
 	 * Don't allow to create new windows from without the application
 	 */
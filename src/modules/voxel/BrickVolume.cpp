@@ -0,0 +1,336 @@
+/**
+ * @file
+ */
+
+#include "BrickVolume.h"
+#include "RawVolume.h"
+#include "core/Assert.h"
+#include "core/StandardLib.h"
+
+namespace voxel {
+
+BrickVolume::BrickVolume(const Region &region) {
+	initialise(region);
+}
+
+BrickVolume::BrickVolume(const RawVolume &volume) : BrickVolume(volume, volume.region()) {
+}
+
+BrickVolume::BrickVolume(const RawVolume &volume, const Region &region) {
+	core_assert_msg(volume.region().containsRegion(region), "The region must be inside of the volume region");
+	initialise(region);
+	setBorderValue(volume.borderValue());
+	const int w = width();
+	const int h = height();
+	const int d = depth();
+	const int srcW = volume.width();
+	const int srcH = volume.height();
+	const glm::ivec3 srcPos = region.getLowerCorner() - volume.region().getLowerCorner();
+	const Voxel *src = (const Voxel *)volume.data();
+	for (int z = 0; z < d; ++z) {
+		for (int y = 0; y < h; ++y) {
+			const Voxel *row =
+				src + srcPos.x + (size_t)(y + srcPos.y) * srcW + (size_t)(z + srcPos.z) * srcW * srcH;
+			const int32_t yzOffset = _offsetY[y] + _offsetZ[z];
+			for (int x = 0; x < w; ++x) {
+				_data[_offsetX[x] + yzOffset] = row[x];
+			}
+		}
+	}
+}
+
+BrickVolume::BrickVolume(const BrickVolume &copy)
+	: _region(copy._region), _borderVoxel(copy._borderVoxel), _offsetX(copy._offsetX), _offsetY(copy._offsetY),
+	  _offsetZ(copy._offsetZ), _voxels(copy._voxels) {
+	const size_t size = _voxels * sizeof(Voxel);
+	_data = (Voxel *)core_malloc(size);
+	core_memcpy((void *)_data, (const void *)copy._data, size);
+}
+
+BrickVolume::BrickVolume(BrickVolume &&move) noexcept
+	: _region(move._region), _borderVoxel(move._borderVoxel), _offsetX(core::move(move._offsetX)),
+	  _offsetY(core::move(move._offsetY)), _offsetZ(core::move(move._offsetZ)), _voxels(move._voxels),
+	  _data(move._data) {
+	move._data = nullptr;
+	move._voxels = 0u;
+}
+
+BrickVolume::~BrickVolume() {
+	core_free(_data);
+	_data = nullptr;
+}
+
+/**
+ * @brief Spreads the bits of the brick coordinate of the given axis to the positions of the morton code. Axis without
+ * bits left are skipped - for full clusters this is the same code as the tables in @c Morton.h produce.
+ */
+static int32_t interleaveBits(int32_t coord, int axis, const int32_t bits[3]) {
+	int32_t code = 0;
+	int32_t pos = 0;
+	for (int32_t bit = 0; bit < BrickVolume::ClusterShift; ++bit) {
+		for (int a = 0; a < 3; ++a) {
+			if (bit >= bits[a]) {
+				continue;
+			}
+			if (a == axis && ((coord >> bit) & 1)) {
+				code |= 1 << pos;
+			}
+			++pos;
+		}
+	}
+	return code;
+}
+
+void BrickVolume::initialise(const Region &region) {
+	_region = region;
+
+	core_assert_msg(width() > 0, "Volume width must be greater than zero.");
+	core_assert_msg(height() > 0, "Volume height must be greater than zero.");
+	core_assert_msg(depth() > 0, "Volume depth must be greater than zero.");
+
+	const glm::ivec3 bricks((width() + BrickMask) >> BrickShift, (height() + BrickMask) >> BrickShift,
+							(depth() + BrickMask) >> BrickShift);
+	// a cluster axis is shrunk to the next power of two of the bricks along that axis - thin volumes are not padded
+	// to a full cluster
+	int32_t clusterBits[3];
+	glm::ivec3 clusterBricks;
+	for (int axis = 0; axis < 3; ++axis) {
+		clusterBits[axis] = 0;
+		while (clusterBits[axis] < ClusterShift && (1 << clusterBits[axis]) < bricks[axis]) {
+			++clusterBits[axis];
+		}
+		clusterBricks[axis] = 1 << clusterBits[axis];
+	}
+	const glm::ivec3 clusters = (bricks + clusterBricks - 1) / clusterBricks;
+	const int32_t clusterVoxels = clusterBricks.x * clusterBricks.y * clusterBricks.z * BrickVoxels;
+
+	// inside a brick x is running fastest - the bricks of a cluster are arranged in morton order and the clusters are
+	// stored x-major
+	_offsetX.resize(width());
+	for (int32_t x = 0; x < width(); ++x) {
+		const int32_t brick = x >> BrickShift;
+		const int32_t morton = interleaveBits(brick & (clusterBricks.x - 1), 0, clusterBits);
+		const int32_t cluster = brick >> clusterBits[0];
+		_offsetX[x] = (x & BrickMask) + morton * BrickVoxels + cluster * clusterVoxels;
+	}
+	_offsetY.resize(height());
+	for (int32_t y = 0; y < height(); ++y) {
+		const int32_t brick = y >> BrickShift;
+		const int32_t morton = interleaveBits(brick & (clusterBricks.y - 1), 1, clusterBits);
+		const int32_t cluster = (brick >> clusterBits[1]) * clusters.x;
+		_offsetY[y] = (y & BrickMask) * BrickSize + morton * BrickVoxels + cluster * clusterVoxels;
+	}
+	_offsetZ.resize(depth());
+	for (int32_t z = 0; z < depth(); ++z) {
+		const int32_t brick = z >> BrickShift;
+		const int32_t morton = interleaveBits(brick & (clusterBricks.z - 1), 2, clusterBits);
+		const int32_t cluster = (brick >> clusterBits[2]) * clusters.x * clusters.y;
+		_offsetZ[z] = (z & BrickMask) * BrickSize * BrickSize + morton * BrickVoxels + cluster * clusterVoxels;
+	}
+
+	_voxels = (size_t)clusters.x * clusters.y * clusters.z * clusterVoxels;
+	const size_t size = _voxels * sizeof(Voxel);
+	_data = (Voxel *)core_malloc(size);
+	core_assert_msg_always(_data != nullptr, "Failed to allocate the memory for a volume with the size of %i bytes",
+						   (int)size);
+	core_memset((void *)_data, 0, size);
+}
+
+RawVolume *BrickVolume::toRawVolume() const {
+	RawVolume *v = new RawVolume(_region);
+	v->setBorderValue(_borderVoxel);
+	const int w = width();
+	const int h = height();
+	const int d = depth();
+	Voxel *dst = (Voxel *)v->data();
+	for (int z = 0; z < d; ++z) {
+		for (int y = 0; y < h; ++y) {
+			Voxel *row = dst + (size_t)y * w + (size_t)z * w * h;
+			const int32_t yzOffset = _offsetY[y] + _offsetZ[z];
+			for (int x = 0; x < w; ++x) {
+				row[x] = _data[_offsetX[x] + yzOffset];
+			}
+		}
+	}
+	return v;
+}
+
+void BrickVolume::setBorderValue(const Voxel &voxel) {
+	_borderVoxel = voxel;
+}
+
+const Voxel &BrickVolume::voxel(int32_t x, int32_t y, int32_t z) const {
+	if (_region.containsPoint(x, y, z)) {
+		const int32_t localX = x - _region.getLowerX();
+		const int32_t localY = y - _region.getLowerY();
+		const int32_t localZ = z - _region.getLowerZ();
+		return _data[voxelIndex(localX, localY, localZ)];
+	}
+	return _borderVoxel;
+}
+
+bool BrickVolume::setVoxel(int32_t x, int32_t y, int32_t z, const Voxel &voxel) {
+	return setVoxel(glm::ivec3(x, y, z), voxel);
+}
+
+bool BrickVolume::setVoxel(const glm::ivec3 &pos, const Voxel &voxel) {
+	const bool inside = _region.containsPoint(pos);
+	core_assert_msg(inside, "Position is outside valid region %i:%i:%i (mins[%i:%i:%i], maxs[%i:%i:%i])", pos.x, pos.y,
+					pos.z, _region.getLowerX(), _region.getLowerY(), _region.getLowerZ(), _region.getUpperX(),
+					_region.getUpperY(), _region.getUpperZ());
+	if (!inside) {
+		return false;
+	}
+	const glm::ivec3 localPos = pos - _region.getLowerCorner();
+	Voxel &current = _data[voxelIndex(localPos.x, localPos.y, localPos.z)];
+	if (current.isSame(voxel)) {
+		return false;
+	}
+	current = voxel;
+	return true;
+}
+
+void BrickVolume::clear() {
+	core_memset((void *)_data, 0, _voxels * sizeof(Voxel));
+}
+
+size_t BrickVolume::memoryUsage() const {
+	return _voxels * sizeof(Voxel);
+}
+
+BrickVolume::Sampler::Sampler(const BrickVolume *volume)
+	: _volume(const_cast<BrickVolume *>(volume)), _region(volume->region()) {
+}
+
+BrickVolume::Sampler::Sampler(const BrickVolume &volume)
+	: _volume(const_cast<BrickVolume *>(&volume)), _region(volume.region()) {
+}
+
+bool BrickVolume::Sampler::setVoxel(const Voxel &voxel) {
+	if (_currentPositionInvalid) {
+		return false;
+	}
+	*_currentVoxel = voxel;
+	return true;
+}
+
+// the neighbour offsets outside of the volume are never used - the peek falls back to the border value
+void BrickVolume::Sampler::updateOffset(int axis) {
+	const core::Buffer<int32_t> *tables[] = {&_volume->_offsetX, &_volume->_offsetY, &_volume->_offsetZ};
+	int32_t *cached[] = {_offsetX, _offsetY, _offsetZ};
+	const core::Buffer<int32_t> &offsets = *tables[axis];
+	int32_t *offset = cached[axis];
+	const int32_t local = _localPos[axis];
+	offset[0] = local > 0 ? offsets[local - 1] : 0;
+	offset[1] = offsets[local];
+	offset[2] = local + 1 < (int32_t)offsets.size() ? offsets[local + 1] : 0;
+}
+
+void BrickVolume::Sampler::updateVoxel() {
+	_currentVoxel = _volume->_data + _offsetX[1] + _offsetY[1] + _offsetZ[1];
+}
+
+bool BrickVolume::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos) {
+	_posInVolume.x = xPos;
+	_posInVolume.y = yPos;
+	_posInVolume.z = zPos;
+
+	const voxel::Region &region = this->region();
+	_currentPositionInvalid = 0u;
+	if (!region.containsPointInX(xPos)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDX;
+	}
+	if (!region.containsPointInY(yPos)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDY;
+	}
+	if (!region.containsPointInZ(zPos)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDZ;
+	}
+
+	if (currentPositionValid()) {
+		_localPos = _posInVolume - region.getLowerCorner();
+		updateOffset(0);
+		updateOffset(1);
+		updateOffset(2);
+		updateVoxel();
+		return true;
+	}
+	_currentVoxel = nullptr;
+	return false;
+}
+
+void BrickVolume::Sampler::move(int axis, int32_t delta) {
+	static const uint8_t invalidBits[] = {SAMPLER_INVALIDX, SAMPLER_INVALIDY, SAMPLER_INVALIDZ};
+	const bool wasValid = currentPositionValid();
+	_posInVolume[axis] += delta;
+	if (_posInVolume[axis] < _region.getLowerCorner()[axis] || _posInVolume[axis] > _region.getUpperCorner()[axis]) {
+		_currentPositionInvalid |= invalidBits[axis];
+	} else {
+		_currentPositionInvalid &= ~invalidBits[axis];
+	}
+	if (wasValid && currentPositionValid()) {
+		_localPos[axis] += delta;
+		updateOffset(axis);
+		updateVoxel();
+	} else {
+		setPosition(_posInVolume);
+	}
+}
+
+void BrickVolume::Sampler::movePositive(math::Axis axis, uint32_t offset) {
+	switch (axis) {
+	case math::Axis::X:
+		movePositiveX(offset);
+		break;
+	case math::Axis::Y:
+		movePositiveY(offset);
+		break;
+	case math::Axis::Z:
+		movePositiveZ(offset);
+		break;
+	default:
+		break;
+	}
+}
+
+void BrickVolume::Sampler::movePositiveX(uint32_t offset) {
+	move(0, (int32_t)offset);
+}
+
+void BrickVolume::Sampler::movePositiveY(uint32_t offset) {
+	move(1, (int32_t)offset);
+}
+
+void BrickVolume::Sampler::movePositiveZ(uint32_t offset) {
+	move(2, (int32_t)offset);
+}
+
+void BrickVolume::Sampler::moveNegative(math::Axis axis, uint32_t offset) {
+	switch (axis) {
+	case math::Axis::X:
+		moveNegativeX(offset);
+		break;
+	case math::Axis::Y:
+		moveNegativeY(offset);
+		break;
+	case math::Axis::Z:
+		moveNegativeZ(offset);
+		break;
+	default:
+		break;
+	}
+}
+
+void BrickVolume::Sampler::moveNegativeX(uint32_t offset) {
+	move(0, -(int32_t)offset);
+}
+
+void BrickVolume::Sampler::moveNegativeY(uint32_t offset) {
+	move(1, -(int32_t)offset);
+}
+
+void BrickVolume::Sampler::moveNegativeZ(uint32_t offset) {
+	move(2, -(int32_t)offset);
+}
+
+} // namespace voxel
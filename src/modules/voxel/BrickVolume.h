@@ -0,0 +1,269 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Region.h"
+#include "Voxel.h"
+#include "core/collection/Buffer.h"
+#include "math/Axis.h"
+#include <glm/vec3.hpp>
+
+namespace voxel {
+
+class RawVolume;
+
+/**
+ * Dense volume that stores the voxels in bricks of @c BrickSize voxels per axis instead of the x-major rows of
+ * @c RawVolume. The voxels of a brick are contiguous - a 3x3x3 neighbourhood (ambient occlusion of the cubic
+ * extractor, normals) touches at most eight bricks instead of nine rows that are a whole slice apart. The bricks are
+ * grouped into clusters of up to @c ClusterSize bricks per axis and arranged in morton order inside of a cluster - so
+ * neighbouring bricks are close in memory, too. The clusters are stored x-major.
+ *
+ * The index of a voxel is the sum of one precomputed offset per axis - see @c voxelIndex().
+ *
+ * @note Each axis is padded to the next multiple of the cluster size. A cluster axis is shrunk to the next power of two
+ * of the bricks along that axis - a thin volume (e.g. 256x1x256) only allocates one brick layer.
+ * @note The voxels are not accessible as one linear array - code that needs @c RawVolume::data() has to convert the
+ * volume with @c toRawVolume().
+ *
+ * @sa RawVolume
+ */
+class BrickVolume {
+public:
+	static constexpr int32_t BrickShift = 2;
+	static constexpr int32_t BrickSize = 1 << BrickShift;
+	static constexpr int32_t BrickMask = BrickSize - 1;
+	static constexpr int32_t BrickVoxels = BrickSize * BrickSize * BrickSize;
+	/** a cluster has up to 4x4x4 bricks - the morton code of a brick inside of a cluster fits into 6 bits */
+	static constexpr int32_t ClusterShift = 2;
+	static constexpr int32_t ClusterSize = 1 << ClusterShift;
+
+	class Sampler {
+	private:
+		static const uint8_t SAMPLER_INVALIDX = 1 << 0;
+		static const uint8_t SAMPLER_INVALIDY = 1 << 1;
+		static const uint8_t SAMPLER_INVALIDZ = 1 << 2;
+
+		void updateOffset(int axis);
+		void updateVoxel();
+		/** moves the position along the given axis index by a signed amount of voxels */
+		void move(int axis, int32_t delta);
+
+	public:
+		Sampler(const BrickVolume &volume);
+		Sampler(const BrickVolume *volume);
+
+		const Voxel &voxel() const;
+		const Region &region() const;
+
+		bool currentPositionValid() const;
+
+		bool setPosition(const glm::ivec3 &pos);
+		bool setPosition(int32_t x, int32_t y, int32_t z);
+		bool setVoxel(const Voxel &voxel);
+		const glm::ivec3 &position() const;
+
+		void movePositiveX(uint32_t offset = 1);
+		void movePositiveY(uint32_t offset = 1);
+		void movePositiveZ(uint32_t offset = 1);
+		void movePositive(math::Axis axis, uint32_t offset = 1);
+
+		void moveNegativeX(uint32_t offset = 1);
+		void moveNegativeY(uint32_t offset = 1);
+		void moveNegativeZ(uint32_t offset = 1);
+		void moveNegative(math::Axis axis, uint32_t offset = 1);
+
+		template<int X, int Y, int Z>
+		const Voxel &peekVoxel() const;
+
+		const Voxel &peekVoxel1nx1ny1nz() const { return peekVoxel<-1, -1, -1>(); }
+		const Voxel &peekVoxel1nx1ny0pz() const { return peekVoxel<-1, -1, 0>(); }
+		const Voxel &peekVoxel1nx1ny1pz() const { return peekVoxel<-1, -1, 1>(); }
+		const Voxel &peekVoxel1nx0py1nz() const { return peekVoxel<-1, 0, -1>(); }
+		const Voxel &peekVoxel1nx0py0pz() const { return peekVoxel<-1, 0, 0>(); }
+		const Voxel &peekVoxel1nx0py1pz() const { return peekVoxel<-1, 0, 1>(); }
+		const Voxel &peekVoxel1nx1py1nz() const { return peekVoxel<-1, 1, -1>(); }
+		const Voxel &peekVoxel1nx1py0pz() const { return peekVoxel<-1, 1, 0>(); }
+		const Voxel &peekVoxel1nx1py1pz() const { return peekVoxel<-1, 1, 1>(); }
+
+		const Voxel &peekVoxel0px1ny1nz() const { return peekVoxel<0, -1, -1>(); }
+		const Voxel &peekVoxel0px1ny0pz() const { return peekVoxel<0, -1, 0>(); }
+		const Voxel &peekVoxel0px1ny1pz() const { return peekVoxel<0, -1, 1>(); }
+		const Voxel &peekVoxel0px0py1nz() const { return peekVoxel<0, 0, -1>(); }
+		const Voxel &peekVoxel0px0py0pz() const { return peekVoxel<0, 0, 0>(); }
+		const Voxel &peekVoxel0px0py1pz() const { return peekVoxel<0, 0, 1>(); }
+		const Voxel &peekVoxel0px1py1nz() const { return peekVoxel<0, 1, -1>(); }
+		const Voxel &peekVoxel0px1py0pz() const { return peekVoxel<0, 1, 0>(); }
+		const Voxel &peekVoxel0px1py1pz() const { return peekVoxel<0, 1, 1>(); }
+
+		const Voxel &peekVoxel1px1ny1nz() const { return peekVoxel<1, -1, -1>(); }
+		const Voxel &peekVoxel1px1ny0pz() const { return peekVoxel<1, -1, 0>(); }
+		const Voxel &peekVoxel1px1ny1pz() const { return peekVoxel<1, -1, 1>(); }
+		const Voxel &peekVoxel1px0py1nz() const { return peekVoxel<1, 0, -1>(); }
+		const Voxel &peekVoxel1px0py0pz() const { return peekVoxel<1, 0, 0>(); }
+		const Voxel &peekVoxel1px0py1pz() const { return peekVoxel<1, 0, 1>(); }
+		const Voxel &peekVoxel1px1py1nz() const { return peekVoxel<1, 1, -1>(); }
+		const Voxel &peekVoxel1px1py0pz() const { return peekVoxel<1, 1, 0>(); }
+		const Voxel &peekVoxel1px1py1pz() const { return peekVoxel<1, 1, 1>(); }
+
+	protected:
+		BrickVolume *_volume;
+
+		voxel::Region _region;
+
+		glm::ivec3 _posInVolume{0, 0, 0};
+		/** @c _posInVolume relative to the lower corner of the region - the index into the offset tables */
+		glm::ivec3 _localPos{0, 0, 0};
+
+		/**
+		 * The table offsets of the previous, the current and the next coordinate per axis. A peek sums three of them
+		 * instead of doing three table lookups in the volume.
+		 */
+		int32_t _offsetX[3]{0, 0, 0};
+		int32_t _offsetY[3]{0, 0, 0};
+		int32_t _offsetZ[3]{0, 0, 0};
+
+		Voxel *_currentVoxel = nullptr;
+
+		/** one @c SAMPLER_INVALID bit for each axis the position is outside of the region */
+		uint8_t _currentPositionInvalid = 0u;
+	};
+
+	/** all voxels are initialized to air */
+	BrickVolume(const Region &region);
+	/** copies the region, the voxels and the border value of the given volume into the brick layout */
+	BrickVolume(const RawVolume &volume);
+	/**
+	 * @brief Copies only the given part of the volume - reads outside of the region return the border value of the
+	 * volume
+	 * @note The region must be inside of the region of the volume
+	 */
+	BrickVolume(const RawVolume &volume, const Region &region);
+	BrickVolume(const BrickVolume &copy);
+	BrickVolume(BrickVolume &&move) noexcept;
+	~BrickVolume();
+
+	/**
+	 * @brief Converts the bricks back into the linear layout
+	 * @note The caller owns the returned volume
+	 */
+	RawVolume *toRawVolume() const;
+
+	/**
+	 * @brief The voxel that is returned for reads outside of the region - e.g. by the peeks of the extractors at the
+	 * region border
+	 */
+	const Voxel &borderValue() const;
+	void setBorderValue(const Voxel &voxel);
+
+	/**
+	 * @return The region without the brick padding
+	 */
+	const Region &region() const;
+
+	int32_t width() const;
+	int32_t height() const;
+	int32_t depth() const;
+
+	/**
+	 * @return The voxel at the given world position or the border value
+	 */
+	const Voxel &voxel(int32_t x, int32_t y, int32_t z) const;
+	inline const Voxel &voxel(const glm::ivec3 &pos) const {
+		return voxel(pos.x, pos.y, pos.z);
+	}
+
+	/**
+	 * @return @c false if the position is outside of the region or the voxel didn't change
+	 */
+	bool setVoxel(int32_t x, int32_t y, int32_t z, const Voxel &voxel);
+	bool setVoxel(const glm::ivec3 &pos, const Voxel &voxel);
+
+	void clear();
+
+	/**
+	 * @return The amount of bytes that are allocated for the voxel data - including the padding
+	 */
+	size_t memoryUsage() const;
+
+private:
+	void initialise(const Region &region);
+	int32_t voxelIndex(int32_t localX, int32_t localY, int32_t localZ) const;
+
+	Region _region;
+	Voxel _borderVoxel;
+
+	/** The offsets of the local coordinates per axis - the sum of all three is the index of the voxel */
+	core::Buffer<int32_t> _offsetX;
+	core::Buffer<int32_t> _offsetY;
+	core::Buffer<int32_t> _offsetZ;
+
+	/** The amount of voxels that are allocated - including the padding */
+	size_t _voxels = 0u;
+	Voxel *_data = nullptr;
+};
+
+inline const Region &BrickVolume::region() const {
+	return _region;
+}
+
+inline const Voxel &BrickVolume::borderValue() const {
+	return _borderVoxel;
+}
+
+inline int32_t BrickVolume::width() const {
+	return _region.getWidthInVoxels();
+}
+
+inline int32_t BrickVolume::height() const {
+	return _region.getHeightInVoxels();
+}
+
+inline int32_t BrickVolume::depth() const {
+	return _region.getDepthInVoxels();
+}
+
+inline int32_t BrickVolume::voxelIndex(int32_t localX, int32_t localY, int32_t localZ) const {
+	return _offsetX[localX] + _offsetY[localY] + _offsetZ[localZ];
+}
+
+inline const Region &BrickVolume::Sampler::region() const {
+	return _region;
+}
+
+inline const glm::ivec3 &BrickVolume::Sampler::position() const {
+	return _posInVolume;
+}
+
+inline bool BrickVolume::Sampler::currentPositionValid() const {
+	return !_currentPositionInvalid;
+}
+
+inline bool BrickVolume::Sampler::setPosition(const glm::ivec3 &pos) {
+	return setPosition(pos.x, pos.y, pos.z);
+}
+
+inline const Voxel &BrickVolume::Sampler::voxel() const {
+	if (currentPositionValid()) {
+		return *_currentVoxel;
+	}
+	return _volume->voxel(_posInVolume);
+}
+
+template<int X, int Y, int Z>
+inline const Voxel &BrickVolume::Sampler::peekVoxel() const {
+	const glm::ivec3 &pos = _posInVolume;
+	if (!currentPositionValid() || (X < 0 && pos.x <= _region.getLowerX()) || (X > 0 && pos.x >= _region.getUpperX()) ||
+		(Y < 0 && pos.y <= _region.getLowerY()) || (Y > 0 && pos.y >= _region.getUpperY()) ||
+		(Z < 0 && pos.z <= _region.getLowerZ()) || (Z > 0 && pos.z >= _region.getUpperZ())) {
+		return _volume->voxel(pos.x + X, pos.y + Y, pos.z + Z);
+	}
+	if constexpr (X == 0 && Y == 0 && Z == 0) {
+		return *_currentVoxel;
+	}
+	return _volume->_data[_offsetX[X + 1] + _offsetY[Y + 1] + _offsetZ[Z + 1]];
+}
+
+} // namespace voxel
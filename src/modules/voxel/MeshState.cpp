@@ -3,6 +3,7 @@
  */
 
 #include "MeshState.h"
+#include "core/Hash.h"
 #include "core/Log.h"
 #include "palette/NormalPalette.h"
 #include "voxel/MaterialColor.h"
@@ -12,6 +13,11 @@
 
 namespace voxel {
 
+/**
+ * @brief The max memory of the meshes that are kept for bricks with a known content hash
+ */
+static constexpr size_t MaxMeshCacheBytes = 64u * 1024u * 1024u;
+
 bool MeshState::init() {
 	_meshMode = core::Var::getSafe(cfg::VoxelMeshMode);
 	_meshMode->markClean();
@@ -93,6 +99,117 @@ void MeshState::clear() {
 		}
 		_meshes[i].clear();
 	}
+	clearMeshCache();
+	_brickHashes.clear();
+	_meshHashes.clear();
+}
+
+void MeshState::clearMeshCache() {
+	CachedMesh *cached = _meshCacheOldest;
+	while (cached != nullptr) {
+		CachedMesh *next = cached->next;
+		delete cached;
+		cached = next;
+	}
+	_meshCacheOldest = _meshCacheNewest = nullptr;
+	_meshCache.clear();
+	_meshCacheBytes = 0u;
+}
+
+void MeshState::unlinkCachedMesh(CachedMesh *cached) {
+	if (cached->prev != nullptr) {
+		cached->prev->next = cached->next;
+	} else {
+		_meshCacheOldest = cached->next;
+	}
+	if (cached->next != nullptr) {
+		cached->next->prev = cached->prev;
+	} else {
+		_meshCacheNewest = cached->prev;
+	}
+	_meshCache.remove(cached->hash);
+	_meshCacheBytes -= cached->bytes;
+}
+
+void MeshState::addToMeshCache(uint64_t hash, voxel::Mesh *opaque, voxel::Mesh *transparency) {
+	if (opaque == nullptr || transparency == nullptr || _meshCache.hasKey(hash)) {
+		delete opaque;
+		delete transparency;
+		return;
+	}
+	CachedMesh *cached = new CachedMesh();
+	cached->mesh.mesh[MeshType_Opaque] = core::move(*opaque);
+	cached->mesh.mesh[MeshType_Transparency] = core::move(*transparency);
+	delete opaque;
+	delete transparency;
+	size_t bytes = 0u;
+	for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
+		const voxel::Mesh &mesh = cached->mesh.mesh[i];
+		bytes += mesh.getVertexVector().size() * sizeof(voxel::VoxelVertex);
+		bytes += mesh.getNormalVector().size() * sizeof(glm::vec3);
+		bytes += mesh.getIndexVector().size() * sizeof(voxel::IndexType);
+	}
+	if (bytes > MaxMeshCacheBytes / 4) {
+		delete cached;
+		return;
+	}
+	// evict the least recently used meshes
+	while (_meshCacheBytes + bytes > MaxMeshCacheBytes && _meshCacheOldest != nullptr) {
+		CachedMesh *oldest = _meshCacheOldest;
+		unlinkCachedMesh(oldest);
+		delete oldest;
+	}
+	cached->hash = hash;
+	cached->bytes = bytes;
+	cached->prev = _meshCacheNewest;
+	if (_meshCacheNewest != nullptr) {
+		_meshCacheNewest->next = cached;
+	} else {
+		_meshCacheOldest = cached;
+	}
+	_meshCacheNewest = cached;
+	_meshCache.put(hash, cached);
+	_meshCacheBytes += bytes;
+}
+
+bool MeshState::takeFromMeshCache(uint64_t hash, voxel::ChunkMesh &mesh) {
+	auto iter = _meshCache.find(hash);
+	if (iter == _meshCache.end()) {
+		return false;
+	}
+	CachedMesh *cached = iter->value;
+	unlinkCachedMesh(cached);
+	mesh = core::move(cached->mesh);
+	delete cached;
+	return true;
+}
+
+voxel::Mesh *MeshState::takeMesh(const glm::ivec3 &pos, int idx, MeshType type) {
+	auto iter = _meshes[type].find(pos);
+	if (iter == _meshes[type].end()) {
+		return nullptr;
+	}
+	voxel::Mesh *mesh = iter->value[idx];
+	iter->value[idx] = nullptr;
+	return mesh;
+}
+
+void MeshState::removeBrickHashes(int idx) {
+	core::DynamicArray<glm::ivec4> bricks;
+	for (const auto &iter : _brickHashes) {
+		if (iter->key.w == idx) {
+			bricks.push_back(iter->key);
+		}
+	}
+	for (const auto &iter : _meshHashes) {
+		if (iter->key.w == idx) {
+			bricks.push_back(iter->key);
+		}
+	}
+	for (const glm::ivec4 &brick : bricks) {
+		_brickHashes.remove(brick);
+		_meshHashes.remove(brick);
+	}
 }
 
 void MeshState::addOrReplaceMeshes(MeshState::ExtractionCtx &result, MeshType type) {
@@ -110,9 +227,19 @@ void MeshState::addOrReplaceMeshes(MeshState::ExtractionCtx &result, MeshType ty
 int MeshState::pop() {
 	MeshState::ExtractionCtx result;
 	while (_pendingQueue.pop(result)) {
+		const glm::ivec4 brickKey(result.mins, result.idx);
 		if (_volumeData[result.idx]._rawVolume == nullptr) {
+			// the extraction is discarded - the brick must be extracted again once there is a volume
+			_brickHashes.remove(brickKey);
 			continue;
 		}
+		uint64_t meshHash = 0u;
+		if (_meshHashes.get(brickKey, meshHash) && meshHash != 0u && meshHash != result.hash) {
+			// keep the replaced meshes - the brick might get back into this state
+			addToMeshCache(meshHash, takeMesh(result.mins, result.idx, MeshType_Opaque),
+						   takeMesh(result.mins, result.idx, MeshType_Transparency));
+		}
+		_meshHashes.put(brickKey, result.hash);
 		addOrReplaceMeshes(result, MeshType_Opaque);
 		addOrReplaceMeshes(result, MeshType_Transparency);
 		return result.idx;
@@ -133,6 +260,8 @@ bool MeshState::deleteMeshes(const glm::ivec3 &pos, int idx) {
 			d = true;
 		}
 	}
+	_brickHashes.remove(glm::ivec4(pos, idx));
+	_meshHashes.remove(glm::ivec4(pos, idx));
 	return d;
 }
 
@@ -148,6 +277,7 @@ bool MeshState::deleteMeshes(int idx) {
 			d = true;
 		}
 	}
+	removeBrickHashes(idx);
 	return d;
 }
 
@@ -186,6 +316,28 @@ const palette::NormalPalette &MeshState::normalsPalette(int idx) const {
 	return *_volumeData[idx]._normalPalette.value();
 }
 
+/**
+ * @brief Hash over the voxels that are taken into account by the extractor - including the mesh mode and the position
+ * of the brick as the vertices are relative to the volume
+ */
+static uint64_t contentHash(const voxel::RawVolume &copy, const voxel::Region &region,
+							voxel::SurfaceExtractionType type, const palette::Palette &palette) {
+	core_trace_scoped(MeshStateContentHash);
+	const int32_t bounds[] = {region.getLowerX(),		region.getLowerY(),		  region.getLowerZ(),
+							  copy.region().getLowerX(), copy.region().getLowerY(), copy.region().getLowerZ(),
+							  copy.region().getUpperX(), copy.region().getUpperY(), copy.region().getUpperZ()};
+	uint64_t seed = core::hash64(bounds, sizeof(bounds), (uint64_t)type);
+	if (type == voxel::SurfaceExtractionType::MarchingCubes) {
+		// the vertex colors are taken from the palette
+		const uint64_t paletteHash = palette.hash();
+		seed = core::hash64(&paletteHash, sizeof(paletteHash), seed);
+	}
+	const size_t len = (size_t)copy.region().voxels() * sizeof(voxel::Voxel);
+	const uint64_t hash = core::hash64(copy.data(), len, seed);
+	// 0 is reserved for empty bricks
+	return hash == 0u ? 1u : hash;
+}
+
 voxel::Region MeshState::calculateExtractRegion(int x, int y, int z, const glm::ivec3 &meshSize) const {
 	const glm::ivec3 mins(x * meshSize.x, y * meshSize.y, z * meshSize.z);
 	const glm::ivec3 maxs = mins + meshSize - 1;
@@ -220,16 +372,29 @@ bool MeshState::runScheduledExtractions(size_t maxExtraction) {
 		}
 		voxel::RawVolume copy(v, copyRegion, &onlyAir);
 		const glm::ivec3 &mins = finalRegion.getLowerCorner();
-		if (!onlyAir) {
-			const palette::Palette &pal = palette(resolveIdx(idx));
+		const palette::Palette &pal = palette(resolveIdx(idx));
+		const uint64_t hash = onlyAir ? 0u : contentHash(copy, finalRegion, type, pal);
+		const glm::ivec4 brickKey(mins, idx);
+		uint64_t lastHash;
+		if (_brickHashes.get(brickKey, lastHash) && lastHash == hash) {
+			// the mesh of the brick is already up to date or on its way
+			Log::debug("Skip unchanged mesh for idx: %i (%i:%i:%i)", idx, mins.x, mins.y, mins.z);
+			continue;
+		}
+		_brickHashes.put(brickKey, hash);
+		voxel::ChunkMesh cachedMesh(0, 0);
+		if (!onlyAir && takeFromMeshCache(hash, cachedMesh)) {
+			Log::debug("Reuse cached mesh for idx: %i (%i:%i:%i)", idx, mins.x, mins.y, mins.z);
+			_pendingQueue.emplace(mins, idx, core::move(cachedMesh), hash);
+		} else if (!onlyAir) {
 			++_pendingExtractorTasks;
 			_threadPool.enqueue([type, movedPal = core::move(pal), movedCopy = core::move(copy), mins, idx,
-								 finalRegion, this]() {
+								 finalRegion, hash, this]() {
 				++_runningExtractorTasks;
 				voxel::ChunkMesh mesh(65536, 65536, true);
 				voxel::SurfaceExtractionContext ctx = voxel::createContext(type, &movedCopy, finalRegion, movedPal, mesh, mins);
 				voxel::extractSurface(ctx);
-				_pendingQueue.emplace(mins, idx, core::move(mesh));
+				_pendingQueue.emplace(mins, idx, core::move(mesh), hash);
 				Log::debug("Enqueue mesh for idx: %i (%i:%i:%i)", idx, mins.x, mins.y, mins.z);
 				--_runningExtractorTasks;
 				--_pendingExtractorTasks;
@@ -263,6 +428,15 @@ bool MeshState::update() {
 	return triggerClear;
 }
 
+static inline glm::ivec3 brickCoord(const glm::ivec3 &pos, int meshSize) {
+	glm::ivec3 brick;
+	for (int i = 0; i < 3; ++i) {
+		// round towards negative infinity
+		brick[i] = pos[i] >= 0 ? pos[i] / meshSize : -((-pos[i] + meshSize - 1) / meshSize);
+	}
+	return brick;
+}
+
 bool MeshState::scheduleRegionExtraction(int idx, const voxel::Region &region) {
 	core_trace_scoped(MeshStateScheduleExtraction);
 	const int bufferIndex = resolveIdx(idx);
@@ -270,10 +444,10 @@ bool MeshState::scheduleRegionExtraction(int idx, const voxel::Region &region) {
 	if (v == nullptr) {
 		return false;
 	}
+	++_volumeData[bufferIndex]._changes;
 
 	const int s = _meshSize->intVal();
 	const glm::ivec3 meshSize(s);
-	const glm::ivec3 meshSizeMinusOne(s - 1);
 	voxel::Region completeRegion = v->region();
 	completeRegion.shiftUpperCorner(1, 1, 1);
 
@@ -281,8 +455,10 @@ bool MeshState::scheduleRegionExtraction(int idx, const voxel::Region &region) {
 	// the given region mesh size ranges
 	// the boundaries are special - that's why we take care of this with
 	// the offset of 1 - see the cubic surface extractor docs
-	const glm::ivec3 &l = (region.getLowerCorner() - meshSizeMinusOne) / meshSize;
-	const glm::ivec3 &u = (region.getUpperCorner() + 1) / meshSize;
+	// a voxel change modifies the faces of the voxel and - because of the ambient occlusion - the faces of the
+	// direct neighbours. Faces on the upper side of a voxel belong to the next brick.
+	const glm::ivec3 &l = brickCoord(region.getLowerCorner() - 1, s);
+	const glm::ivec3 &u = brickCoord(region.getUpperCorner() + 1, s);
 
 	bool deletedMesh = false;
 	Log::debug("modified region: %s", region.toString().c_str());
@@ -293,8 +469,9 @@ bool MeshState::scheduleRegionExtraction(int idx, const voxel::Region &region) {
 				const glm::ivec3 &mins = finalRegion.getLowerCorner();
 
 				if (!voxel::intersects(completeRegion, finalRegion)) {
-					deleteMeshes(mins, bufferIndex);
-					deletedMesh = true;
+					if (deleteMeshes(mins, bufferIndex)) {
+						deletedMesh = true;
+					}
 					continue;
 				}
 
@@ -318,6 +495,10 @@ void MeshState::waitForPendingExtractions() {
 	}
 }
 
+bool MeshState::upToDate() const {
+	return _extractRegions.empty() && _pendingExtractorTasks == 0 && _pendingQueue.empty();
+}
+
 void MeshState::clearPendingExtractions() {
 	_threadPool.abort();
 	while (_runningExtractorTasks > 0) {
@@ -325,6 +506,8 @@ void MeshState::clearPendingExtractions() {
 	}
 	_pendingQueue.clear();
 	_pendingExtractorTasks = 0;
+	// the aborted extractions never reach the meshes
+	_brickHashes.clear();
 }
 
 voxel::SurfaceExtractionType MeshState::meshMode() const {
@@ -339,6 +522,13 @@ int MeshState::resolveIdx(int idx) const {
 	return idx;
 }
 
+uint64_t MeshState::changes(int idx) const {
+	if (idx < 0 || idx >= MAX_VOLUMES) {
+		return 0u;
+	}
+	return _volumeData[idx]._changes;
+}
+
 bool MeshState::sameNormalPalette(int idx, const palette::NormalPalette *palette) const {
 	if (idx < 0 || idx >= MAX_VOLUMES) {
 		return false;
@@ -367,9 +557,13 @@ voxel::RawVolume *MeshState::setVolume(int idx, voxel::RawVolume *v, palette::Pa
 	}
 	core_trace_scoped(RawVolumeRendererSetVolume);
 	_volumeData[idx]._rawVolume = v;
+	++_volumeData[idx]._changes;
 	if (meshDelete) {
 		deleteMeshes(idx);
 		meshDeleted = true;
+	} else {
+		// the scheduled extractions of the old volume are dropped below
+		removeBrickHashes(idx);
 	}
 	const size_t n = _extractRegions.size();
 	for (size_t i = 0; i < n; ++i) {
@@ -51,6 +51,8 @@ private:
 		// if one or three axes are negative, then cull the front face
 		video::Face _cullFace = video::Face::Back;
 		int _reference = -1;
+		/** increased for every dirty region and every new volume */
+		uint64_t _changes = 0u;
 		glm::mat4 _model{1.0f};
 		glm::vec3 _pivot{0.0f};
 		glm::vec3 _mins{0.0f};
@@ -67,12 +69,14 @@ private:
 	struct ExtractionCtx {
 		ExtractionCtx() {
 		}
-		ExtractionCtx(const glm::ivec3 &_mins, int _idx, voxel::ChunkMesh &&_mesh)
-			: mins(_mins), idx(_idx), mesh(_mesh) {
+		ExtractionCtx(const glm::ivec3 &_mins, int _idx, voxel::ChunkMesh &&_mesh, uint64_t _hash = 0u)
+			: mins(_mins), idx(_idx), mesh(core::move(_mesh)), hash(_hash) {
 		}
 		glm::ivec3 mins{};
 		int idx = -1;
 		voxel::ChunkMesh mesh;
+		// the content hash of the voxels the mesh was extracted from - 0 for empty meshes
+		uint64_t hash = 0u;
 
 		inline bool operator<(const ExtractionCtx &rhs) const {
 			return idx < rhs.idx;
@@ -83,6 +87,45 @@ private:
 	Volumes _volumeData;
 	core::VarPtr _meshSize;
 
+	/**
+	 * @brief Meshes that were replaced by a newer extraction of their brick - by the content hash of the voxels they
+	 * were extracted from. This allows to reuse the meshes if a brick gets back into a state that was already
+	 * extracted before - e.g. on undo and redo.
+	 *
+	 * The meshes are moved in and out of the cache - a hit removes the entry. The entries are linked in the order of
+	 * their insertion, which is also the order of their last usage - the oldest entry is evicted first.
+	 */
+	struct CachedMesh {
+		voxel::ChunkMesh mesh{0, 0};
+		uint64_t hash = 0u;
+		size_t bytes = 0u;
+		CachedMesh *prev = nullptr;
+		CachedMesh *next = nullptr;
+	};
+	typedef core::DynamicMap<uint64_t, CachedMesh *, 1031> MeshCache;
+	MeshCache _meshCache;
+	CachedMesh *_meshCacheOldest = nullptr;
+	CachedMesh *_meshCacheNewest = nullptr;
+	size_t _meshCacheBytes = 0u;
+	/**
+	 * @brief Content hashes of bricks (key is mins and volume index)
+	 */
+	typedef core::DynamicMap<glm::ivec4, uint64_t, 1031, glm::hash<glm::ivec4>> BrickHashes;
+	/**
+	 * @brief The content hash of the last extraction that was scheduled for a brick
+	 */
+	BrickHashes _brickHashes;
+	/**
+	 * @brief The content hash of the meshes that are currently in @c _meshes
+	 */
+	BrickHashes _meshHashes;
+	void addToMeshCache(uint64_t hash, voxel::Mesh *opaque, voxel::Mesh *transparency);
+	bool takeFromMeshCache(uint64_t hash, voxel::ChunkMesh &mesh);
+	void unlinkCachedMesh(CachedMesh *cached);
+	void clearMeshCache();
+	voxel::Mesh *takeMesh(const glm::ivec3 &pos, int idx, MeshType type);
+	void removeBrickHashes(int idx);
+
 	struct ExtractRegion {
 		ExtractRegion(const voxel::Region &_region, int _idx, bool _visible)
 			: region(_region), idx(_idx), visible(_visible) {
@@ -134,7 +177,16 @@ public:
 	 * @return the amount of pending extractions
 	 */
 	int pendingExtractions() const;
+	/**
+	 * @return @c true if there are no scheduled or running extractions and all extracted meshes were taken over by
+	 * @c pop()
+	 */
+	bool upToDate() const;
 	void clearPendingExtractions();
+	/**
+	 * @return the amount of replaced meshes that are cached by their content hash
+	 */
+	int cachedMeshes() const;
 
 	/**
 	 * @sa shutdown()
@@ -172,11 +224,22 @@ public:
 
 	/**
 	 * @brief Split the region according to the configured mesh size
+	 *
+	 * Only the bricks that can be affected by a change of the given region are scheduled. When the extraction is
+	 * executed, the voxel content of the brick is hashed - unchanged bricks are skipped and bricks that were already
+	 * extracted with the same content are taken from the mesh cache.
+	 *
 	 * @note Without calling @c extractAllPending() or @c update() the mesh won't get extracted
 	 * @return @c true if the mesh should get deleted in the renderer
 	 */
 	bool scheduleRegionExtraction(int idx, const voxel::Region &region);
 
+	/**
+	 * @return A counter that changes whenever a region of the volume was scheduled for extraction or the volume was
+	 * replaced - equal values mean unchanged voxels
+	 */
+	uint64_t changes(int idx) const;
+
 	bool sameNormalPalette(int idx, const palette::NormalPalette *palette) const;
 
 	[[nodiscard]] voxel::RawVolume *setVolume(int idx, voxel::RawVolume *volume, palette::Palette *palette,
@@ -223,6 +286,10 @@ inline int MeshState::pendingExtractions() const {
 	return (int)_extractRegions.size();
 }
 
+inline int MeshState::cachedMeshes() const {
+	return (int)_meshCache.size();
+}
+
 inline voxel::RawVolume *MeshState::volume(int idx) {
 	if (idx < 0 || idx >= MAX_VOLUMES) {
 		return nullptr;
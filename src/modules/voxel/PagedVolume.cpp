@@ -0,0 +1,387 @@
+/**
+ * @file
+ */
+
+#include "PagedVolume.h"
+#include "RawVolume.h"
+#include "core/Assert.h"
+#include "core/StandardLib.h"
+#include <glm/common.hpp>
+
+namespace voxel {
+
+static constexpr size_t BrickBytes = PagedVolume::BrickVoxels * sizeof(Voxel);
+
+namespace {
+/**
+ * All bricks that were never written to point to this read-only brick. The content is zeroed to match
+ * the content of a freshly cleared @c RawVolume.
+ */
+struct EmptyBrick {
+	Voxel *data;
+	EmptyBrick() {
+		data = (Voxel *)core_malloc(BrickBytes);
+		core_memset((void *)data, 0, BrickBytes);
+	}
+	~EmptyBrick() {
+		core_free(data);
+	}
+};
+} // namespace
+
+static const Voxel *emptyBrick() {
+	static EmptyBrick brick;
+	return brick.data;
+}
+
+PagedVolume::PagedVolume(const Region &region) {
+	initialise(region);
+}
+
+PagedVolume::PagedVolume(const RawVolume &volume) {
+	initialise(volume.region());
+	setBorderValue(volume.borderValue());
+	const glm::ivec3 &mins = _region.getLowerCorner();
+	const int w = width();
+	const int h = height();
+	const int d = depth();
+	const Voxel *src = (const Voxel *)volume.data();
+	for (int z = 0; z < d; ++z) {
+		for (int y = 0; y < h; ++y) {
+			const Voxel *row = src + (size_t)y * w + (size_t)z * w * h;
+			for (int x = 0; x < w; ++x) {
+				const Voxel &v = row[x];
+				if (isAir(v.getMaterial())) {
+					continue;
+				}
+				setVoxel(mins.x + x, mins.y + y, mins.z + z, v);
+			}
+		}
+	}
+}
+
+PagedVolume::PagedVolume(const PagedVolume &copy) : _region(copy._region), _borderVoxel(copy._borderVoxel), _bricks(copy._bricks) {
+	_data.resize(copy._data.size());
+	for (size_t i = 0; i < copy._data.size(); ++i) {
+		if (copy._data[i] == nullptr) {
+			_data[i] = nullptr;
+			continue;
+		}
+		_data[i] = (Voxel *)core_malloc(BrickBytes);
+		core_memcpy((void *)_data[i], (const void *)copy._data[i], BrickBytes);
+	}
+}
+
+PagedVolume::PagedVolume(PagedVolume &&move) noexcept
+	: _region(move._region), _borderVoxel(move._borderVoxel), _bricks(move._bricks), _data(core::move(move._data)) {
+	move._bricks = glm::ivec3(0);
+}
+
+PagedVolume::~PagedVolume() {
+	clear();
+}
+
+void PagedVolume::initialise(const Region &region) {
+	_region = region;
+
+	core_assert_msg(width() > 0, "Volume width must be greater than zero.");
+	core_assert_msg(height() > 0, "Volume height must be greater than zero.");
+	core_assert_msg(depth() > 0, "Volume depth must be greater than zero.");
+
+	_bricks.x = (width() + BrickMask) >> BrickShift;
+	_bricks.y = (height() + BrickMask) >> BrickShift;
+	_bricks.z = (depth() + BrickMask) >> BrickShift;
+	_data.resize(totalBricks());
+	_data.fill(nullptr);
+}
+
+RawVolume *PagedVolume::toRawVolume() const {
+	return toRawVolume(_region);
+}
+
+RawVolume *PagedVolume::toRawVolume(const Region &region) const {
+	core_assert_msg(_region.containsRegion(region), "The region must be inside of the volume region");
+	RawVolume *v = new RawVolume(region);
+	v->setBorderValue(_borderVoxel);
+	const glm::ivec3 &mins = _region.getLowerCorner();
+	// local coordinates - the upper corner is exclusive
+	const glm::ivec3 lower = region.getLowerCorner() - mins;
+	const glm::ivec3 upper = region.getUpperCorner() - mins + 1;
+	const glm::ivec3 lowerBrick = lower >> BrickShift;
+	const glm::ivec3 upperBrick = (upper - 1) >> BrickShift;
+	for (int bz = lowerBrick.z; bz <= upperBrick.z; ++bz) {
+		for (int by = lowerBrick.y; by <= upperBrick.y; ++by) {
+			for (int bx = lowerBrick.x; bx <= upperBrick.x; ++bx) {
+				const Voxel *b = _data[bx + by * _bricks.x + bz * _bricks.x * _bricks.y];
+				if (b == nullptr) {
+					continue;
+				}
+				const int lx = core_max(bx << BrickShift, lower.x);
+				const int ly = core_max(by << BrickShift, lower.y);
+				const int lz = core_max(bz << BrickShift, lower.z);
+				const int ex = core_min((bx << BrickShift) + BrickSize, upper.x);
+				const int ey = core_min((by << BrickShift) + BrickSize, upper.y);
+				const int ez = core_min((bz << BrickShift) + BrickSize, upper.z);
+				for (int z = lz; z < ez; ++z) {
+					for (int y = ly; y < ey; ++y) {
+						for (int x = lx; x < ex; ++x) {
+							v->setVoxelUnsafe(mins + glm::ivec3(x, y, z), b[voxelIndex(x, y, z)]);
+						}
+					}
+				}
+			}
+		}
+	}
+	return v;
+}
+
+Region PagedVolume::dataRegion() const {
+	const int w = width();
+	const int h = height();
+	const int d = depth();
+	glm::ivec3 lower(w, h, d);
+	glm::ivec3 upper(-1);
+	for (int bz = 0; bz < _bricks.z; ++bz) {
+		for (int by = 0; by < _bricks.y; ++by) {
+			for (int bx = 0; bx < _bricks.x; ++bx) {
+				const Voxel *b = _data[bx + by * _bricks.x + bz * _bricks.x * _bricks.y];
+				if (b == nullptr) {
+					continue;
+				}
+				const int lx = bx << BrickShift;
+				const int ly = by << BrickShift;
+				const int lz = bz << BrickShift;
+				const int ex = core_min(lx + BrickSize, w);
+				const int ey = core_min(ly + BrickSize, h);
+				const int ez = core_min(lz + BrickSize, d);
+				for (int z = lz; z < ez; ++z) {
+					for (int y = ly; y < ey; ++y) {
+						for (int x = lx; x < ex; ++x) {
+							if (isAir(b[voxelIndex(x, y, z)].getMaterial())) {
+								continue;
+							}
+							lower = glm::min(lower, glm::ivec3(x, y, z));
+							upper = glm::max(upper, glm::ivec3(x, y, z));
+						}
+					}
+				}
+			}
+		}
+	}
+	if (upper.x < 0) {
+		return Region::InvalidRegion;
+	}
+	const glm::ivec3 &mins = _region.getLowerCorner();
+	return Region(mins + lower, mins + upper);
+}
+
+void PagedVolume::setBorderValue(const Voxel &voxel) {
+	_borderVoxel = voxel;
+}
+
+const Voxel *PagedVolume::brick(int32_t localX, int32_t localY, int32_t localZ) const {
+	const Voxel *b = _data[brickIndex(localX, localY, localZ)];
+	if (b == nullptr) {
+		return emptyBrick();
+	}
+	return b;
+}
+
+Voxel *PagedVolume::allocateBrick(int32_t localX, int32_t localY, int32_t localZ) {
+	Voxel *&b = _data[brickIndex(localX, localY, localZ)];
+	if (b == nullptr) {
+		b = (Voxel *)core_malloc(BrickBytes);
+		core_assert_msg_always(b != nullptr, "Failed to allocate the memory for a volume brick");
+		core_memset((void *)b, 0, BrickBytes);
+	}
+	return b;
+}
+
+const Voxel &PagedVolume::voxel(int32_t x, int32_t y, int32_t z) const {
+	if (_region.containsPoint(x, y, z)) {
+		const int32_t localX = x - _region.getLowerX();
+		const int32_t localY = y - _region.getLowerY();
+		const int32_t localZ = z - _region.getLowerZ();
+		return brick(localX, localY, localZ)[voxelIndex(localX, localY, localZ)];
+	}
+	return _borderVoxel;
+}
+
+bool PagedVolume::setVoxel(int32_t x, int32_t y, int32_t z, const Voxel &voxel) {
+	return setVoxel(glm::ivec3(x, y, z), voxel);
+}
+
+bool PagedVolume::setVoxel(const glm::ivec3 &pos, const Voxel &voxel) {
+	const bool inside = _region.containsPoint(pos);
+	core_assert_msg(inside, "Position is outside valid region %i:%i:%i (mins[%i:%i:%i], maxs[%i:%i:%i])", pos.x, pos.y,
+					pos.z, _region.getLowerX(), _region.getLowerY(), _region.getLowerZ(), _region.getUpperX(),
+					_region.getUpperY(), _region.getUpperZ());
+	if (!inside) {
+		return false;
+	}
+	const glm::ivec3 localPos = pos - _region.getLowerCorner();
+	const int index = voxelIndex(localPos.x, localPos.y, localPos.z);
+	const Voxel *current = brick(localPos.x, localPos.y, localPos.z);
+	if (current[index].isSame(voxel)) {
+		return false;
+	}
+	// don't allocate a brick just to store air in it
+	if (current == emptyBrick() && isAir(voxel.getMaterial())) {
+		return false;
+	}
+	Voxel *b = allocateBrick(localPos.x, localPos.y, localPos.z);
+	b[index] = voxel;
+	return true;
+}
+
+void PagedVolume::clear() {
+	for (Voxel *&b : _data) {
+		core_free(b);
+		b = nullptr;
+	}
+}
+
+int PagedVolume::allocatedBricks() const {
+	int n = 0;
+	for (const Voxel *b : _data) {
+		if (b != nullptr) {
+			++n;
+		}
+	}
+	return n;
+}
+
+size_t PagedVolume::memoryUsage() const {
+	return (size_t)allocatedBricks() * BrickBytes;
+}
+
+PagedVolume::Sampler::Sampler(const PagedVolume *volume)
+	: _volume(const_cast<PagedVolume *>(volume)), _region(volume->region()) {
+}
+
+PagedVolume::Sampler::Sampler(const PagedVolume &volume)
+	: _volume(const_cast<PagedVolume *>(&volume)), _region(volume.region()) {
+}
+
+PagedVolume::Sampler::~Sampler() {
+}
+
+bool PagedVolume::Sampler::setVoxel(const Voxel &voxel) {
+	if (_currentPositionInvalid) {
+		return false;
+	}
+	_volume->setVoxel(_posInVolume, voxel);
+	// the brick might have been allocated by this write
+	setPosition(_posInVolume);
+	return true;
+}
+
+bool PagedVolume::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos) {
+	_posInVolume.x = xPos;
+	_posInVolume.y = yPos;
+	_posInVolume.z = zPos;
+
+	const voxel::Region &region = this->region();
+	_currentPositionInvalid = 0u;
+	if (!region.containsPointInX(xPos)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDX;
+	}
+	if (!region.containsPointInY(yPos)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDY;
+	}
+	if (!region.containsPointInZ(zPos)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDZ;
+	}
+
+	if (currentPositionValid()) {
+		const glm::ivec3 &lowerCorner = region.getLowerCorner();
+		const int32_t localX = xPos - lowerCorner.x;
+		const int32_t localY = yPos - lowerCorner.y;
+		const int32_t localZ = zPos - lowerCorner.z;
+		_posInBrick.x = localX & BrickMask;
+		_posInBrick.y = localY & BrickMask;
+		_posInBrick.z = localZ & BrickMask;
+		_currentVoxel = _volume->brick(localX, localY, localZ) + voxelIndex(localX, localY, localZ);
+		return true;
+	}
+	_currentVoxel = nullptr;
+	return false;
+}
+
+void PagedVolume::Sampler::move(int32_t dx, int32_t dy, int32_t dz) {
+	if (currentPositionValid()) {
+		const uint32_t bx = (uint32_t)(_posInBrick.x + dx);
+		const uint32_t by = (uint32_t)(_posInBrick.y + dy);
+		const uint32_t bz = (uint32_t)(_posInBrick.z + dz);
+		if (bx < (uint32_t)BrickSize && by < (uint32_t)BrickSize && bz < (uint32_t)BrickSize &&
+			_region.containsPoint(_posInVolume.x + dx, _posInVolume.y + dy, _posInVolume.z + dz)) {
+			_posInVolume.x += dx;
+			_posInVolume.y += dy;
+			_posInVolume.z += dz;
+			_posInBrick.x = (int32_t)bx;
+			_posInBrick.y = (int32_t)by;
+			_posInBrick.z = (int32_t)bz;
+			_currentVoxel += dx + dy * BrickSize + dz * BrickSize * BrickSize;
+			return;
+		}
+	}
+	setPosition(_posInVolume.x + dx, _posInVolume.y + dy, _posInVolume.z + dz);
+}
+
+void PagedVolume::Sampler::movePositive(math::Axis axis, uint32_t offset) {
+	switch (axis) {
+	case math::Axis::X:
+		movePositiveX(offset);
+		break;
+	case math::Axis::Y:
+		movePositiveY(offset);
+		break;
+	case math::Axis::Z:
+		movePositiveZ(offset);
+		break;
+	default:
+		break;
+	}
+}
+
+void PagedVolume::Sampler::movePositiveX(uint32_t offset) {
+	move((int32_t)offset, 0, 0);
+}
+
+void PagedVolume::Sampler::movePositiveY(uint32_t offset) {
+	move(0, (int32_t)offset, 0);
+}
+
+void PagedVolume::Sampler::movePositiveZ(uint32_t offset) {
+	move(0, 0, (int32_t)offset);
+}
+
+void PagedVolume::Sampler::moveNegative(math::Axis axis, uint32_t offset) {
+	switch (axis) {
+	case math::Axis::X:
+		moveNegativeX(offset);
+		break;
+	case math::Axis::Y:
+		moveNegativeY(offset);
+		break;
+	case math::Axis::Z:
+		moveNegativeZ(offset);
+		break;
+	default:
+		break;
+	}
+}
+
+void PagedVolume::Sampler::moveNegativeX(uint32_t offset) {
+	move(-(int32_t)offset, 0, 0);
+}
+
+void PagedVolume::Sampler::moveNegativeY(uint32_t offset) {
+	move(0, -(int32_t)offset, 0);
+}
+
+void PagedVolume::Sampler::moveNegativeZ(uint32_t offset) {
+	move(0, 0, -(int32_t)offset);
+}
+
+} // namespace voxel
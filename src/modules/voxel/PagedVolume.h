@@ -0,0 +1,409 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Region.h"
+#include "Voxel.h"
+#include "core/collection/DynamicArray.h"
+#include "math/Axis.h"
+#include <glm/vec3.hpp>
+
+namespace voxel {
+
+class RawVolume;
+
+/**
+ * Volume implementation which splits the region into fixed size bricks. A brick is only allocated on the first
+ * write of a non-air voxel - all other bricks share a single read-only all-air brick. This keeps the resident
+ * memory low for huge but sparse scenes while still allowing pointer arithmetic inside a brick.
+ *
+ * The voxel layout inside a brick is the same x-major layout that is used by @c RawVolume. A brick has the size of a
+ * minecraft section - the region formats fill one section after another into the bricks.
+ *
+ * @sa RawVolume
+ * @sa SparseVolume
+ */
+class PagedVolume {
+public:
+	static constexpr int32_t BrickShift = 4;
+	static constexpr int32_t BrickSize = 1 << BrickShift;
+	static constexpr int32_t BrickMask = BrickSize - 1;
+	static constexpr int32_t BrickVoxels = BrickSize * BrickSize * BrickSize;
+
+	class Sampler {
+	private:
+		static const uint8_t SAMPLER_INVALIDX = 1 << 0;
+		static const uint8_t SAMPLER_INVALIDY = 1 << 1;
+		static const uint8_t SAMPLER_INVALIDZ = 1 << 2;
+
+		const Voxel &peek(int32_t dx, int32_t dy, int32_t dz) const;
+		void move(int32_t dx, int32_t dy, int32_t dz);
+
+	public:
+		Sampler(const PagedVolume &volume);
+		Sampler(const PagedVolume *volume);
+		~Sampler();
+
+		const Voxel &voxel() const;
+		const Region &region() const;
+
+		bool currentPositionValid() const;
+
+		bool setPosition(const glm::ivec3 &pos);
+		bool setPosition(int32_t x, int32_t y, int32_t z);
+		bool setVoxel(const Voxel &voxel);
+		const glm::ivec3 &position() const;
+
+		void movePositiveX(uint32_t offset = 1);
+		void movePositiveY(uint32_t offset = 1);
+		void movePositiveZ(uint32_t offset = 1);
+		void movePositive(math::Axis axis, uint32_t offset = 1);
+
+		void moveNegativeX(uint32_t offset = 1);
+		void moveNegativeY(uint32_t offset = 1);
+		void moveNegativeZ(uint32_t offset = 1);
+		void moveNegative(math::Axis axis, uint32_t offset = 1);
+
+		const Voxel &peekVoxel1nx1ny1nz() const;
+		const Voxel &peekVoxel1nx1ny0pz() const;
+		const Voxel &peekVoxel1nx1ny1pz() const;
+		const Voxel &peekVoxel1nx0py1nz() const;
+		const Voxel &peekVoxel1nx0py0pz() const;
+		const Voxel &peekVoxel1nx0py1pz() const;
+		const Voxel &peekVoxel1nx1py1nz() const;
+		const Voxel &peekVoxel1nx1py0pz() const;
+		const Voxel &peekVoxel1nx1py1pz() const;
+
+		const Voxel &peekVoxel0px1ny1nz() const;
+		const Voxel &peekVoxel0px1ny0pz() const;
+		const Voxel &peekVoxel0px1ny1pz() const;
+		const Voxel &peekVoxel0px0py1nz() const;
+		const Voxel &peekVoxel0px0py0pz() const;
+		const Voxel &peekVoxel0px0py1pz() const;
+		const Voxel &peekVoxel0px1py1nz() const;
+		const Voxel &peekVoxel0px1py0pz() const;
+		const Voxel &peekVoxel0px1py1pz() const;
+
+		const Voxel &peekVoxel1px1ny1nz() const;
+		const Voxel &peekVoxel1px1ny0pz() const;
+		const Voxel &peekVoxel1px1ny1pz() const;
+		const Voxel &peekVoxel1px0py1nz() const;
+		const Voxel &peekVoxel1px0py0pz() const;
+		const Voxel &peekVoxel1px0py1pz() const;
+		const Voxel &peekVoxel1px1py1nz() const;
+		const Voxel &peekVoxel1px1py0pz() const;
+		const Voxel &peekVoxel1px1py1pz() const;
+
+	protected:
+		PagedVolume *_volume;
+
+		voxel::Region _region;
+
+		// The current position in the volume
+		glm::ivec3 _posInVolume{0, 0, 0};
+		// The current position relative to the lower corner of the current brick
+		glm::ivec3 _posInBrick{0, 0, 0};
+
+		/** Points either into an allocated brick or into the shared all-air brick */
+		const Voxel *_currentVoxel = nullptr;
+
+		/** Whether the current position is inside the volume */
+		uint8_t _currentPositionInvalid = 0u;
+	};
+
+	/// Constructor for creating a fixed size volume - no brick is allocated until the first voxel is set.
+	PagedVolume(const Region &region);
+	/// Converts the given @c RawVolume - bricks that only contain air are not allocated
+	PagedVolume(const RawVolume &volume);
+	PagedVolume(const PagedVolume &copy);
+	PagedVolume(PagedVolume &&move) noexcept;
+	~PagedVolume();
+
+	/**
+	 * @return A new @c RawVolume with the same region and voxels.
+	 * @note It's the callers responsibility to properly release the memory.
+	 */
+	RawVolume *toRawVolume() const;
+	/**
+	 * @return A new @c RawVolume with the given region - e.g. the @c dataRegion() to crop the empty parts.
+	 * @note It's the callers responsibility to properly release the memory.
+	 */
+	RawVolume *toRawVolume(const Region &region) const;
+
+	/**
+	 * @return The region of the voxels that are not air - only the allocated bricks are visited. Returns
+	 * @c Region::InvalidRegion if the volume only contains air.
+	 */
+	Region dataRegion() const;
+
+	/**
+	 * The border value is returned whenever an attempt is made to read a voxel which
+	 * is outside the extents of the volume.
+	 * @return The value used for voxels outside of the volume
+	 */
+	const Voxel &borderValue() const;
+	/**
+	 * Sets the value used for voxels which are outside the volume
+	 */
+	void setBorderValue(const Voxel &voxel);
+
+	/**
+	 * @return A Region representing the extent of the volume.
+	 */
+	const Region &region() const;
+
+	/**
+	 * @return The width of the volume in voxels.
+	 * @sa height(), depth()
+	 */
+	int32_t width() const;
+	/**
+	 * @return The height of the volume in voxels.
+	 * @sa width(), depth()
+	 */
+	int32_t height() const;
+	/**
+	 * @return The depth of the volume in voxels.
+	 * @sa width(), height()
+	 */
+	int32_t depth() const;
+
+	/**
+	 * Gets a voxel at the position given by <tt>x,y,z</tt> coordinates
+	 */
+	const Voxel &voxel(int32_t x, int32_t y, int32_t z) const;
+	inline const Voxel &voxel(const glm::ivec3 &pos) const {
+		return voxel(pos.x, pos.y, pos.z);
+	}
+
+	/**
+	 * Sets the voxel at the position given by <tt>x,y,z</tt> coordinates. Allocates the brick if needed.
+	 * @return @c true if the voxel was placed, @c false if it was already the same voxel
+	 */
+	bool setVoxel(int32_t x, int32_t y, int32_t z, const Voxel &voxel);
+	bool setVoxel(const glm::ivec3 &pos, const Voxel &voxel);
+
+	/**
+	 * @brief Releases all bricks - the volume only contains air afterwards
+	 */
+	void clear();
+
+	/**
+	 * @return The amount of bricks that are allocated for non-air voxels
+	 */
+	int allocatedBricks() const;
+	/**
+	 * @return The amount of bricks needed to cover the whole region
+	 */
+	int totalBricks() const;
+	/**
+	 * @return The amount of bytes that are allocated for the voxel data of the bricks
+	 */
+	size_t memoryUsage() const;
+
+private:
+	friend class Sampler;
+
+	int brickIndex(int32_t localX, int32_t localY, int32_t localZ) const;
+	static int voxelIndex(int32_t localX, int32_t localY, int32_t localZ);
+	const Voxel *brick(int32_t localX, int32_t localY, int32_t localZ) const;
+	Voxel *allocateBrick(int32_t localX, int32_t localY, int32_t localZ);
+	void initialise(const Region &region);
+
+	/** The size of the volume */
+	Region _region;
+
+	/** The border value */
+	Voxel _borderVoxel;
+
+	/** The amount of bricks in each direction */
+	glm::ivec3 _bricks{0, 0, 0};
+
+	/** A @c nullptr entry means that the brick is not allocated and only contains air */
+	core::DynamicArray<Voxel *> _data;
+};
+
+inline const Region &PagedVolume::region() const {
+	return _region;
+}
+
+inline const Voxel &PagedVolume::borderValue() const {
+	return _borderVoxel;
+}
+
+inline int32_t PagedVolume::width() const {
+	return _region.getWidthInVoxels();
+}
+
+inline int32_t PagedVolume::height() const {
+	return _region.getHeightInVoxels();
+}
+
+inline int32_t PagedVolume::depth() const {
+	return _region.getDepthInVoxels();
+}
+
+inline int PagedVolume::totalBricks() const {
+	return _bricks.x * _bricks.y * _bricks.z;
+}
+
+inline int PagedVolume::brickIndex(int32_t localX, int32_t localY, int32_t localZ) const {
+	return (localX >> BrickShift) + (localY >> BrickShift) * _bricks.x +
+		   (localZ >> BrickShift) * _bricks.x * _bricks.y;
+}
+
+inline int PagedVolume::voxelIndex(int32_t localX, int32_t localY, int32_t localZ) {
+	return (localX & BrickMask) + (localY & BrickMask) * BrickSize + (localZ & BrickMask) * BrickSize * BrickSize;
+}
+
+inline const Region &PagedVolume::Sampler::region() const {
+	return _region;
+}
+
+inline const glm::ivec3 &PagedVolume::Sampler::position() const {
+	return _posInVolume;
+}
+
+inline bool PagedVolume::Sampler::currentPositionValid() const {
+	return !_currentPositionInvalid;
+}
+
+inline bool PagedVolume::Sampler::setPosition(const glm::ivec3 &v3dNewPos) {
+	return setPosition(v3dNewPos.x, v3dNewPos.y, v3dNewPos.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::voxel() const {
+	if (this->currentPositionValid()) {
+		return *_currentVoxel;
+	}
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z);
+}
+
+/**
+ * Neighbours in the same brick are resolved by pointer offsets, everything else (brick borders or positions
+ * outside of the region) is looked up via the volume.
+ */
+inline const Voxel &PagedVolume::Sampler::peek(int32_t dx, int32_t dy, int32_t dz) const {
+	if (this->currentPositionValid()) {
+		const uint32_t bx = (uint32_t)(_posInBrick.x + dx);
+		const uint32_t by = (uint32_t)(_posInBrick.y + dy);
+		const uint32_t bz = (uint32_t)(_posInBrick.z + dz);
+		if (bx < (uint32_t)BrickSize && by < (uint32_t)BrickSize && bz < (uint32_t)BrickSize &&
+			_region.containsPoint(_posInVolume.x + dx, _posInVolume.y + dy, _posInVolume.z + dz)) {
+			return *(_currentVoxel + dx + dy * BrickSize + dz * BrickSize * BrickSize);
+		}
+	}
+	return this->_volume->voxel(this->_posInVolume.x + dx, this->_posInVolume.y + dy, this->_posInVolume.z + dz);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1ny1nz() const {
+	return peek(-1, -1, -1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1ny0pz() const {
+	return peek(-1, -1, 0);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1ny1pz() const {
+	return peek(-1, -1, 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx0py1nz() const {
+	return peek(-1, 0, -1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx0py0pz() const {
+	return peek(-1, 0, 0);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx0py1pz() const {
+	return peek(-1, 0, 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1py1nz() const {
+	return peek(-1, 1, -1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1py0pz() const {
+	return peek(-1, 1, 0);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1py1pz() const {
+	return peek(-1, 1, 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1ny1nz() const {
+	return peek(0, -1, -1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1ny0pz() const {
+	return peek(0, -1, 0);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1ny1pz() const {
+	return peek(0, -1, 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px0py1nz() const {
+	return peek(0, 0, -1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px0py0pz() const {
+	return voxel();
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px0py1pz() const {
+	return peek(0, 0, 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1py1nz() const {
+	return peek(0, 1, -1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1py0pz() const {
+	return peek(0, 1, 0);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1py1pz() const {
+	return peek(0, 1, 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1ny1nz() const {
+	return peek(1, -1, -1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1ny0pz() const {
+	return peek(1, -1, 0);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1ny1pz() const {
+	return peek(1, -1, 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px0py1nz() const {
+	return peek(1, 0, -1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px0py0pz() const {
+	return peek(1, 0, 0);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px0py1pz() const {
+	return peek(1, 0, 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1py1nz() const {
+	return peek(1, 1, -1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1py0pz() const {
+	return peek(1, 1, 0);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1py1pz() const {
+	return peek(1, 1, 1);
+}
+
+} // namespace voxel
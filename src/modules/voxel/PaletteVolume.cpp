@@ -0,0 +1,351 @@
+/**
+ * @file
+ */
+
+#include "PaletteVolume.h"
+#include "RawVolume.h"
+#include "core/Assert.h"
+#include "core/StandardLib.h"
+
+namespace voxel {
+
+PaletteVolume::PaletteVolume(const Region &region, uint8_t airIndex) : _airIndex(airIndex) {
+	initialise(region);
+}
+
+PaletteVolume::PaletteVolume(const RawVolume &volume) : PaletteVolume((const Voxel *)volume.data(), volume.region()) {
+	setBorderValue(volume.borderValue());
+}
+
+PaletteVolume::PaletteVolume(const Voxel *voxels, const Region &region) : _airIndex(255u) {
+	const size_t count = (size_t)region.voxels();
+	bool used[256]{};
+	for (size_t i = 0; i < count; ++i) {
+		if (!isAir(voxels[i].getMaterial())) {
+			used[voxels[i].getColor()] = true;
+		}
+	}
+	// prefer the last palette index - most palettes don't use it
+	for (int i = 255; i >= 0; --i) {
+		if (!used[i]) {
+			_airIndex = (uint8_t)i;
+			break;
+		}
+	}
+	initialise(region);
+	for (size_t i = 0; i < count; ++i) {
+		if (!isAir(voxels[i].getMaterial())) {
+			setVoxelAt((int32_t)i, voxels[i]);
+		}
+	}
+}
+
+PaletteVolume::PaletteVolume(const Region &region, const Voxel *indexVoxels, uint8_t airIndex, const uint8_t *data)
+	: _airIndex(airIndex) {
+	initialise(region);
+	for (int i = 0; i < 256; ++i) {
+		_indexVoxels[i] = indexVoxels[i];
+	}
+	core_memcpy(_data, data, (size_t)region.voxels());
+}
+
+PaletteVolume::PaletteVolume(const PaletteVolume &copy)
+	: _region(copy._region), _borderVoxel(copy._borderVoxel), _sideTable(copy._sideTable), _airIndex(copy._airIndex) {
+	for (int i = 0; i < 256; ++i) {
+		_indexVoxels[i] = copy._indexVoxels[i];
+	}
+	const size_t size = (size_t)width() * height() * depth();
+	_data = (uint8_t *)core_malloc(size);
+	core_memcpy(_data, copy._data, size);
+}
+
+PaletteVolume::PaletteVolume(PaletteVolume &&move) noexcept
+	: _region(move._region), _borderVoxel(move._borderVoxel), _sideTable(core::move(move._sideTable)),
+	  _airIndex(move._airIndex), _data(move._data) {
+	for (int i = 0; i < 256; ++i) {
+		_indexVoxels[i] = move._indexVoxels[i];
+	}
+	move._data = nullptr;
+}
+
+PaletteVolume::~PaletteVolume() {
+	core_free(_data);
+	_data = nullptr;
+}
+
+void PaletteVolume::initialise(const Region &region) {
+	_region = region;
+
+	core_assert_msg(width() > 0, "Volume width must be greater than zero.");
+	core_assert_msg(height() > 0, "Volume height must be greater than zero.");
+	core_assert_msg(depth() > 0, "Volume depth must be greater than zero.");
+
+	const size_t size = (size_t)width() * height() * depth();
+	_data = (uint8_t *)core_malloc(size);
+	core_assert_msg_always(_data != nullptr, "Failed to allocate the memory for a volume with the size of %i bytes",
+						   (int)size);
+	core_memset(_data, _airIndex, size);
+}
+
+RawVolume *PaletteVolume::toRawVolume() const {
+	RawVolume *v = new RawVolume(_region);
+	v->setBorderValue(_borderVoxel);
+	Voxel lookup[256];
+	for (int i = 0; i < 256; ++i) {
+		lookup[i] = i == _airIndex ? _airVoxel : _indexVoxels[i];
+	}
+	Voxel *dst = (Voxel *)v->data();
+	const size_t voxels = (size_t)width() * height() * depth();
+	for (size_t i = 0; i < voxels; ++i) {
+		dst[i] = lookup[_data[i]];
+	}
+	for (const auto &e : _sideTable) {
+		dst[e->key] = e->value;
+	}
+	return v;
+}
+
+void PaletteVolume::setBorderValue(const Voxel &voxel) {
+	_borderVoxel = voxel;
+}
+
+const Voxel &PaletteVolume::voxel(int32_t x, int32_t y, int32_t z) const {
+	if (_region.containsPoint(x, y, z)) {
+		const int32_t localX = x - _region.getLowerX();
+		const int32_t localY = y - _region.getLowerY();
+		const int32_t localZ = z - _region.getLowerZ();
+		return voxelAt(voxelIndex(localX, localY, localZ));
+	}
+	return _borderVoxel;
+}
+
+bool PaletteVolume::setVoxel(int32_t x, int32_t y, int32_t z, const Voxel &voxel) {
+	return setVoxel(glm::ivec3(x, y, z), voxel);
+}
+
+bool PaletteVolume::setVoxel(const glm::ivec3 &pos, const Voxel &voxel) {
+	const bool inside = _region.containsPoint(pos);
+	core_assert_msg(inside, "Position is outside valid region %i:%i:%i (mins[%i:%i:%i], maxs[%i:%i:%i])", pos.x, pos.y,
+					pos.z, _region.getLowerX(), _region.getLowerY(), _region.getLowerZ(), _region.getUpperX(),
+					_region.getUpperY(), _region.getUpperZ());
+	if (!inside) {
+		return false;
+	}
+	const glm::ivec3 localPos = pos - _region.getLowerCorner();
+	return setVoxelAt(voxelIndex(localPos.x, localPos.y, localPos.z), voxel);
+}
+
+bool PaletteVolume::setVoxelAt(int32_t index, const Voxel &voxel) {
+	const Voxel &current = voxelAt(index);
+	if (isAir(voxel.getMaterial())) {
+		if (isAir(current.getMaterial())) {
+			return false;
+		}
+		if (!_sideTable.empty()) {
+			_sideTable.remove(index);
+		}
+		_data[index] = _airIndex;
+		return true;
+	}
+	if (current.isSame(voxel) && current.getFlags() == voxel.getFlags()) {
+		return false;
+	}
+	Voxel v = voxel;
+	// the ambient occlusion scratch value is not part of the voxel state
+	v._unused2 = 0u;
+	const uint8_t paletteIndex = v.getColor();
+	if (paletteIndex != _airIndex) {
+		Voxel &indexVoxel = _indexVoxels[paletteIndex];
+		if (isAir(indexVoxel.getMaterial())) {
+			indexVoxel = v;
+		}
+		if (indexVoxel.isSame(v) && indexVoxel.getFlags() == v.getFlags()) {
+			if (!_sideTable.empty()) {
+				_sideTable.remove(index);
+			}
+			_data[index] = paletteIndex;
+			return true;
+		}
+	}
+	_data[index] = paletteIndex;
+	_sideTable.put(index, v);
+	return true;
+}
+
+void PaletteVolume::clear() {
+	core_memset(_data, _airIndex, (size_t)width() * height() * depth());
+	_sideTable.clear();
+	for (int i = 0; i < 256; ++i) {
+		_indexVoxels[i] = Voxel();
+	}
+}
+
+size_t PaletteVolume::memoryUsage() const {
+	return (size_t)width() * height() * depth() + _sideTable.size() * (sizeof(int32_t) + sizeof(Voxel));
+}
+
+PaletteVolume::Sampler::Sampler(const PaletteVolume *volume)
+	: _volume(const_cast<PaletteVolume *>(volume)), _region(volume->region()) {
+}
+
+PaletteVolume::Sampler::Sampler(const PaletteVolume &volume)
+	: _volume(const_cast<PaletteVolume *>(&volume)), _region(volume.region()) {
+}
+
+bool PaletteVolume::Sampler::setVoxel(const Voxel &voxel) {
+	if (_currentPositionInvalid) {
+		return false;
+	}
+	_volume->setVoxelAt(_currentIndex, voxel);
+	return true;
+}
+
+bool PaletteVolume::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos) {
+	_posInVolume.x = xPos;
+	_posInVolume.y = yPos;
+	_posInVolume.z = zPos;
+
+	const voxel::Region &region = this->region();
+	_currentPositionInvalid = 0u;
+	if (!region.containsPointInX(xPos)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDX;
+	}
+	if (!region.containsPointInY(yPos)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDY;
+	}
+	if (!region.containsPointInZ(zPos)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDZ;
+	}
+
+	if (currentPositionValid()) {
+		const glm::ivec3 localPos = _posInVolume - region.getLowerCorner();
+		_currentIndex = _volume->voxelIndex(localPos.x, localPos.y, localPos.z);
+		return true;
+	}
+	_currentIndex = 0;
+	return false;
+}
+
+void PaletteVolume::Sampler::movePositive(math::Axis axis, uint32_t offset) {
+	switch (axis) {
+	case math::Axis::X:
+		movePositiveX(offset);
+		break;
+	case math::Axis::Y:
+		movePositiveY(offset);
+		break;
+	case math::Axis::Z:
+		movePositiveZ(offset);
+		break;
+	default:
+		break;
+	}
+}
+
+void PaletteVolume::Sampler::movePositiveX(uint32_t offset) {
+	const bool bIsOldPositionValid = currentPositionValid();
+	_posInVolume.x += (int)offset;
+	if (!_region.containsPointInX(_posInVolume.x)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDX;
+	} else {
+		_currentPositionInvalid &= ~SAMPLER_INVALIDX;
+	}
+	if (bIsOldPositionValid && currentPositionValid()) {
+		_currentIndex += (int32_t)offset;
+	} else {
+		setPosition(_posInVolume);
+	}
+}
+
+void PaletteVolume::Sampler::movePositiveY(uint32_t offset) {
+	const bool bIsOldPositionValid = currentPositionValid();
+	_posInVolume.y += (int)offset;
+	if (!_region.containsPointInY(_posInVolume.y)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDY;
+	} else {
+		_currentPositionInvalid &= ~SAMPLER_INVALIDY;
+	}
+	if (bIsOldPositionValid && currentPositionValid()) {
+		_currentIndex += _volume->width() * (int32_t)offset;
+	} else {
+		setPosition(_posInVolume);
+	}
+}
+
+void PaletteVolume::Sampler::movePositiveZ(uint32_t offset) {
+	const bool bIsOldPositionValid = currentPositionValid();
+	_posInVolume.z += (int)offset;
+	if (!_region.containsPointInZ(_posInVolume.z)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDZ;
+	} else {
+		_currentPositionInvalid &= ~SAMPLER_INVALIDZ;
+	}
+	if (bIsOldPositionValid && currentPositionValid()) {
+		_currentIndex += _volume->width() * _volume->height() * (int32_t)offset;
+	} else {
+		setPosition(_posInVolume);
+	}
+}
+
+void PaletteVolume::Sampler::moveNegative(math::Axis axis, uint32_t offset) {
+	switch (axis) {
+	case math::Axis::X:
+		moveNegativeX(offset);
+		break;
+	case math::Axis::Y:
+		moveNegativeY(offset);
+		break;
+	case math::Axis::Z:
+		moveNegativeZ(offset);
+		break;
+	default:
+		break;
+	}
+}
+
+void PaletteVolume::Sampler::moveNegativeX(uint32_t offset) {
+	const bool bIsOldPositionValid = currentPositionValid();
+	_posInVolume.x -= (int)offset;
+	if (!_region.containsPointInX(_posInVolume.x)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDX;
+	} else {
+		_currentPositionInvalid &= ~SAMPLER_INVALIDX;
+	}
+	if (bIsOldPositionValid && currentPositionValid()) {
+		_currentIndex -= (int32_t)offset;
+	} else {
+		setPosition(_posInVolume);
+	}
+}
+
+void PaletteVolume::Sampler::moveNegativeY(uint32_t offset) {
+	const bool bIsOldPositionValid = currentPositionValid();
+	_posInVolume.y -= (int)offset;
+	if (!_region.containsPointInY(_posInVolume.y)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDY;
+	} else {
+		_currentPositionInvalid &= ~SAMPLER_INVALIDY;
+	}
+	if (bIsOldPositionValid && currentPositionValid()) {
+		_currentIndex -= _volume->width() * (int32_t)offset;
+	} else {
+		setPosition(_posInVolume);
+	}
+}
+
+void PaletteVolume::Sampler::moveNegativeZ(uint32_t offset) {
+	const bool bIsOldPositionValid = currentPositionValid();
+	_posInVolume.z -= (int)offset;
+	if (!_region.containsPointInZ(_posInVolume.z)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDZ;
+	} else {
+		_currentPositionInvalid &= ~SAMPLER_INVALIDZ;
+	}
+	if (bIsOldPositionValid && currentPositionValid()) {
+		_currentIndex -= _volume->width() * _volume->height() * (int32_t)offset;
+	} else {
+		setPosition(_posInVolume);
+	}
+}
+
+} // namespace voxel
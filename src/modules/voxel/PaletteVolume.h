@@ -0,0 +1,301 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Region.h"
+#include "Voxel.h"
+#include "core/collection/DynamicMap.h"
+#include "math/Axis.h"
+#include <glm/vec3.hpp>
+
+namespace voxel {
+
+class RawVolume;
+
+/**
+ * Stores the palette index of each voxel in one byte instead of the four bytes of a @c Voxel - the indices are in the
+ * same order as the voxels of @c RawVolume::data().
+ *
+ * One palette index is reserved for air. The first voxel that is written with a palette index defines the material,
+ * the normal and the flags for all other voxels with this index. Voxels that differ from this (or that use the index
+ * that is reserved for air) are put into a side table - reading them is slower, but nothing gets lost.
+ *
+ * This is only used by the memento states - they compress the indices of compact volumes instead of the voxels.
+ *
+ * @note All air voxels are the same - the color or normal of air voxels is not preserved.
+ * @note The voxels are converted on access - the returned references stay valid until the next modification.
+ *
+ * @sa RawVolume
+ */
+class PaletteVolume {
+public:
+	class Sampler {
+	private:
+		static const uint8_t SAMPLER_INVALIDX = 1 << 0;
+		static const uint8_t SAMPLER_INVALIDY = 1 << 1;
+		static const uint8_t SAMPLER_INVALIDZ = 1 << 2;
+
+	public:
+		Sampler(const PaletteVolume &volume);
+		Sampler(const PaletteVolume *volume);
+
+		const Voxel &voxel() const;
+		const Region &region() const;
+
+		bool currentPositionValid() const;
+
+		bool setPosition(const glm::ivec3 &pos);
+		bool setPosition(int32_t x, int32_t y, int32_t z);
+		bool setVoxel(const Voxel &voxel);
+		const glm::ivec3 &position() const;
+
+		void movePositiveX(uint32_t offset = 1);
+		void movePositiveY(uint32_t offset = 1);
+		void movePositiveZ(uint32_t offset = 1);
+		void movePositive(math::Axis axis, uint32_t offset = 1);
+
+		void moveNegativeX(uint32_t offset = 1);
+		void moveNegativeY(uint32_t offset = 1);
+		void moveNegativeZ(uint32_t offset = 1);
+		void moveNegative(math::Axis axis, uint32_t offset = 1);
+
+		template<int X, int Y, int Z>
+		const Voxel &peekVoxel() const;
+
+		const Voxel &peekVoxel1nx1ny1nz() const { return peekVoxel<-1, -1, -1>(); }
+		const Voxel &peekVoxel1nx1ny0pz() const { return peekVoxel<-1, -1, 0>(); }
+		const Voxel &peekVoxel1nx1ny1pz() const { return peekVoxel<-1, -1, 1>(); }
+		const Voxel &peekVoxel1nx0py1nz() const { return peekVoxel<-1, 0, -1>(); }
+		const Voxel &peekVoxel1nx0py0pz() const { return peekVoxel<-1, 0, 0>(); }
+		const Voxel &peekVoxel1nx0py1pz() const { return peekVoxel<-1, 0, 1>(); }
+		const Voxel &peekVoxel1nx1py1nz() const { return peekVoxel<-1, 1, -1>(); }
+		const Voxel &peekVoxel1nx1py0pz() const { return peekVoxel<-1, 1, 0>(); }
+		const Voxel &peekVoxel1nx1py1pz() const { return peekVoxel<-1, 1, 1>(); }
+
+		const Voxel &peekVoxel0px1ny1nz() const { return peekVoxel<0, -1, -1>(); }
+		const Voxel &peekVoxel0px1ny0pz() const { return peekVoxel<0, -1, 0>(); }
+		const Voxel &peekVoxel0px1ny1pz() const { return peekVoxel<0, -1, 1>(); }
+		const Voxel &peekVoxel0px0py1nz() const { return peekVoxel<0, 0, -1>(); }
+		const Voxel &peekVoxel0px0py0pz() const { return peekVoxel<0, 0, 0>(); }
+		const Voxel &peekVoxel0px0py1pz() const { return peekVoxel<0, 0, 1>(); }
+		const Voxel &peekVoxel0px1py1nz() const { return peekVoxel<0, 1, -1>(); }
+		const Voxel &peekVoxel0px1py0pz() const { return peekVoxel<0, 1, 0>(); }
+		const Voxel &peekVoxel0px1py1pz() const { return peekVoxel<0, 1, 1>(); }
+
+		const Voxel &peekVoxel1px1ny1nz() const { return peekVoxel<1, -1, -1>(); }
+		const Voxel &peekVoxel1px1ny0pz() const { return peekVoxel<1, -1, 0>(); }
+		const Voxel &peekVoxel1px1ny1pz() const { return peekVoxel<1, -1, 1>(); }
+		const Voxel &peekVoxel1px0py1nz() const { return peekVoxel<1, 0, -1>(); }
+		const Voxel &peekVoxel1px0py0pz() const { return peekVoxel<1, 0, 0>(); }
+		const Voxel &peekVoxel1px0py1pz() const { return peekVoxel<1, 0, 1>(); }
+		const Voxel &peekVoxel1px1py1nz() const { return peekVoxel<1, 1, -1>(); }
+		const Voxel &peekVoxel1px1py0pz() const { return peekVoxel<1, 1, 0>(); }
+		const Voxel &peekVoxel1px1py1pz() const { return peekVoxel<1, 1, 1>(); }
+
+	protected:
+		PaletteVolume *_volume;
+
+		voxel::Region _region;
+
+		glm::ivec3 _posInVolume{0, 0, 0};
+		/** the index of @c _posInVolume into the palette indices of the volume */
+		int32_t _currentIndex = 0;
+
+		/** one @c SAMPLER_INVALID bit for each axis the position is outside of the region */
+		uint8_t _currentPositionInvalid = 0u;
+	};
+
+	/**
+	 * @param airIndex The palette index that is reserved for air voxels. Voxels with this color are still supported,
+	 * but they end up in the side table.
+	 */
+	PaletteVolume(const Region &region, uint8_t airIndex = 255u);
+	/**
+	 * Converts the given @c RawVolume - a palette index that is not used by the volume is reserved for air.
+	 */
+	PaletteVolume(const RawVolume &volume);
+	/**
+	 * @param voxels The voxels of the region in the layout of @c RawVolume::data()
+	 */
+	PaletteVolume(const Voxel *voxels, const Region &region);
+	/**
+	 * @brief Restores a compact volume from the values of @c indexVoxels(), @c airIndex() and @c data()
+	 */
+	PaletteVolume(const Region &region, const Voxel *indexVoxels, uint8_t airIndex, const uint8_t *data);
+	PaletteVolume(const PaletteVolume &copy);
+	PaletteVolume(PaletteVolume &&move) noexcept;
+	~PaletteVolume();
+
+	/**
+	 * @brief Expands the palette indices and the side table into a @c RawVolume
+	 * @note The caller owns the returned volume
+	 */
+	RawVolume *toRawVolume() const;
+
+	/**
+	 * @brief The voxel that is returned for reads outside of the region - it's not limited to the palette index
+	 * mapping
+	 */
+	const Voxel &borderValue() const;
+	void setBorderValue(const Voxel &voxel);
+
+	const Region &region() const;
+
+	int32_t width() const;
+	int32_t height() const;
+	int32_t depth() const;
+
+	/**
+	 * @return The voxel of the palette index (or the side table) at the given world position or the border value
+	 */
+	const Voxel &voxel(int32_t x, int32_t y, int32_t z) const;
+	inline const Voxel &voxel(const glm::ivec3 &pos) const {
+		return voxel(pos.x, pos.y, pos.z);
+	}
+
+	/**
+	 * @brief Stores the palette index of the voxel - the voxel only ends up in the side table if it doesn't match the
+	 * voxel of its palette index
+	 * @return @c true if the voxel was placed, @c false if it was already the same voxel
+	 */
+	bool setVoxel(int32_t x, int32_t y, int32_t z, const Voxel &voxel);
+	bool setVoxel(const glm::ivec3 &pos, const Voxel &voxel);
+
+	void clear();
+
+	/**
+	 * @return The palette index that marks an air voxel in @c data()
+	 */
+	uint8_t airIndex() const;
+	/**
+	 * @return The palette indices of the volume in the same order as the voxels of @c RawVolume::data()
+	 */
+	const uint8_t *data() const;
+	/**
+	 * @return The 256 voxels that are stored for the palette indices - the entry of @c airIndex() is unused
+	 */
+	const Voxel *indexVoxels() const;
+	/**
+	 * @return @c true if no voxel needs the side table - @c data() and @c airIndex() are enough to describe all voxels
+	 */
+	bool isCompact() const;
+	/**
+	 * @return The amount of bytes that are allocated for the voxel data - including the side table entries
+	 */
+	size_t memoryUsage() const;
+
+private:
+	void initialise(const Region &region);
+	int32_t voxelIndex(int32_t localX, int32_t localY, int32_t localZ) const;
+	const Voxel &voxelAt(int32_t index) const;
+	bool setVoxelAt(int32_t index, const Voxel &voxel);
+
+	Region _region;
+	Voxel _borderVoxel;
+	/** The value for all air voxels - this matches the content of a cleared @c RawVolume */
+	Voxel _airVoxel{VoxelType::Air, 0, 0};
+	/** The voxel for each palette index - an air material means the palette index was not yet used */
+	Voxel _indexVoxels[256];
+	/** The voxels that can't be expressed by their palette index alone - the key is the index into @c _data */
+	core::DynamicMap<int32_t, Voxel, 1031> _sideTable;
+
+	uint8_t _airIndex;
+
+	/** The palette indices */
+	uint8_t *_data = nullptr;
+};
+
+inline const Region &PaletteVolume::region() const {
+	return _region;
+}
+
+inline const Voxel &PaletteVolume::borderValue() const {
+	return _borderVoxel;
+}
+
+inline int32_t PaletteVolume::width() const {
+	return _region.getWidthInVoxels();
+}
+
+inline int32_t PaletteVolume::height() const {
+	return _region.getHeightInVoxels();
+}
+
+inline int32_t PaletteVolume::depth() const {
+	return _region.getDepthInVoxels();
+}
+
+inline uint8_t PaletteVolume::airIndex() const {
+	return _airIndex;
+}
+
+inline const uint8_t *PaletteVolume::data() const {
+	return _data;
+}
+
+inline const Voxel *PaletteVolume::indexVoxels() const {
+	return _indexVoxels;
+}
+
+inline bool PaletteVolume::isCompact() const {
+	return _sideTable.empty();
+}
+
+inline int32_t PaletteVolume::voxelIndex(int32_t localX, int32_t localY, int32_t localZ) const {
+	return localX + localY * width() + localZ * width() * height();
+}
+
+inline const Voxel &PaletteVolume::voxelAt(int32_t index) const {
+	if (!_sideTable.empty()) {
+		auto iter = _sideTable.find(index);
+		if (iter != _sideTable.end()) {
+			return iter->value;
+		}
+	}
+	const uint8_t paletteIndex = _data[index];
+	if (paletteIndex == _airIndex) {
+		return _airVoxel;
+	}
+	return _indexVoxels[paletteIndex];
+}
+
+inline const Region &PaletteVolume::Sampler::region() const {
+	return _region;
+}
+
+inline const glm::ivec3 &PaletteVolume::Sampler::position() const {
+	return _posInVolume;
+}
+
+inline bool PaletteVolume::Sampler::currentPositionValid() const {
+	return !_currentPositionInvalid;
+}
+
+inline bool PaletteVolume::Sampler::setPosition(const glm::ivec3 &pos) {
+	return setPosition(pos.x, pos.y, pos.z);
+}
+
+inline const Voxel &PaletteVolume::Sampler::voxel() const {
+	if (currentPositionValid()) {
+		return _volume->voxelAt(_currentIndex);
+	}
+	return _volume->voxel(_posInVolume);
+}
+
+template<int X, int Y, int Z>
+inline const Voxel &PaletteVolume::Sampler::peekVoxel() const {
+	static_assert(X >= -1 && X <= 1 && Y >= -1 && Y <= 1 && Z >= -1 && Z <= 1, "Only the direct neighbours can be peeked");
+	const glm::ivec3 &pos = _posInVolume;
+	if (!currentPositionValid() || (X < 0 && pos.x <= _region.getLowerX()) || (X > 0 && pos.x >= _region.getUpperX()) ||
+		(Y < 0 && pos.y <= _region.getLowerY()) || (Y > 0 && pos.y >= _region.getUpperY()) ||
+		(Z < 0 && pos.z <= _region.getLowerZ()) || (Z > 0 && pos.z >= _region.getUpperZ())) {
+		return _volume->voxel(pos.x + X, pos.y + Y, pos.z + Z);
+	}
+	const int32_t w = _region.getWidthInVoxels();
+	const int32_t h = _region.getHeightInVoxels();
+	return _volume->voxelAt(_currentIndex + X + Y * w + Z * w * h);
+}
+
+} // namespace voxel
@@ -0,0 +1,46 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "app/App.h"
+#include "core/Trace.h"
+#include "core/concurrent/TaskGroup.h"
+#include "voxel/Region.h"
+#include <glm/common.hpp>
+
+namespace voxel {
+
+/**
+ * @brief Splits the region into slabs along the z axis and executes the given function for each slab on the app
+ * thread pool. The function gets the sub region as parameter.
+ *
+ * @note This blocks until all slabs are processed. The calling thread processes slabs, too - so it's safe to call this
+ * from within a task of the app thread pool.
+ * @param minDepth The min amount of z slices per slab - use this to keep the tasks from getting too small
+ */
+template<class FUNC>
+void parallelFor(const Region &region, FUNC &&func, int minDepth = 1) {
+	core_trace_scoped(ParallelForRegion);
+	core::ThreadPool &pool = app::App::getInstance()->threadPool();
+	const int depth = region.getDepthInVoxels();
+	// a few more slabs than workers to balance slabs with different costs
+	const int maxSlabs = (int)pool.size() * 4;
+	const int slabDepth = glm::max(glm::max(1, minDepth), (depth + maxSlabs - 1) / glm::max(1, maxSlabs));
+	if (depth <= slabDepth) {
+		func(region);
+		return;
+	}
+	core::TaskGroup group(pool);
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); z += slabDepth) {
+		glm::ivec3 mins = region.getLowerCorner();
+		glm::ivec3 maxs = region.getUpperCorner();
+		mins.z = z;
+		maxs.z = glm::min(region.getUpperZ(), z + slabDepth - 1);
+		group.run([&func, slab = Region(mins, maxs)]() { func(slab); });
+	}
+	group.wait();
+}
+
+} // namespace voxel
@@ -60,8 +60,9 @@ RawVolume::RawVolume(const RawVolume &src, const core::DynamicArray<Region> &cop
 	for (Region copyRegion : copyRegions) {
 		core_assert(copyRegion.isValid());
 		copyRegion.cropTo(_region);
-		RawVolume::Sampler destSampler(*this);
-		RawVolume::Sampler srcSampler(src);
+		// the copy region is cropped to both volumes
+		RawVolume::InteriorSampler destSampler(*this);
+		RawVolume::InteriorSampler srcSampler(src);
 		for (int32_t x = copyRegion.getLowerX(); x <= copyRegion.getUpperX(); ++x) {
 			for (int32_t y = copyRegion.getLowerY(); y <= copyRegion.getUpperY(); ++y) {
 				srcSampler.setPosition(x, y, copyRegion.getLowerZ());
@@ -288,30 +289,38 @@ void RawVolume::fill(const voxel::Voxel &voxel) {
 	}
 }
 
-RawVolume::Sampler::Sampler(const RawVolume *volume)
-	: _volume(const_cast<RawVolume *>(volume)), _region(volume->region()) {
+template<bool Interior>
+RawVolume::SamplerT<Interior>::SamplerT(const RawVolume *volume)
+	: _volume(const_cast<RawVolume *>(volume)), _region(volume->region()), _strideY(volume->width()),
+	  _strideZ(volume->width() * volume->height()) {
 }
 
-RawVolume::Sampler::Sampler(const RawVolume &volume)
-	: _volume(const_cast<RawVolume *>(&volume)), _region(volume.region()) {
+template<bool Interior>
+RawVolume::SamplerT<Interior>::SamplerT(const RawVolume &volume) : SamplerT(&volume) {
 }
 
-RawVolume::Sampler::~Sampler() {
-}
-
-bool RawVolume::Sampler::setVoxel(const Voxel &voxel) {
-	if (_currentPositionInvalid) {
+template<bool Interior>
+bool RawVolume::SamplerT<Interior>::setVoxel(const Voxel &voxel) {
+	if (!currentPositionValid()) {
 		return false;
 	}
 	*_currentVoxel = voxel;
 	return true;
 }
 
-bool RawVolume::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos) {
+template<bool Interior>
+bool RawVolume::SamplerT<Interior>::setPosition(int32_t xPos, int32_t yPos, int32_t zPos) {
 	_posInVolume.x = xPos;
 	_posInVolume.y = yPos;
 	_posInVolume.z = zPos;
 
+	const glm::ivec3 &v3dLowerCorner = _volume->region().getLowerCorner();
+	if constexpr (Interior) {
+		_currentVoxel = _volume->_data + (xPos - v3dLowerCorner.x) + (yPos - v3dLowerCorner.y) * _strideY +
+						(zPos - v3dLowerCorner.z) * _strideZ;
+		return true;
+	}
+
 	const voxel::Region &region = this->region();
 	_currentPositionInvalid = 0u;
 	if (!region.containsPointInX(xPos)) {
@@ -326,11 +335,10 @@ bool RawVolume::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos) {
 
 	// Then we update the voxel pointer
 	if (currentPositionValid()) {
-		const glm::ivec3 &v3dLowerCorner = region.getLowerCorner();
 		const int32_t iLocalXPos = xPos - v3dLowerCorner.x;
 		const int32_t iLocalYPos = yPos - v3dLowerCorner.y;
 		const int32_t iLocalZPos = zPos - v3dLowerCorner.z;
-		const int32_t uVoxelIndex = iLocalXPos + iLocalYPos * _volume->width() + iLocalZPos * _volume->width() * _volume->height();
+		const int32_t uVoxelIndex = iLocalXPos + iLocalYPos * _strideY + iLocalZPos * _strideZ;
 
 		_currentVoxel = _volume->_data + uVoxelIndex;
 		return true;
@@ -339,7 +347,8 @@ bool RawVolume::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos) {
 	return false;
 }
 
-void RawVolume::Sampler::movePositive(math::Axis axis, uint32_t offset) {
+template<bool Interior>
+void RawVolume::SamplerT<Interior>::movePositive(math::Axis axis, uint32_t offset) {
 	switch (axis) {
 	case math::Axis::X:
 		movePositiveX(offset);
@@ -355,11 +364,15 @@ void RawVolume::Sampler::movePositive(math::Axis axis, uint32_t offset) {
 	}
 }
 
-void RawVolume::Sampler::movePositiveX(uint32_t offset) {
-	const bool bIsOldPositionValid = currentPositionValid();
-
+template<bool Interior>
+void RawVolume::SamplerT<Interior>::movePositiveX(uint32_t offset) {
 	_posInVolume.x += (int)offset;
+	if constexpr (Interior) {
+		_currentVoxel += (intptr_t)offset;
+		return;
+	}
 
+	const bool bIsOldPositionValid = currentPositionValid();
 	if (!region().containsPointInX(_posInVolume.x)) {
 		_currentPositionInvalid |= SAMPLER_INVALIDX;
 	} else {
@@ -376,11 +389,15 @@ void RawVolume::Sampler::movePositiveX(uint32_t offset) {
 	}
 }
 
-void RawVolume::Sampler::movePositiveY(uint32_t offset) {
-	const bool bIsOldPositionValid = currentPositionValid();
-
+template<bool Interior>
+void RawVolume::SamplerT<Interior>::movePositiveY(uint32_t offset) {
 	_posInVolume.y += (int)offset;
+	if constexpr (Interior) {
+		_currentVoxel += (intptr_t)_strideY * offset;
+		return;
+	}
 
+	const bool bIsOldPositionValid = currentPositionValid();
 	if (!region().containsPointInY(_posInVolume.y)) {
 		_currentPositionInvalid |= SAMPLER_INVALIDY;
 	} else {
@@ -391,17 +408,21 @@ void RawVolume::Sampler::movePositiveY(uint32_t offset) {
 	if (!bIsOldPositionValid) {
 		setPosition(_posInVolume);
 	} else if (currentPositionValid()) {
-		_currentVoxel += (intptr_t)(_volume->width() * offset);
+		_currentVoxel += (intptr_t)_strideY * offset;
 	} else {
 		_currentVoxel = nullptr;
 	}
 }
 
-void RawVolume::Sampler::movePositiveZ(uint32_t offset) {
-	const bool bIsOldPositionValid = currentPositionValid();
-
+template<bool Interior>
+void RawVolume::SamplerT<Interior>::movePositiveZ(uint32_t offset) {
 	_posInVolume.z += (int)offset;
+	if constexpr (Interior) {
+		_currentVoxel += (intptr_t)_strideZ * offset;
+		return;
+	}
 
+	const bool bIsOldPositionValid = currentPositionValid();
 	if (!region().containsPointInZ(_posInVolume.z)) {
 		_currentPositionInvalid |= SAMPLER_INVALIDZ;
 	} else {
@@ -412,13 +433,14 @@ void RawVolume::Sampler::movePositiveZ(uint32_t offset) {
 	if (!bIsOldPositionValid) {
 		setPosition(_posInVolume);
 	} else if (currentPositionValid()) {
-		_currentVoxel += (intptr_t)(_volume->width() * _volume->height() * offset);
+		_currentVoxel += (intptr_t)_strideZ * offset;
 	} else {
 		_currentVoxel = nullptr;
 	}
 }
 
-void RawVolume::Sampler::moveNegative(math::Axis axis, uint32_t offset) {
+template<bool Interior>
+void RawVolume::SamplerT<Interior>::moveNegative(math::Axis axis, uint32_t offset) {
 	switch (axis) {
 	case math::Axis::X:
 		moveNegativeX(offset);
@@ -434,11 +456,15 @@ void RawVolume::Sampler::moveNegative(math::Axis axis, uint32_t offset) {
 	}
 }
 
-void RawVolume::Sampler::moveNegativeX(uint32_t offset) {
-	const bool bIsOldPositionValid = currentPositionValid();
-
+template<bool Interior>
+void RawVolume::SamplerT<Interior>::moveNegativeX(uint32_t offset) {
 	_posInVolume.x -= (int)offset;
+	if constexpr (Interior) {
+		_currentVoxel -= (intptr_t)offset;
+		return;
+	}
 
+	const bool bIsOldPositionValid = currentPositionValid();
 	if (!region().containsPointInX(_posInVolume.x)) {
 		_currentPositionInvalid |= SAMPLER_INVALIDX;
 	} else {
@@ -455,11 +481,15 @@ void RawVolume::Sampler::moveNegativeX(uint32_t offset) {
 	}
 }
 
-void RawVolume::Sampler::moveNegativeY(uint32_t offset) {
-	const bool bIsOldPositionValid = currentPositionValid();
-
+template<bool Interior>
+void RawVolume::SamplerT<Interior>::moveNegativeY(uint32_t offset) {
 	_posInVolume.y -= (int)offset;
+	if constexpr (Interior) {
+		_currentVoxel -= (intptr_t)_strideY * offset;
+		return;
+	}
 
+	const bool bIsOldPositionValid = currentPositionValid();
 	if (!region().containsPointInY(_posInVolume.y)) {
 		_currentPositionInvalid |= SAMPLER_INVALIDY;
 	} else {
@@ -470,17 +500,21 @@ void RawVolume::Sampler::moveNegativeY(uint32_t offset) {
 	if (!bIsOldPositionValid) {
 		setPosition(_posInVolume);
 	} else if (currentPositionValid()) {
-		_currentVoxel -= (intptr_t)(_volume->width() * offset);
+		_currentVoxel -= (intptr_t)_strideY * offset;
 	} else {
 		_currentVoxel = nullptr;
 	}
 }
 
-void RawVolume::Sampler::moveNegativeZ(uint32_t offset) {
-	const bool bIsOldPositionValid = currentPositionValid();
-
+template<bool Interior>
+void RawVolume::SamplerT<Interior>::moveNegativeZ(uint32_t offset) {
 	_posInVolume.z -= (int)offset;
+	if constexpr (Interior) {
+		_currentVoxel -= (intptr_t)_strideZ * offset;
+		return;
+	}
 
+	const bool bIsOldPositionValid = currentPositionValid();
 	if (!region().containsPointInZ(_posInVolume.z)) {
 		_currentPositionInvalid |= SAMPLER_INVALIDZ;
 	} else {
@@ -491,10 +525,13 @@ void RawVolume::Sampler::moveNegativeZ(uint32_t offset) {
 	if (!bIsOldPositionValid) {
 		setPosition(_posInVolume);
 	} else if (currentPositionValid()) {
-		_currentVoxel -= (intptr_t)(_volume->width() * _volume->height() * offset);
+		_currentVoxel -= (intptr_t)_strideZ * offset;
 	} else {
 		_currentVoxel = nullptr;
 	}
 }
 
+template class RawVolume::SamplerT<false>;
+template class RawVolume::SamplerT<true>;
+
 } // namespace voxel
@@ -17,16 +17,27 @@ namespace voxel {
  */
 class RawVolume {
 public:
-	class Sampler {
+	/**
+	 * @brief Walks the voxels of the volume without any virtual calls
+	 *
+	 * The samplers of the volume wrappers derive from this and hide @c setVoxel() - they are always used by their
+	 * concrete type (e.g. @c typename Volume::Sampler) and thus resolved at compile time.
+	 *
+	 * @tparam Interior If @c true there are no bounds checks at all and the @c peekVoxel functions are plain pointer
+	 * offsets. Such a sampler may only be used if the position and the peeked neighbours are inside the volume region.
+	 * @sa Sampler
+	 * @sa InteriorSampler
+	 */
+	template<bool Interior>
+	class SamplerT {
 	private:
 		static const uint8_t SAMPLER_INVALIDX = 1 << 0;
 		static const uint8_t SAMPLER_INVALIDY = 1 << 1;
 		static const uint8_t SAMPLER_INVALIDZ = 1 << 2;
 
 	public:
-		Sampler(const RawVolume &volume);
-		Sampler(const RawVolume *volume);
-		virtual ~Sampler();
+		SamplerT(const RawVolume &volume);
+		SamplerT(const RawVolume *volume);
 
 		const Voxel &voxel() const;
 		const Region &region() const;
@@ -35,7 +46,7 @@ public:
 
 		bool setPosition(const glm::ivec3 &pos);
 		bool setPosition(int32_t x, int32_t y, int32_t z);
-		virtual bool setVoxel(const Voxel &voxel);
+		bool setVoxel(const Voxel &voxel);
 		const glm::ivec3 &position() const;
 
 		void movePositiveX(uint32_t offset = 1);
@@ -48,41 +59,52 @@ public:
 		void moveNegativeZ(uint32_t offset = 1);
 		void moveNegative(math::Axis axis, uint32_t offset = 1);
 
-		const Voxel &peekVoxel1nx1ny1nz() const;
-		const Voxel &peekVoxel1nx1ny0pz() const;
-		const Voxel &peekVoxel1nx1ny1pz() const;
-		const Voxel &peekVoxel1nx0py1nz() const;
-		const Voxel &peekVoxel1nx0py0pz() const;
-		const Voxel &peekVoxel1nx0py1pz() const;
-		const Voxel &peekVoxel1nx1py1nz() const;
-		const Voxel &peekVoxel1nx1py0pz() const;
-		const Voxel &peekVoxel1nx1py1pz() const;
-
-		const Voxel &peekVoxel0px1ny1nz() const;
-		const Voxel &peekVoxel0px1ny0pz() const;
-		const Voxel &peekVoxel0px1ny1pz() const;
-		const Voxel &peekVoxel0px0py1nz() const;
-		const Voxel &peekVoxel0px0py0pz() const;
-		const Voxel &peekVoxel0px0py1pz() const;
-		const Voxel &peekVoxel0px1py1nz() const;
-		const Voxel &peekVoxel0px1py0pz() const;
-		const Voxel &peekVoxel0px1py1pz() const;
-
-		const Voxel &peekVoxel1px1ny1nz() const;
-		const Voxel &peekVoxel1px1ny0pz() const;
-		const Voxel &peekVoxel1px1ny1pz() const;
-		const Voxel &peekVoxel1px0py1nz() const;
-		const Voxel &peekVoxel1px0py0pz() const;
-		const Voxel &peekVoxel1px0py1pz() const;
-		const Voxel &peekVoxel1px1py1nz() const;
-		const Voxel &peekVoxel1px1py0pz() const;
-		const Voxel &peekVoxel1px1py1pz() const;
+		/**
+		 * @brief Get the voxel relative to the current position - the offsets are known at compile time and only the
+		 * bounds checks of the axes that are not @c 0 are done
+		 */
+		template<int X, int Y, int Z>
+		const Voxel &peekVoxel() const;
+
+		const Voxel &peekVoxel1nx1ny1nz() const { return peekVoxel<-1, -1, -1>(); }
+		const Voxel &peekVoxel1nx1ny0pz() const { return peekVoxel<-1, -1, 0>(); }
+		const Voxel &peekVoxel1nx1ny1pz() const { return peekVoxel<-1, -1, 1>(); }
+		const Voxel &peekVoxel1nx0py1nz() const { return peekVoxel<-1, 0, -1>(); }
+		const Voxel &peekVoxel1nx0py0pz() const { return peekVoxel<-1, 0, 0>(); }
+		const Voxel &peekVoxel1nx0py1pz() const { return peekVoxel<-1, 0, 1>(); }
+		const Voxel &peekVoxel1nx1py1nz() const { return peekVoxel<-1, 1, -1>(); }
+		const Voxel &peekVoxel1nx1py0pz() const { return peekVoxel<-1, 1, 0>(); }
+		const Voxel &peekVoxel1nx1py1pz() const { return peekVoxel<-1, 1, 1>(); }
+
+		const Voxel &peekVoxel0px1ny1nz() const { return peekVoxel<0, -1, -1>(); }
+		const Voxel &peekVoxel0px1ny0pz() const { return peekVoxel<0, -1, 0>(); }
+		const Voxel &peekVoxel0px1ny1pz() const { return peekVoxel<0, -1, 1>(); }
+		const Voxel &peekVoxel0px0py1nz() const { return peekVoxel<0, 0, -1>(); }
+		const Voxel &peekVoxel0px0py0pz() const { return peekVoxel<0, 0, 0>(); }
+		const Voxel &peekVoxel0px0py1pz() const { return peekVoxel<0, 0, 1>(); }
+		const Voxel &peekVoxel0px1py1nz() const { return peekVoxel<0, 1, -1>(); }
+		const Voxel &peekVoxel0px1py0pz() const { return peekVoxel<0, 1, 0>(); }
+		const Voxel &peekVoxel0px1py1pz() const { return peekVoxel<0, 1, 1>(); }
+
+		const Voxel &peekVoxel1px1ny1nz() const { return peekVoxel<1, -1, -1>(); }
+		const Voxel &peekVoxel1px1ny0pz() const { return peekVoxel<1, -1, 0>(); }
+		const Voxel &peekVoxel1px1ny1pz() const { return peekVoxel<1, -1, 1>(); }
+		const Voxel &peekVoxel1px0py1nz() const { return peekVoxel<1, 0, -1>(); }
+		const Voxel &peekVoxel1px0py0pz() const { return peekVoxel<1, 0, 0>(); }
+		const Voxel &peekVoxel1px0py1pz() const { return peekVoxel<1, 0, 1>(); }
+		const Voxel &peekVoxel1px1py1nz() const { return peekVoxel<1, 1, -1>(); }
+		const Voxel &peekVoxel1px1py0pz() const { return peekVoxel<1, 1, 0>(); }
+		const Voxel &peekVoxel1px1py1pz() const { return peekVoxel<1, 1, 1>(); }
 
 	protected:
 		RawVolume *_volume;
 
 		voxel::Region _region;
 
+		/** The amount of voxels to skip in the data of the volume to get to the next row (y) and slice (z) */
+		int32_t _strideY;
+		int32_t _strideZ;
+
 		// The current position in the volume
 		glm::ivec3 _posInVolume{0, 0, 0};
 
@@ -93,6 +115,19 @@ public:
 		uint8_t _currentPositionInvalid = 0u;
 	};
 
+	/**
+	 * @brief The bounds checked sampler - positions outside of the region return the border value of the volume
+	 */
+	class Sampler : public SamplerT<false> {
+	public:
+		using SamplerT<false>::SamplerT;
+	};
+
+	/**
+	 * @brief Sampler for walks that are known to stay inside the volume region - see @c SamplerT
+	 */
+	using InteriorSampler = SamplerT<true>;
+
 	RawVolume(const Voxel *data, const voxel::Region &region);
 	RawVolume(Voxel *data, const voxel::Region &region);
 
@@ -259,264 +294,51 @@ inline const Voxel &RawVolume::voxel(const glm::ivec3 &pos) const {
 	return voxel(pos.x, pos.y, pos.z);
 }
 
-#define CAN_GO_NEG_X(val) ((val) > region.getLowerX())
-#define CAN_GO_POS_X(val) ((val) < region.getUpperX())
-#define CAN_GO_NEG_Y(val) ((val) > region.getLowerY())
-#define CAN_GO_POS_Y(val) ((val) < region.getUpperY())
-#define CAN_GO_NEG_Z(val) ((val) > region.getLowerZ())
-#define CAN_GO_POS_Z(val) ((val) < region.getUpperZ())
-
-inline const Region &RawVolume::Sampler::region() const {
+template<bool Interior>
+inline const Region &RawVolume::SamplerT<Interior>::region() const {
 	return _region;
 }
 
-inline const glm::ivec3 &RawVolume::Sampler::position() const {
+template<bool Interior>
+inline const glm::ivec3 &RawVolume::SamplerT<Interior>::position() const {
 	return _posInVolume;
 }
 
-inline const Voxel &RawVolume::Sampler::voxel() const {
+template<bool Interior>
+inline const Voxel &RawVolume::SamplerT<Interior>::voxel() const {
 	if (this->currentPositionValid()) {
 		return *_currentVoxel;
 	}
 	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z);
 }
 
-inline bool RawVolume::Sampler::currentPositionValid() const {
+template<bool Interior>
+inline bool RawVolume::SamplerT<Interior>::currentPositionValid() const {
+	if constexpr (Interior) {
+		return true;
+	}
 	return !_currentPositionInvalid;
 }
 
-inline bool RawVolume::Sampler::setPosition(const glm::ivec3 &v3dNewPos) {
+template<bool Interior>
+inline bool RawVolume::SamplerT<Interior>::setPosition(const glm::ivec3 &v3dNewPos) {
 	return setPosition(v3dNewPos.x, v3dNewPos.y, v3dNewPos.z);
 }
 
-inline const Voxel &RawVolume::Sampler::peekVoxel1nx1ny1nz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
-		CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - 1 - region.getWidthInVoxels() - region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1nx1ny0pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y)) {
-		return *(_currentVoxel - 1 - region.getWidthInVoxels());
-	}
-	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1nx1ny1pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
-		CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - 1 - region.getWidthInVoxels() + region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1nx0py1nz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - 1 - region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y, this->_posInVolume.z - 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1nx0py0pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x)) {
-		return *(_currentVoxel - 1);
-	}
-	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y, this->_posInVolume.z);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1nx0py1pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - 1 + region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y, this->_posInVolume.z + 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1nx1py1nz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
-		CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - 1 + region.getWidthInVoxels() - region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1nx1py0pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y)) {
-		return *(_currentVoxel - 1 + region.getWidthInVoxels());
-	}
-	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1nx1py1pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
-		CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - 1 + region.getWidthInVoxels() + region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel0px1ny1nz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_Y(this->_posInVolume.y) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - region.getWidthInVoxels() - region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel0px1ny0pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_Y(this->_posInVolume.y)) {
-		return *(_currentVoxel - region.getWidthInVoxels());
-	}
-	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel0px1ny1pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_Y(this->_posInVolume.y) && CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - region.getWidthInVoxels() + region.stride());
+template<bool Interior>
+template<int X, int Y, int Z>
+inline const Voxel &RawVolume::SamplerT<Interior>::peekVoxel() const {
+	static_assert(X >= -1 && X <= 1 && Y >= -1 && Y <= 1 && Z >= -1 && Z <= 1, "Only the direct neighbours can be peeked");
+	if constexpr (!Interior) {
+		const glm::ivec3 &pos = this->_posInVolume;
+		if (!this->currentPositionValid() || (X < 0 && pos.x <= _region.getLowerX()) ||
+			(X > 0 && pos.x >= _region.getUpperX()) || (Y < 0 && pos.y <= _region.getLowerY()) ||
+			(Y > 0 && pos.y >= _region.getUpperY()) || (Z < 0 && pos.z <= _region.getLowerZ()) ||
+			(Z > 0 && pos.z >= _region.getUpperZ())) {
+			return this->_volume->voxel(pos.x + X, pos.y + Y, pos.z + Z);
+		}
 	}
-	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
+	return *(_currentVoxel + X + Y * _strideY + Z * _strideZ);
 }
 
-inline const Voxel &RawVolume::Sampler::peekVoxel0px0py1nz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z - 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel0px0py0pz() const {
-	if (this->currentPositionValid()) {
-		return *_currentVoxel;
-	}
-	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel0px0py1pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z + 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel0px1py1nz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_Y(this->_posInVolume.y) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + region.getWidthInVoxels() - region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel0px1py0pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_Y(this->_posInVolume.y)) {
-		return *(_currentVoxel + region.getWidthInVoxels());
-	}
-	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel0px1py1pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_Y(this->_posInVolume.y) && CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + region.getWidthInVoxels() + region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1px1ny1nz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
-		CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + 1 - region.getWidthInVoxels() - region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1px1ny0pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y)) {
-		return *(_currentVoxel + 1 - region.getWidthInVoxels());
-	}
-	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1px1ny1pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
-		CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + 1 - region.getWidthInVoxels() + region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1px0py1nz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + 1 - region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y, this->_posInVolume.z - 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1px0py0pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x)) {
-		return *(_currentVoxel + 1);
-	}
-	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y, this->_posInVolume.z);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1px0py1pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + 1 + region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y, this->_posInVolume.z + 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1px1py1nz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
-		CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + 1 + region.getWidthInVoxels() - region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1px1py0pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y)) {
-		return *(_currentVoxel + 1 + region.getWidthInVoxels());
-	}
-	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z);
-}
-
-inline const Voxel &RawVolume::Sampler::peekVoxel1px1py1pz() const {
-	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
-		CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + 1 + region.getWidthInVoxels() + region.stride());
-	}
-	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
-}
-
-#undef CAN_GO_NEG_X
-#undef CAN_GO_POS_X
-#undef CAN_GO_NEG_Y
-#undef CAN_GO_POS_Y
-#undef CAN_GO_NEG_Z
-#undef CAN_GO_POS_Z
-
 } // namespace voxel
@@ -39,7 +39,10 @@ public:
 			_region = volume.region();
 		}
 
-		bool setVoxel(const Voxel& voxel) override {
+		/**
+		 * @note Hides the setVoxel() of the base sampler to track the dirty region
+		 */
+		bool setVoxel(const Voxel& voxel) {
 			if (Super::setVoxel(voxel)) {
 				voxel::Region &dirtyRegion = _rawVolumeWrapper->_dirtyRegion;
 				const glm::ivec3 &pos = position();
@@ -33,16 +33,16 @@ public:
 	public:
 		Sampler(const SparseVolume &volume);
 		Sampler(const SparseVolume *volume);
-		virtual ~Sampler();
+		~Sampler();
 
 		const Voxel &voxel() const;
-		virtual const Region region() const;
+		const Region region() const;
 
 		bool currentPositionValid() const;
 
 		bool setPosition(const glm::ivec3 &pos);
 		bool setPosition(int32_t x, int32_t y, int32_t z);
-		virtual bool setVoxel(const Voxel &voxel);
+		bool setVoxel(const Voxel &voxel);
 		const glm::ivec3 &position() const;
 
 		void movePositiveX(uint32_t offset = 1);
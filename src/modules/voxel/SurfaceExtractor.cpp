@@ -3,30 +3,48 @@
  */
 
 #include "SurfaceExtractor.h"
+#include "app/App.h"
+#include "core/GLM.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicMap.h"
+#include "core/concurrent/TaskGroup.h"
+#include "voxel/BrickVolume.h"
+#include "voxel/ChunkMesh.h"
 #include "voxel/MaterialColor.h"
+#include "voxel/PagedVolume.h"
 #include "voxel/Region.h"
 #include "voxel/RawVolume.h"
+#include "voxel/private/BinarySurfaceExtractor.h"
 #include "voxel/private/CubicSurfaceExtractor.h"
 #include "voxel/private/MarchingCubesSurfaceExtractor.h"
 
 namespace voxel {
 
-SurfaceExtractionContext buildCubicContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
-										   const glm::ivec3 &translate, bool mergeQuads, bool reuseVertices,
-										   bool ambientOcclusion, bool optimize) {
-	return SurfaceExtractionContext(volume, getPalette(), region, mesh, translate, SurfaceExtractionType::Cubic,
-									mergeQuads, reuseVertices, ambientOcclusion, optimize);
+template<class Volume>
+SurfaceExtractionContextT<Volume> buildCubicContext(const Volume *volume, const Region &region, ChunkMesh &mesh,
+													const glm::ivec3 &translate, bool mergeQuads, bool reuseVertices,
+													bool ambientOcclusion, bool optimize) {
+	return SurfaceExtractionContextT<Volume>(volume, getPalette(), region, mesh, translate,
+											 SurfaceExtractionType::Cubic, mergeQuads, reuseVertices,
+											 ambientOcclusion, optimize);
 }
 
-SurfaceExtractionContext buildMarchingCubesContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
-												   const palette::Palette &palette, bool optimize) {
-	return SurfaceExtractionContext(volume, palette, region, mesh, glm::ivec3(0), SurfaceExtractionType::MarchingCubes,
-									false, false, false, optimize);
+template<class Volume>
+SurfaceExtractionContextT<Volume> buildMarchingCubesContext(const Volume *volume, const Region &region,
+															ChunkMesh &mesh, const palette::Palette &palette,
+															bool optimize) {
+	return SurfaceExtractionContextT<Volume>(volume, palette, region, mesh, glm::ivec3(0),
+											 SurfaceExtractionType::MarchingCubes, false, false, false, optimize);
 }
 
-void extractSurface(SurfaceExtractionContext &ctx) {
+template<class Volume>
+void extractSurface(SurfaceExtractionContextT<Volume> &ctx) {
 	if (ctx.type == SurfaceExtractionType::MarchingCubes) {
 		voxel::extractMarchingCubesMesh(ctx.volume, ctx.palette, ctx.region, &ctx.mesh, ctx.optimize);
+	} else if (ctx.type == SurfaceExtractionType::Binary) {
+		voxel::extractBinaryMesh(ctx.volume, ctx.region, &ctx.mesh, ctx.translate, ctx.mergeQuads, ctx.reuseVertices,
+								 ctx.optimize);
 	} else {
 		voxel::extractCubicMesh(ctx.volume, ctx.region, &ctx.mesh, ctx.translate, ctx.mergeQuads, ctx.reuseVertices,
 								ctx.ambientOcclusion, ctx.optimize);
@@ -40,7 +58,177 @@ voxel::SurfaceExtractionContext createContext(voxel::SurfaceExtractionType type,
 	if (type == voxel::SurfaceExtractionType::MarchingCubes) {
 		return voxel::buildMarchingCubesContext(volume, region, mesh, palette, optimize);
 	}
+	if (type == voxel::SurfaceExtractionType::Binary) {
+		return voxel::SurfaceExtractionContext(volume, palette, region, mesh, translate, type, mergeQuads,
+											   reuseVertices, false, optimize);
+	}
 	return voxel::buildCubicContext(volume, region, mesh, translate, mergeQuads, reuseVertices, ambientOcclusion, optimize);
 }
 
+using SeamVertices = core::DynamicMap<glm::ivec4, IndexType, 1031, glm::hash<glm::ivec4>>;
+
+static inline glm::ivec4 seamKey(const VoxelVertex &vertex) {
+	const int attributes = (int)vertex.colorIndex | ((int)vertex.normalIndex << 8) | ((int)vertex.info << 16);
+	return glm::ivec4((int)vertex.position.x, (int)vertex.position.y, attributes, 0);
+}
+
+/**
+ * @brief Appends the slab mesh to the target mesh. Vertices on the lower seam plane are looked up in the vertices that
+ * the previous slab put on that plane, vertices on the upper seam plane are recorded for the next slab.
+ */
+static void appendSlabMesh(Mesh &target, const Mesh &slab, bool reuseVertices, float lowerSeamZ,
+						   const SeamVertices &lowerSeam, float upperSeamZ, SeamVertices &upperSeam) {
+	const VertexArray &vertices = slab.getVertexVector();
+	const IndexArray &indices = slab.getIndexVector();
+	core::DynamicArray<IndexType> remap(vertices.size());
+	target.getVertexVector().reserve(target.getNoOfVertices() + vertices.size());
+	target.getIndexVector().reserve(target.getNoOfIndices() + indices.size());
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		const VoxelVertex &vertex = vertices[i];
+		if (reuseVertices && vertex.position.z == lowerSeamZ) {
+			auto iter = lowerSeam.find(seamKey(vertex));
+			if (iter != lowerSeam.end()) {
+				remap[i] = iter->second;
+				continue;
+			}
+		}
+		remap[i] = target.addVertex(vertex);
+		if (reuseVertices && vertex.position.z == upperSeamZ) {
+			upperSeam.put(seamKey(vertex), remap[i]);
+		}
+	}
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		target.addTriangle(remap[indices[i]], remap[indices[i + 1]], remap[indices[i + 2]]);
+	}
+}
+
+/**
+ * @brief Splits the region of the context into slabs along the z axis, runs the given functor for each slab on the app
+ * thread pool and stitches the slab meshes into the mesh of the context
+ * @return @c false if the region is not split into slabs - nothing was extracted in this case
+ */
+template<class Volume, class ExtractSlab>
+static bool extractSlabs(SurfaceExtractionContextT<Volume> &ctx, int slabDepth, const ExtractSlab &extractSlab) {
+	const Region &region = ctx.region;
+	const int depth = region.getDepthInVoxels();
+	if (slabDepth <= 0) {
+		const int threads = (int)app::App::getInstance()->threadPool().size();
+		slabDepth = glm::max(16, (depth + threads - 1) / glm::max(1, threads));
+	}
+	if (ctx.type == SurfaceExtractionType::MarchingCubes || depth <= slabDepth) {
+		return false;
+	}
+
+	const int slabs = (depth + slabDepth - 1) / slabDepth;
+	core::DynamicArray<Region> slabRegions;
+	slabRegions.reserve(slabs);
+	for (int i = 0; i < slabs; ++i) {
+		const int lowerZ = region.getLowerZ() + i * slabDepth;
+		const int upperZ = glm::min(region.getUpperZ(), lowerZ + slabDepth - 1);
+		glm::ivec3 mins = region.getLowerCorner();
+		glm::ivec3 maxs = region.getUpperCorner();
+		mins.z = lowerZ;
+		maxs.z = upperZ;
+		slabRegions.emplace_back(mins, maxs);
+	}
+
+	core::DynamicArray<ChunkMesh> slabMeshes;
+	slabMeshes.resize(slabs);
+
+	// the waiting thread executes pending tasks - this doesn't dead lock if this is called from a worker of the same
+	// pool (e.g. the per-node mesh extraction of the mesh formats)
+	{
+		core::TaskGroup group(app::App::getInstance()->threadPool());
+		for (int i = 0; i < slabs; ++i) {
+			group.run([&ctx, &extractSlab, &slabRegions, &slabMeshes, i]() {
+				const Region &slabRegion = slabRegions[i];
+				// the slab vertices are relative to the lower corner of the whole region
+				glm::ivec3 translate = ctx.translate;
+				translate.z += slabRegion.getLowerZ() - ctx.region.getLowerZ();
+				extractSlab(slabRegion, slabMeshes[i], translate, false);
+			});
+		}
+		group.wait();
+	}
+
+	core_trace_scoped(StitchSlabs);
+	ctx.mesh.clear();
+	ctx.mesh.setOffset(region.getLowerCorner());
+	for (int m = 0; m < ChunkMesh::Meshes; ++m) {
+		SeamVertices lowerSeam;
+		for (int i = 0; i < slabs; ++i) {
+			const float lowerSeamZ = (float)(slabRegions[i].getLowerZ() - region.getLowerZ() + ctx.translate.z);
+			const float upperSeamZ = lowerSeamZ + (float)slabRegions[i].getDepthInVoxels();
+			SeamVertices upperSeam;
+			appendSlabMesh(ctx.mesh.mesh[m], slabMeshes[i].mesh[m], ctx.reuseVertices, lowerSeamZ, lowerSeam,
+						   upperSeamZ, upperSeam);
+			lowerSeam = core::move(upperSeam);
+		}
+	}
+	if (ctx.optimize) {
+		ctx.mesh.optimize();
+	}
+	ctx.mesh.compressIndices();
+	return true;
+}
+
+template<class Volume>
+void extractSurfaceParallel(SurfaceExtractionContextT<Volume> &ctx, int slabDepth) {
+	core_trace_scoped(ExtractSurfaceParallel);
+	auto extractSlab = [&ctx](const Region &slabRegion, ChunkMesh &mesh, const glm::ivec3 &translate, bool optimize) {
+		SurfaceExtractionContextT<Volume> slabCtx(ctx.volume, ctx.palette, slabRegion, mesh, translate, ctx.type,
+												  ctx.mergeQuads, ctx.reuseVertices, ctx.ambientOcclusion, optimize);
+		extractSurface(slabCtx);
+	};
+	if (!extractSlabs(ctx, slabDepth, extractSlab)) {
+		extractSurface(ctx);
+	}
+}
+
+void extractSurfaceParallelBricks(SurfaceExtractionContext &ctx, int slabDepth) {
+	core_trace_scoped(ExtractSurfaceParallelBricks);
+	if (ctx.type != SurfaceExtractionType::Cubic) {
+		extractSurfaceParallel(ctx, slabDepth);
+		return;
+	}
+	auto extractSlab = [&ctx](const Region &slabRegion, ChunkMesh &mesh, const glm::ivec3 &translate, bool optimize) {
+		// the extractor peeks one voxel around the slab - everything else is not copied
+		Region copyRegion = slabRegion;
+		copyRegion.grow(1);
+		if (!copyRegion.cropTo(ctx.volume->region())) {
+			SurfaceExtractionContext slabCtx(ctx.volume, ctx.palette, slabRegion, mesh, translate, ctx.type,
+											 ctx.mergeQuads, ctx.reuseVertices, ctx.ambientOcclusion, optimize);
+			extractSurface(slabCtx);
+			return;
+		}
+		const BrickVolume brickVolume(*ctx.volume, copyRegion);
+		SurfaceExtractionContextT<BrickVolume> slabCtx(&brickVolume, ctx.palette, slabRegion, mesh, translate,
+													   ctx.type, ctx.mergeQuads, ctx.reuseVertices,
+													   ctx.ambientOcclusion, optimize);
+		extractSurface(slabCtx);
+	};
+	if (!extractSlabs(ctx, slabDepth, extractSlab)) {
+		extractSlab(ctx.region, ctx.mesh, ctx.translate, ctx.optimize);
+	}
+}
+
+template SurfaceExtractionContextT<RawVolume> buildCubicContext(const RawVolume *, const Region &, ChunkMesh &,
+																const glm::ivec3 &, bool, bool, bool, bool);
+template SurfaceExtractionContextT<BrickVolume> buildCubicContext(const BrickVolume *, const Region &, ChunkMesh &,
+																  const glm::ivec3 &, bool, bool, bool, bool);
+template SurfaceExtractionContextT<PagedVolume> buildCubicContext(const PagedVolume *, const Region &, ChunkMesh &,
+																  const glm::ivec3 &, bool, bool, bool, bool);
+template SurfaceExtractionContextT<RawVolume> buildMarchingCubesContext(const RawVolume *, const Region &, ChunkMesh &,
+																		const palette::Palette &, bool);
+template SurfaceExtractionContextT<BrickVolume> buildMarchingCubesContext(const BrickVolume *, const Region &,
+																		  ChunkMesh &, const palette::Palette &, bool);
+template SurfaceExtractionContextT<PagedVolume> buildMarchingCubesContext(const PagedVolume *, const Region &,
+																		  ChunkMesh &, const palette::Palette &, bool);
+template void extractSurface(SurfaceExtractionContextT<RawVolume> &);
+template void extractSurface(SurfaceExtractionContextT<BrickVolume> &);
+template void extractSurface(SurfaceExtractionContextT<PagedVolume> &);
+template void extractSurfaceParallel(SurfaceExtractionContextT<RawVolume> &, int);
+template void extractSurfaceParallel(SurfaceExtractionContextT<BrickVolume> &, int);
+template void extractSurfaceParallel(SurfaceExtractionContextT<PagedVolume> &, int);
+
 } // namespace voxel
@@ -12,37 +12,82 @@ class Palette;
 
 namespace voxel {
 class RawVolume;
+class BrickVolume;
+class PagedVolume;
 class Region;
 struct ChunkMesh;
 
-enum class SurfaceExtractionType { Cubic, MarchingCubes, Max };
+/**
+ * @brief The mesh extraction algorithms
+ * @li @c Cubic The cubic extractor with ambient occlusion
+ * @li @c MarchingCubes Smooth meshes with normals
+ * @li @c Binary Cubic meshes that are extracted on bit masks - much faster than @c Cubic, but without ambient
+ * occlusion
+ */
+enum class SurfaceExtractionType { Cubic, MarchingCubes, Binary, Max };
 
-struct SurfaceExtractionContext {
-	SurfaceExtractionContext(const RawVolume *_volume, const palette::Palette &_palette, const Region &_region,
-							 ChunkMesh &_mesh, const glm::ivec3 &_translate, SurfaceExtractionType _type,
-							 bool _mergeQuads, bool _reuseVertices, bool _ambientOcclusion, bool _optimize)
+/**
+ * @brief The parameters for the surface extraction
+ * @note The extraction functions are instantiated for @c RawVolume, @c BrickVolume and @c PagedVolume
+ */
+template<class Volume>
+struct SurfaceExtractionContextT {
+	SurfaceExtractionContextT(const Volume *_volume, const palette::Palette &_palette, const Region &_region,
+							  ChunkMesh &_mesh, const glm::ivec3 &_translate, SurfaceExtractionType _type,
+							  bool _mergeQuads, bool _reuseVertices, bool _ambientOcclusion, bool _optimize)
 		: volume(_volume), palette(_palette), region(_region), mesh(_mesh), translate(_translate), type(_type),
 		  mergeQuads(_mergeQuads), reuseVertices(_reuseVertices), ambientOcclusion(_ambientOcclusion), optimize(_optimize) {
 	}
-	const RawVolume *volume;
+	const Volume *volume;
 	const palette::Palette &palette; // used only for MarchingCubes
 	const Region &region;
 	ChunkMesh &mesh;
 	const glm::ivec3 translate;
 	const SurfaceExtractionType type;
-	const bool mergeQuads;		 // used only for Cubic
-	const bool reuseVertices;	 // used only for Cubic
+	const bool mergeQuads;		 // used only for Cubic and Binary
+	const bool reuseVertices;	 // used only for Cubic and Binary
 	const bool ambientOcclusion; // used only for Cubic
 	const bool optimize;
 };
 
-SurfaceExtractionContext buildCubicContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
-										   const glm::ivec3 &translate = glm::ivec3(0), bool mergeQuads = true,
-										   bool reuseVertices = true, bool ambientOcclusion = true, bool optimize = false);
-SurfaceExtractionContext buildMarchingCubesContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
-												   const palette::Palette &palette, bool optimize = false);
+using SurfaceExtractionContext = SurfaceExtractionContextT<RawVolume>;
+
+template<class Volume>
+SurfaceExtractionContextT<Volume> buildCubicContext(const Volume *volume, const Region &region, ChunkMesh &mesh,
+													const glm::ivec3 &translate = glm::ivec3(0), bool mergeQuads = true,
+													bool reuseVertices = true, bool ambientOcclusion = true,
+													bool optimize = false);
+template<class Volume>
+SurfaceExtractionContextT<Volume> buildMarchingCubesContext(const Volume *volume, const Region &region,
+															ChunkMesh &mesh, const palette::Palette &palette,
+															bool optimize = false);
+
+template<class Volume>
+void extractSurface(SurfaceExtractionContextT<Volume> &ctx);
 
-void extractSurface(SurfaceExtractionContext &ctx);
+
+/**
+ * @brief Splits the region of the given context into slabs along the z axis, extracts them in parallel on the app
+ * thread pool and stitches the results into the mesh of the context. Vertices on the slab seams are shared if
+ * @c SurfaceExtractionContext::reuseVertices is enabled.
+ *
+ * @note Quads are not merged across slab borders - the mesh is still valid, but might contain a few more quads than
+ * the mesh that @c extractSurface() would produce for the same region.
+ * @note Only supported for @c SurfaceExtractionType::Cubic and @c SurfaceExtractionType::Binary - other types fall back
+ * to @c extractSurface()
+ * @param slabDepth The amount of voxels in z direction for each slab. If @c 0 the depth is chosen by the amount of
+ * threads in the pool.
+ */
+template<class Volume>
+void extractSurfaceParallel(SurfaceExtractionContextT<Volume> &ctx, int slabDepth = 0);
+
+/**
+ * @brief Same as @c extractSurfaceParallel() - but every slab of the cubic extraction copies its part of the volume
+ * into a @c BrickVolume first. The neighbour peeks of the ambient occlusion profit from the brick layout.
+ * @note Only the slabs that are currently extracted are copied - never the whole volume at once
+ * @note Other extraction types than @c SurfaceExtractionType::Cubic are extracted from the @c RawVolume
+ */
+void extractSurfaceParallelBricks(SurfaceExtractionContext &ctx, int slabDepth = 0);
 
 voxel::SurfaceExtractionContext createContext(voxel::SurfaceExtractionType type, const voxel::RawVolume *volume,
 											  const voxel::Region &region, const palette::Palette &palette,
@@ -4,6 +4,7 @@
 
 #include "app/benchmark/AbstractBenchmark.h"
 #include "voxel/ChunkMesh.h"
+#include "voxel/MaterialColor.h"
 #include "voxel/RawVolume.h"
 #include "voxel/SurfaceExtractor.h"
 
@@ -105,6 +106,21 @@ BENCHMARK_DEFINE_F(SurfaceExtractorBenchmark, Visit)(benchmark::State &state) {
 	}
 }
 
+BENCHMARK_DEFINE_F(SurfaceExtractorBenchmark, Binary)(benchmark::State &state) {
+	for (auto _ : state) {
+		const bool mergeQuads = true;
+		const bool reuseVertices = true;
+
+		voxel::ChunkMesh mesh;
+
+		voxel::SurfaceExtractionContext ctx =
+			voxel::createContext(voxel::SurfaceExtractionType::Binary, &v, v.region(), voxel::getPalette(), mesh,
+								 glm::ivec3(0), mergeQuads, reuseVertices);
+		voxel::extractSurface(ctx);
+	}
+}
+
 BENCHMARK_REGISTER_F(SurfaceExtractorBenchmark, Visit);
+BENCHMARK_REGISTER_F(SurfaceExtractorBenchmark, Binary);
 
 BENCHMARK_MAIN();
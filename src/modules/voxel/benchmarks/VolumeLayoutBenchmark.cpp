@@ -0,0 +1,189 @@
+/**
+ * @file
+ * @brief Compares the linear layout of the @c RawVolume with the brick layout of the @c BrickVolume
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/ScopedPtr.h"
+#include "voxel/BrickVolume.h"
+#include "voxel/ChunkMesh.h"
+#include "voxel/MaterialColor.h"
+#include "voxel/RawVolume.h"
+#include "voxel/SurfaceExtractor.h"
+
+class VolumeLayoutBenchmark : public app::AbstractBenchmark {
+protected:
+	const voxel::Region _region{0, 127};
+	core::ScopedPtr<voxel::RawVolume> _raw;
+	core::ScopedPtr<voxel::BrickVolume> _brick;
+
+public:
+	void SetUp(::benchmark::State &state) override {
+		app::AbstractBenchmark::SetUp(state);
+		_raw = new voxel::RawVolume(_region);
+		// a hilly terrain with a few caves - a lot of surface voxels and a solid interior
+		for (int z = 0; z <= _region.getUpperZ(); ++z) {
+			for (int x = 0; x <= _region.getUpperX(); ++x) {
+				const int height = 48 + ((x * 7 + z * 13) % 23) + ((x * z) % 11);
+				for (int y = 0; y < height; ++y) {
+					if ((x * 31 + y * 17 + z * 11) % 37 == 0) {
+						continue;
+					}
+					_raw->setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, 1 + (y & 31)));
+				}
+			}
+		}
+		_brick = new voxel::BrickVolume(*_raw);
+	}
+
+	void TearDown(::benchmark::State &state) override {
+		_raw = nullptr;
+		_brick = nullptr;
+		app::AbstractBenchmark::TearDown(state);
+	}
+};
+
+/**
+ * @brief Counts the solid voxels that are fully enclosed by solid neighbours - touches the whole 3x3x3 neighbourhood
+ * for every voxel
+ */
+template<class Volume>
+static int countEnclosedVoxels(const Volume &volume) {
+	const voxel::Region &region = volume.region();
+	typename Volume::Sampler sampler(volume);
+	int count = 0;
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			sampler.setPosition(region.getLowerX(), y, z);
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				if (!voxel::isAir(sampler.voxel().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1nx1ny1nz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel0px1ny1nz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1px1ny1nz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1nx0py1nz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel0px0py1nz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1px0py1nz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1nx1py1nz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel0px1py1nz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1px1py1nz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1nx1ny0pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel0px1ny0pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1px1ny0pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1nx0py0pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1px0py0pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1nx1py0pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel0px1py0pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1px1py0pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1nx1ny1pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel0px1ny1pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1px1ny1pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1nx0py1pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel0px0py1pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1px0py1pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1nx1py1pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel0px1py1pz().getMaterial()) &&
+					!voxel::isAir(sampler.peekVoxel1px1py1pz().getMaterial())) {
+					++count;
+				}
+				sampler.movePositiveX();
+			}
+		}
+	}
+	return count;
+}
+
+/**
+ * @brief Walks the volume along the y axis in the inner loop - the worst case for the linear layout
+ */
+template<class Volume>
+static int countSurfaceVoxelsColumnMajor(const Volume &volume) {
+	const voxel::Region &region = volume.region();
+	typename Volume::Sampler sampler(volume);
+	int count = 0;
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+			sampler.setPosition(x, region.getLowerY(), z);
+			for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				if (!voxel::isAir(sampler.voxel().getMaterial()) &&
+					(voxel::isAir(sampler.peekVoxel1nx0py0pz().getMaterial()) ||
+					 voxel::isAir(sampler.peekVoxel1px0py0pz().getMaterial()) ||
+					 voxel::isAir(sampler.peekVoxel0px1ny0pz().getMaterial()) ||
+					 voxel::isAir(sampler.peekVoxel0px1py0pz().getMaterial()) ||
+					 voxel::isAir(sampler.peekVoxel0px0py1nz().getMaterial()) ||
+					 voxel::isAir(sampler.peekVoxel0px0py1pz().getMaterial()))) {
+					++count;
+				}
+				sampler.movePositiveY();
+			}
+		}
+	}
+	return count;
+}
+
+BENCHMARK_DEFINE_F(VolumeLayoutBenchmark, ExtractCubicRaw)(benchmark::State &state) {
+	for (auto _ : state) {
+		voxel::ChunkMesh mesh;
+		voxel::SurfaceExtractionContext ctx = voxel::buildCubicContext<voxel::RawVolume>(_raw, _region, mesh);
+		voxel::extractSurface(ctx);
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeLayoutBenchmark, ExtractCubicBrick)(benchmark::State &state) {
+	for (auto _ : state) {
+		voxel::ChunkMesh mesh;
+		voxel::SurfaceExtractionContextT<voxel::BrickVolume> ctx =
+			voxel::buildCubicContext<voxel::BrickVolume>(_brick, _region, mesh);
+		voxel::extractSurface(ctx);
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeLayoutBenchmark, ExtractMarchingCubesRaw)(benchmark::State &state) {
+	for (auto _ : state) {
+		voxel::ChunkMesh mesh;
+		voxel::SurfaceExtractionContext ctx =
+			voxel::buildMarchingCubesContext<voxel::RawVolume>(_raw, _region, mesh, voxel::getPalette());
+		voxel::extractSurface(ctx);
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeLayoutBenchmark, ExtractMarchingCubesBrick)(benchmark::State &state) {
+	for (auto _ : state) {
+		voxel::ChunkMesh mesh;
+		voxel::SurfaceExtractionContextT<voxel::BrickVolume> ctx =
+			voxel::buildMarchingCubesContext<voxel::BrickVolume>(_brick, _region, mesh, voxel::getPalette());
+		voxel::extractSurface(ctx);
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeLayoutBenchmark, VisitNeighboursRaw)(benchmark::State &state) {
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(countEnclosedVoxels(*_raw));
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeLayoutBenchmark, VisitNeighboursBrick)(benchmark::State &state) {
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(countEnclosedVoxels(*_brick));
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeLayoutBenchmark, VisitColumnsRaw)(benchmark::State &state) {
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(countSurfaceVoxelsColumnMajor(*_raw));
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeLayoutBenchmark, VisitColumnsBrick)(benchmark::State &state) {
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(countSurfaceVoxelsColumnMajor(*_brick));
+	}
+}
+
+BENCHMARK_REGISTER_F(VolumeLayoutBenchmark, ExtractCubicRaw);
+BENCHMARK_REGISTER_F(VolumeLayoutBenchmark, ExtractCubicBrick);
+BENCHMARK_REGISTER_F(VolumeLayoutBenchmark, ExtractMarchingCubesRaw);
+BENCHMARK_REGISTER_F(VolumeLayoutBenchmark, ExtractMarchingCubesBrick);
+BENCHMARK_REGISTER_F(VolumeLayoutBenchmark, VisitNeighboursRaw);
+BENCHMARK_REGISTER_F(VolumeLayoutBenchmark, VisitNeighboursBrick);
+BENCHMARK_REGISTER_F(VolumeLayoutBenchmark, VisitColumnsRaw);
+BENCHMARK_REGISTER_F(VolumeLayoutBenchmark, VisitColumnsBrick);
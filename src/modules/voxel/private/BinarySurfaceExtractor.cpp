@@ -0,0 +1,322 @@
+/**
+ * @file
+ */
+
+#include "BinarySurfaceExtractor.h"
+#include "core/Bits.h"
+#include "core/GLM.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicMap.h"
+#include "voxel/ChunkMesh.h"
+#include "voxel/Face.h"
+#include "voxel/BrickVolume.h"
+#include "voxel/PagedVolume.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Region.h"
+#include "voxel/Voxel.h"
+#include "voxel/VoxelVertex.h"
+#include <glm/vec3.hpp>
+
+namespace voxel {
+
+namespace {
+
+/**
+ * @brief One bit per voxel - the x axis is packed into 64 bit words, one column of words per y and z
+ *
+ * The masks cover the region plus one voxel on the lower side of each axis. Index @c 0 is the voxel in front
+ * of the region, index @c 1 is the lower corner of the region.
+ */
+struct BitColumns {
+	int words = 0;
+	glm::ivec3 size{0};
+	core::DynamicArray<uint64_t> bits;
+
+	void init(const glm::ivec3 &paddedSize) {
+		size = paddedSize;
+		words = (size.x + 63) / 64;
+		bits.resize((size_t)words * size.y * size.z);
+		bits.fill(0u);
+	}
+
+	inline uint64_t *column(int y, int z) {
+		return &bits[((size_t)z * size.y + y) * words];
+	}
+
+	inline const uint64_t *column(int y, int z) const {
+		return &bits[((size_t)z * size.y + y) * words];
+	}
+
+	inline void set(int x, int y, int z) {
+		column(y, z)[x >> 6] |= 1ull << (x & 63);
+	}
+
+	inline bool test(const glm::ivec3 &pos) const {
+		return (column(pos.y, pos.z)[pos.x >> 6] >> (pos.x & 63)) & 1u;
+	}
+
+	inline void reset(const glm::ivec3 &pos) {
+		column(pos.y, pos.z)[pos.x >> 6] &= ~(1ull << (pos.x & 63));
+	}
+};
+
+using VertexCache = core::DynamicMap<glm::ivec4, IndexType, 1031, glm::hash<glm::ivec4>>;
+
+} // namespace
+
+/**
+ * @brief Computes the faces of the given direction for all voxels of the region
+ * @param[in] solid The occupancy of the voxels that produce a face
+ * @param[in] valid The bits of a column that belong to the region
+ */
+static void computeFaces(const BitColumns &solid, const core::DynamicArray<uint64_t> &valid, FaceNames face,
+						 BitColumns &faces) {
+	core_trace_scoped(ComputeFaces);
+	faces.bits.fill(0u);
+	const int words = solid.words;
+	for (int z = 1; z < solid.size.z; ++z) {
+		for (int y = 1; y < solid.size.y; ++y) {
+			const uint64_t *cur = solid.column(y, z);
+			uint64_t *out = faces.column(y, z);
+			switch (face) {
+			case FaceNames::NegativeX:
+			case FaceNames::PositiveX: {
+				uint64_t carry = 0u;
+				for (int k = 0; k < words; ++k) {
+					// the bit at x holds the voxel at x - 1
+					const uint64_t shifted = (cur[k] << 1) | carry;
+					carry = cur[k] >> 63;
+					if (face == FaceNames::NegativeX) {
+						out[k] = cur[k] & ~shifted & valid[k];
+					} else {
+						out[k] = shifted & ~cur[k] & valid[k];
+					}
+				}
+				break;
+			}
+			case FaceNames::NegativeY:
+			case FaceNames::PositiveY:
+			case FaceNames::NegativeZ:
+			case FaceNames::PositiveZ: {
+				const bool yAxis = face == FaceNames::NegativeY || face == FaceNames::PositiveY;
+				const uint64_t *prev = yAxis ? solid.column(y - 1, z) : solid.column(y, z - 1);
+				if (isNegativeFace(face)) {
+					for (int k = 0; k < words; ++k) {
+						out[k] = cur[k] & ~prev[k] & valid[k];
+					}
+				} else {
+					for (int k = 0; k < words; ++k) {
+						out[k] = prev[k] & ~cur[k] & valid[k];
+					}
+				}
+				break;
+			}
+			default:
+				break;
+			}
+		}
+	}
+}
+
+static IndexType addVertex(Mesh *mesh, bool reuseVertices, VertexCache &cache, const glm::ivec3 &pos,
+						   const Voxel &voxel) {
+	const int attributes = (int)voxel.getColor() | ((int)voxel.getNormal() << 8) | ((int)voxel.getFlags() << 16);
+	const glm::ivec4 key(pos, attributes);
+	if (reuseVertices) {
+		auto iter = cache.find(key);
+		if (iter != cache.end()) {
+			return iter->second;
+		}
+	}
+	VoxelVertex vertex;
+	vertex.position = pos;
+	vertex.colorIndex = voxel.getColor();
+	vertex.normalIndex = voxel.getNormal();
+	vertex.ambientOcclusion = 3;
+	vertex.flags = voxel.getFlags();
+	vertex.padding = 0u;
+	vertex.padding2 = 0u;
+	const IndexType index = mesh->addVertex(vertex);
+	if (reuseVertices) {
+		cache.put(key, index);
+	}
+	return index;
+}
+
+static CORE_FORCE_INLINE bool isSameFace(const Voxel &v1, const Voxel &v2) {
+	return v1.isSame(v2) && v1.getFlags() == v2.getFlags();
+}
+
+/**
+ * @brief Adds the quad with the same winding that the cubic extractor is using
+ * @param[in] corner The lower corner of the quad in mesh coordinates
+ * @param[in] axis1 The extent of the quad along the first in-plane axis
+ * @param[in] axis2 The extent of the quad along the second in-plane axis
+ */
+static void addQuad(Mesh *mesh, bool reuseVertices, VertexCache &cache, FaceNames face, const glm::ivec3 &corner,
+					const glm::ivec3 &axis1, const glm::ivec3 &axis2, const Voxel &voxel) {
+	glm::ivec3 positions[4];
+	positions[0] = corner;
+	positions[2] = corner + axis1 + axis2;
+	if (face == FaceNames::NegativeX || face == FaceNames::PositiveY || face == FaceNames::NegativeZ) {
+		positions[1] = corner + axis2;
+		positions[3] = corner + axis1;
+	} else {
+		positions[1] = corner + axis1;
+		positions[3] = corner + axis2;
+	}
+	IndexType indices[4];
+	for (int i = 0; i < 4; ++i) {
+		indices[i] = addVertex(mesh, reuseVertices, cache, positions[i], voxel);
+	}
+	mesh->addTriangle(indices[0], indices[1], indices[2]);
+	mesh->addTriangle(indices[0], indices[2], indices[3]);
+}
+
+/**
+ * @brief Greedily merges the set face bits into quads. The bits are cleared once they are part of a quad.
+ */
+template<class Volume>
+static void meshifyFaces(const Volume *volData, const Region &region, BitColumns &faces, FaceNames face,
+						 Mesh *mesh, const glm::ivec3 &translate, bool mergeQuads, bool reuseVertices,
+						 VertexCache &cache) {
+	core_trace_scoped(MeshifyFaces);
+	const math::Axis axis = faceToAxis(face);
+	// the in-plane axes - the first one is the one the greedy merge is growing first
+	glm::ivec3 step1(0);
+	glm::ivec3 step2(0);
+	if (axis == math::Axis::X) {
+		step1.y = 1;
+		step2.z = 1;
+	} else if (axis == math::Axis::Y) {
+		step1.x = 1;
+		step2.z = 1;
+	} else {
+		step1.x = 1;
+		step2.y = 1;
+	}
+	// the voxel that owns the face of a positive direction is located in front of the face position
+	glm::ivec3 ownerOffset = region.getLowerCorner() - 1;
+	if (isPositiveFace(face)) {
+		ownerOffset[math::getIndexForAxis(axis)] -= 1;
+	}
+	const glm::ivec3 &maxs = faces.size;
+	auto inside = [&maxs](const glm::ivec3 &p) { return p.x < maxs.x && p.y < maxs.y && p.z < maxs.z; };
+
+	for (int z = 1; z < maxs.z; ++z) {
+		for (int y = 1; y < maxs.y; ++y) {
+			uint64_t *column = faces.column(y, z);
+			for (int k = 0; k < faces.words; ++k) {
+				while (column[k] != 0u) {
+					const glm::ivec3 start(k * 64 + core::countTrailingZeros(column[k]), y, z);
+					column[k] &= column[k] - 1u;
+					const Voxel &voxel = volData->voxel(start + ownerOffset);
+					int extent1 = 1;
+					int extent2 = 1;
+					if (mergeQuads) {
+						for (glm::ivec3 p = start + step1; inside(p); p += step1) {
+							if (!faces.test(p) || !isSameFace(voxel, volData->voxel(p + ownerOffset))) {
+								break;
+							}
+							faces.reset(p);
+							++extent1;
+						}
+						for (glm::ivec3 row = start + step2; inside(row); row += step2) {
+							bool match = true;
+							glm::ivec3 p = row;
+							for (int i = 0; i < extent1; ++i, p += step1) {
+								if (!faces.test(p) || !isSameFace(voxel, volData->voxel(p + ownerOffset))) {
+									match = false;
+									break;
+								}
+							}
+							if (!match) {
+								break;
+							}
+							p = row;
+							for (int i = 0; i < extent1; ++i, p += step1) {
+								faces.reset(p);
+							}
+							++extent2;
+						}
+					}
+					// the padding voxel is at index 0 - the mesh coordinates start at the lower corner
+					const glm::ivec3 corner = start - 1 + translate;
+					addQuad(mesh, reuseVertices, cache, face, corner, step1 * extent1, step2 * extent2, voxel);
+				}
+			}
+		}
+	}
+}
+
+template<class Volume>
+void extractBinaryMesh(const Volume *volData, const Region &region, ChunkMesh *result,
+								  const glm::ivec3 &translate, bool mergeQuads, bool reuseVertices, bool optimize) {
+	core_trace_scoped(ExtractBinaryMesh);
+
+	result->clear();
+	const glm::ivec3 &offset = region.getLowerCorner();
+	result->setOffset(offset);
+
+	const glm::ivec3 paddedSize = region.getDimensionsInVoxels() + 1;
+	BitColumns opaque;
+	BitColumns transparent;
+	opaque.init(paddedSize);
+	transparent.init(paddedSize);
+
+	{
+		core_trace_scoped(BuildOccupancy);
+		typename Volume::Sampler sampler(volData);
+		for (int z = 0; z < paddedSize.z; ++z) {
+			for (int y = 0; y < paddedSize.y; ++y) {
+				sampler.setPosition(offset.x - 1, offset.y - 1 + y, offset.z - 1 + z);
+				for (int x = 0; x < paddedSize.x; ++x) {
+					const VoxelType material = sampler.voxel().getMaterial();
+					if (!isAir(material)) {
+						if (isTransparent(material)) {
+							transparent.set(x, y, z);
+						} else {
+							opaque.set(x, y, z);
+						}
+					}
+					sampler.movePositiveX();
+				}
+			}
+		}
+	}
+
+	// the bits 1 to width of a column belong to the region
+	core::DynamicArray<uint64_t> valid;
+	valid.resize(opaque.words);
+	valid.fill(0u);
+	for (int x = 1; x < paddedSize.x; ++x) {
+		valid[x >> 6] |= 1ull << (x & 63);
+	}
+
+	BitColumns faces;
+	faces.init(paddedSize);
+	BitColumns *solids[] = {&opaque, &transparent};
+	for (int m = 0; m < ChunkMesh::Meshes; ++m) {
+		VertexCache cache;
+		for (int f = 0; f < (int)FaceNames::Max; ++f) {
+			const FaceNames face = (FaceNames)f;
+			computeFaces(*solids[m], valid, face, faces);
+			meshifyFaces(volData, region, faces, face, &result->mesh[m], translate, mergeQuads, reuseVertices, cache);
+		}
+	}
+
+	if (optimize) {
+		result->optimize();
+	}
+	result->compressIndices();
+}
+
+template void extractBinaryMesh(const voxel::RawVolume *volData, const Region &region, ChunkMesh *result,
+								const glm::ivec3 &translate, bool mergeQuads, bool reuseVertices, bool optimize);
+template void extractBinaryMesh(const voxel::BrickVolume *volData, const Region &region, ChunkMesh *result,
+								const glm::ivec3 &translate, bool mergeQuads, bool reuseVertices, bool optimize);
+template void extractBinaryMesh(const voxel::PagedVolume *volData, const Region &region, ChunkMesh *result,
+								const glm::ivec3 &translate, bool mergeQuads, bool reuseVertices, bool optimize);
+
+} // namespace voxel
@@ -0,0 +1,41 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include <glm/fwd.hpp>
+
+namespace voxel {
+
+class RawVolume;
+class BrickVolume;
+class PagedVolume;
+class Region;
+struct ChunkMesh;
+
+/**
+ * @brief Cubic mesh extraction on bit masks
+ *
+ * The volume is converted into two occupancy bit masks (opaque and transparent voxels) with one bit per voxel. The
+ * x axis of the region is packed into 64 bit words. The visible faces of all six directions are computed with
+ * shifts and and-not operations on whole words - e.g. the faces pointing into the negative x direction are
+ * @code solid & ~(solid << 1) @endcode and the faces pointing into the negative y direction are
+ * @code solid[y] & ~solid[y - 1] @endcode
+ *
+ * The set face bits are then greedily merged into quads of the same voxel color, normal and flags by scanning
+ * for the lowest set bit and clearing the bits that were consumed by a quad. Empty words are skipped without
+ * touching the voxel data again.
+ *
+ * The face ownership rules are the same as for the @c extractCubicMesh() function: faces that are located on the
+ * lower boundary planes of the region belong to the region, faces on the upper boundary planes don't.
+ *
+ * @note No ambient occlusion is computed - all vertices are fully lit. This is the trade-off for being able to
+ * merge the faces without having to compare the occlusion values of the vertices.
+ * @note Instantiated for @c RawVolume, @c BrickVolume and @c PagedVolume
+ */
+template<class Volume>
+void extractBinaryMesh(const Volume *volData, const Region &region, ChunkMesh *result, const glm::ivec3 &translate,
+					   bool mergeQuads = true, bool reuseVertices = true, bool optimize = false);
+
+} // namespace voxel
@@ -5,6 +5,8 @@
 #include "CubicSurfaceExtractor.h"
 #include "core/Common.h"
 #include "voxel/ChunkMesh.h"
+#include "voxel/BrickVolume.h"
+#include "voxel/PagedVolume.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
 #include "voxel/VoxelVertex.h"
@@ -389,7 +391,8 @@ static IndexType addVertex(bool reuseVertices, uint32_t x, uint32_t y, uint32_t
 	return 0; //Should never happen.
 }
 
-void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, ChunkMesh* result, const glm::ivec3& translate, bool mergeQuads, bool reuseVertices, bool ambientOcclusion, bool optimize) {
+template<class Volume>
+void extractCubicMesh(const Volume* volData, const Region& region, ChunkMesh* result, const glm::ivec3& translate, bool mergeQuads, bool reuseVertices, bool ambientOcclusion, bool optimize) {
 	core_trace_scoped(ExtractCubicMesh);
 
 	result->clear();
@@ -429,17 +432,17 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 	vecQuadsT[core::enumVal(FaceNames::NegativeZ)].resize(zSize);
 	vecQuadsT[core::enumVal(FaceNames::PositiveZ)].resize(zSize);
 
-	voxel::RawVolume::Sampler volumeSampler(volData);
+	typename Volume::Sampler volumeSampler(volData);
 
 	{
 	core_trace_scoped(QuadGeneration);
 	volumeSampler.setPosition(offset);
 	for (int32_t z = offset.z; z <= upper.z; ++z) {
 		const uint32_t regZ = z - offset.z;
-		voxel::RawVolume::Sampler volumeSampler2 = volumeSampler;
+		typename Volume::Sampler volumeSampler2 = volumeSampler;
 		for (int32_t x = offset.x; x <= upper.x; ++x) {
 			const uint32_t regX = x - offset.x;
-			voxel::RawVolume::Sampler volumeSampler3 = volumeSampler2;
+			typename Volume::Sampler volumeSampler3 = volumeSampler2;
 			for (int32_t y = offset.y; y <= upper.y; ++y) {
 				const uint32_t regY = y - offset.y;
 
@@ -734,4 +737,14 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 	result->compressIndices();
 }
 
+template void extractCubicMesh(const voxel::RawVolume *volData, const Region &region, ChunkMesh *result,
+							   const glm::ivec3 &translate, bool mergeQuads, bool reuseVertices, bool ambientOcclusion,
+							   bool optimize);
+template void extractCubicMesh(const voxel::BrickVolume *volData, const Region &region, ChunkMesh *result,
+							   const glm::ivec3 &translate, bool mergeQuads, bool reuseVertices, bool ambientOcclusion,
+							   bool optimize);
+template void extractCubicMesh(const voxel::PagedVolume *volData, const Region &region, ChunkMesh *result,
+							   const glm::ivec3 &translate, bool mergeQuads, bool reuseVertices, bool ambientOcclusion,
+							   bool optimize);
+
 }
@@ -13,6 +13,8 @@ class Palette;
 namespace voxel {
 
 class RawVolume;
+class BrickVolume;
+class PagedVolume;
 class Region;
 struct ChunkMesh;
 
@@ -101,7 +103,10 @@ struct ChunkMesh;
  * @li It leaves the user in control of memory allocation and would allow them to implement e.g. a mesh pooling system.
  * @li The user-provided mesh could have a different index type (e.g. 16-bit indices) to reduce memory usage.
  * @li The user could provide a custom mesh class, e.g a thin wrapper around an openGL VBO to allow direct writing into this structure.
+ *
+ * @note Instantiated for @c RawVolume, @c BrickVolume and @c PagedVolume
  */
-void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, ChunkMesh* result, const glm::ivec3& translate, bool mergeQuads = true, bool reuseVertices = true, bool ambientOcclusion = true, bool optimize = false);
+template<class Volume>
+void extractCubicMesh(const Volume* volData, const Region& region, ChunkMesh* result, const glm::ivec3& translate, bool mergeQuads = true, bool reuseVertices = true, bool ambientOcclusion = true, bool optimize = false);
 
 }
@@ -10,6 +10,8 @@
 #include "math/Axis.h"
 #include "voxel/ChunkMesh.h"
 #include "palette/Palette.h"
+#include "voxel/BrickVolume.h"
+#include "voxel/PagedVolume.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Region.h"
 #include "voxel/VoxelVertex.h"
@@ -46,7 +48,8 @@ static inline Voxel blendMaterials(const palette::Palette &palette, const Voxel
 }
 
 // Gradient estimation
-static glm::vec3 computeCentralDifferenceGradient(const RawVolume::Sampler &volIter) {
+template<class Sampler>
+static glm::vec3 computeCentralDifferenceGradient(const Sampler &volIter) {
 	const float voxel1nx = convertToDensity(volIter.peekVoxel1nx0py0pz());
 	const float voxel1px = convertToDensity(volIter.peekVoxel1px0py0pz());
 
@@ -59,7 +62,8 @@ static glm::vec3 computeCentralDifferenceGradient(const RawVolume::Sampler &volI
 	return glm::vec3(voxel1nx - voxel1px, voxel1ny - voxel1py, voxel1nz - voxel1pz);
 }
 
-static void generateVertex(math::Axis axis, const palette::Palette &palette, RawVolume::Sampler &sampler,
+template<class Sampler>
+static void generateVertex(math::Axis axis, const palette::Palette &palette, Sampler &sampler,
 				   ChunkMesh *result, core::Array2DView<glm::ivec3> &indicesView,
 				   const Voxel &v111, const glm::vec3 &n111, float v111Density, int x, int y) {
 	sampler.moveNegative(axis);
@@ -95,7 +99,9 @@ static void generateVertex(math::Axis axis, const palette::Palette &palette, Raw
 	sampler.movePositive(axis);
 }
 
-void extractMarchingCubesMesh(const RawVolume *volume, const palette::Palette &palette, const Region &region, ChunkMesh *result, bool optimize) {
+template<class Volume>
+void extractMarchingCubesMesh(const Volume *volume, const palette::Palette &palette, const Region &region,
+										 ChunkMesh *result, bool optimize) {
 	core_assert_msg(volume != nullptr, "Provided volume cannot be null");
 	core_assert_msg(result != nullptr, "Provided mesh cannot be null");
 
@@ -122,13 +128,13 @@ void extractMarchingCubesMesh(const RawVolume *volume, const palette::Palette &p
 
 	// A sampler pointing at the beginning of the region, which gets incremented to always point at the beginning of a
 	// slice.
-	RawVolume::Sampler startOfSlice(volume);
+	typename Volume::Sampler startOfSlice(volume);
 	startOfSlice.setPosition(region.getLowerCorner());
 
 	for (int32_t z = 0; z < d; z++) {
 		// A sampler pointing at the beginning of the slice, which gets incremented to always point at the beginning of
 		// a row.
-		RawVolume::Sampler startOfRow = startOfSlice;
+		typename Volume::Sampler startOfRow = startOfSlice;
 
 		core::Array2DView<glm::ivec3> indicesView(indicesBuf.data(), w, h);
 		core::Array2DView<glm::ivec3> previousIndicesView(previousIndicesBuf.data(), w, h);
@@ -136,7 +142,7 @@ void extractMarchingCubesMesh(const RawVolume *volume, const palette::Palette &p
 		for (int32_t y = 0; y < h; y++) {
 			// Copying a sampler which is already pointing at the correct location seems (slightly) faster than
 			// calling setPosition(). Therefore we make use of 'startOfRow' and 'startOfSlice' to reset the sampler.
-			RawVolume::Sampler sampler = startOfRow;
+			typename Volume::Sampler sampler = startOfRow;
 
 			for (int32_t x = 0; x < w; x++) {
 				// Note: In many cases the provided region will be (mostly) empty which means mesh vertices/indices
@@ -287,4 +293,11 @@ void extractMarchingCubesMesh(const RawVolume *volume, const palette::Palette &p
 	result->compressIndices();
 }
 
+template void extractMarchingCubesMesh(const RawVolume *volume, const palette::Palette &palette,
+									   const Region &region, ChunkMesh *result, bool optimize);
+template void extractMarchingCubesMesh(const BrickVolume *volume, const palette::Palette &palette,
+									   const Region &region, ChunkMesh *result, bool optimize);
+template void extractMarchingCubesMesh(const PagedVolume *volume, const palette::Palette &palette,
+									   const Region &region, ChunkMesh *result, bool optimize);
+
 } // namespace voxel
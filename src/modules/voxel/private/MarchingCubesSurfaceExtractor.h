@@ -11,11 +11,15 @@ class Palette;
 namespace voxel {
 
 class RawVolume;
+class BrickVolume;
+class PagedVolume;
 class Region;
 struct ChunkMesh;
 
 // Also known as: "3D Contouring", "Marching Cubes", "Surface Reconstruction"
-void extractMarchingCubesMesh(const RawVolume *volume, const palette::Palette &palette, const Region &region,
+// instantiated for RawVolume, BrickVolume and PagedVolume
+template<class Volume>
+void extractMarchingCubesMesh(const Volume *volume, const palette::Palette &palette, const Region &region,
 							  ChunkMesh *result, bool optimize);
 
 } // namespace voxel
@@ -0,0 +1,139 @@
+/**
+ * @file
+ */
+
+#include "AbstractVoxelTest.h"
+#include "core/ScopedPtr.h"
+#include "voxel/BrickVolume.h"
+#include "voxel/ChunkMesh.h"
+#include "voxel/RawVolume.h"
+#include "voxel/SurfaceExtractor.h"
+#include "voxel/Voxel.h"
+
+namespace voxel {
+
+class BrickVolumeTest : public AbstractVoxelTest {};
+
+TEST_F(BrickVolumeTest, testMemoryUsageIsPadded) {
+	BrickVolume v(Region(glm::ivec3(0), glm::ivec3(16, 0, 31)));
+	// 5x1x8 bricks - x and z are padded to full clusters, y only to one brick
+	EXPECT_EQ((size_t)(32 * 4 * 32) * sizeof(Voxel), v.memoryUsage());
+}
+
+TEST_F(BrickVolumeTest, testMemoryUsageThinVolume) {
+	BrickVolume v(Region(glm::ivec3(0), glm::ivec3(255, 0, 255)));
+	EXPECT_EQ((size_t)(256 * BrickVolume::BrickSize * 256) * sizeof(Voxel), v.memoryUsage());
+}
+
+TEST_F(BrickVolumeTest, testEveryVoxelHasItsOwnSlot) {
+	const Region region(glm::ivec3(-2, 3, 1), glm::ivec3(34, 21, 40));
+	BrickVolume v(region);
+	auto color = [](int x, int y, int z) { return (uint8_t)(1 + ((x * 7 + y * 13 + z * 31) & 0xfe)); };
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				v.setVoxel(x, y, z, createVoxel(VoxelType::Generic, color(x, y, z)));
+			}
+		}
+	}
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				ASSERT_EQ(color(x, y, z), v.voxel(x, y, z).getColor()) << x << ":" << y << ":" << z;
+			}
+		}
+	}
+	v.clear();
+	EXPECT_TRUE(isAir(v.voxel(region.getLowerCorner()).getMaterial()));
+}
+
+TEST_F(BrickVolumeTest, testBorderValue) {
+	BrickVolume v(Region(-5, 5));
+	const Voxel border = createVoxel(VoxelType::Generic, 42);
+	v.setBorderValue(border);
+	EXPECT_EQ(42, v.voxel(6, 0, 0).getColor());
+	BrickVolume::Sampler sampler(v);
+	ASSERT_TRUE(sampler.setPosition(5, 0, 0));
+	EXPECT_EQ(42, sampler.peekVoxel1px0py0pz().getColor());
+	EXPECT_TRUE(isAir(sampler.peekVoxel1nx0py0pz().getMaterial()));
+}
+
+TEST_F(BrickVolumeTest, testSamplerMatchesRawVolume) {
+	const Region region(glm::ivec3(-3, 0, 5), glm::ivec3(40, 20, 36));
+	RawVolume raw(region);
+	for (int i = 0; i < 2000; ++i) {
+		const glm::ivec3 pos(_random.random(region.getLowerX(), region.getUpperX()),
+							 _random.random(region.getLowerY(), region.getUpperY()),
+							 _random.random(region.getLowerZ(), region.getUpperZ()));
+		raw.setVoxel(pos, createVoxel(VoxelType::Generic, _random.random(1, 255)));
+	}
+	const BrickVolume brick(raw);
+
+	RawVolume::Sampler rawSampler(raw);
+	BrickVolume::Sampler brickSampler(brick);
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		rawSampler.setPosition(region.getLowerX(), region.getLowerY(), z);
+		brickSampler.setPosition(region.getLowerX(), region.getLowerY(), z);
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			RawVolume::Sampler rawSampler2 = rawSampler;
+			BrickVolume::Sampler brickSampler2 = brickSampler;
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				ASSERT_TRUE(rawSampler2.voxel().isSame(brickSampler2.voxel())) << x << ":" << y << ":" << z;
+				ASSERT_TRUE(rawSampler2.peekVoxel1nx1ny1nz().isSame(brickSampler2.peekVoxel1nx1ny1nz()));
+				ASSERT_TRUE(rawSampler2.peekVoxel1px1py1pz().isSame(brickSampler2.peekVoxel1px1py1pz()));
+				ASSERT_TRUE(rawSampler2.peekVoxel1nx0py1pz().isSame(brickSampler2.peekVoxel1nx0py1pz()));
+				ASSERT_TRUE(rawSampler2.peekVoxel0px1ny0pz().isSame(brickSampler2.peekVoxel0px1ny0pz()));
+				ASSERT_TRUE(rawSampler2.peekVoxel1px1ny0pz().isSame(brickSampler2.peekVoxel1px1ny0pz()));
+				rawSampler2.movePositiveX();
+				brickSampler2.movePositiveX();
+			}
+			rawSampler.movePositiveY();
+			brickSampler.movePositiveY();
+		}
+	}
+
+	core::ScopedPtr<RawVolume> roundTrip(brick.toRawVolume());
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				ASSERT_TRUE(raw.voxel(x, y, z).isSame(roundTrip->voxel(x, y, z)));
+			}
+		}
+	}
+}
+
+TEST_F(BrickVolumeTest, testSamplerSetVoxel) {
+	BrickVolume v(Region(0, 63));
+	BrickVolume::Sampler sampler(v);
+	sampler.setPosition(31, 31, 31);
+	EXPECT_TRUE(sampler.setVoxel(createVoxel(VoxelType::Generic, 1)));
+	sampler.movePositiveX();
+	EXPECT_TRUE(sampler.setVoxel(createVoxel(VoxelType::Generic, 2)));
+	EXPECT_EQ(1, sampler.peekVoxel1nx0py0pz().getColor());
+	EXPECT_EQ(2, sampler.voxel().getColor());
+	EXPECT_EQ(2, v.voxel(32, 31, 31).getColor());
+}
+
+TEST_F(BrickVolumeTest, testExtractSurface) {
+	const Region region(0, 40);
+	RawVolume raw(region);
+	for (int i = 0; i < 500; ++i) {
+		const glm::ivec3 pos(_random.random(0, 40), _random.random(0, 40), _random.random(0, 40));
+		raw.setVoxel(pos, createVoxel(VoxelType::Generic, _random.random(1, 255)));
+	}
+	const BrickVolume brick(raw);
+
+	ChunkMesh rawMesh;
+	SurfaceExtractionContext rawCtx = buildCubicContext(&raw, region, rawMesh);
+	extractSurface(rawCtx);
+
+	ChunkMesh brickMesh;
+	SurfaceExtractionContextT<BrickVolume> brickCtx = buildCubicContext(&brick, region, brickMesh);
+	extractSurface(brickCtx);
+
+	EXPECT_GT(rawMesh.mesh[0].getNoOfIndices(), 0u);
+	EXPECT_EQ(rawMesh.mesh[0].getNoOfVertices(), brickMesh.mesh[0].getNoOfVertices());
+	EXPECT_EQ(rawMesh.mesh[0].getNoOfIndices(), brickMesh.mesh[0].getNoOfIndices());
+}
+
+} // namespace voxel
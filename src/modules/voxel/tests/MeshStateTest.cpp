@@ -37,7 +37,8 @@ TEST_F(MeshStateTest, testExtractRegion) {
 	EXPECT_EQ(0, meshState.pendingExtractions());
 	const voxel::Region region(1, 0, 1, 1, 0, 1);
 	meshState.scheduleRegionExtraction(0, region);
-	EXPECT_EQ(1, meshState.pendingExtractions());
+	// the voxels at y = -1 are part of the brick below - their ambient occlusion depends on the modified voxel
+	EXPECT_EQ(2, meshState.pendingExtractions());
 
 	(void)meshState.shutdown();
 }
@@ -65,4 +66,53 @@ TEST_F(MeshStateTest, testExtractRegionBoundary) {
 	(void)meshState.shutdown();
 }
 
+TEST_F(MeshStateTest, testMeshCache) {
+	voxel::RawVolume v(voxel::Region(0, 31));
+	v.setVoxel(3, 3, 3, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+
+	MeshState meshState;
+	meshState.construct();
+	meshState.init();
+	bool deleted = false;
+	palette::Palette pal;
+	pal.nippon();
+	(void)meshState.setVolume(0, &v, &pal, nullptr, true, deleted);
+
+	const voxel::Region region(3, 3);
+	meshState.scheduleRegionExtraction(0, region);
+	meshState.extractAllPending();
+	EXPECT_EQ(0, meshState.pop());
+	EXPECT_EQ(-1, meshState.pop());
+	// the mesh is in use - only replaced meshes are cached
+	EXPECT_EQ(0, meshState.cachedMeshes());
+
+	// nothing changed - nothing to extract
+	meshState.scheduleRegionExtraction(0, region);
+	meshState.extractAllPending();
+	EXPECT_EQ(-1, meshState.pop());
+
+	v.setVoxel(3, 3, 3, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	meshState.scheduleRegionExtraction(0, region);
+	meshState.extractAllPending();
+	EXPECT_EQ(0, meshState.pop());
+	EXPECT_EQ(1, meshState.cachedMeshes());
+
+	// undo - the mesh is taken from the cache
+	v.setVoxel(3, 3, 3, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	meshState.scheduleRegionExtraction(0, region);
+	meshState.extractAllPending();
+	EXPECT_EQ(0, meshState.pop());
+	// the cached mesh was moved back in and the replaced one was moved into the cache
+	EXPECT_EQ(1, meshState.cachedMeshes());
+	const MeshState::MeshesMap &meshes = meshState.meshes(MeshType_Opaque);
+	auto iter = meshes.find(glm::ivec3(0));
+	ASSERT_NE(meshes.end(), iter);
+	const voxel::Mesh *mesh = iter->value[0];
+	ASSERT_NE(nullptr, mesh);
+	ASSERT_GT(mesh->getNoOfVertices(), 0u);
+	EXPECT_EQ(1, mesh->getVertexVector()[0].colorIndex);
+
+	(void)meshState.shutdown();
+}
+
 } // namespace voxelrender
@@ -0,0 +1,142 @@
+/**
+ * @file
+ */
+
+#include "AbstractVoxelTest.h"
+#include "core/ScopedPtr.h"
+#include "voxel/ChunkMesh.h"
+#include "voxel/PagedVolume.h"
+#include "voxel/RawVolume.h"
+#include "voxel/SurfaceExtractor.h"
+#include "voxel/Voxel.h"
+
+namespace voxel {
+
+class PagedVolumeTest : public AbstractVoxelTest {};
+
+TEST_F(PagedVolumeTest, testSetVoxelAllocatesBrick) {
+	PagedVolume v(Region(0, 127));
+	EXPECT_EQ(512, v.totalBricks());
+	EXPECT_EQ(0, v.allocatedBricks());
+	EXPECT_TRUE(isAir(v.voxel(100, 100, 100).getMaterial()));
+	EXPECT_FALSE(v.setVoxel(100, 100, 100, voxel::Voxel())) << "Setting air should not allocate a brick";
+	EXPECT_EQ(0, v.allocatedBricks());
+	EXPECT_TRUE(v.setVoxel(100, 100, 100, createVoxel(VoxelType::Generic, 1)));
+	EXPECT_EQ(1, v.allocatedBricks());
+	EXPECT_EQ(1, v.voxel(100, 100, 100).getColor());
+	EXPECT_FALSE(v.setVoxel(100, 100, 100, createVoxel(VoxelType::Generic, 1)));
+	EXPECT_TRUE(v.setVoxel(101, 100, 100, createVoxel(VoxelType::Generic, 2)));
+	EXPECT_EQ(1, v.allocatedBricks());
+	EXPECT_TRUE(v.setVoxel(0, 0, 0, createVoxel(VoxelType::Generic, 3)));
+	EXPECT_EQ(2, v.allocatedBricks());
+	v.clear();
+	EXPECT_EQ(0, v.allocatedBricks());
+	EXPECT_TRUE(isAir(v.voxel(0, 0, 0).getMaterial()));
+}
+
+TEST_F(PagedVolumeTest, testBorderValue) {
+	PagedVolume v(Region(-5, 5));
+	const Voxel border = createVoxel(VoxelType::Generic, 42);
+	v.setBorderValue(border);
+	EXPECT_EQ(42, v.voxel(6, 0, 0).getColor());
+	PagedVolume::Sampler sampler(v);
+	ASSERT_TRUE(sampler.setPosition(5, 0, 0));
+	EXPECT_EQ(42, sampler.peekVoxel1px0py0pz().getColor());
+	EXPECT_TRUE(isAir(sampler.peekVoxel1nx0py0pz().getMaterial()));
+}
+
+TEST_F(PagedVolumeTest, testSamplerMatchesRawVolume) {
+	const Region region(glm::ivec3(-3, 0, 5), glm::ivec3(70, 40, 75));
+	RawVolume raw(region);
+	for (int i = 0; i < 2000; ++i) {
+		const glm::ivec3 pos(_random.random(region.getLowerX(), region.getUpperX()),
+							 _random.random(region.getLowerY(), region.getUpperY()),
+							 _random.random(region.getLowerZ(), region.getUpperZ()));
+		raw.setVoxel(pos, createVoxel(VoxelType::Generic, _random.random(1, 255)));
+	}
+	const PagedVolume paged(raw);
+
+	RawVolume::Sampler rawSampler(raw);
+	PagedVolume::Sampler pagedSampler(paged);
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		rawSampler.setPosition(region.getLowerX(), region.getLowerY(), z);
+		pagedSampler.setPosition(region.getLowerX(), region.getLowerY(), z);
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			RawVolume::Sampler rawSampler2 = rawSampler;
+			PagedVolume::Sampler pagedSampler2 = pagedSampler;
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				ASSERT_TRUE(rawSampler2.voxel().isSame(pagedSampler2.voxel())) << x << ":" << y << ":" << z;
+				ASSERT_TRUE(rawSampler2.peekVoxel1nx1ny1nz().isSame(pagedSampler2.peekVoxel1nx1ny1nz()));
+				ASSERT_TRUE(rawSampler2.peekVoxel1px1py1pz().isSame(pagedSampler2.peekVoxel1px1py1pz()));
+				ASSERT_TRUE(rawSampler2.peekVoxel1nx0py1pz().isSame(pagedSampler2.peekVoxel1nx0py1pz()));
+				ASSERT_TRUE(rawSampler2.peekVoxel0px1ny0pz().isSame(pagedSampler2.peekVoxel0px1ny0pz()));
+				rawSampler2.movePositiveX();
+				pagedSampler2.movePositiveX();
+			}
+			rawSampler.movePositiveY();
+			pagedSampler.movePositiveY();
+		}
+	}
+
+	core::ScopedPtr<RawVolume> roundTrip(paged.toRawVolume());
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				ASSERT_TRUE(raw.voxel(x, y, z).isSame(roundTrip->voxel(x, y, z)));
+			}
+		}
+	}
+}
+
+TEST_F(PagedVolumeTest, testDataRegion) {
+	PagedVolume v(Region(glm::ivec3(0, -64, 0), glm::ivec3(15, 319, 15)));
+	EXPECT_FALSE(v.dataRegion().isValid());
+	v.setVoxel(3, -10, 4, createVoxel(VoxelType::Generic, 1));
+	v.setVoxel(5, 100, 2, createVoxel(VoxelType::Generic, 2));
+	const Region dataRegion = v.dataRegion();
+	EXPECT_EQ(glm::ivec3(3, -10, 2), dataRegion.getLowerCorner());
+	EXPECT_EQ(glm::ivec3(5, 100, 4), dataRegion.getUpperCorner());
+	EXPECT_EQ(2, v.allocatedBricks());
+
+	core::ScopedPtr<RawVolume> cropped(v.toRawVolume(dataRegion));
+	EXPECT_EQ(dataRegion, cropped->region());
+	EXPECT_EQ(1, cropped->voxel(3, -10, 4).getColor());
+	EXPECT_EQ(2, cropped->voxel(5, 100, 2).getColor());
+	EXPECT_TRUE(isAir(cropped->voxel(4, 50, 3).getMaterial()));
+}
+
+TEST_F(PagedVolumeTest, testSamplerSetVoxel) {
+	PagedVolume v(Region(0, 63));
+	PagedVolume::Sampler sampler(v);
+	sampler.setPosition(31, 31, 31);
+	EXPECT_TRUE(sampler.setVoxel(createVoxel(VoxelType::Generic, 1)));
+	sampler.movePositiveX();
+	EXPECT_TRUE(sampler.setVoxel(createVoxel(VoxelType::Generic, 2)));
+	EXPECT_EQ(2, v.allocatedBricks());
+	EXPECT_EQ(1, sampler.peekVoxel1nx0py0pz().getColor());
+	EXPECT_EQ(2, sampler.voxel().getColor());
+}
+
+TEST_F(PagedVolumeTest, testExtractSurface) {
+	const Region region(0, 40);
+	RawVolume raw(region);
+	for (int i = 0; i < 500; ++i) {
+		const glm::ivec3 pos(_random.random(0, 40), _random.random(0, 40), _random.random(0, 40));
+		raw.setVoxel(pos, createVoxel(VoxelType::Generic, _random.random(1, 255)));
+	}
+	const PagedVolume paged(raw);
+
+	ChunkMesh rawMesh;
+	SurfaceExtractionContext rawCtx = buildCubicContext(&raw, region, rawMesh);
+	extractSurface(rawCtx);
+
+	ChunkMesh pagedMesh;
+	SurfaceExtractionContextT<PagedVolume> pagedCtx = buildCubicContext(&paged, region, pagedMesh);
+	extractSurface(pagedCtx);
+
+	EXPECT_GT(rawMesh.mesh[0].getNoOfIndices(), 0u);
+	EXPECT_EQ(rawMesh.mesh[0].getNoOfVertices(), pagedMesh.mesh[0].getNoOfVertices());
+	EXPECT_EQ(rawMesh.mesh[0].getNoOfIndices(), pagedMesh.mesh[0].getNoOfIndices());
+}
+
+} // namespace voxel
@@ -0,0 +1,84 @@
+/**
+ * @file
+ */
+
+#include "AbstractVoxelTest.h"
+#include "core/ScopedPtr.h"
+#include "voxel/PaletteVolume.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Voxel.h"
+
+namespace voxel {
+
+class PaletteVolumeTest : public AbstractVoxelTest {};
+
+TEST_F(PaletteVolumeTest, testOneBytePerVoxel) {
+	PaletteVolume v(Region(0, 15));
+	EXPECT_EQ(16u * 16u * 16u, v.memoryUsage());
+	EXPECT_TRUE(v.setVoxel(1, 2, 3, createVoxel(VoxelType::Generic, 1)));
+	EXPECT_FALSE(v.setVoxel(1, 2, 3, createVoxel(VoxelType::Generic, 1)));
+	EXPECT_TRUE(v.setVoxel(3, 2, 1, createVoxel(VoxelType::Transparent, 2)));
+	EXPECT_TRUE(v.isCompact());
+	EXPECT_EQ(1, v.data()[1 + 2 * 16 + 3 * 16 * 16]);
+	EXPECT_EQ(v.airIndex(), v.data()[0]);
+	EXPECT_EQ(VoxelType::Transparent, v.voxel(3, 2, 1).getMaterial());
+	EXPECT_TRUE(v.setVoxel(1, 2, 3, Voxel()));
+	EXPECT_FALSE(v.setVoxel(1, 2, 3, Voxel()));
+	EXPECT_TRUE(isAir(v.voxel(1, 2, 3).getMaterial()));
+}
+
+TEST_F(PaletteVolumeTest, testSideTable) {
+	PaletteVolume v(Region(0, 7), 5);
+	EXPECT_TRUE(v.setVoxel(0, 0, 0, createVoxel(VoxelType::Generic, 1, 2)));
+	// same palette index with a different normal
+	EXPECT_TRUE(v.setVoxel(1, 0, 0, createVoxel(VoxelType::Generic, 1, 3)));
+	EXPECT_FALSE(v.isCompact());
+	EXPECT_EQ(2, v.voxel(0, 0, 0).getNormal());
+	EXPECT_EQ(3, v.voxel(1, 0, 0).getNormal());
+	EXPECT_TRUE(v.setVoxel(1, 0, 0, createVoxel(VoxelType::Generic, 1, 2)));
+	EXPECT_TRUE(v.isCompact());
+
+	// the palette index that is reserved for air
+	EXPECT_TRUE(v.setVoxel(2, 0, 0, createVoxel(VoxelType::Generic, 5)));
+	EXPECT_FALSE(v.isCompact());
+	EXPECT_EQ(VoxelType::Generic, v.voxel(2, 0, 0).getMaterial());
+	EXPECT_EQ(5, v.voxel(2, 0, 0).getColor());
+	EXPECT_TRUE(v.setVoxel(2, 0, 0, Voxel()));
+	EXPECT_TRUE(v.isCompact());
+	EXPECT_TRUE(isAir(v.voxel(2, 0, 0).getMaterial()));
+}
+
+TEST_F(PaletteVolumeTest, testRawVolumeRoundTrip) {
+	const Region region(glm::ivec3(-3, 0, 5), glm::ivec3(30, 20, 26));
+	RawVolume raw(region);
+	for (int i = 0; i < 2000; ++i) {
+		const glm::ivec3 pos(_random.random(region.getLowerX(), region.getUpperX()),
+							 _random.random(region.getLowerY(), region.getUpperY()),
+							 _random.random(region.getLowerZ(), region.getUpperZ()));
+		raw.setVoxel(pos, createVoxel(VoxelType::Generic, _random.random(0, 200)));
+	}
+	const PaletteVolume palVolume(raw);
+	EXPECT_TRUE(palVolume.isCompact());
+	EXPECT_GT(palVolume.airIndex(), 200);
+
+	PaletteVolume::Sampler sampler(palVolume);
+	RawVolume::Sampler rawSampler(raw);
+	core::ScopedPtr<RawVolume> roundTrip(palVolume.toRawVolume());
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			sampler.setPosition(region.getLowerX(), y, z);
+			rawSampler.setPosition(region.getLowerX(), y, z);
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				ASSERT_TRUE(raw.voxel(x, y, z).isSame(roundTrip->voxel(x, y, z))) << x << ":" << y << ":" << z;
+				ASSERT_TRUE(rawSampler.voxel().isSame(sampler.voxel()));
+				ASSERT_TRUE(rawSampler.peekVoxel1nx1ny1nz().isSame(sampler.peekVoxel1nx1ny1nz()));
+				ASSERT_TRUE(rawSampler.peekVoxel1px1py1pz().isSame(sampler.peekVoxel1px1py1pz()));
+				ASSERT_TRUE(rawSampler.peekVoxel0px1ny0pz().isSame(sampler.peekVoxel0px1ny0pz()));
+				sampler.movePositiveX();
+				rawSampler.movePositiveX();
+			}
+		}
+	}
+}
+
+} // namespace voxel
@@ -245,4 +245,36 @@ TEST_F(RawVolumeTest, testFullSamplerLoop) {
 	}
 }
 
+TEST_F(RawVolumeTest, testInteriorSamplerPeek) {
+	const voxel::Region region(-2, -1, 0, 3, 4, 2);
+	RawVolume v(region);
+	for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				const int color = (x - region.getLowerX()) + (y - region.getLowerY()) * 6 + z * 36;
+				v.setVoxel(x, y, z, voxel::createVoxel(VoxelType::Generic, color));
+			}
+		}
+	}
+	RawVolume::InteriorSampler interior(v);
+	RawVolume::Sampler sampler(v);
+	interior.setPosition(region.getLowerX() + 1, 0, 1);
+	for (int32_t x = region.getLowerX() + 1; x < region.getUpperX(); ++x) {
+		sampler.setPosition(x, 0, 1);
+		EXPECT_EQ(sampler.voxel(), interior.voxel());
+		EXPECT_EQ(v.voxel(x - 1, -1, 0), interior.peekVoxel1nx1ny1nz());
+		EXPECT_EQ(sampler.peekVoxel1nx1ny1nz(), interior.peekVoxel1nx1ny1nz());
+		EXPECT_EQ(sampler.peekVoxel0px1py1pz(), interior.peekVoxel0px1py1pz());
+		EXPECT_EQ(sampler.peekVoxel1px0py1nz(), interior.peekVoxel1px0py1nz());
+		EXPECT_EQ(v.voxel(x + 1, 1, 2), interior.peekVoxel1px1py1pz());
+		interior.movePositiveX();
+	}
+	interior.moveNegativeX();
+	interior.movePositiveY(2);
+	interior.movePositiveZ();
+	EXPECT_EQ(v.voxel(region.getUpperX() - 1, 2, 2), interior.voxel());
+	EXPECT_TRUE(interior.setVoxel(voxel::createVoxel(VoxelType::Generic, 1)));
+	EXPECT_EQ(1, v.voxel(region.getUpperX() - 1, 2, 2).getColor());
+}
+
 }
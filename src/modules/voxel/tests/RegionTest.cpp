@@ -4,6 +4,8 @@
 
 #include "voxel/Region.h"
 #include "app/tests/AbstractTest.h"
+#include "core/concurrent/Atomic.h"
+#include "voxel/ParallelFor.h"
 #include <glm/ext/scalar_constants.hpp>
 #include <glm/gtc/epsilon.hpp>
 #ifndef GLM_ENABLE_EXPERIMENTAL
@@ -230,4 +232,19 @@ TEST_F(RegionTest, testCenter) {
 	EXPECT_GLM_EQ(glm::vec3(0.5f), region4.calcCenterf());
 }
 
+TEST_F(RegionTest, testParallelFor) {
+	const voxel::Region region(-3, 60);
+	core::AtomicInt voxels{0};
+	core::AtomicInt slabs{0};
+	voxel::parallelFor(region, [&](const voxel::Region &slab) {
+		EXPECT_TRUE(region.containsRegion(slab));
+		EXPECT_EQ(region.getWidthInVoxels(), slab.getWidthInVoxels());
+		EXPECT_EQ(region.getHeightInVoxels(), slab.getHeightInVoxels());
+		voxels.increment(slab.voxels());
+		slabs.increment(1);
+	});
+	EXPECT_EQ(region.voxels(), (int)voxels);
+	EXPECT_GT((int)slabs, 0);
+}
+
 } // namespace voxel
@@ -5,11 +5,45 @@
 #include "voxel/SurfaceExtractor.h"
 #include "app/tests/AbstractTest.h"
 #include "voxel/ChunkMesh.h"
+#include "voxel/MaterialColor.h"
 #include "voxel/RawVolume.h"
+#include <glm/geometric.hpp>
 
 namespace voxel {
 
-class SurfaceExtractorTest : public app::AbstractTest {};
+class SurfaceExtractorTest : public app::AbstractTest {
+protected:
+	float surfaceArea(const voxel::Mesh &mesh) const {
+		const voxel::IndexArray &indices = mesh.getIndexVector();
+		const voxel::VertexArray &vertices = mesh.getVertexVector();
+		float area = 0.0f;
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			const glm::vec3 &p0 = vertices[indices[i + 0]].position;
+			const glm::vec3 &p1 = vertices[indices[i + 1]].position;
+			const glm::vec3 &p2 = vertices[indices[i + 2]].position;
+			area += glm::length(glm::cross(p1 - p0, p2 - p0)) * 0.5f;
+		}
+		return area;
+	}
+
+	void fillTestVolume(voxel::RawVolume &v) {
+		const voxel::Region &region = v.region();
+		for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+					if ((x * 3 + y + z * 5) % 7 == 0) {
+						continue;
+					}
+					if ((x + y) % 11 == 0) {
+						v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Transparent, 4));
+					} else {
+						v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (x + z) % 3 + 1));
+					}
+				}
+			}
+		}
+	}
+};
 
 // https://github.com/vengi-voxel/vengi/issues/389
 // 63 vertices mesh object. When you import this one into Blender, then when manually merged (Mesh > Merge > By Distance
@@ -133,4 +167,123 @@ TEST_F(SurfaceExtractorTest, testMeshExtractionIssue445) {
 	EXPECT_EQ(8, (int)mesh.mesh[0].getNoOfVertices());
 }
 
+TEST_F(SurfaceExtractorTest, testMeshExtractionParallel) {
+	voxel::Region region(0, 63);
+	voxel::RawVolume v(region);
+	for (int x = 4; x <= 50; ++x) {
+		for (int y = 0; y <= 20; ++y) {
+			for (int z = 2; z <= 60; ++z) {
+				if ((x + y + z) % 7 == 0) {
+					continue;
+				}
+				v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (x + z) % 3 + 1));
+			}
+		}
+	}
+	region.shiftUpperCorner(1, 1, 1);
+
+	const bool mergeQuads = false;
+	const bool reuseVertices = true;
+	const bool ambientOcclusion = true;
+
+	voxel::ChunkMesh serialMesh;
+	SurfaceExtractionContext serialCtx =
+		voxel::buildCubicContext(&v, region, serialMesh, glm::ivec3(0), mergeQuads, reuseVertices, ambientOcclusion);
+	voxel::extractSurface(serialCtx);
+
+	voxel::ChunkMesh parallelMesh;
+	SurfaceExtractionContext parallelCtx =
+		voxel::buildCubicContext(&v, region, parallelMesh, glm::ivec3(0), mergeQuads, reuseVertices, ambientOcclusion);
+	voxel::extractSurfaceParallel(parallelCtx, 16);
+
+	ASSERT_GT(serialMesh.mesh[0].getNoOfIndices(), 0u);
+	EXPECT_EQ(serialMesh.mesh[0].getNoOfIndices(), parallelMesh.mesh[0].getNoOfIndices());
+	EXPECT_EQ(serialMesh.mesh[0].getNoOfVertices(), parallelMesh.mesh[0].getNoOfVertices())
+		<< "The vertices on the slab seams should be shared";
+	EXPECT_EQ(serialMesh.mesh[0].getOffset(), parallelMesh.mesh[0].getOffset());
+}
+
+TEST_F(SurfaceExtractorTest, testMeshExtractionParallelBricks) {
+	// the voxels touch the region border - the slab copies must include the neighbours of the slab and the border value
+	voxel::Region region(glm::ivec3(-2, 0, 3), glm::ivec3(40, 20, 60));
+	voxel::RawVolume v(region);
+	fillTestVolume(v);
+	region.shiftUpperCorner(1, 1, 1);
+
+	voxel::ChunkMesh rawMesh;
+	SurfaceExtractionContext rawCtx = voxel::buildCubicContext(&v, region, rawMesh, glm::ivec3(0), false, true, true);
+	voxel::extractSurfaceParallel(rawCtx, 16);
+
+	voxel::ChunkMesh brickMesh;
+	SurfaceExtractionContext brickCtx =
+		voxel::buildCubicContext(&v, region, brickMesh, glm::ivec3(0), false, true, true);
+	voxel::extractSurfaceParallelBricks(brickCtx, 16);
+
+	for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
+		const voxel::VertexArray &rawVertices = rawMesh.mesh[i].getVertexVector();
+		const voxel::VertexArray &brickVertices = brickMesh.mesh[i].getVertexVector();
+		ASSERT_EQ(rawVertices.size(), brickVertices.size()) << "mesh " << i;
+		for (size_t n = 0; n < rawVertices.size(); ++n) {
+			ASSERT_EQ(rawVertices[n].position, brickVertices[n].position) << "mesh " << i << " vertex " << n;
+			ASSERT_EQ(rawVertices[n].info, brickVertices[n].info) << "mesh " << i << " vertex " << n;
+		}
+		EXPECT_EQ(rawMesh.mesh[i].getNoOfIndices(), brickMesh.mesh[i].getNoOfIndices()) << "mesh " << i;
+	}
+}
+
+TEST_F(SurfaceExtractorTest, testBinaryMeshExtractionMatchesCubic) {
+	// the width exceeds 64 voxels to cover faces that cross the bit mask words
+	voxel::Region region(glm::ivec3(-3, 2, 1), glm::ivec3(70, 20, 30));
+	voxel::RawVolume v(region);
+	fillTestVolume(v);
+	region.shiftUpperCorner(1, 1, 1);
+
+	voxel::ChunkMesh cubicMesh;
+	SurfaceExtractionContext cubicCtx =
+		voxel::buildCubicContext(&v, region, cubicMesh, glm::ivec3(0), false, true, false);
+	voxel::extractSurface(cubicCtx);
+
+	voxel::ChunkMesh binaryMesh;
+	SurfaceExtractionContext binaryCtx = voxel::createContext(voxel::SurfaceExtractionType::Binary, &v, region,
+															  voxel::getPalette(), binaryMesh, glm::ivec3(0), false);
+	voxel::extractSurface(binaryCtx);
+
+	for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
+		ASSERT_GT(cubicMesh.mesh[i].getNoOfIndices(), 0u) << "mesh " << i;
+		EXPECT_EQ(cubicMesh.mesh[i].getNoOfIndices(), binaryMesh.mesh[i].getNoOfIndices()) << "mesh " << i;
+		EXPECT_EQ(cubicMesh.mesh[i].getOffset(), binaryMesh.mesh[i].getOffset());
+	}
+
+	voxel::ChunkMesh mergedMesh;
+	SurfaceExtractionContext mergedCtx = voxel::createContext(voxel::SurfaceExtractionType::Binary, &v, region,
+															  voxel::getPalette(), mergedMesh, glm::ivec3(0), true);
+	voxel::extractSurface(mergedCtx);
+	for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
+		EXPECT_LT(mergedMesh.mesh[i].getNoOfIndices(), binaryMesh.mesh[i].getNoOfIndices()) << "mesh " << i;
+		EXPECT_FLOAT_EQ(surfaceArea(cubicMesh.mesh[i]), surfaceArea(mergedMesh.mesh[i])) << "mesh " << i;
+	}
+}
+
+TEST_F(SurfaceExtractorTest, testBinaryMeshExtractionBox) {
+	const voxel::Region volumeRegion(glm::ivec3(-1), glm::ivec3(2));
+	voxel::RawVolume v(volumeRegion);
+	for (int x = -1; x <= 2; ++x) {
+		for (int y = -1; y <= 2; ++y) {
+			for (int z = -1; z <= 2; ++z) {
+				v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+			}
+		}
+	}
+	voxel::Region region = volumeRegion;
+	region.shiftUpperCorner(1, 1, 1);
+
+	voxel::ChunkMesh mesh;
+	SurfaceExtractionContext ctx = voxel::createContext(voxel::SurfaceExtractionType::Binary, &v, region,
+														voxel::getPalette(), mesh, glm::ivec3(0));
+	voxel::extractSurface(ctx);
+	EXPECT_EQ(8, (int)mesh.mesh[0].getNoOfVertices());
+	EXPECT_EQ(36, (int)mesh.mesh[0].getNoOfIndices());
+	EXPECT_EQ(0, (int)mesh.mesh[1].getNoOfIndices());
+}
+
 } // namespace voxel
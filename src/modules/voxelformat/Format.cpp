@@ -11,7 +11,10 @@
 #include "core/Log.h"
 #include "core/StringUtil.h"
 #include "core/Var.h"
+#include "core/Trace.h"
 #include "core/collection/DynamicArray.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/TaskGroup.h"
 #include "image/Image.h"
 #include "io/Archive.h"
 #include "math/Math.h"
@@ -193,6 +196,44 @@ bool Format::stopExecution() {
 	return app::App::getInstance()->shouldQuit();
 }
 
+bool Format::processPayloads(int n, const std::function<bool(int)> &func) {
+	core_trace_scoped(ProcessPayloads);
+	if (n <= 0) {
+		return true;
+	}
+	if (n == 1) {
+		return func(0);
+	}
+	core::AtomicBool success(true);
+	core::TaskGroup taskGroup(app::App::getInstance()->threadPool());
+	for (int i = 0; i < n; ++i) {
+		taskGroup.run([i, &func, &success]() {
+			if (!func(i)) {
+				success = false;
+			}
+		});
+	}
+	taskGroup.wait();
+	return success;
+}
+
+bool Format::addNode(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &&node, int parent,
+					 const LoadContext &ctx) {
+	if (ctx.nodeSink == nullptr || !node.isAnyModelNode()) {
+		return sceneGraph.emplace(core::move(node), parent) != InvalidNodeId;
+	}
+	prepareStreamedNode(node);
+	return ctx.nodeSink->addNode(core::move(node));
+}
+
+void PaletteFormat::prepareStreamedNode(scenegraph::SceneGraphNode &node) {
+	// see loadGroups()
+	if (!core::Var::getSafe(cfg::VoxelCreatePalette)->boolVal()) {
+		node.remapToPalette(voxel::getPalette());
+		node.setPalette(voxel::getPalette());
+	}
+}
+
 bool PaletteFormat::loadGroups(const core::String &filename, const io::ArchivePtr &archive,
 							   scenegraph::SceneGraph &sceneGraph, const LoadContext &ctx) {
 	palette::Palette palette;
@@ -15,6 +15,7 @@
 #include "voxel/RawVolume.h"
 #include "voxelformat/FormatThumbnail.h"
 #include <glm/fwd.hpp>
+#include <functional>
 
 namespace palette {
 class Palette;
@@ -35,14 +36,51 @@ using RGBAMap = core::DynamicMap<core::RGBA, bool, 1031, core::RGBAHasher>;
 
 typedef void (*ProgressMonitor)(const char *name, int cur, int max);
 
+/**
+ * @brief Receives the model nodes of formats that are able to load them incrementally
+ *
+ * This allows to process scenes that don't fit into memory at once - the format hands over every node as soon as it
+ * is loaded and doesn't keep it in its own scene graph.
+ * @note Only a few formats support this (e.g. the minecraft region formats and the sandbox vxm format). All other
+ * formats just fill the scene graph as usual.
+ * @sa LoadContext::nodeSink
+ */
+class NodeSink {
+public:
+	virtual ~NodeSink() = default;
+	/**
+	 * @brief The sink takes over the node
+	 * @return @c false to abort the loading
+	 */
+	virtual bool addNode(scenegraph::SceneGraphNode &&node) = 0;
+};
+
 struct LoadContext {
 	ProgressMonitor monitor = nullptr;
+	/**
+	 * If this is set, the formats that support streaming are handing the model nodes to the sink instead of putting
+	 * them into the scene graph.
+	 */
+	NodeSink *nodeSink = nullptr;
+	/**
+	 * The max amount of voxel data in bytes that a streaming format should keep in flight while it hands the nodes
+	 * over to the @c nodeSink - @c 0 means that there is no limit
+	 */
+	size_t memoryBudget = 0u;
 	inline void progress(const char *name, int cur, int max) const {
 		if (monitor == nullptr) {
 			return;
 		}
 		monitor(name, cur, max);
 	}
+	/**
+	 * @brief Formats that are loading other formats and need their nodes in the scene graph must use this context
+	 */
+	inline LoadContext withoutSink() const {
+		LoadContext ctx = *this;
+		ctx.nodeSink = nullptr;
+		return ctx;
+	}
 };
 struct SaveContext {
 	ProgressMonitor monitor = nullptr;
@@ -112,6 +150,34 @@ protected:
 	 */
 	static bool stopExecution();
 
+	/**
+	 * @brief Adds a loaded model node to the scene graph or hands it over to the @c NodeSink of the load context
+	 * @note Formats that are calling this for their model nodes are supporting the streaming of nodes
+	 * @return @c false if the node couldn't get added or the sink aborted the loading
+	 */
+	bool addNode(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &&node, int parent,
+				 const LoadContext &ctx);
+	/**
+	 * @brief Called for every node that is handed over to the @c NodeSink. Any post processing that is usually done
+	 * on the whole scene graph after loading must be applied here.
+	 */
+	virtual void prepareStreamedNode(scenegraph::SceneGraphNode &node) {
+	}
+
+	/**
+	 * @brief Runs the expensive part of loading or saving independent node payloads on the thread pool
+	 *
+	 * Formats that store the voxels of every node independently (e.g. separately compressed) are first doing a
+	 * sequential pass over the structure of the file to collect the payloads and their offsets. This executes the
+	 * decoding or encoding of the payloads in parallel. The results must be applied afterwards in the order of the file
+	 * to keep the scene graph and the written data stable.
+	 *
+	 * @param[in] n The amount of payloads
+	 * @param[in] func Called once for every payload index - must only touch the state of that payload
+	 * @return @c false if any of the calls returned @c false
+	 */
+	static bool processPayloads(int n, const std::function<bool(int)> &func);
+
 	static core::String stringProperty(const scenegraph::SceneGraphNode *node, const core::String &name,
 									   const core::String &defaultVal = "");
 	static bool boolProperty(const scenegraph::SceneGraphNode *node, const core::String &name, bool defaultVal = false);
@@ -210,6 +276,7 @@ protected:
 	 * @return A palette index of @c -1 means that the format doesn't support this feature. Otherwise an index between @c [0,palette::PaletteMaxColors] must be used
 	 */
 	virtual int emptyPaletteIndex() const;
+	void prepareStreamedNode(scenegraph::SceneGraphNode &node) override;
 	bool loadGroups(const core::String &filename, const io::ArchivePtr &archive, scenegraph::SceneGraph &sceneGraph,
 					const LoadContext &ctx) override final;
 
@@ -626,6 +626,9 @@ bool loadFormat(const io::FileDescription &fileDesc, const io::ArchivePtr &archi
 		if (!f->load(filename, archive, newSceneGraph, ctx)) {
 			Log::error("Error while loading %s", filename.c_str());
 			newSceneGraph.clear();
+			if (ctx.nodeSink != nullptr) {
+				return false;
+			}
 		}
 	} else {
 		Log::error("Failed to load model file %s - unsupported "
@@ -636,6 +639,11 @@ bool loadFormat(const io::FileDescription &fileDesc, const io::ArchivePtr &archi
 	const int models = (int)newSceneGraph.size(scenegraph::SceneGraphNodeType::Model);
 	const int points = (int)newSceneGraph.size(scenegraph::SceneGraphNodeType::Point);
 	if (models == 0 && points == 0) {
+		if (ctx.nodeSink != nullptr) {
+			// the models might have been handed over to the sink
+			Log::info("Load file %s without model nodes in the scene graph", filename.c_str());
+			return true;
+		}
 		Log::error("Failed to load model file %s. Scene graph "
 				   "doesn't contain models.",
 				   filename.c_str());
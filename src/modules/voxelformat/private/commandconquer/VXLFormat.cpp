@@ -109,13 +109,16 @@ bool VXLFormat::writeLayer(io::SeekableWriteStream &stream, const scenegraph::Sc
 
 	offsets.start = stream.pos() - (int64_t)nodeSectionOffset;
 
+	// the span offsets are collected and written after the span data
+	core::Buffer<int32_t> spanStartOffsets(baseSize);
+	core::Buffer<int32_t> spanEndOffsets(baseSize);
 	for (uint32_t i = 0; i < baseSize; i++) {
-		wrapBool(stream.writeInt32(-1))
+		spanStartOffsets[i] = vxl::EmptyColumn;
+		spanEndOffsets[i] = vxl::EmptyColumn;
 	}
+	wrapBool(stream.writeInt32Array(spanStartOffsets.data(), baseSize))
 	offsets.end = stream.pos() - (int64_t)nodeSectionOffset;
-	for (uint32_t i = 0; i < baseSize; i++) {
-		wrapBool(stream.writeInt32(-1))
-	}
+	wrapBool(stream.writeInt32Array(spanEndOffsets.data(), baseSize))
 	offsets.data = stream.pos() - (int64_t)nodeSectionOffset;
 
 	const voxel::RawVolume *v = sceneGraph.resolveVolume(node);
@@ -128,7 +131,6 @@ bool VXLFormat::writeLayer(io::SeekableWriteStream &stream, const scenegraph::Sc
 
 		int32_t spanStartOffset = vxl::EmptyColumn;
 		int32_t spanEndOffset = vxl::EmptyColumn;
-		int64_t spanEndPos = stream.pos();
 		if (!spanIsEmpty(v, x, z)) {
 			uint8_t skipCount = 0u;
 			for (int y = region.getLowerY(); y <= region.getUpperY();) {
@@ -145,30 +147,26 @@ bool VXLFormat::writeLayer(io::SeekableWriteStream &stream, const scenegraph::Sc
 			if (skipCount > 0) {
 				wrapBool(writeLayerBodyEntry(stream, v, 0, 0, 0, skipCount, 0, node.normalPalette()))
 			}
-			spanEndPos = stream.pos();
-			const int64_t spanDelta = spanEndPos - spanStartPos;
+			const int64_t spanDelta = stream.pos() - spanStartPos;
 			spanStartOffset = (int32_t)(spanStartPos - spanDataOffset);
 			spanEndOffset = (int32_t)(spanStartOffset + spanDelta - 1);
 		}
-
-		if (stream.seek(globalSpanStartPos + i * sizeof(uint32_t)) == -1) {
-			Log::error("Failed to seek");
-			return false;
-		}
-		wrapBool(stream.writeInt32(spanStartOffset))
 		Log::trace("Write SpanStartPos: %i", spanStartOffset);
-
-		if (stream.seek(globalSpanStartPos + (i + baseSize) * sizeof(uint32_t)) == -1) {
-			Log::error("Failed to seek");
-			return false;
-		}
-		wrapBool(stream.writeInt32(spanEndOffset))
 		Log::trace("Write SpanEndPos: %i", spanEndOffset);
+		spanStartOffsets[i] = spanStartOffset;
+		spanEndOffsets[i] = spanEndOffset;
+	}
 
-		if (stream.seek(spanEndPos) == -1) {
-			Log::error("Failed to seek");
-			return false;
-		}
+	const int64_t spanEndPos = stream.pos();
+	if (stream.seek(globalSpanStartPos) == -1) {
+		Log::error("Failed to seek");
+		return false;
+	}
+	wrapBool(stream.writeInt32Array(spanStartOffsets.data(), baseSize))
+	wrapBool(stream.writeInt32Array(spanEndOffsets.data(), baseSize))
+	if (stream.seek(spanEndPos) == -1) {
+		Log::error("Failed to seek");
+		return false;
 	}
 
 	return true;
@@ -394,12 +392,8 @@ bool VXLFormat::readLayer(io::SeekableReadStream &stream, vxl::VXLModel &mdl, ui
 		Log::error("Failed to skip %u layer start offset bytes", footer.spanStartOffset);
 		return false;
 	}
-	for (uint32_t i = 0; i < baseSize; ++i) {
-		wrap(stream.readInt32(colStart[i]))
-	}
-	for (uint32_t i = 0; i < baseSize; ++i) {
-		wrap(stream.readInt32(colEnd[i]))
-	}
+	wrap(stream.readInt32Array(colStart.data(), baseSize))
+	wrap(stream.readInt32Array(colEnd.data(), baseSize))
 
 	const uint64_t dataStart = stream.pos();
 	if (dataStart - nodeStart != footer.spanDataOffset) {
@@ -462,11 +456,12 @@ bool VXLFormat::readLayer(io::SeekableReadStream &stream, vxl::VXLModel &mdl, ui
 
 			Log::trace("skipCount: %i voxelCount: %i", (int)skipCount, (int)voxelCount);
 
+			// color and normal index pairs
+			uint8_t span[2 * 256];
+			wrap(stream.readUInt8Array(span, 2 * voxelCount))
 			for (uint8_t j = 0u; j < voxelCount; ++j) {
-				uint8_t color;
-				wrap(stream.readUInt8(color))
-				uint8_t normal;
-				wrap(stream.readUInt8(normal))
+				const uint8_t color = span[2 * j + 0];
+				const uint8_t normal = span[2 * j + 1];
 				maxNormalIndex = core_max(maxNormalIndex, normal);
 				const voxel::Voxel v = voxel::createVoxel(palette, color, normal);
 				pos.y = z;
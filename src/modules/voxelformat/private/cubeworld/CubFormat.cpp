@@ -5,6 +5,7 @@
 #include "CubFormat.h"
 #include "core/Log.h"
 #include "core/ScopedPtr.h"
+#include "core/collection/DynamicArray.h"
 #include "scenegraph/SceneGraph.h"
 #include "palette/PaletteLookup.h"
 
@@ -40,13 +41,15 @@ size_t CubFormat::loadPalette(const core::String &filename, const io::ArchivePtr
 		return 0;
 	}
 
+	core::DynamicArray<uint8_t> row;
+	row.resize((size_t)width * 3);
 	for (uint32_t h = 0u; h < height; ++h) {
 		for (uint32_t d = 0u; d < depth; ++d) {
+			wrap(stream->readUInt8Array(row.data(), row.size()))
 			for (uint32_t w = 0u; w < width; ++w) {
-				uint8_t r, g, b;
-				wrap(stream->readUInt8(r))
-				wrap(stream->readUInt8(g))
-				wrap(stream->readUInt8(b))
+				const uint8_t r = row[w * 3 + 0];
+				const uint8_t g = row[w * 3 + 1];
+				const uint8_t b = row[w * 3 + 2];
 				if (r == 0u && g == 0u && b == 0u) {
 					// empty voxel
 					continue;
@@ -86,13 +89,15 @@ bool CubFormat::loadGroupsRGBA(const core::String &filename, const io::ArchivePt
 	scenegraph::SceneGraphNode node;
 	node.setVolume(volume, true);
 	palette::PaletteLookup palLookup(palette);
+	core::DynamicArray<uint8_t> row;
+	row.resize((size_t)width * 3);
 	for (uint32_t h = 0u; h < height; ++h) {
 		for (uint32_t d = 0u; d < depth; ++d) {
+			wrap(stream->readUInt8Array(row.data(), row.size()))
 			for (uint32_t w = 0u; w < width; ++w) {
-				uint8_t r, g, b;
-				wrap(stream->readUInt8(r))
-				wrap(stream->readUInt8(g))
-				wrap(stream->readUInt8(b))
+				const uint8_t r = row[w * 3 + 0];
+				const uint8_t g = row[w * 3 + 1];
+				const uint8_t b = row[w * 3 + 2];
 				if (r == 0u && g == 0u && b == 0u) {
 					// empty voxel
 					continue;
@@ -137,15 +142,16 @@ bool CubFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core:
 	wrapBool(stream->writeUInt32(height))
 
 	const palette::Palette &palette = node->palette();
+	core::DynamicArray<uint8_t> row;
+	row.resize((size_t)width * 3);
 	for (uint32_t y = 0u; y < height; ++y) {
 		for (uint32_t z = 0u; z < depth; ++z) {
 			for (uint32_t x = 0u; x < width; ++x) {
 				core_assert_always(sampler.setPosition(lower.x + x, lower.y + y, lower.z + z));
 				const voxel::Voxel &voxel = sampler.voxel();
+				uint8_t *rgb = &row[x * 3];
 				if (voxel.getMaterial() == voxel::VoxelType::Air) {
-					wrapBool(stream->writeUInt8(0))
-					wrapBool(stream->writeUInt8(0))
-					wrapBool(stream->writeUInt8(0))
+					rgb[0] = rgb[1] = rgb[2] = 0;
 					continue;
 				}
 
@@ -153,10 +159,11 @@ bool CubFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core:
 				if (rgba.r == 0u && rgba.g == 0u && rgba.b == 0u) {
 					rgba = palette.color(palette.findReplacement(voxel.getColor()));
 				}
-				wrapBool(stream->writeUInt8(rgba.r))
-				wrapBool(stream->writeUInt8(rgba.g))
-				wrapBool(stream->writeUInt8(rgba.b))
+				rgb[0] = rgba.r;
+				rgb[1] = rgba.g;
+				rgb[2] = rgba.b;
 			}
+			wrapBool(stream->writeUInt8Array(row.data(), row.size()))
 		}
 	}
 	return true;
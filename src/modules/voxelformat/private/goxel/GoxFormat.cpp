@@ -202,7 +202,7 @@ bool GoxFormat::loadChunk_LAYR(State &state, const GoxChunk &c, io::SeekableRead
 			delete modelVolume;
 			return false;
 		}
-		if (index > state.images.size()) {
+		if (index >= state.images.size()) {
 			Log::error("Index out of bounds: %u", index);
 			delete modelVolume;
 			return false;
@@ -352,24 +352,44 @@ bool GoxFormat::loadChunk_LAYR(State &state, const GoxChunk &c, io::SeekableRead
 }
 
 bool GoxFormat::loadChunk_BL16(State &state, const GoxChunk &c, io::SeekableReadStream &stream) {
-	uint8_t *png = (uint8_t *)core_malloc(c.length);
-	wrapBool(loadChunk_ReadData(stream, (char *)png, c.length))
-	image::ImagePtr img = image::createEmptyImage("gox-voxeldata");
-	bool success = img->load(png, c.length);
-	core_free(png);
-	if (!success) {
-		Log::error("Failed to load png chunk");
+	if (c.length <= 0) {
+		Log::error("Invalid png chunk size: %i", c.length);
 		return false;
 	}
-	if (img->width() != 64 || img->height() != 64 || img->depth() != 4) {
-		Log::error("Invalid image dimensions: %i:%i", img->width(), img->height());
-		return false;
-	}
-	Log::debug("Found BL16 with index %i", (int)state.images.size());
-	state.images.push_back(img);
+	core::Buffer<uint8_t> png;
+	png.resize(c.length);
+	wrapBool(loadChunk_ReadData(stream, (char *)png.data(), c.length))
+	Log::debug("Found BL16 with index %i", (int)(state.images.size() + state.pendingImages.size()));
+	// the blocks are independent - they are decoded in parallel once they are referenced
+	state.pendingImages.push_back(core::move(png));
 	return true;
 }
 
+bool GoxFormat::decodePendingImages(State &state) {
+	const int n = (int)state.pendingImages.size();
+	if (n == 0) {
+		return true;
+	}
+	const size_t first = state.images.size();
+	state.images.resize(first + n);
+	const bool success = processPayloads(n, [&](int i) {
+		const core::Buffer<uint8_t> &png = state.pendingImages[i];
+		image::ImagePtr img = image::createEmptyImage("gox-voxeldata");
+		if (!img->load(png.data(), (int)png.size())) {
+			Log::error("Failed to load png chunk");
+			return false;
+		}
+		if (img->width() != 64 || img->height() != 64 || img->depth() != 4) {
+			Log::error("Invalid image dimensions: %i:%i", img->width(), img->height());
+			return false;
+		}
+		state.images[first + i] = img;
+		return true;
+	});
+	state.pendingImages.clear();
+	return success;
+}
+
 bool GoxFormat::loadChunk_MATE(State &state, const GoxChunk &c, io::SeekableReadStream &stream,
 							   scenegraph::SceneGraph &sceneGraph) {
 	char dictKey[256];
@@ -555,6 +575,7 @@ size_t GoxFormat::loadPalette(const core::String &filename, const io::ArchivePtr
 		}
 		loadChunk_ValidateCRC(*stream);
 	}
+	wrapBool(decodePendingImages(state))
 
 	for (image::ImagePtr &img : state.images) {
 		for (int x = 0; x < img->width(); ++x) {
@@ -600,6 +621,7 @@ bool GoxFormat::loadGroupsRGBA(const core::String &filename, const io::ArchivePt
 		if (c.type == FourCC('B', 'L', '1', '6')) {
 			wrapBool(loadChunk_BL16(state, c, *stream))
 		} else if (c.type == FourCC('L', 'A', 'Y', 'R')) {
+			wrapBool(decodePendingImages(state))
 			wrapBool(loadChunk_LAYR(state, c, *stream, sceneGraph, palette))
 		} else if (c.type == FourCC('C', 'A', 'M', 'R')) {
 			wrapBool(loadChunk_CAMR(state, c, *stream, sceneGraph))
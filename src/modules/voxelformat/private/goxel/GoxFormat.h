@@ -7,6 +7,7 @@
 #include "core/collection/StringMap.h"
 #include "palette/Palette.h"
 #include "voxelformat/Format.h"
+#include "core/collection/Buffer.h"
 #include "core/collection/DynamicArray.h"
 #include "io/Stream.h"
 
@@ -84,6 +85,8 @@ private:
 	struct State {
 		int32_t version = 0;
 		core::DynamicArray<image::ImagePtr> images;
+		/** the png data of the BL16 chunks that were not yet decoded - they are decoded in parallel */
+		core::DynamicArray<core::Buffer<uint8_t>> pendingImages;
 		core::StringMap<palette::Material> materials;
 	};
 
@@ -94,6 +97,7 @@ private:
 	bool loadChunk_LAYR(State &state, const GoxChunk &c, io::SeekableReadStream &stream,
 						scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette);
 	bool loadChunk_BL16(State &state, const GoxChunk &c, io::SeekableReadStream &stream);
+	bool decodePendingImages(State &state);
 	bool loadChunk_MATE(State &state, const GoxChunk &c, io::SeekableReadStream &stream,
 						scenegraph::SceneGraph &sceneGraph);
 	bool loadChunk_CAMR(State &state, const GoxChunk &c, io::SeekableReadStream &stream,
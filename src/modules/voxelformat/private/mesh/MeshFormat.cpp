@@ -4,18 +4,18 @@
 
 #include "MeshFormat.h"
 #include "app/App.h"
-#include "app/Async.h"
 #include "core/Color.h"
 #include "core/GLM.h"
 #include "core/GameConfig.h"
 #include "core/Log.h"
 #include "core/RGBA.h"
 #include "core/StringUtil.h"
+#include "core/Trace.h"
 #include "core/Var.h"
 #include "core/collection/DynamicArray.h"
 #include "core/collection/DynamicMap.h"
 #include "core/collection/Map.h"
-#include "core/concurrent/Lock.h"
+#include "core/concurrent/TaskGroup.h"
 #include "io/Archive.h"
 #include "io/FormatDescription.h"
 #include "palette/NormalPalette.h"
@@ -29,7 +29,7 @@
 #include "voxel/SurfaceExtractor.h"
 #include "voxel/Voxel.h"
 #include "voxelutil/VoxelUtil.h"
-#include <SDL_timer.h>
+#include <float.h>
 #include <glm/ext/scalar_constants.hpp>
 #include <glm/geometric.hpp>
 #include <glm/gtc/epsilon.hpp>
@@ -37,7 +37,6 @@
 namespace voxelformat {
 
 #define AlphaThreshold 0
-#define MaxTriangleColorContributions 4
 
 MeshFormat::MeshFormat() {
 	_flattenFactor = core::Var::getSafe(cfg::VoxformatRGBFlattenFactor)->intVal();
@@ -72,54 +71,57 @@ glm::vec3 MeshFormat::getInputScale() {
 	return {scaleX, scaleY, scaleZ};
 }
 
-void MeshFormat::subdivideTri(const voxelformat::TexturedTri &tri, TriCollection &tinyTris) {
-	if (stopExecution()) {
-		return;
-	}
-	const glm::vec3 &mins = tri.mins();
-	const glm::vec3 &maxs = tri.maxs();
-	const glm::vec3 size = maxs - mins;
-	if (glm::any(glm::greaterThan(size, glm::vec3(1.0f)))) {
-		voxelformat::TexturedTri out[4];
-		tri.subdivide(out);
-		for (int i = 0; i < lengthof(out); ++i) {
-			subdivideTri(out[i], tinyTris);
-		}
-		return;
-	}
-	tinyTris.push_back(tri);
-}
-
 core::RGBA MeshFormat::PosSampling::getColor(uint8_t flattenFactor, bool weightedAverage) const {
-	if (entries.size() == 1) {
+	if (count == 1) {
 		return core::Color::flattenRGB(entries[0].color.r, entries[0].color.g, entries[0].color.b, entries[0].color.a,
 									   flattenFactor);
 	}
 	if (weightedAverage) {
 		float sumArea = 0.0f;
-		for (const PosSamplingEntry &pe : entries) {
-			sumArea += pe.area;
+		for (int i = 0; i < count; ++i) {
+			sumArea += entries[i].area;
 		}
 		core::RGBA color(0, 0, 0, 255);
 		if (sumArea <= 0.0f) {
 			return color;
 		}
-		for (const PosSamplingEntry &pe : entries) {
-			color = core::RGBA::mix(color, pe.color, pe.area / sumArea);
+		for (int i = 0; i < count; ++i) {
+			color = core::RGBA::mix(color, entries[i].color, entries[i].area / sumArea);
 		}
 		return core::Color::flattenRGB(color.r, color.g, color.b, color.a, flattenFactor);
 	}
 	core::RGBA color(0, 0, 0, AlphaThreshold);
 	float area = 0.0f;
-	for (const PosSamplingEntry &pe : entries) {
-		if (pe.area > area) {
-			area = pe.area;
-			color = pe.color;
+	for (int i = 0; i < count; ++i) {
+		if (entries[i].area > area) {
+			area = entries[i].area;
+			color = entries[i].color;
 		}
 	}
 	return core::Color::flattenRGB(color.r, color.g, color.b, color.a, flattenFactor);
 }
 
+MeshFormat::PosSamplingTile::PosSamplingTile(const voxel::Region &region) : _region(region) {
+	_slots.resize(region.voxels());
+	_slots.fill(-1);
+}
+
+void MeshFormat::PosSamplingTile::add(const glm::ivec3 &pos, float area, core::RGBA color) {
+	if (!_region.containsPoint(pos)) {
+		return;
+	}
+	const glm::ivec3 local = pos - _region.getLowerCorner();
+	const int idx = local.x + (local.y + local.z * _region.getHeightInVoxels()) * _region.getWidthInVoxels();
+	const int slot = _slots[idx];
+	if (slot == -1) {
+		_slots[idx] = (int)_samples.size();
+		_positions.push_back(pos);
+		_samples.emplace_back(area, color);
+		return;
+	}
+	_samples[slot].add(area, color);
+}
+
 static void convertToVoxelGrid(glm::vec3 &v) {
 	// convert into voxel grid coordinates
 	if (v.x < 0.0f) {
@@ -142,73 +144,173 @@ glm::vec2 MeshFormat::paletteUV(int colorIndex) {
 	return {u, v};
 }
 
-void MeshFormat::transformTris(const voxel::Region &region, const TriCollection &tris, PosMap &posMap) {
-	Log::debug("subdivided into %i triangles", (int)tris.size());
-	for (const voxelformat::TexturedTri &tri : tris) {
-		if (stopExecution()) {
-			return;
-		}
-		const float area = tri.area();
-		const core::RGBA rgba = tri.centerColor();
-		if (rgba.a <= AlphaThreshold) {
-			continue;
-		}
-		glm::vec3 c = tri.center();
-		convertToVoxelGrid(c);
-
-		const glm::ivec3 p(c);
-		core_assert_msg(region.containsPoint(p), "Failed to transform tri %i:%i:%i (region: %s)", p.x, p.y, p.z,
-						region.toString().c_str());
-		auto iter = posMap.find(p);
-		if (iter == posMap.end()) {
-			posMap.emplace(p, {area, rgba});
-		} else if (iter->value.entries.size() < MaxTriangleColorContributions && iter->value.entries[0].color != rgba) {
-			PosSampling &pos = iter->value;
-			pos.entries.emplace_back(area, rgba);
+void MeshFormat::transformTri(const voxelformat::TexturedTri &tri, PosSamplingTile &tile) {
+	// voxel boxes are shifted by this value to make them half open - a triangle on a voxel boundary plane only
+	// touches one layer of voxels
+	const float boundaryEpsilon = 0.001f;
+	const voxel::Region &region = tile.region();
+	const glm::ivec3 mins = glm::max(glm::ivec3(glm::floor(tri.mins())), region.getLowerCorner());
+	const glm::ivec3 maxs =
+		glm::min(glm::ivec3(glm::floor(tri.maxs() + boundaryEpsilon)), region.getUpperCorner());
+	if (glm::any(glm::greaterThan(mins, maxs))) {
+		return;
+	}
+	const glm::vec3 &v0 = tri.vertices[0];
+	const glm::vec3 &v1 = tri.vertices[1];
+	const glm::vec3 &v2 = tri.vertices[2];
+	const glm::vec3 normal = tri.normal();
+	// a triangle contributes at most one voxel face worth of area to a voxel
+	const float weight = glm::min(glm::length(normal) * 0.5f, 1.0f);
+	const glm::vec3 absNormal = glm::abs(normal);
+	int axis = 0;
+	if (absNormal.y > absNormal[axis]) {
+		axis = 1;
+	}
+	if (absNormal.z > absNormal[axis]) {
+		axis = 2;
+	}
+	const int axis1 = (axis + 1) % 3;
+	const int axis2 = (axis + 2) % 3;
+	const float planeDist = glm::dot(normal, v0);
+	const bool degenerated = absNormal[axis] <= glm::epsilon<float>();
+	const glm::vec3 voxelHalf(0.5f);
+
+	glm::ivec3 p;
+	for (p[axis1] = mins[axis1]; p[axis1] <= maxs[axis1]; ++p[axis1]) {
+		for (p[axis2] = mins[axis2]; p[axis2] <= maxs[axis2]; ++p[axis2]) {
+			int lower = mins[axis];
+			int upper = maxs[axis];
+			if (!degenerated) {
+				// the range of the triangle plane along the dominant axis within this column
+				float planeMin = FLT_MAX;
+				float planeMax = -FLT_MAX;
+				for (int c = 0; c < 4; ++c) {
+					const float u = (float)(p[axis1] + (c & 1));
+					const float v = (float)(p[axis2] + (c >> 1));
+					const float d = (planeDist - normal[axis1] * u - normal[axis2] * v) / normal[axis];
+					planeMin = glm::min(planeMin, d);
+					planeMax = glm::max(planeMax, d);
+				}
+				lower = glm::max(lower, (int)glm::floor(planeMin));
+				upper = glm::min(upper, (int)glm::floor(planeMax + boundaryEpsilon));
+			}
+			for (p[axis] = lower; p[axis] <= upper; ++p[axis]) {
+				const glm::vec3 center = glm::vec3(p) + (0.5f - boundaryEpsilon);
+				if (!glm::intersectTriangleAABB(center, voxelHalf, v0, v1, v2)) {
+					continue;
+				}
+				// the closest point on the triangle for voxels whose center is not above the triangle
+				glm::vec3 barycentric = glm::max(tri.calculateBarycentric(center), glm::vec3(0.0f));
+				const float sum = barycentric.x + barycentric.y + barycentric.z;
+				if (sum > 0.0f) {
+					barycentric /= sum;
+				} else {
+					barycentric = glm::vec3(1.0f / 3.0f);
+				}
+				const core::RGBA rgba = tri.colorAtBarycentric(barycentric);
+				if (rgba.a <= AlphaThreshold) {
+					continue;
+				}
+				tile.add(p, weight, rgba);
+			}
 		}
 	}
 }
 
-void MeshFormat::transformTrisAxisAligned(const voxel::Region &region, const TriCollection &tris, PosMap &posMap) {
-	Log::debug("axis aligned %i triangles", (int)tris.size());
-	for (const voxelformat::TexturedTri &tri : tris) {
-		if (stopExecution()) {
-			return;
-		}
-		const core::RGBA rgba = tri.centerColor();
-		if (rgba.a <= AlphaThreshold) {
-			continue;
+void MeshFormat::transformTriAxisAligned(const voxelformat::TexturedTri &tri, PosSamplingTile &tile) {
+	const core::RGBA rgba = tri.centerColor();
+	if (rgba.a <= AlphaThreshold) {
+		return;
+	}
+	const float area = tri.area();
+	const glm::vec3 &normal = glm::normalize(tri.normal());
+	const glm::ivec3 sideDelta(normal.x <= 0 ? 0 : -1, normal.y <= 0 ? 0 : -1, normal.z <= 0 ? 0 : -1);
+	// only visit the positions that are part of the tile
+	const voxel::Region &region = tile.region();
+	const glm::ivec3 mins = glm::max(tri.roundedMins(), region.getLowerCorner() - sideDelta);
+	const glm::ivec3 maxs = glm::min(tri.roundedMaxs() + glm::ivec3(glm::round(glm::abs(normal))),
+									 region.getUpperCorner() - sideDelta + 1);
+
+	for (int x = mins.x; x < maxs.x; x++) {
+		for (int y = mins.y; y < maxs.y; y++) {
+			for (int z = mins.z; z < maxs.z; z++) {
+				tile.add(glm::ivec3(x + sideDelta.x, y + sideDelta.y, z + sideDelta.z), area, rgba);
+			}
 		}
-		const float area = tri.area();
-		const glm::vec3 &normal = glm::normalize(tri.normal());
-		const glm::ivec3 sideDelta(normal.x <= 0 ? 0 : -1, normal.y <= 0 ? 0 : -1, normal.z <= 0 ? 0 : -1);
-		const glm::ivec3 mins = tri.roundedMins();
-		const glm::ivec3 maxs = tri.roundedMaxs() + glm::ivec3(glm::round(glm::abs(normal)));
-		Log::debug("mins: %i:%i:%i", mins.x, mins.y, mins.z);
-		Log::debug("maxs: %i:%i:%i", maxs.x, maxs.y, maxs.z);
-		Log::debug("normal: %f:%f:%f", normal.x, normal.y, normal.z);
-		Log::debug("sideDelta: %i:%i:%i", sideDelta.x, sideDelta.y, sideDelta.z);
-
-		for (int x = mins.x; x < maxs.x; x++) {
-			for (int y = mins.y; y < maxs.y; y++) {
-				for (int z = mins.z; z < maxs.z; z++) {
-					const glm::ivec3 p(x + sideDelta.x, y + sideDelta.y, z + sideDelta.z);
-					if (!region.containsPoint(p)) {
-						Log::debug("Failed to transform tri %i:%i:%i (region: %s), (sideDelta: %i:%i:%i)", p.x, p.y,
-								   p.z, region.toString().c_str(), sideDelta.x, sideDelta.y, sideDelta.z);
-						continue;
-					}
-					auto iter = posMap.find(p);
-					if (iter == posMap.end()) {
-						posMap.emplace(p, {area, rgba});
-					} else if (iter->value.entries.size() < MaxTriangleColorContributions && iter->value.entries[0].color != rgba) {
-						PosSampling &pos = iter->value;
-						pos.entries.emplace_back(area, rgba);
+	}
+}
+
+core::DynamicArray<MeshFormat::PosColors> MeshFormat::transformTiles(const voxel::Region &region,
+																	  const TriCollection &tris,
+																	  bool axisAligned) const {
+	core_trace_scoped(TransformTiles);
+	const glm::ivec3 &lower = region.getLowerCorner();
+	const glm::ivec3 tiles = (region.getDimensionsInVoxels() + VoxelizeTileSize - 1) / VoxelizeTileSize;
+	core::DynamicArray<core::DynamicArray<int>> bins;
+	bins.resize((size_t)tiles.x * tiles.y * tiles.z);
+	{
+		core_trace_scoped(BinTriangles);
+		for (int i = 0; i < (int)tris.size(); ++i) {
+			const voxelformat::TexturedTri &tri = tris[i];
+			// a triangle can put voxels one position in front of its bounds (see the side delta of the axis aligned
+			// triangles)
+			const glm::ivec3 mins = glm::ivec3(glm::floor(tri.mins())) - 1;
+			const glm::ivec3 maxs = glm::ivec3(glm::ceil(tri.maxs())) + 1;
+			const glm::ivec3 tileMins = (glm::clamp(mins, lower, region.getUpperCorner()) - lower) / VoxelizeTileSize;
+			const glm::ivec3 tileMaxs = (glm::clamp(maxs, lower, region.getUpperCorner()) - lower) / VoxelizeTileSize;
+			for (int z = tileMins.z; z <= tileMaxs.z; ++z) {
+				for (int y = tileMins.y; y <= tileMaxs.y; ++y) {
+					for (int x = tileMins.x; x <= tileMaxs.x; ++x) {
+						bins[x + (y + z * tiles.y) * tiles.x].push_back(i);
 					}
 				}
 			}
 		}
 	}
+
+	core::DynamicArray<PosColors> results;
+	results.resize(bins.size());
+	auto transformTile = [&](int tileIdx) {
+		const core::DynamicArray<int> &bin = bins[tileIdx];
+		const glm::ivec3 tile(tileIdx % tiles.x, (tileIdx / tiles.x) % tiles.y, tileIdx / (tiles.x * tiles.y));
+		const glm::ivec3 tileMins = lower + tile * VoxelizeTileSize;
+		const glm::ivec3 tileMaxs = glm::min(tileMins + VoxelizeTileSize - 1, region.getUpperCorner());
+		PosSamplingTile samples(voxel::Region(tileMins, tileMaxs));
+		if (axisAligned) {
+			for (int triIdx : bin) {
+				if (stopExecution()) {
+					return;
+				}
+				transformTriAxisAligned(tris[triIdx], samples);
+			}
+		} else {
+			for (int triIdx : bin) {
+				if (stopExecution()) {
+					return;
+				}
+				transformTri(tris[triIdx], samples);
+			}
+		}
+		PosColors &out = results[tileIdx];
+		out.reserve(samples.size());
+		for (size_t i = 0; i < samples.size(); ++i) {
+			const core::RGBA rgba = samples.sampling(i).getColor(_flattenFactor, _weightedAverage);
+			if (rgba.a <= AlphaThreshold) {
+				continue;
+			}
+			out.push_back({samples.position(i), rgba});
+		}
+	};
+
+	core::TaskGroup group(app::App::getInstance()->threadPool());
+	for (int tileIdx = 0; tileIdx < (int)bins.size(); ++tileIdx) {
+		if (bins[tileIdx].empty()) {
+			continue;
+		}
+		group.run([&transformTile, tileIdx]() { transformTile(tileIdx); });
+	}
+	group.wait();
+	return results;
 }
 
 bool MeshFormat::isVoxelMesh(const TriCollection &tris) {
@@ -303,11 +405,7 @@ int MeshFormat::voxelizeNode(const core::String &uuid, const core::String &name,
 	const int voxelizeMode = core::Var::getSafe(cfg::VoxformatVoxelizeMode)->intVal();
 	const bool fillHollow = core::Var::getSafe(cfg::VoxformatFillHollow)->boolVal();
 	if (axisAligned) {
-		const int maxVoxels = vdim.x * vdim.y * vdim.z;
-		Log::debug("max voxels: %i (%i:%i:%i)", maxVoxels, vdim.x, vdim.y, vdim.z);
-		PosMap posMap(maxVoxels);
-		transformTrisAxisAligned(region, tris, posMap);
-		voxelizeTris(node, posMap, fillHollow);
+		voxelizeTris(node, transformTiles(region, tris, true), fillHollow);
 	} else if (voxelizeMode == 1) {
 		voxel::RawVolumeWrapper wrapper(node.volume());
 		palette::Palette palette;
@@ -367,30 +465,8 @@ int MeshFormat::voxelizeNode(const core::String &uuid, const core::String &name,
 			voxelutil::fillHollow(wrapper, voxel);
 		}
 	} else {
-		Log::debug("Subdivide %i triangles", (int)tris.size());
-		core::DynamicArray<std::future<TriCollection>> futures;
-		futures.reserve(tris.size());
-		for (const voxelformat::TexturedTri &tri : tris) {
-			futures.emplace_back(app::async([tri]() {
-				TriCollection subdivided;
-				subdivideTri(tri, subdivided);
-				return subdivided;
-			}));
-		}
-		TriCollection subdivided;
-		for (std::future<TriCollection> &future : futures) {
-			const TriCollection &sub = future.get();
-			subdivided.append(sub);
-		}
-
-		if (subdivided.empty()) {
-			Log::warn("Empty volume - could not subdivide");
-			return InvalidNodeId;
-		}
-
-		PosMap posMap((int)subdivided.size() * 3);
-		transformTris(region, subdivided, posMap);
-		voxelizeTris(node, posMap, fillHollow);
+		Log::debug("Voxelize %i triangles", (int)tris.size());
+		voxelizeTris(node, transformTiles(region, tris, false), fillHollow);
 	}
 
 	if (resetOrigin) {
@@ -421,23 +497,20 @@ bool MeshFormat::calculateAABB(const TriCollection &tris, glm::vec3 &mins, glm::
 	return true;
 }
 
-void MeshFormat::voxelizeTris(scenegraph::SceneGraphNode &node, const PosMap &posMap, bool fillHollow) const {
-	voxel::RawVolumeWrapper wrapper(node.volume());
+void MeshFormat::voxelizeTris(scenegraph::SceneGraphNode &node, const core::DynamicArray<PosColors> &tiles,
+							  bool fillHollow) const {
+	if (stopExecution()) {
+		return;
+	}
 	palette::Palette palette;
 	const bool createPalette = core::Var::getSafe(cfg::VoxelCreatePalette)->boolVal();
 	if (createPalette) {
 		RGBAMap colors;
 		Log::debug("create palette");
-		for (const auto &entry : posMap) {
-			if (stopExecution()) {
-				return;
-			}
-			const PosSampling &pos = entry->second;
-			const core::RGBA rgba = pos.getColor(_flattenFactor, _weightedAverage);
-			if (rgba.a <= AlphaThreshold) {
-				continue;
+		for (const PosColors &tile : tiles) {
+			for (const PosColor &entry : tile) {
+				colors.put(entry.color, true);
 			}
-			colors.put(rgba, true);
 		}
 		const size_t colorCount = colors.size();
 		core::Buffer<core::RGBA> colorBuffer;
@@ -450,19 +523,30 @@ void MeshFormat::voxelizeTris(scenegraph::SceneGraphNode &node, const PosMap &po
 		palette = voxel::getPalette();
 	}
 
-	Log::debug("create voxels for %i positions", (int)posMap.size());
-	for (const auto &entry : posMap) {
-		if (stopExecution()) {
-			return;
-		}
-		const PosSampling &pos = entry->second;
-		const core::RGBA rgba = pos.getColor(_flattenFactor, _weightedAverage);
-		if (rgba.a <= AlphaThreshold) {
+	// the tiles don't overlap - so they can be written in parallel
+	voxel::RawVolume *volume = node.volume();
+	core::TaskGroup group(app::App::getInstance()->threadPool());
+	for (const PosColors &tile : tiles) {
+		if (tile.empty()) {
 			continue;
 		}
-		const voxel::Voxel voxel = voxel::createVoxel(palette, palette.getClosestMatch(rgba));
-		wrapper.setVoxel(entry->first, voxel);
+		group.run([&palette, volume, &tile]() {
+			core::DynamicArray<core::RGBA> colors;
+			colors.reserve(tile.size());
+			for (const PosColor &entry : tile) {
+				colors.push_back(entry.color);
+			}
+			core::DynamicArray<int> indices;
+			indices.resize(tile.size());
+			palette.getClosestMatches(colors.data(), indices.data(), colors.size());
+			for (size_t i = 0; i < tile.size(); ++i) {
+				const voxel::Voxel voxel = voxel::createVoxel(palette, indices[i]);
+				volume->setVoxel(tile[i].pos, voxel);
+			}
+		});
 	}
+	group.wait();
+
 	if (palette.colorCount() == 1) {
 		core::RGBA c = palette.color(0);
 		if (c.a == 0) {
@@ -476,6 +560,7 @@ void MeshFormat::voxelizeTris(scenegraph::SceneGraphNode &node, const PosMap &po
 			return;
 		}
 		Log::debug("fill hollows");
+		voxel::RawVolumeWrapper wrapper(volume);
 		const voxel::Voxel voxel = voxel::createVoxel(palette, FillColorIndex);
 		voxelutil::fillHollow(wrapper, voxel);
 	}
@@ -600,6 +685,9 @@ core::String MeshFormat::lookupTexture(const core::String &meshFilename, const c
 	return fullpath;
 }
 
+// the slabs of volumes with at least this amount of voxels are copied into the brick layout for the cubic extraction
+static constexpr int BrickExtractionVoxels = 64 * 64 * 64;
+
 bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core::String &filename,
 							const io::ArchivePtr &archive, const SaveContext &saveCtx) {
 	const bool mergeQuads = core::Var::getSafe(cfg::VoxformatMergequads)->boolVal();
@@ -614,44 +702,57 @@ bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core
 
 	const voxel::SurfaceExtractionType type = (voxel::SurfaceExtractionType)core::Var::getSafe(cfg::VoxelMeshMode)->intVal();
 
-	const size_t models = sceneGraph.size(scenegraph::SceneGraphNodeType::AllModels);
-	Meshes meshes;
-	core::Map<int, int> meshIdxNodeMap;
-	core_trace_mutex(core::Lock, lock, "MeshFormat");
-	// TODO: this could get optimized by re-using the same mesh for multiple nodes (in case of reference nodes)
+	core::DynamicArray<const scenegraph::SceneGraphNode *> nodes;
+	nodes.reserve(sceneGraph.size(scenegraph::SceneGraphNodeType::AllModels));
 	for (auto iter = sceneGraph.beginAllModels(); iter != sceneGraph.end(); ++iter) {
-		const scenegraph::SceneGraphNode &node = *iter;
-		app::async([&, volume = sceneGraph.resolveVolume(node), region = sceneGraph.resolveRegion(node)]() {
-			voxel::ChunkMesh *mesh = new voxel::ChunkMesh();
-			voxel::Region regionExt = region;
-			// we are increasing the region by one voxel to ensure the inclusion of the boundary voxels in this mesh
-			regionExt.shiftUpperCorner(1, 1, 1);
-			voxel::SurfaceExtractionContext ctx =
-				voxel::createContext(type, volume, regionExt, node.palette(), *mesh, {0, 0, 0}, mergeQuads,
-									 reuseVertices, ambientOcclusion);
-			voxel::extractSurface(ctx);
-			if (withNormals) {
-				Log::debug("Calculate normals");
-				mesh->calculateNormals();
-			}
-			if (optimizeMesh) {
-				mesh->optimize();
-			}
-
-			core::ScopedLock scoped(lock);
-			meshes.emplace_back(mesh, node, applyTransform);
-		});
-	}
-	for (;;) {
-		lock.lock();
-		const size_t size = meshes.size();
-		lock.unlock();
-		if (size < models) {
-			SDL_Delay(10);
-		} else {
-			break;
+		nodes.push_back(&*iter);
+	}
+	core::DynamicArray<voxel::ChunkMesh *> chunkMeshes;
+	chunkMeshes.resize(nodes.size());
+	{
+		// the waiting thread executes pending tasks - this doesn't dead lock if the save is called from a worker of
+		// the app pool
+		core::TaskGroup group(app::App::getInstance()->threadPool());
+		// TODO: this could get optimized by re-using the same mesh for multiple nodes (in case of reference nodes)
+		for (size_t i = 0; i < nodes.size(); ++i) {
+			const scenegraph::SceneGraphNode &node = *nodes[i];
+			group.run([&, i, volume = sceneGraph.resolveVolume(node), region = sceneGraph.resolveRegion(node)]() {
+				voxel::ChunkMesh *mesh = new voxel::ChunkMesh();
+				voxel::Region regionExt = region;
+				// we are increasing the region by one voxel to ensure the inclusion of the boundary voxels in this
+				// mesh
+				regionExt.shiftUpperCorner(1, 1, 1);
+				voxel::SurfaceExtractionContext ctx =
+					voxel::createContext(type, volume, regionExt, nodes[i]->palette(), *mesh, {0, 0, 0}, mergeQuads,
+										 reuseVertices, ambientOcclusion);
+				// large volumes are split into slabs that are extracted on the other workers of the pool
+				if (type == voxel::SurfaceExtractionType::Cubic && ambientOcclusion && volume != nullptr &&
+					volume->region().voxels() >= BrickExtractionVoxels) {
+					// the ambient occlusion peeks the 3x3x3 neighbourhood of every visible face - for large volumes
+					// the per slab copy into the brick layout is cheaper than the cache misses of the linear layout
+					voxel::extractSurfaceParallelBricks(ctx);
+				} else {
+					voxel::extractSurfaceParallel(ctx);
+				}
+				if (withNormals) {
+					Log::debug("Calculate normals");
+					mesh->calculateNormals();
+				}
+				if (optimizeMesh) {
+					mesh->optimize();
+				}
+				chunkMeshes[i] = mesh;
+			});
 		}
+		group.wait();
 	}
+	// keep the order of the scene graph nodes
+	Meshes meshes;
+	meshes.reserve(nodes.size());
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		meshes.emplace_back(chunkMeshes[i], *nodes[i], applyTransform);
+	}
+	core::Map<int, int> meshIdxNodeMap;
 	Meshes nonEmptyMeshes;
 	nonEmptyMeshes.reserve(meshes.size());
 
@@ -670,7 +771,7 @@ bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core
 	} else {
 		Log::debug("Save meshes");
 		state = saveMeshes(meshIdxNodeMap, sceneGraph, nonEmptyMeshes, filename, archive, {1.0f, 1.0f, 1.0f},
-						   type == voxel::SurfaceExtractionType::Cubic ? quads : false, withColor, withTexCoords);
+						   type != voxel::SurfaceExtractionType::MarchingCubes ? quads : false, withColor, withTexCoords);
 	}
 	for (MeshExt &meshext : meshes) {
 		delete meshext.mesh;
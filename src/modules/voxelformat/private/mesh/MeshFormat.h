@@ -9,6 +9,7 @@
 #include "core/collection/Map.h"
 #include "io/Archive.h"
 #include "voxel/ChunkMesh.h"
+#include "voxel/Region.h"
 #include "voxelformat/Format.h"
 
 namespace voxelformat {
@@ -23,12 +24,12 @@ namespace voxelformat {
 class MeshFormat : public Format {
 public:
 	static constexpr const uint8_t FillColorIndex = 2;
-	using TriCollection = core::DynamicArray<voxelformat::TexturedTri, 512>;
-
 	/**
-	 * Subdivide until we brought the triangles down to the size of 1 or smaller
+	 * @brief Edge length of the tiles that are voxelized independently of each other
 	 */
-	static void subdivideTri(const voxelformat::TexturedTri &tri, TriCollection &tinyTris);
+	static constexpr const int VoxelizeTileSize = 32;
+	using TriCollection = core::DynamicArray<voxelformat::TexturedTri, 512>;
+
 	static bool calculateAABB(const TriCollection &tris, glm::vec3 &mins, glm::vec3 &maxs);
 	/**
 	 * @brief Checks whether the given triangles are axis aligned - usually true for voxel meshes
@@ -99,6 +100,8 @@ protected:
 	 * during voxelization
 	 */
 	struct PosSamplingEntry {
+		inline PosSamplingEntry() : area(0.0f) {
+		}
 		inline PosSamplingEntry(float _area, core::RGBA _color) : area(_area), color(_color) {
 		}
 		float area;
@@ -110,46 +113,114 @@ protected:
 	 * during voxelization
 	 */
 	struct PosSampling {
-		core::DynamicArray<PosSamplingEntry> entries;
+		static constexpr int MaxEntries = 4;
+		PosSamplingEntry entries[MaxEntries];
+		int count = 0;
+		PosSampling() = default;
 		inline PosSampling(float area, core::RGBA color) {
-			entries.emplace_back(area, color);
+			add(area, color);
+		}
+		/**
+		 * @note Only the first @c MaxEntries different colors are taken into account
+		 */
+		inline void add(float area, core::RGBA color) {
+			if (count >= MaxEntries || (count > 0 && entries[0].color == color)) {
+				return;
+			}
+			entries[count++] = PosSamplingEntry(area, color);
 		}
 		core::RGBA getColor(uint8_t flattenFactor, bool weightedAverage) const;
 	};
 
 	/**
-	 * @brief A map with positions and colors that can get averaged from the input triangles
+	 * @brief Dense buffer with the positions and colors for one tile of the volume
+	 *
+	 * Every tile is filled by only one thread - and because the tiles don't overlap, the colors of the tiles don't
+	 * need to get merged into one shared map.
 	 */
-	typedef core::Map<glm::ivec3, PosSampling, 64, glm::hash<glm::ivec3>> PosMap;
+	class PosSamplingTile {
+	private:
+		voxel::Region _region;
+		/**
+		 * @brief Index into @c _samples for every voxel of the tile - @c -1 if there is no sample yet
+		 */
+		core::DynamicArray<int> _slots;
+		core::DynamicArray<glm::ivec3> _positions;
+		core::DynamicArray<PosSampling> _samples;
+
+	public:
+		PosSamplingTile(const voxel::Region &region);
+
+		/**
+		 * @brief Adds a color sample for the given position - positions outside of the tile region are ignored
+		 */
+		void add(const glm::ivec3 &pos, float area, core::RGBA color);
+
+		inline const voxel::Region &region() const {
+			return _region;
+		}
+		inline size_t size() const {
+			return _samples.size();
+		}
+		inline const glm::ivec3 &position(size_t idx) const {
+			return _positions[idx];
+		}
+		inline const PosSampling &sampling(size_t idx) const {
+			return _samples[idx];
+		}
+	};
+
+	/**
+	 * @brief The final position and color of a voxel
+	 */
+	struct PosColor {
+		glm::ivec3 pos;
+		core::RGBA color;
+	};
+	using PosColors = core::DynamicArray<PosColor>;
 
 	/**
-	 * @brief Convert the given input triangles into a list of positions to place the voxels at
+	 * @brief Convert the given input triangle into a list of positions to place the voxels at
+	 *
+	 * Only the voxels that are touched by the triangle are visited: the triangle plane is walked column by column
+	 * along its dominant normal axis and the few candidate voxels of each column are checked with a separating axis
+	 * triangle/box overlap test. The color is sampled at the voxel center via barycentric coordinates.
 	 *
-	 * @param[in] tris The triangles to voxelize
-	 * @param[out] posMap The PosMap instance to fill with positions and colors
-	 * @sa transformTrisAxisAligned()
+	 * @param[in] tri The triangle to voxelize
+	 * @param[out] tile The tile to fill with positions and colors
+	 * @sa transformTriAxisAligned()
 	 * @sa voxelizeTris()
 	 */
-	static void transformTris(const voxel::Region &region, const TriCollection &tris, PosMap &posMap);
+	static void transformTri(const voxelformat::TexturedTri &tri, PosSamplingTile &tile);
 	/**
-	 * @brief Convert the given input triangles into a list of positions to place the voxels at. This version is for
+	 * @brief Convert the given input triangle into a list of positions to place the voxels at. This version is for
 	 * aligned aligned triangles. This is usually the case for meshes that were exported from voxels.
 	 *
-	 * @param[in] tris The triangles to voxelize
-	 * @param[out] posMap The @c PosMap instance to fill with positions and colors
-	 * @sa transformTris()
+	 * @param[in] tri The triangle to voxelize
+	 * @param[out] tile The tile to fill with positions and colors
+	 * @sa transformTri()
 	 * @sa voxelizeTris()
 	 */
-	static void transformTrisAxisAligned(const voxel::Region &region, const TriCollection &tris, PosMap &posMap);
+	static void transformTriAxisAligned(const voxelformat::TexturedTri &tri, PosSamplingTile &tile);
+	/**
+	 * @brief Bins the triangles into tiles of @c VoxelizeTileSize voxels and converts the tiles in parallel
+	 *
+	 * @param[in] region The region of all triangles
+	 * @param[in] axisAligned Use @c transformTriAxisAligned() instead of @c transformTri()
+	 * @return The voxel positions and colors - one entry per tile that has voxels
+	 */
+	core::DynamicArray<PosColors> transformTiles(const voxel::Region &region, const TriCollection &tris,
+											   bool axisAligned) const;
 	/**
-	 * @brief Convert the given @c PosMap into a volume
+	 * @brief Convert the given positions and colors into a volume
 	 *
-	 * @note The @c PosMap values can get calculated by @c transformTris() or @c transformTrisAxisAligned()
-	 * @param[in] posMap The @c PosMap values with voxel positions and colors
+	 * @note The values can get calculated by @c transformTiles()
+	 * @param[in] tiles The voxel positions and colors
 	 * @param[in] fillHollow Fill the inner parts of a voxel volume
 	 * @param[out] node The node to create the volume in
 	 */
-	void voxelizeTris(scenegraph::SceneGraphNode &node, const PosMap &posMap, bool fillHollow) const;
+	void voxelizeTris(scenegraph::SceneGraphNode &node, const core::DynamicArray<PosColors> &tiles,
+					  bool fillHollow) const;
 
 public:
 	static core::String lookupTexture(const core::String &meshFilename, const core::String &in);
@@ -36,9 +36,11 @@ struct TexturedTri : public math::Tri {
 	[[nodiscard]] bool calcUVs(const glm::vec3 &pos, glm::vec2 &uv) const;
 	core::RGBA colorAt(const glm::vec2 &uv, bool originUpperLeft = false) const;
 	core::RGBA centerColor() const;
-
-	// Sierpinski gasket with keeping the middle
-	void subdivide(TexturedTri out[4]) const;
+	/**
+	 * @brief Interpolates the texture coordinates or the vertex colors with the given barycentric coordinates
+	 * @sa math::Tri::calculateBarycentric()
+	 */
+	core::RGBA colorAtBarycentric(const glm::vec3 &barycentric) const;
 };
 
 } // namespace voxelformat
@@ -3,17 +3,18 @@
  */
 
 #include "DatFormat.h"
-#include "app/Async.h"
+#include "app/App.h"
 #include "core/Color.h"
 #include "core/Common.h"
 #include "core/Log.h"
 #include "core/ScopedPtr.h"
 #include "core/StringUtil.h"
 #include "core/collection/DynamicArray.h"
+#include "core/concurrent/TaskGroup.h"
 #include "io/Archive.h"
 #include "io/ZipReadStream.h"
+#include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphNode.h"
-#include "scenegraph/SceneGraphUtil.h"
 #include "palette/Palette.h"
 #include "voxel/Voxel.h"
 #include "MCRFormat.h"
@@ -23,6 +24,29 @@
 
 namespace voxelformat {
 
+size_t DatFormat::estimateRegionBytes(const io::ArchivePtr &archive, const core::String &regionFilename) {
+	// a region has up to 32x32 chunks of 16x16 columns with a height of 256 voxels - the chunk volumes and the merged
+	// volume are alive at the same time
+	const size_t chunkBytes = 16u * 16u * 256u * sizeof(voxel::Voxel) * 2u;
+	const size_t maxBytes = (size_t)MCRFormat::SECTOR_INTS * chunkBytes;
+	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(regionFilename));
+	if (!stream) {
+		return maxBytes;
+	}
+	// the header has one location entry per chunk - the chunk is not present if the entry is zero
+	size_t chunks = 0u;
+	for (int i = 0; i < MCRFormat::SECTOR_INTS; ++i) {
+		uint32_t location;
+		if (stream->readUInt32(location) != 0) {
+			return maxBytes;
+		}
+		if (location != 0u) {
+			++chunks;
+		}
+	}
+	return chunks * chunkBytes;
+}
+
 bool DatFormat::loadGroupsPalette(const core::String &filename, const io::ArchivePtr &archive,
 								  scenegraph::SceneGraph &sceneGraph, palette::Palette &palette,
 								  const LoadContext &loadctx) {
@@ -83,38 +107,87 @@ bool DatFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 
 	int nodesAdded = 0;
 
-	core::DynamicArray<std::future<scenegraph::SceneGraph>> futures;
-	Log::info("Found %i region files", (int)entities.size());
+	core::DynamicArray<core::String> regionFilenames;
+	regionFilenames.reserve(entities.size());
 	for (const io::FilesystemEntry &e : entities) {
 		if (e.type != io::FilesystemEntry::Type::file) {
 			continue;
 		}
-		const core::String &regionFilename = core::string::path(baseName, "region", e.name);
-		futures.emplace_back(app::async([regionFilename, &archive, &loadctx]() {
-			MCRFormat mcrFormat;
-			scenegraph::SceneGraph newSceneGraph;
-			if (!mcrFormat.load(regionFilename, archive, newSceneGraph, loadctx)) {
-				Log::debug("Could not load %s", regionFilename.c_str());
-				return core::move(newSceneGraph);
-			}
-			const scenegraph::SceneGraph::MergedVolumePalette &merged = newSceneGraph.merge();
-			newSceneGraph.clear();
-			if (merged.first == nullptr) {
-				return core::move(newSceneGraph);
-			}
-			scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
-			node.setVolume(merged.first, true);
-			node.setPalette(merged.second);
-			newSceneGraph.emplace(core::move(node));
-			return core::move(newSceneGraph);
-		}));
+		regionFilenames.push_back(core::string::path(baseName, "region", e.name));
 	}
-	Log::debug("Scheduled %i regions", (int)futures.size());
+	Log::info("Found %i region files", (int)regionFilenames.size());
+
+	// the chunks of a region are merged - the region loading must not stream them to the sink
+	const LoadContext regionCtx = loadctx.withoutSink();
+	auto loadRegion = [&archive, &regionCtx](const core::String &regionFilename) {
+		MCRFormat mcrFormat;
+		scenegraph::SceneGraph newSceneGraph;
+		if (!mcrFormat.load(regionFilename, archive, newSceneGraph, regionCtx)) {
+			Log::debug("Could not load %s", regionFilename.c_str());
+			return core::move(newSceneGraph);
+		}
+		const scenegraph::SceneGraph::MergedVolumePalette &merged = newSceneGraph.merge();
+		newSceneGraph.clear();
+		if (merged.first == nullptr) {
+			return core::move(newSceneGraph);
+		}
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(merged.first, true);
+		node.setPalette(merged.second);
+		newSceneGraph.emplace(core::move(node));
+		return core::move(newSceneGraph);
+	};
+
+	// if the nodes are streamed, only as many regions are loaded at the same time as fit into the memory budget -
+	// otherwise all regions are scheduled at once
+	const bool streamed = loadctx.nodeSink != nullptr;
+	const size_t maxBatchSize =
+		streamed && loadctx.memoryBudget == 0u ? core_max((size_t)1, app::App::getInstance()->threadPool().size())
+											   : regionFilenames.size();
 	int count = 0;
-	for (auto &f : futures) {
-		scenegraph::SceneGraph newSceneGraph = core::move(f.get());
-		nodesAdded += scenegraph::addSceneGraphNodes(sceneGraph, newSceneGraph, rootNode);
-		Log::debug("... loaded %i", count++);
+	size_t start = 0;
+	while (start < regionFilenames.size()) {
+		size_t end = start;
+		size_t batchBytes = 0u;
+		while (end < regionFilenames.size() && end - start < maxBatchSize) {
+			if (streamed && loadctx.memoryBudget > 0u) {
+				const size_t regionBytes = estimateRegionBytes(archive, regionFilenames[end]);
+				// at least one region is loaded - even if it exceeds the budget on its own
+				if (end > start && batchBytes + regionBytes > loadctx.memoryBudget) {
+					break;
+				}
+				batchBytes += regionBytes;
+			}
+			++end;
+		}
+		core::DynamicArray<scenegraph::SceneGraph> regionSceneGraphs;
+		regionSceneGraphs.resize(end - start);
+		{
+			core::TaskGroup group(app::App::getInstance()->threadPool());
+			for (size_t i = start; i < end; ++i) {
+				group.run([&loadRegion, &regionFilenames, &regionSceneGraphs, start, i]() {
+					regionSceneGraphs[i - start] = loadRegion(regionFilenames[i]);
+				});
+			}
+			Log::debug("Scheduled %i regions (estimated %i MB)", (int)(end - start), (int)(batchBytes / 1024u / 1024u));
+			group.wait();
+		}
+		for (scenegraph::SceneGraph &newSceneGraph : regionSceneGraphs) {
+			for (auto iter = newSceneGraph.beginModel(); iter != newSceneGraph.end(); ++iter) {
+				scenegraph::SceneGraphNode &regionNode = *iter;
+				scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+				node.setPalette(regionNode.palette());
+				regionNode.releaseOwnership();
+				node.setVolume(regionNode.volume(), true);
+				if (!addNode(sceneGraph, core::move(node), rootNode, loadctx)) {
+					return false;
+				}
+				++nodesAdded;
+			}
+			newSceneGraph.clear();
+			Log::debug("... loaded %i", count++);
+		}
+		start = end;
 	}
 
 	return nodesAdded > 0;
@@ -16,6 +16,13 @@ namespace voxelformat {
  * @ingroup Formats
  */
 class DatFormat : public PaletteFormat {
+private:
+	/**
+	 * @brief Estimates the amount of voxel data in bytes that is needed to load the given region file by counting
+	 * the chunks in the region header
+	 */
+	static size_t estimateRegionBytes(const io::ArchivePtr &archive, const core::String &regionFilename);
+
 protected:
 	bool loadGroupsPalette(const core::String &filename, const io::ArchivePtr &archive,
 						   scenegraph::SceneGraph &sceneGraph, palette::Palette &palette,
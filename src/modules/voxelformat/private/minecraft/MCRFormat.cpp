@@ -3,19 +3,22 @@
  */
 
 #include "MCRFormat.h"
+#include "app/App.h"
 #include "core/Color.h"
 #include "core/Common.h"
 #include "core/Log.h"
 #include "core/ScopedPtr.h"
 #include "core/StringUtil.h"
+#include "core/Trace.h"
 #include "core/collection/DynamicArray.h"
+#include "core/concurrent/TaskGroup.h"
+#include "io/MemoryReadStream.h"
 #include "io/Stream.h"
 #include "io/ZipReadStream.h"
 #include "io/ZipWriteStream.h"
 #include "scenegraph/SceneGraph.h"
 #include "palette/Palette.h"
-#include "voxelutil/VolumeCropper.h"
-#include "voxelutil/VolumeMerger.h"
+#include "voxel/PagedVolume.h"
 #include "MinecraftPaletteMap.h"
 #include "NamedBinaryTag.h"
 
@@ -65,20 +68,16 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 			return false;
 		}
 
+		// the location table - 3 bytes sector offset and 1 byte sector count per chunk
+		uint32_t header[SECTOR_INTS];
+		wrap(stream->readUInt32BEArray(header, SECTOR_INTS));
 		for (int i = 0; i < SECTOR_INTS; ++i) {
-			uint8_t raw[3];
-			wrap(stream->readUInt8(raw[0]));
-			wrap(stream->readUInt8(raw[1]));
-			wrap(stream->readUInt8(raw[2]));
-			wrap(stream->readUInt8(_offsets[i].sectorCount));
-
-			_offsets[i].offset = ((raw[0] << 16) + (raw[1] << 8) + raw[2]) * SECTOR_BYTES;
+			_offsets[i].offset = (header[i] >> 8) * SECTOR_BYTES;
+			_offsets[i].sectorCount = (uint8_t)(header[i] & 0xFFu);
 		}
 
-		for (int i = 0; i < SECTOR_INTS; ++i) {
-			uint32_t lastModValue;
-			wrap(stream->readUInt32BE(lastModValue));
-		}
+		// the timestamp table
+		wrap(stream->readUInt32BEArray(header, SECTOR_INTS));
 
 		// might be an empty region file
 		if (stream->eos()) {
@@ -86,7 +85,7 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 			return false;
 		}
 
-		const bool success = loadMinecraftRegion(sceneGraph, *stream, palette);
+		const bool success = loadMinecraftRegion(sceneGraph, *stream, palette, ctx);
 		return success;
 	}
 	}
@@ -95,19 +94,67 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 }
 
 bool MCRFormat::loadMinecraftRegion(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream,
-									const palette::Palette &palette) {
-	for (int i = 0; i < SECTOR_INTS; ++i) {
-		if (_offsets[i].sectorCount == 0u || _offsets[i].offset < sizeof(_offsets)) {
-			continue;
+									const palette::Palette &palette, const LoadContext &ctx) {
+	// the compressed chunks are read one after another - the inflating and the nbt parsing is done in parallel and the
+	// chunks are added in the order of the region file. The batches keep the memory bounded.
+	core::ThreadPool &threadPool = app::App::getInstance()->threadPool();
+	const int batchSize = core_max(1, (int)threadPool.size() * 4);
+	core::DynamicArray<CompressedChunk> chunks;
+	chunks.reserve(batchSize);
+	int i = 0;
+	while (i < SECTOR_INTS) {
+		chunks.clear();
+		for (; i < SECTOR_INTS && (int)chunks.size() < batchSize; ++i) {
+			if (_offsets[i].sectorCount == 0u || _offsets[i].offset < sizeof(_offsets)) {
+				continue;
+			}
+			if (_offsets[i].offset + 6 >= (uint32_t)stream.size()) {
+				return false;
+			}
+			if (stream.seek(_offsets[i].offset) == -1) {
+				continue;
+			}
+			CompressedChunk chunk;
+			chunk.sector = i;
+			if (!readCompressedNBT(stream, chunk)) {
+				Log::error("Failed to load minecraft chunk section %i for offset %u", i, (int)_offsets[i].offset);
+				return false;
+			}
+			if (chunk.data.empty()) {
+				continue;
+			}
+			chunks.push_back(core::move(chunk));
 		}
-		if (_offsets[i].offset + 6 >= (uint32_t)stream.size()) {
-			return false;
+
+		{
+			core::TaskGroup taskGroup(threadPool);
+			for (CompressedChunk &chunk : chunks) {
+				taskGroup.run([this, &chunk, &palette]() { chunk.volume = parseCompressedNBT(chunk, palette); });
+			}
+			taskGroup.wait();
 		}
-		if (stream.seek(_offsets[i].offset) == -1) {
-			continue;
+
+		bool success = true;
+		for (CompressedChunk &chunk : chunks) {
+			if (!success) {
+				delete chunk.volume;
+				continue;
+			}
+			if (chunk.volume == nullptr) {
+				Log::error("Failed to load minecraft chunk section %i for offset %u", chunk.sector,
+						   (int)_offsets[chunk.sector].offset);
+				success = false;
+				continue;
+			}
+			scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+			node.setVolume(chunk.volume, true);
+			node.setPalette(palette);
+			// every chunk is a node of its own - with a node sink the chunk is released right after it was loaded
+			if (!addNode(sceneGraph, core::move(node), sceneGraph.root().id(), ctx)) {
+				success = false;
+			}
 		}
-		if (!readCompressedNBT(sceneGraph, stream, i, palette)) {
-			Log::error("Failed to load minecraft chunk section %i for offset %u", i, (int)_offsets[i].offset);
+		if (!success) {
 			return false;
 		}
 	}
@@ -115,8 +162,7 @@ bool MCRFormat::loadMinecraftRegion(scenegraph::SceneGraph &sceneGraph, io::Seek
 	return true;
 }
 
-bool MCRFormat::readCompressedNBT(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream, int sector,
-								  const palette::Palette &palette) {
+bool MCRFormat::readCompressedNBT(io::SeekableReadStream &stream, CompressedChunk &chunk) {
 	uint32_t nbtSize;
 	wrap(stream.readUInt32BE(nbtSize));
 	if (nbtSize == 0) {
@@ -129,54 +175,66 @@ bool MCRFormat::readCompressedNBT(scenegraph::SceneGraph &sceneGraph, io::Seekab
 		return false;
 	}
 
-	uint8_t version;
-	wrap(stream.readUInt8(version));
-	if (version != VERSION_GZIP && version != VERSION_DEFLATE) {
-		Log::error("Unsupported version found: %u", version);
+	wrap(stream.readUInt8(chunk.version));
+	if (chunk.version != VERSION_GZIP && chunk.version != VERSION_DEFLATE) {
+		Log::error("Unsupported version found: %u", chunk.version);
 		return false;
 	}
 
 	// the version is included in the length
 	--nbtSize;
+	chunk.data.resize(nbtSize);
+	if (stream.read(chunk.data.data(), nbtSize) != (int)nbtSize) {
+		Log::error("Could not read %u bytes of nbt data", nbtSize);
+		return false;
+	}
+	return true;
+}
 
-	io::ZipReadStream zipStream(stream, (int)nbtSize);
-	priv::NamedBinaryTagContext ctx;
-	ctx.stream = &zipStream;
-	const priv::NamedBinaryTag &root = priv::NamedBinaryTag::parse(ctx);
+voxel::RawVolume *MCRFormat::parseCompressedNBT(const CompressedChunk &chunk, const palette::Palette &palette) {
+	core_trace_scoped(ParseCompressedNBT);
+	io::MemoryReadStream memStream(chunk.data.data(), chunk.data.size());
+	io::ZipReadStream zipStream(memStream, (int)chunk.data.size());
+	// the nbt data is inflated into one buffer - the tags are read directly from there without building a tree
+	core::Buffer<uint8_t> nbt;
+	nbt.resize(chunk.data.size() * 8u);
+	size_t nbtSize = 0u;
+	while (!zipStream.eos()) {
+		if (nbtSize == nbt.size()) {
+			nbt.resize(nbt.size() * 2u);
+		}
+		const int bytes = zipStream.read(nbt.data() + nbtSize, nbt.size() - nbtSize);
+		if (bytes < 0) {
+			Log::error("Could not inflate the nbt data");
+			return nullptr;
+		}
+		if (bytes == 0) {
+			break;
+		}
+		nbtSize += (size_t)bytes;
+	}
+	const priv::NBTView &root = priv::NBTView::parse(nbt.data(), nbtSize);
 	if (!root.valid()) {
 		Log::error("Could not parse nbt structure");
-		return false;
+		return nullptr;
 	}
 
-	voxel::RawVolume *volume;
 	// https://minecraft.wiki/w/Data_version
 	const int32_t dataVersion = root.get("DataVersion").int32();
 	Log::debug("Found data version %i", dataVersion);
 	if (dataVersion >= 2844) {
-		volume = parseSections(dataVersion, root, sector, palette);
-		if (volume == nullptr) {
-			return false;
-		}
-	} else {
-		volume = parseLevelCompound(dataVersion, root, sector, palette);
-		if (volume == nullptr) {
-			return false;
-		}
+		return parseSections(dataVersion, root, chunk.sector, palette);
 	}
-	scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
-	node.setVolume(volume, true);
-	node.setPalette(palette);
-	sceneGraph.emplace(core::move(node));
-	return true;
+	return parseLevelCompound(dataVersion, root, chunk.sector, palette);
 }
 
-int MCRFormat::getVoxel(int dataVersion, const priv::NamedBinaryTag &data, const glm::ivec3 &pos) {
+int MCRFormat::getVoxel(int dataVersion, const priv::NBTArrayView<int8_t> &data, const glm::ivec3 &pos) {
 	const uint32_t i = pos.y * MAX_SIZE * MAX_SIZE + pos.z * MAX_SIZE + pos.x;
-	if (i >= data.byteArray()->size()) {
-		Log::error("Byte array index out of bounds: %u/%i", i, (int)data.byteArray()->size());
+	if (i >= data.size()) {
+		Log::error("Byte array index out of bounds: %u/%i", i, (int)data.size());
 		return -1;
 	}
-	const int val = (int)(uint8_t)(*data.byteArray())[i];
+	const int val = (int)(uint8_t)data[i];
 	if (val < 0) {
 		Log::error("Invalid value: %i", val);
 		return -1;
@@ -184,62 +242,52 @@ int MCRFormat::getVoxel(int dataVersion, const priv::NamedBinaryTag &data, const
 	return val;
 }
 
-voxel::RawVolume *MCRFormat::error(SectionVolumes &volumes) {
-	for (voxel::RawVolume *v : volumes) {
-		delete v;
-	}
-	return nullptr;
+voxel::Region MCRFormat::sectionColumn() {
+	const glm::ivec3 mins(0, INT8_MIN * MAX_SIZE, 0);
+	const glm::ivec3 maxs(MAX_SIZE - 1, INT8_MAX * MAX_SIZE + MAX_SIZE - 1, MAX_SIZE - 1);
+	return voxel::Region(mins, maxs);
 }
 
-voxel::RawVolume *MCRFormat::finalize(SectionVolumes &volumes, int xPos, int zPos) {
-	if (volumes.empty()) {
+voxel::RawVolume *MCRFormat::finalize(const voxel::PagedVolume &volume, int xPos, int zPos) {
+	// the empty sections between the sections with blocks are never allocated - only the cropped result is
+	const voxel::Region dataRegion = volume.dataRegion();
+	if (!dataRegion.isValid()) {
 		Log::error("No volumes found at %i:%i", xPos, zPos);
 		return nullptr;
 	}
-	// TODO: only merge connected y chunks - don't fill empty chunks - just a waste of memory
-	voxel::RawVolume *merged = voxelutil::merge(volumes);
-	for (voxel::RawVolume *v : volumes) {
-		delete v;
-	}
-	merged->translate(glm::ivec3(xPos * MAX_SIZE, 0, zPos * MAX_SIZE));
-	voxel::RawVolume *cropped = voxelutil::cropVolume(merged);
-	delete merged;
-	return cropped;
+	voxel::RawVolume *v = volume.toRawVolume(dataRegion);
+	v->translate(glm::ivec3(xPos * MAX_SIZE, 0, zPos * MAX_SIZE));
+	return v;
 }
 
-bool MCRFormat::parseBlockStates(int dataVersion, const palette::Palette &palette, const priv::NamedBinaryTag &data,
-								 SectionVolumes &volumes, int sectionY, const MinecraftSectionPalette &secPal) {
+bool MCRFormat::parseBlockStates(int dataVersion, const palette::Palette &palette, const priv::NBTView &data,
+								 voxel::PagedVolume &volume, int sectionY, const MinecraftSectionPalette &secPal) {
 	Log::debug("Parse block states");
-	const bool hasData = data.type() == priv::TagType::LONG_ARRAY && !data.longArray()->empty();
+	const bool hasData = data.type() == priv::TagType::LONG_ARRAY && !data.longArray().empty();
 
-	const glm::ivec3 mins(0, 0, 0);
-	const glm::ivec3 maxs(MAX_SIZE - 1, MAX_SIZE - 1, MAX_SIZE - 1);
-	const voxel::Region region(mins, maxs);
-	voxel::RawVolume *v = new voxel::RawVolume(region);
-	bool hasBlocks = false;
+	// a section fills exactly one brick of the paged volume - sections without blocks don't allocate a brick
+	const glm::ivec3 sectionPos(0, sectionY * MAX_SIZE, 0);
 
 	if (secPal.pal.empty()) {
 		if (data.type() != priv::TagType::BYTE_ARRAY) {
 			Log::error("Unknown block data type: %i for version %i", (int)data.type(), dataVersion);
-			delete v;
 			return false;
 		}
+		const priv::NBTArrayView<int8_t> &byteArray = data.byteArray();
 		glm::ivec3 sPos;
 		for (sPos.y = 0; sPos.y < MAX_SIZE; ++sPos.y) {
 			for (sPos.z = 0; sPos.z < MAX_SIZE; ++sPos.z) {
 				for (sPos.x = 0; sPos.x < MAX_SIZE; ++sPos.x) {
-					const int color = getVoxel(dataVersion, data, sPos);
+					const int color = getVoxel(dataVersion, byteArray, sPos);
 					if (color < 0) {
 						Log::error("Failed to load voxel at position %i:%i:%i (dataversion: %i)", sPos.x, sPos.y,
 								   sPos.z, dataVersion);
-						delete v;
 						return false;
 					}
 					if (color) {
 						const uint8_t palColIdx = palette.getClosestMatch(secPal.mcpal.color(color));
 						const voxel::Voxel voxel = voxel::createVoxel(palette, palColIdx);
-						v->setVoxel(sPos, voxel);
-						hasBlocks = true;
+						volume.setVoxel(sectionPos + sPos, voxel);
 					}
 				}
 			}
@@ -247,26 +295,30 @@ bool MCRFormat::parseBlockStates(int dataVersion, const palette::Palette &palett
 	} else if (hasData) {
 		if (data.type() != priv::TagType::LONG_ARRAY) {
 			Log::error("Unknown block data type: %i for version %i", (int)data.type(), dataVersion);
-			delete v;
 			return false;
 		}
 
-		const core::DynamicArray<int64_t> &blockStates = *data.longArray();
+		const priv::NBTArrayView<int64_t> &blockStates = data.longArray();
 
 		constexpr int blockCount = MAX_SIZE * MAX_SIZE * MAX_SIZE;
 		uint8_t blocks[blockCount];
 		int bsCnt = 0;
 		size_t bitCnt = 0;
 		if (dataVersion < 2529) {
-			const size_t bitSize = (data.longArray()->size()) * 64 / blockCount;
+			const size_t bitSize = blockStates.size() * 64 / blockCount;
 			const uint32_t bitMask = (1 << bitSize) - 1;
 			for (int i = 0; i < blockCount; i++) {
+				const size_t needed = bitCnt + bitSize <= 64 ? bsCnt + 1 : bsCnt + 2;
+				if (needed > blockStates.size()) {
+					Log::error("Block states exceeded: %i of %i for version %i", (int)needed, (int)blockStates.size(),
+							   dataVersion);
+					return false;
+				}
 				if (bitCnt + bitSize <= 64) {
 					const uint64_t blockState = blockStates[bsCnt];
 					const uint64_t blockIndex = (blockState >> bitCnt) & bitMask;
 					if (blockIndex < secPal.pal.size()) {
 						blocks[i] = secPal.pal[blockIndex];
-						hasBlocks = true;
 					} else {
 						blocks[i] = 0;
 					}
@@ -284,7 +336,6 @@ bool MCRFormat::parseBlockStates(int dataVersion, const palette::Palette &palett
 					blockIndex += (blockState2 << (bitSize - bitCnt)) & bitMask;
 					if (blockIndex < secPal.pal.size()) {
 						blocks[i] = secPal.pal[blockIndex];
-						hasBlocks = true;
 					} else {
 						blocks[i] = 0;
 					}
@@ -294,11 +345,15 @@ bool MCRFormat::parseBlockStates(int dataVersion, const palette::Palette &palett
 			const size_t bitSize = secPal.numBits;
 			const uint32_t bitMask = (1 << bitSize) - 1;
 			for (int i = 0; i < blockCount; i++) {
+				if ((size_t)bsCnt >= blockStates.size()) {
+					Log::error("Block states exceeded: %i of %i for version %i", bsCnt, (int)blockStates.size(),
+							   dataVersion);
+					return false;
+				}
 				const uint64_t blockState = blockStates[bsCnt];
 				const uint64_t blockIndex = (blockState >> bitCnt) & bitMask;
 				if (blockIndex < secPal.pal.size()) {
 					blocks[i] = secPal.pal[blockIndex];
-					hasBlocks = true;
 				} else {
 					blocks[i] = 0;
 				}
@@ -319,30 +374,18 @@ bool MCRFormat::parseBlockStates(int dataVersion, const palette::Palette &palett
 					if (color) {
 						const uint8_t palColIdx = palette.getClosestMatch(secPal.mcpal.color(color));
 						const voxel::Voxel voxel = voxel::createVoxel(palette, palColIdx);
-						v->setVoxel(sPos, voxel);
+						volume.setVoxel(sectionPos + sPos, voxel);
 					}
 				}
 			}
 		}
 	}
-
-	if (hasBlocks) {
-		glm::ivec3 translate;
-		translate.x = 0;
-		translate.y = sectionY * MAX_SIZE;
-		translate.z = 0;
-
-		v->translate(translate);
-		volumes.push_back(v);
-	} else {
-		delete v;
-	}
 	return true;
 }
 
-voxel::RawVolume *MCRFormat::parseSections(int dataVersion, const priv::NamedBinaryTag &root, int sector,
+voxel::RawVolume *MCRFormat::parseSections(int dataVersion, const priv::NBTView &root, int sector,
 										   const palette::Palette &pal) {
-	const priv::NamedBinaryTag &sections = root.get("sections");
+	const priv::NBTView &sections = root.get("sections");
 	if (!sections.valid()) {
 		Log::error("Could not find 'sections' tag");
 		return nullptr;
@@ -357,20 +400,20 @@ voxel::RawVolume *MCRFormat::parseSections(int dataVersion, const priv::NamedBin
 
 	Log::debug("xpos: %i, zpos: %i", xPos, zPos);
 
-	const priv::NBTList &sectionsList = *sections.list();
+	const priv::NBTListView &sectionsList = sections.list();
 	Log::debug("Found %i sections", (int)sectionsList.size());
 	if (sectionsList.empty()) {
 		Log::warn("Empty region - no sections found - version: %i", dataVersion);
 		return nullptr;
 	}
-	SectionVolumes volumes;
-	for (const priv::NamedBinaryTag &section : sectionsList) {
-		const priv::NamedBinaryTag &blockStates = section.get("block_states");
+	voxel::PagedVolume volume(sectionColumn());
+	for (const priv::NBTView &section : sectionsList) {
+		const priv::NBTView &blockStates = section.get("block_states");
 		if (!blockStates.valid()) {
 			Log::error("Could not find 'block_states'");
-			return error(volumes);
+			return nullptr;
 		}
-		const priv::NamedBinaryTag &ylvl = section.get("Y");
+		const priv::NBTView &ylvl = section.get("Y");
 		if (!ylvl.valid()) {
 			Log::debug("Could not find Y int in section compound");
 		}
@@ -380,29 +423,29 @@ voxel::RawVolume *MCRFormat::parseSections(int dataVersion, const priv::NamedBin
 		}
 		Log::debug("Y level for section compound: %i", (int)sectionY);
 
-		const priv::NamedBinaryTag &palette = blockStates.get("palette");
+		const priv::NBTView &palette = blockStates.get("palette");
 		if (!palette.valid()) {
 			Log::error("Could not find 'palette'");
-			return error(volumes);
+			return nullptr;
 		}
 		MinecraftSectionPalette secPal;
 		secPal.mcpal.minecraft();
 		if (!parsePaletteList(dataVersion, palette, secPal)) {
 			Log::error("Could not parse palette chunk");
-			return error(volumes);
+			return nullptr;
 		}
-		const priv::NamedBinaryTag &data = blockStates.get("data");
-		if (!parseBlockStates(dataVersion, pal, data, volumes, sectionY, secPal)) {
+		const priv::NBTView &data = blockStates.get("data");
+		if (!parseBlockStates(dataVersion, pal, data, volume, sectionY, secPal)) {
 			Log::error("Failed to parse 'data' tag");
-			return error(volumes);
+			return nullptr;
 		}
 	}
-	return finalize(volumes, xPos, zPos);
+	return finalize(volume, xPos, zPos);
 }
 
-voxel::RawVolume *MCRFormat::parseLevelCompound(int dataVersion, const priv::NamedBinaryTag &root, int sector,
+voxel::RawVolume *MCRFormat::parseLevelCompound(int dataVersion, const priv::NBTView &root, int sector,
 												const palette::Palette &pal) {
-	const priv::NamedBinaryTag &levels = root.get("Level");
+	const priv::NBTView &levels = root.get("Level");
 	if (!levels.valid()) {
 		Log::error("Could not find 'Level' tag");
 		return nullptr;
@@ -415,23 +458,24 @@ voxel::RawVolume *MCRFormat::parseLevelCompound(int dataVersion, const priv::Nam
 	const int32_t zPos = levels.get("zPos").int32();
 
 	if (dataVersion >= 1976) {
-		const core::String *tagStatus = root.get("Status").string();
-		if (tagStatus == nullptr) {
+		priv::NBTStringView tagStatus;
+		if (!root.get("Status").string(tagStatus)) {
 			Log::debug("Status for level node wasn't found (version: %i)", dataVersion);
-		} else if (*tagStatus != "full") {
-			Log::debug("Status for level node is not full but %s (version: %i)", tagStatus->c_str(), dataVersion);
+		} else if (tagStatus != "full") {
+			Log::debug("Status for level node is not full but %.*s (version: %i)", (int)tagStatus.length,
+					   tagStatus.str, dataVersion);
 		}
 	} else if (dataVersion >= 1628) {
-		const core::String *tagStatus = levels.get("Status").string();
-		if (tagStatus == nullptr) {
+		priv::NBTStringView tagStatus;
+		if (!levels.get("Status").string(tagStatus)) {
 			Log::debug("Status for level node wasn't found (version: %i)", dataVersion);
-		} else if (*tagStatus != "postprocessed") {
-			Log::debug("Status for level node is not postprocessed but %s (version: %i)", tagStatus->c_str(),
-					   dataVersion);
+		} else if (tagStatus != "postprocessed") {
+			Log::debug("Status for level node is not postprocessed but %.*s (version: %i)", (int)tagStatus.length,
+					   tagStatus.str, dataVersion);
 		}
 	}
 
-	const priv::NamedBinaryTag &sections = levels.get("Sections");
+	const priv::NBTView &sections = levels.get("Sections");
 	if (!sections.valid()) {
 		Log::error("Could not find 'Sections' tag");
 		return nullptr;
@@ -440,15 +484,15 @@ voxel::RawVolume *MCRFormat::parseLevelCompound(int dataVersion, const priv::Nam
 		Log::error("Invalid type for 'Sections' tag: %i", (int)sections.type());
 		return nullptr;
 	}
-	const priv::NBTList &sectionsList = *sections.list();
+	const priv::NBTListView &sectionsList = sections.list();
 	Log::debug("Found %i sections", (int)sectionsList.size());
 	if (sectionsList.empty()) {
 		Log::warn("Empty region - no sections found - version: %i", dataVersion);
 		return nullptr;
 	}
-	SectionVolumes volumes;
-	for (const priv::NamedBinaryTag &section : sectionsList) {
-		const priv::NamedBinaryTag &ylvl = section.get("Y");
+	voxel::PagedVolume volume(sectionColumn());
+	for (const priv::NBTView &section : sectionsList) {
+		const priv::NBTView &ylvl = section.get("Y");
 		if (!ylvl.valid()) {
 			Log::debug("Could not find Y int in section compound");
 		}
@@ -461,39 +505,39 @@ voxel::RawVolume *MCRFormat::parseLevelCompound(int dataVersion, const priv::Nam
 		MinecraftSectionPalette secPal;
 		secPal.mcpal.minecraft();
 
-		const priv::NamedBinaryTag &palette = section.get("Palette");
+		const priv::NBTView &palette = section.get("Palette");
 		if (palette.valid()) {
 			if (!parsePaletteList(dataVersion, palette, secPal)) {
 				Log::error("Failed to parse 'Palette' tag");
-				return error(volumes);
+				return nullptr;
 			}
 		} else {
 			Log::debug("Could not find a Palette compound in section %i", dataVersion);
 		}
 
 		// TODO:"Data"(byte_array)
-		// const priv::NamedBinaryTag &data = section.get("Data");
-		const core::String &tagId = dataVersion <= 1343 ? "Blocks" : "BlockStates";
-		const priv::NamedBinaryTag &blockStates = section.get(tagId);
+		// const priv::NBTView &data = section.get("Data");
+		const char *tagId = dataVersion <= 1343 ? "Blocks" : "BlockStates";
+		const priv::NBTView &blockStates = section.get(tagId);
 		if (!blockStates.valid()) {
-			Log::debug("Could not find '%s'", tagId.c_str());
+			Log::debug("Could not find '%s'", tagId);
 			continue;
 		}
-		if (!parseBlockStates(dataVersion, pal, blockStates, volumes, sectionY, secPal)) {
-			Log::error("Failed to parse '%s' tag", tagId.c_str());
-			return error(volumes);
+		if (!parseBlockStates(dataVersion, pal, blockStates, volume, sectionY, secPal)) {
+			Log::error("Failed to parse '%s' tag", tagId);
+			return nullptr;
 		}
 	}
-	return finalize(volumes, xPos, zPos);
+	return finalize(volume, xPos, zPos);
 }
 
-bool MCRFormat::parsePaletteList(int dataVersion, const priv::NamedBinaryTag &palette,
+bool MCRFormat::parsePaletteList(int dataVersion, const priv::NBTView &palette,
 								 MinecraftSectionPalette &sectionPal) {
 	if (palette.type() != priv::TagType::LIST) {
 		Log::error("Invalid type for palette: %i", (int)palette.type());
 		return false;
 	}
-	const priv::NBTList &paletteList = *palette.list();
+	const priv::NBTListView &paletteList = palette.list();
 	const size_t paletteCount = paletteList.size();
 	if (paletteCount > 512u) {
 		Log::error("Palette overflow");
@@ -503,22 +547,15 @@ bool MCRFormat::parsePaletteList(int dataVersion, const priv::NamedBinaryTag &pa
 	sectionPal.numBits = (uint32_t)glm::max(glm::ceil(glm::log2((float)paletteCount)), 4.0f);
 
 	int paletteEntry = 0;
-	for (const priv::NamedBinaryTag &block : paletteList) {
+	for (const priv::NBTView &block : paletteList) {
 		if (block.type() != priv::TagType::COMPOUND) {
 			Log::error("Invalid block type %i", (int)block.type());
 			return false;
 		}
 
-		for (const auto &entry : *block.compound()) {
-			if (entry->key != "Name") {
-				continue;
-			}
-			const priv::NamedBinaryTag &nbt = entry->value;
-			const core::String *value = nbt.string();
-			if (value == nullptr) {
-				continue;
-			}
-			sectionPal.pal[paletteEntry] = findPaletteIndex(*value);
+		priv::NBTStringView name;
+		if (block.get("Name").string(name)) {
+			sectionPal.pal[paletteEntry] = findPaletteIndex(name.str, name.length, -1);
 		}
 		++paletteEntry;
 	}
@@ -540,21 +577,18 @@ bool MCRFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core:
 		Log::error("Could not open file %s", filename.c_str());
 		return false;
 	}
+	uint32_t header[SECTOR_INTS];
 	for (int i = 0; i < SECTOR_INTS; ++i) {
-		uint8_t raw[3] = {0, 0, 0};	 // TODO
 		_offsets[i].sectorCount = 0; // TODO
 
 		core_assert(_offsets[i].offset < sizeof(_offsets));
-		wrapBool(stream->writeUInt8(raw[0]));
-		wrapBool(stream->writeUInt8(raw[1]));
-		wrapBool(stream->writeUInt8(raw[2]));
-		wrapBool(stream->writeUInt8(_offsets[i].sectorCount));
+		header[i] = _offsets[i].sectorCount; // TODO: sector offset
 	}
+	wrapBool(stream->writeUInt32BEArray(header, SECTOR_INTS));
 
-	for (int i = 0; i < SECTOR_INTS; ++i) {
-		uint32_t lastModValue = 0u;
-		wrapBool(stream->writeUInt32BE(lastModValue));
-	}
+	// the timestamp table
+	core_memset(header, 0, sizeof(header));
+	wrapBool(stream->writeUInt32BEArray(header, SECTOR_INTS));
 
 	return saveMinecraftRegion(sceneGraph, *stream);
 }
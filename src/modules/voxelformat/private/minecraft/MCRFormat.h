@@ -14,10 +14,17 @@ namespace io {
 class ZipReadStream;
 }
 
+namespace voxel {
+class PagedVolume;
+}
+
 namespace voxelformat {
 
 namespace priv {
 class NamedBinaryTag;
+class NBTView;
+template<typename TYPE>
+class NBTArrayView;
 using NBTCompound = core::DynamicMap<core::String, NamedBinaryTag, 11, core::StringHash>;
 using NBTList = core::DynamicArray<NamedBinaryTag>;
 } // namespace priv
@@ -87,30 +94,47 @@ private:
 		palette::Palette mcpal;
 	};
 
-	using SectionVolumes = core::DynamicArray<voxel::RawVolume *>;
-
-	voxel::RawVolume *error(SectionVolumes &volumes);
-	voxel::RawVolume *finalize(SectionVolumes &volumes, int xPos, int zPos);
+	/**
+	 * @brief The region of a chunk column with all the sections that the signed section y can address
+	 * @note The sections are filled into a @c voxel::PagedVolume with this region - only the sections with blocks
+	 * allocate memory
+	 */
+	static voxel::Region sectionColumn();
+	voxel::RawVolume *finalize(const voxel::PagedVolume &volume, int xPos, int zPos);
 
-	static int getVoxel(int dataVersion, const priv::NamedBinaryTag &data, const glm::ivec3 &pos);
+	static int getVoxel(int dataVersion, const priv::NBTArrayView<int8_t> &data, const glm::ivec3 &pos);
 
 	// shared across versions
-	bool parsePaletteList(int dataVersion, const priv::NamedBinaryTag &palette, MinecraftSectionPalette &sectionPal);
-	bool parseBlockStates(int dataVersion, const palette::Palette &palette, const priv::NamedBinaryTag &data,
-						  SectionVolumes &volumes, int sectionY, const MinecraftSectionPalette &secPal);
+	bool parsePaletteList(int dataVersion, const priv::NBTView &palette, MinecraftSectionPalette &sectionPal);
+	bool parseBlockStates(int dataVersion, const palette::Palette &palette, const priv::NBTView &data,
+						  voxel::PagedVolume &volume, int sectionY, const MinecraftSectionPalette &secPal);
 
 	// new version (>= 2844)
-	voxel::RawVolume *parseSections(int dataVersion, const priv::NamedBinaryTag &root, int sector,
+	voxel::RawVolume *parseSections(int dataVersion, const priv::NBTView &root, int sector,
 									const palette::Palette &palette);
 
 	// old version (< 2844)
-	voxel::RawVolume *parseLevelCompound(int dataVersion, const priv::NamedBinaryTag &root, int sector,
+	voxel::RawVolume *parseLevelCompound(int dataVersion, const priv::NBTView &root, int sector,
 										 const palette::Palette &palette);
 
-	bool readCompressedNBT(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream, int sector,
-						   const palette::Palette &palette);
+	/**
+	 * @brief The nbt data of a chunk as it is stored in the region file
+	 */
+	struct CompressedChunk {
+		int sector = 0;
+		uint8_t version = 0u;
+		core::Buffer<uint8_t> data;
+		/** the parsed chunk - @c nullptr if the parsing failed */
+		voxel::RawVolume *volume = nullptr;
+	};
+
+	bool readCompressedNBT(io::SeekableReadStream &stream, CompressedChunk &chunk);
+	/**
+	 * @note This is called in parallel for the chunks of a region - it must not touch any state of the format
+	 */
+	voxel::RawVolume *parseCompressedNBT(const CompressedChunk &chunk, const palette::Palette &palette);
 	bool loadMinecraftRegion(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream,
-							 const palette::Palette &palette);
+							 const palette::Palette &palette, const LoadContext &ctx);
 
 	bool saveSections(const scenegraph::SceneGraph &sceneGraph, priv::NBTList &sections, int sector);
 	bool saveCompressedNBT(const scenegraph::SceneGraph &sceneGraph, io::SeekableWriteStream &stream, int sector);
@@ -93,9 +93,7 @@ bool MTSFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 	databuf.resize(nodecount);
 
 	io::ZipReadStream zipStream(*stream);
-	for (int i = 0; i < nodecount; ++i) {
-		wrap(zipStream.readUInt16BE(databuf[i].param0))
-	}
+	wrap(zipStream.readUInt16BEArray((uint16_t *)databuf.data(), nodecount))
 
 	palette.minecraft();
 	const voxel::Region region(0, 0, 0, size.x - 1, size.y - 1, size.z - 1);
@@ -5,6 +5,7 @@
 #include "MinecraftPaletteMap.h"
 #include "core/Log.h"
 #include "core/ArrayLength.h"
+#include <string.h>
 
 namespace voxelformat {
 
@@ -964,18 +965,17 @@ const PaletteArray &getPaletteArray() {
 	return mcPalette;
 }
 
-int findPaletteIndex(const core::String &name, int defaultValue) {
-	core::String key = name;
+int findPaletteIndex(const char *name, size_t length, int defaultValue) {
 	// minecraft:dark_oak_stairs[facing=east,half=bottom,shape=outer_left,waterlogged=false][INT] = 554
-	size_t pos = key.find(":");
-	if (pos != core::String::npos) {
-		key = key.substr(pos + 1, key.size() - pos - 1);
-	}
-	size_t n = key.find("[");
-	if (n != core::String::npos) {
-		key = key.substr(0, n);
+	const char *end = (const char *)memchr(name, '[', length);
+	if (end == nullptr) {
+		end = name + length;
 	}
+	const char *start = (const char *)memchr(name, ':', end - name);
+	start = start == nullptr ? name : start + 1;
 
+	// the block names fit into the stack buffer of the string
+	const core::String key(start, end - start);
 	const PaletteMap &map = getPaletteMap();
 	auto iter = map.find(key);
 	if (iter == map.end()) {
@@ -985,6 +985,10 @@ int findPaletteIndex(const core::String &name, int defaultValue) {
 	return iter->value.palIdx;
 }
 
+int findPaletteIndex(const core::String &name, int defaultValue) {
+	return findPaletteIndex(name.c_str(), name.size(), defaultValue);
+}
+
 const PaletteMap &getPaletteMap() {
 	// https://gitlab.com/bztsrc/mtsedit/blob/master/etc/Mineclone2.gpl
 	// https://github.com/mcedit/mcedit2/tree/master/src/mceditlib/blocktypes
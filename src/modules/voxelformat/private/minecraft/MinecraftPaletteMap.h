@@ -32,5 +32,11 @@ const PaletteArray &getPaletteArray();
  * @param[in] defaultValue the value that is returned if the given name could not get matched
  */
 int findPaletteIndex(const core::String &name, int defaultValue = -1);
+/**
+ * @brief Same as above for a name that is not zero terminated - e.g. a view into the nbt data
+ * @note The namespace and the block state are skipped without copying the name - only the block name itself is used
+ * for the lookup. The default value is not optional to not match the @c const @c char* calls of the other overload
+ */
+int findPaletteIndex(const char *name, size_t length, int defaultValue);
 
 } // namespace voxelformat
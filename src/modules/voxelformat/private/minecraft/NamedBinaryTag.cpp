@@ -6,6 +6,8 @@
 #include "core/Log.h"
 #include "core/ArrayLength.h"
 #include "io/BufferedReadWriteStream.h"
+#include <SDL_endian.h>
+#include <SDL_stdinc.h>
 
 namespace voxelformat {
 
@@ -243,24 +245,14 @@ bool NamedBinaryTag::writeType(io::WriteStream &stream, const NamedBinaryTag &ta
 		if (!stream.writeUInt32BE(length)) {
 			return false;
 		}
-		for (size_t i = 0; i < length; i++) {
-			if (!stream.writeInt8((*tag.byteArray())[i])) {
-				return false;
-			}
-		}
-		return true;
+		return stream.writeUInt8Array((const uint8_t *)tag.byteArray()->data(), length);
 	}
 	case TagType::INT_ARRAY: {
 		const size_t length = tag.intArray()->size();
 		if (!stream.writeUInt32BE(length)) {
 			return false;
 		}
-		for (size_t i = 0; i < length; i++) {
-			if (!stream.writeInt32((*tag.intArray())[i])) {
-				return false;
-			}
-		}
-		return true;
+		return stream.writeUInt32BEArray((const uint32_t *)tag.intArray()->data(), length);
 	}
 	case TagType::LONG_ARRAY: {
 		const size_t length = tag.longArray()->size();
@@ -268,7 +260,7 @@ bool NamedBinaryTag::writeType(io::WriteStream &stream, const NamedBinaryTag &ta
 			return false;
 		}
 		for (size_t i = 0; i < length; i++) {
-			if (!stream.writeInt64((*tag.longArray())[i])) {
+			if (!stream.writeInt64BE((*tag.longArray())[i])) {
 				return false;
 			}
 		}
@@ -504,5 +496,329 @@ NamedBinaryTag &NamedBinaryTag::operator=(NamedBinaryTag &&val) noexcept {
 	return *this;
 }
 
+namespace nbtview {
+
+// nbt trees are usually not deeper than a few levels - this protects against malicious data
+static constexpr int MaxLevel = 512;
+
+static inline uint16_t readUInt16BE(const uint8_t *data) {
+	uint16_t val;
+	SDL_memcpy(&val, data, sizeof(val));
+	return SDL_SwapBE16(val);
+}
+
+static inline uint32_t readUInt32BE(const uint8_t *data) {
+	uint32_t val;
+	SDL_memcpy(&val, data, sizeof(val));
+	return SDL_SwapBE32(val);
+}
+
+static inline uint64_t readUInt64BE(const uint8_t *data) {
+	uint64_t val;
+	SDL_memcpy(&val, data, sizeof(val));
+	return SDL_SwapBE64(val);
+}
+
+static inline size_t remaining(const uint8_t *data, const uint8_t *end) {
+	return data < end ? (size_t)(end - data) : 0u;
+}
+
+/**
+ * @return The size of the payload of primitive types - @c 0 for all other types
+ */
+static inline size_t primitiveSize(TagType type) {
+	switch (type) {
+	case TagType::BYTE:
+		return 1u;
+	case TagType::SHORT:
+		return 2u;
+	case TagType::INT:
+	case TagType::FLOAT:
+		return 4u;
+	case TagType::LONG:
+	case TagType::DOUBLE:
+		return 8u;
+	default:
+		return 0u;
+	}
+}
+
+} // namespace nbtview
+
+template<>
+int8_t NBTArrayView<int8_t>::operator[](size_t idx) const {
+	core_assert(idx < _size);
+	return (int8_t)_data[idx];
+}
+
+template<>
+int32_t NBTArrayView<int32_t>::operator[](size_t idx) const {
+	core_assert(idx < _size);
+	return (int32_t)nbtview::readUInt32BE(_data + idx * sizeof(int32_t));
+}
+
+template<>
+int64_t NBTArrayView<int64_t>::operator[](size_t idx) const {
+	core_assert(idx < _size);
+	return (int64_t)nbtview::readUInt64BE(_data + idx * sizeof(int64_t));
+}
+
+bool NBTStringView::operator==(const char *other) const {
+	const size_t otherLength = SDL_strlen(other);
+	return otherLength == length && SDL_memcmp(str, other, length) == 0;
+}
+
+core::String NBTStringView::toString() const {
+	return core::String(str, length);
+}
+
+NBTView NBTView::parse(const uint8_t *buf, size_t size) {
+	const uint8_t *end = buf + size;
+	if (size < 3u || (TagType)buf[0] != TagType::COMPOUND) {
+		return NBTView{};
+	}
+	const uint16_t rootNameLength = nbtview::readUInt16BE(buf + 1);
+	const uint8_t *data = buf + 3;
+	if (nbtview::remaining(data, end) < rootNameLength) {
+		return NBTView{};
+	}
+	return NBTView{TagType::COMPOUND, data + rootNameLength, end};
+}
+
+const uint8_t *NBTView::skip(TagType type, const uint8_t *data, const uint8_t *end, int level) {
+	if (data == nullptr || level > nbtview::MaxLevel) {
+		return nullptr;
+	}
+	const size_t left = nbtview::remaining(data, end);
+	switch (type) {
+	case TagType::BYTE:
+	case TagType::SHORT:
+	case TagType::INT:
+	case TagType::FLOAT:
+	case TagType::LONG:
+	case TagType::DOUBLE: {
+		const size_t size = nbtview::primitiveSize(type);
+		return left >= size ? data + size : nullptr;
+	}
+	case TagType::BYTE_ARRAY:
+	case TagType::INT_ARRAY:
+	case TagType::LONG_ARRAY: {
+		if (left < 4u) {
+			return nullptr;
+		}
+		const size_t elementSize = type == TagType::BYTE_ARRAY ? 1u : (type == TagType::INT_ARRAY ? 4u : 8u);
+		const size_t length = nbtview::readUInt32BE(data);
+		if ((left - 4u) / elementSize < length) {
+			return nullptr;
+		}
+		return data + 4u + length * elementSize;
+	}
+	case TagType::STRING: {
+		if (left < 2u) {
+			return nullptr;
+		}
+		const size_t length = nbtview::readUInt16BE(data);
+		return left - 2u >= length ? data + 2u + length : nullptr;
+	}
+	case TagType::LIST: {
+		if (left < 5u) {
+			return nullptr;
+		}
+		const TagType elementType = (TagType)data[0];
+		const uint32_t length = nbtview::readUInt32BE(data + 1);
+		const uint8_t *p = data + 5u;
+		if (elementType == TagType::END || length == 0u) {
+			return p;
+		}
+		if (elementType >= TagType::MAX) {
+			return nullptr;
+		}
+		const size_t size = nbtview::primitiveSize(elementType);
+		if (size > 0u) {
+			return (left - 5u) / size >= length ? p + (size_t)length * size : nullptr;
+		}
+		for (uint32_t i = 0; i < length && p != nullptr; ++i) {
+			p = skip(elementType, p, end, level + 1);
+		}
+		return p;
+	}
+	case TagType::COMPOUND: {
+		const uint8_t *p = data;
+		while (p != nullptr) {
+			if (p >= end) {
+				return nullptr;
+			}
+			const TagType subType = (TagType)*p++;
+			if (subType == TagType::END) {
+				return p;
+			}
+			if (subType >= TagType::MAX || nbtview::remaining(p, end) < 2u) {
+				return nullptr;
+			}
+			const uint16_t nameLength = nbtview::readUInt16BE(p);
+			p += 2u;
+			if (nbtview::remaining(p, end) < nameLength) {
+				return nullptr;
+			}
+			p = skip(subType, p + nameLength, end, level + 1);
+		}
+		return nullptr;
+	}
+	default:
+		return nullptr;
+	}
+}
+
+NBTView NBTView::sibling() const {
+	const uint8_t *next = skip(_tagType, _data, _end);
+	if (next == nullptr) {
+		return NBTView{};
+	}
+	return NBTView{_tagType, next, _end};
+}
+
+NBTView NBTView::get(const char *name) const {
+	if (_tagType != TagType::COMPOUND) {
+		return NBTView{};
+	}
+	const size_t nameLength = SDL_strlen(name);
+	const uint8_t *p = _data;
+	while (p != nullptr && p < _end) {
+		const TagType subType = (TagType)*p++;
+		if (subType == TagType::END || subType >= TagType::MAX || nbtview::remaining(p, _end) < 2u) {
+			break;
+		}
+		const uint16_t length = nbtview::readUInt16BE(p);
+		p += 2u;
+		if (nbtview::remaining(p, _end) < length) {
+			break;
+		}
+		const bool match = length == nameLength && SDL_memcmp(p, name, length) == 0;
+		p += length;
+		if (match) {
+			return NBTView{subType, p, _end};
+		}
+		p = skip(subType, p, _end);
+	}
+	return NBTView{};
+}
+
+template<typename TYPE>
+TYPE NBTView::primitive(TagType type, TYPE defaultVal) const {
+	if (_tagType != type || nbtview::remaining(_data, _end) < sizeof(TYPE)) {
+		return defaultVal;
+	}
+	switch (sizeof(TYPE)) {
+	case 1:
+		return (TYPE)(int8_t)_data[0];
+	case 2:
+		return (TYPE)(int16_t)nbtview::readUInt16BE(_data);
+	case 4: {
+		const uint32_t bits = nbtview::readUInt32BE(_data);
+		TYPE val;
+		SDL_memcpy(&val, &bits, sizeof(val));
+		return val;
+	}
+	default: {
+		const uint64_t bits = nbtview::readUInt64BE(_data);
+		TYPE val;
+		SDL_memcpy(&val, &bits, sizeof(val));
+		return val;
+	}
+	}
+}
+
+int8_t NBTView::int8(int8_t defaultVal) const {
+	return primitive<int8_t>(TagType::BYTE, defaultVal);
+}
+
+int16_t NBTView::int16(int16_t defaultVal) const {
+	return primitive<int16_t>(TagType::SHORT, defaultVal);
+}
+
+int32_t NBTView::int32(int32_t defaultVal) const {
+	return primitive<int32_t>(TagType::INT, defaultVal);
+}
+
+int64_t NBTView::int64(int64_t defaultVal) const {
+	return primitive<int64_t>(TagType::LONG, defaultVal);
+}
+
+float NBTView::float32(float defaultVal) const {
+	return primitive<float>(TagType::FLOAT, defaultVal);
+}
+
+double NBTView::float64(double defaultVal) const {
+	return primitive<double>(TagType::DOUBLE, defaultVal);
+}
+
+bool NBTView::string(NBTStringView &str) const {
+	if (_tagType != TagType::STRING || nbtview::remaining(_data, _end) < 2u) {
+		return false;
+	}
+	const uint16_t length = nbtview::readUInt16BE(_data);
+	if (nbtview::remaining(_data + 2u, _end) < length) {
+		return false;
+	}
+	str.str = (const char *)_data + 2u;
+	str.length = length;
+	return true;
+}
+
+template<typename TYPE>
+NBTArrayView<TYPE> NBTView::array(TagType type) const {
+	if (_tagType != type || skip(type, _data, _end) == nullptr) {
+		return NBTArrayView<TYPE>{};
+	}
+	return NBTArrayView<TYPE>{_data + 4u, nbtview::readUInt32BE(_data)};
+}
+
+NBTArrayView<int8_t> NBTView::byteArray() const {
+	return array<int8_t>(TagType::BYTE_ARRAY);
+}
+
+NBTArrayView<int32_t> NBTView::intArray() const {
+	return array<int32_t>(TagType::INT_ARRAY);
+}
+
+NBTArrayView<int64_t> NBTView::longArray() const {
+	return array<int64_t>(TagType::LONG_ARRAY);
+}
+
+NBTListView NBTView::list() const {
+	if (_tagType != TagType::LIST || nbtview::remaining(_data, _end) < 5u) {
+		return NBTListView{};
+	}
+	const TagType elementType = (TagType)_data[0];
+	if (elementType == TagType::END || elementType >= TagType::MAX) {
+		return NBTListView{};
+	}
+	return NBTListView{elementType, nbtview::readUInt32BE(_data + 1), _data + 5u, _end};
+}
+
+NBTListView::iterator NBTListView::begin() const {
+	if (_size == 0u) {
+		return end();
+	}
+	return iterator(NBTView{_elementType, _data, _end}, _size);
+}
+
+NBTListView::iterator &NBTListView::iterator::operator++() {
+	if (_remaining == 0u) {
+		return *this;
+	}
+	--_remaining;
+	if (_remaining == 0u) {
+		_current = NBTView{};
+		return *this;
+	}
+	_current = _current.sibling();
+	if (!_current.valid()) {
+		// truncated data
+		_remaining = 0u;
+	}
+	return *this;
+}
+
 } // namespace priv
 } // namespace voxel
@@ -284,5 +284,194 @@ public:
 	NamedBinaryTag &operator=(NamedBinaryTag &&val) noexcept;
 };
 
+/**
+ * @brief View on an array payload of nbt data in memory - the values are converted from big endian on access
+ */
+template<typename TYPE>
+class NBTArrayView {
+private:
+	const uint8_t *_data = nullptr;
+	uint32_t _size = 0u;
+
+public:
+	NBTArrayView() {
+	}
+	NBTArrayView(const uint8_t *data, uint32_t size) : _data(data), _size(size) {
+	}
+
+	inline size_t size() const {
+		return _size;
+	}
+
+	inline bool empty() const {
+		return _size == 0u;
+	}
+
+	TYPE operator[](size_t idx) const;
+};
+
+/**
+ * @brief A string payload of nbt data in memory - it's not null terminated
+ */
+struct NBTStringView {
+	const char *str = nullptr;
+	uint16_t length = 0u;
+
+	bool operator==(const char *other) const;
+	inline bool operator!=(const char *other) const {
+		return !(*this == other);
+	}
+	core::String toString() const;
+};
+
+template<>
+int8_t NBTArrayView<int8_t>::operator[](size_t idx) const;
+template<>
+int32_t NBTArrayView<int32_t>::operator[](size_t idx) const;
+template<>
+int64_t NBTArrayView<int64_t>::operator[](size_t idx) const;
+
+class NBTListView;
+
+/**
+ * @brief Allocation free view on a tag of nbt data that is held in memory
+ *
+ * Nothing is parsed upfront. Compounds are searched by skipping over the payloads of the other tags, strings and
+ * arrays are views into the buffer. This is meant for loading large amounts of nbt data where only a few tags are
+ * needed - like the block states of the minecraft region chunks.
+ *
+ * @note The buffer must outlive the views
+ * @sa NamedBinaryTag to build a tree of tags that can also be written
+ */
+class NBTView {
+private:
+	TagType _tagType = TagType::MAX;
+	/** the start of the payload */
+	const uint8_t *_data = nullptr;
+	/** the end of the buffer */
+	const uint8_t *_end = nullptr;
+
+	template<typename TYPE>
+	TYPE primitive(TagType type, TYPE defaultVal) const;
+	template<typename TYPE>
+	NBTArrayView<TYPE> array(TagType type) const;
+
+public:
+	NBTView() {
+	}
+	NBTView(TagType type, const uint8_t *data, const uint8_t *end) : _tagType(type), _data(data), _end(end) {
+	}
+
+	/**
+	 * @brief Creates the view for the root compound of the given uncompressed nbt data
+	 */
+	static NBTView parse(const uint8_t *buf, size_t size);
+
+	/**
+	 * @return The pointer behind the payload of the given type or @c nullptr if the data is truncated or nested too
+	 * deep
+	 */
+	static const uint8_t *skip(TagType type, const uint8_t *data, const uint8_t *end, int level = 0);
+
+	/**
+	 * @return The view of the same type that directly follows the payload of this one - this is how the elements of
+	 * a list are iterated
+	 */
+	NBTView sibling() const;
+
+	inline bool valid() const {
+		return _tagType != TagType::MAX;
+	}
+
+	inline TagType type() const {
+		return _tagType;
+	}
+
+	/**
+	 * @return The tag of the compound with the given name - an invalid view if this is no compound or the tag doesn't
+	 * exist
+	 */
+	NBTView get(const char *name) const;
+
+	int8_t int8(int8_t defaultVal = 0) const;
+	int16_t int16(int16_t defaultVal = 0) const;
+	int32_t int32(int32_t defaultVal = 0) const;
+	int64_t int64(int64_t defaultVal = 0) const;
+	float float32(float defaultVal = 0.0f) const;
+	double float64(double defaultVal = 0.0) const;
+
+	/**
+	 * @return @c false if this is no string tag
+	 */
+	bool string(NBTStringView &str) const;
+	NBTArrayView<int8_t> byteArray() const;
+	NBTArrayView<int32_t> intArray() const;
+	NBTArrayView<int64_t> longArray() const;
+	/**
+	 * @note Iterating the list is linear - the elements don't need to get parsed to access the next one
+	 */
+	NBTListView list() const;
+};
+
+/**
+ * @brief The elements of a list tag in memory
+ */
+class NBTListView {
+private:
+	TagType _elementType = TagType::END;
+	uint32_t _size = 0u;
+	const uint8_t *_data = nullptr;
+	const uint8_t *_end = nullptr;
+
+public:
+	NBTListView() {
+	}
+	NBTListView(TagType elementType, uint32_t size, const uint8_t *data, const uint8_t *end)
+		: _elementType(elementType), _size(size), _data(data), _end(end) {
+	}
+
+	class iterator {
+	private:
+		NBTView _current;
+		uint32_t _remaining = 0u;
+
+	public:
+		iterator() {
+		}
+		iterator(const NBTView &current, uint32_t remaining) : _current(current), _remaining(remaining) {
+		}
+		inline const NBTView &operator*() const {
+			return _current;
+		}
+		inline const NBTView *operator->() const {
+			return &_current;
+		}
+		iterator &operator++();
+		inline bool operator!=(const iterator &rhs) const {
+			return _remaining != rhs._remaining;
+		}
+		inline bool operator==(const iterator &rhs) const {
+			return _remaining == rhs._remaining;
+		}
+	};
+
+	inline TagType elementType() const {
+		return _elementType;
+	}
+
+	inline size_t size() const {
+		return _size;
+	}
+
+	inline bool empty() const {
+		return _size == 0u;
+	}
+
+	iterator begin() const;
+	inline iterator end() const {
+		return iterator();
+	}
+};
+
 } // namespace priv
 } // namespace voxel
@@ -8,6 +8,7 @@
 #include "core/Log.h"
 #include "core/ScopedPtr.h"
 #include "core/Var.h"
+#include "core/collection/DynamicArray.h"
 #include "core/collection/DynamicMap.h"
 #include "io/Stream.h"
 #include "scenegraph/SceneGraph.h"
@@ -62,13 +63,27 @@ private:
 	bool _error = false;
 	core::RGBA _currentColor;
 	uint32_t _count = 0;
+	/** the colors of an uncompressed matrix are written in batches */
+	static constexpr size_t ColorBatchSize = 4096;
+	core::DynamicArray<core::RGBA> _colors;
 
 	bool saveColor(io::WriteStream &stream, core::RGBA color) {
 		// VisibilityMask::AlphaChannelVisibleByValue
-		wrapSave(stream.writeUInt8(color.r))
-		wrapSave(stream.writeUInt8(color.g))
-		wrapSave(stream.writeUInt8(color.b))
-		wrapSave(stream.writeUInt8(color.a > 0 ? 255 : 0))
+		color.a = color.a > 0 ? 255 : 0;
+		wrapSave(stream.writeRGBAArray(&color, 1))
+		return true;
+	}
+
+	bool flushColors() {
+		if (_colors.empty()) {
+			return true;
+		}
+		for (core::RGBA &color : _colors) {
+			// VisibilityMask::AlphaChannelVisibleByValue
+			color.a = color.a > 0 ? 255 : 0;
+		}
+		wrapSave(_stream.writeRGBAArray(_colors.data(), _colors.size()))
+		_colors.clear();
 		return true;
 	}
 
@@ -77,6 +92,9 @@ public:
 				 const scenegraph::SceneGraphNode &node, bool leftHanded, bool rleCompressed)
 		: _stream(stream), _volume(sceneGraph.resolveVolume(node)), _palette(node.palette()),
 		  _maxs(_volume->region().getUpperCorner()), _leftHanded(leftHanded), _rleCompressed(rleCompressed) {
+		if (!_rleCompressed) {
+			_colors.reserve(ColorBatchSize);
+		}
 	}
 
 	void addVoxel(int x, int y, int z, const voxel::Voxel &voxel) {
@@ -85,12 +103,13 @@ public:
 		}
 		if (!_rleCompressed) {
 			core::RGBA color(0, 0, 0, 0);
-			if (voxel::isAir(voxel.getMaterial())) {
-				wrapSaveWriter(saveColor(_stream, color))
-			} else {
+			if (!voxel::isAir(voxel.getMaterial())) {
 				color = _palette.color(voxel.getColor());
 			}
-			wrapSaveWriter(saveColor(_stream, color))
+			_colors.push_back(color);
+			if (_colors.size() >= ColorBatchSize) {
+				wrapSaveWriter(flushColors())
+			}
 			return;
 		}
 		constexpr voxel::Voxel Empty;
@@ -141,7 +160,10 @@ public:
 		}
 	}
 
-	bool success() const {
+	bool success() {
+		if (!_error && !flushColors()) {
+			return false;
+		}
 		return !_error;
 	}
 };
@@ -222,6 +244,10 @@ voxel::Voxel QBFormat::getVoxel(State &state, io::SeekableReadStream &stream, pa
 	if (!readColor(state, stream, color)) {
 		return voxel::Voxel();
 	}
+	return getVoxel(color, palLookup);
+}
+
+voxel::Voxel QBFormat::getVoxel(core::RGBA color, palette::PaletteLookup &palLookup) {
 	if (color.a == 0) {
 		return voxel::Voxel();
 	}
@@ -231,14 +257,15 @@ voxel::Voxel QBFormat::getVoxel(State &state, io::SeekableReadStream &stream, pa
 }
 
 bool QBFormat::readColor(State &state, io::SeekableReadStream &stream, core::RGBA &color) {
-	if (state._colorFormat == ColorFormat::RGBA) {
-		wrap(stream.readUInt8(color.r))
-		wrap(stream.readUInt8(color.g))
-		wrap(stream.readUInt8(color.b))
-	} else {
-		wrap(stream.readUInt8(color.b))
-		wrap(stream.readUInt8(color.g))
-		wrap(stream.readUInt8(color.r))
+	return readColors(state, stream, &color, 1);
+}
+
+bool QBFormat::readColors(State &state, io::SeekableReadStream &stream, core::RGBA *colors, size_t n) {
+	wrap(stream.readRGBAArray(colors, n))
+	if (state._colorFormat != ColorFormat::RGBA) {
+		for (size_t i = 0; i < n; ++i) {
+			core::exchange(colors[i].r, colors[i].b);
+		}
 	}
 	// the returned alpha value might also be the vis mask
 	// if (mask == 0) // voxel invisble
@@ -248,7 +275,6 @@ bool QBFormat::readColor(State &state, io::SeekableReadStream &stream, core::RGB
 	// if (mask && 16 == 16) // bottom side visible
 	// if (mask && 32 == 32) // front side visible
 	// if (mask && 64 == 64) // back side visible
-	wrap(stream.readUInt8(color.a))
 	return true;
 }
 
@@ -309,10 +335,13 @@ bool QBFormat::readMatrix(State &state, io::SeekableReadStream &stream, scenegra
 	core::ScopedPtr<voxel::RawVolume> v(new voxel::RawVolume(region));
 	if (state._compressed == Compression::None) {
 		Log::debug("qb matrix uncompressed");
+		core::DynamicArray<core::RGBA> row;
+		row.resize(size.x);
 		for (uint32_t z = 0; z < size.z; ++z) {
 			for (uint32_t y = 0; y < size.y; ++y) {
+				wrapBool(readColors(state, stream, row.data(), size.x))
 				for (uint32_t x = 0; x < size.x; ++x) {
-					const voxel::Voxel &voxel = getVoxel(state, stream, palLookup);
+					const voxel::Voxel &voxel = getVoxel(row[x], palLookup);
 					if (state._zAxisOrientation == ZAxisOrientation::LeftHanded) {
 						v->setVoxel((int)x, (int)y, (int)z, voxel);
 					} else {
@@ -411,11 +440,13 @@ bool QBFormat::readPalette(State &state, io::SeekableReadStream &stream, RGBAMap
 
 	if (state._compressed == Compression::None) {
 		Log::debug("qb matrix uncompressed");
+		core::DynamicArray<core::RGBA> row;
+		row.resize(size.x);
 		for (uint32_t z = 0; z < size.z; ++z) {
 			for (uint32_t y = 0; y < size.y; ++y) {
+				wrapBool(readColors(state, stream, row.data(), size.x))
 				for (uint32_t x = 0; x < size.x; ++x) {
-					core::RGBA color(0);
-					wrapBool(readColor(state, stream, color))
+					const core::RGBA color = row[x];
 					if (color.a == 0) {
 						continue;
 					}
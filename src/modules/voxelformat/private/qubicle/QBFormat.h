@@ -44,6 +44,11 @@ private:
 	enum class VisMaskSides : uint8_t { Invisble, Left, Right, Top, Bottom, Front, Back };
 
 	bool readColor(State &state, io::SeekableReadStream &stream, core::RGBA &color);
+	/**
+	 * @brief Reads @c n colors at once - e.g. a whole row of an uncompressed matrix
+	 */
+	bool readColors(State &state, io::SeekableReadStream &stream, core::RGBA *colors, size_t n);
+	voxel::Voxel getVoxel(core::RGBA color, palette::PaletteLookup &palLookup);
 	voxel::Voxel getVoxel(State &state, io::SeekableReadStream &stream, palette::PaletteLookup &palLookup);
 	bool readMatrix(State &state, io::SeekableReadStream &stream, scenegraph::SceneGraph &sceneGraph,
 					palette::PaletteLookup &palLookup);
@@ -3,6 +3,7 @@
  */
 
 #include "QBTFormat.h"
+#include "app/App.h"
 #include "core/Color.h"
 #include "core/Common.h"
 #include "core/FourCC.h"
@@ -10,8 +11,12 @@
 #include "core/GameConfig.h"
 #include "core/Log.h"
 #include "core/ScopedPtr.h"
+#include "core/StandardLib.h"
 #include "core/Var.h"
+#include "core/collection/DynamicArray.h"
+#include "core/concurrent/ThreadPool.h"
 #include "io/BufferedReadWriteStream.h"
+#include "io/MemoryReadStream.h"
 #include "io/Stream.h"
 #include "io/ZipReadStream.h"
 #include "io/ZipWriteStream.h"
@@ -130,8 +135,8 @@ public:
 		return false;                                                                                                  \
 	}
 
-bool QBTFormat::saveMatrix(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-						   const scenegraph::SceneGraphNode &node, bool colorMap) const {
+bool QBTFormat::compressMatrix(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
+							   bool colorMap, CompressedMatrix &compressed) const {
 	const voxel::Region &region = sceneGraph.resolveRegion(node);
 	const glm::ivec3 &mins = region.getLowerCorner();
 	const glm::ivec3 &maxs = region.getUpperCorner();
@@ -141,39 +146,60 @@ bool QBTFormat::saveMatrix(io::SeekableWriteStream &stream, const scenegraph::Sc
 
 	const int zlibBufSize = size.x * size.y * size.z * (int)sizeof(uint32_t);
 	io::BufferedReadWriteStream bufferStream(zlibBufSize);
-	io::ZipWriteStream zipStream(bufferStream);
-
-	const voxel::RawVolume *v = sceneGraph.resolveVolume(node);
-	for (int x = mins.x; x <= maxs.x; ++x) {
-		for (int z = mins.z; z <= maxs.z; ++z) {
-			for (int y = mins.y; y <= maxs.y; ++y) {
-				const voxel::Voxel &voxel = v->voxel(x, y, z);
-				if (isAir(voxel.getMaterial())) {
-					zipStream.writeUInt8(0);
-					zipStream.writeUInt8(0);
-					zipStream.writeUInt8(0);
-					zipStream.writeUInt8(0); // mask 0 == air
-					continue;
-				}
-				if (colorMap) {
-					zipStream.writeUInt8(voxel.getColor());
-					zipStream.writeUInt8(0);
-					zipStream.writeUInt8(0);
-				} else {
-					const core::RGBA voxelColor = palette.color(voxel.getColor());
-					// const uint8_t alpha = voxelColor.a * 255.0f;
-					zipStream.writeUInt8(voxelColor.r);
-					zipStream.writeUInt8(voxelColor.g);
-					zipStream.writeUInt8(voxelColor.b);
+	{
+		io::ZipWriteStream zipStream(bufferStream);
+		core::DynamicArray<uint8_t> column;
+		column.resize((size_t)size.y * 4);
+
+		const voxel::RawVolume *v = sceneGraph.resolveVolume(node);
+		for (int x = mins.x; x <= maxs.x; ++x) {
+			for (int z = mins.z; z <= maxs.z; ++z) {
+				uint8_t *rgbm = column.data();
+				for (int y = mins.y; y <= maxs.y; ++y, rgbm += 4) {
+					const voxel::Voxel &voxel = v->voxel(x, y, z);
+					if (isAir(voxel.getMaterial())) {
+						rgbm[0] = rgbm[1] = rgbm[2] = 0;
+						rgbm[3] = 0; // mask 0 == air
+						continue;
+					}
+					if (colorMap) {
+						rgbm[0] = voxel.getColor();
+						rgbm[1] = 0;
+						rgbm[2] = 0;
+					} else {
+						const core::RGBA voxelColor = palette.color(voxel.getColor());
+						// const uint8_t alpha = voxelColor.a * 255.0f;
+						rgbm[0] = voxelColor.r;
+						rgbm[1] = voxelColor.g;
+						rgbm[2] = voxelColor.b;
+					}
+					// mask != 0 means solid, 1 is core (surrounded by others and not visible)
+					// TODO: const voxel::FaceBits faceBits = voxel::visibleFaces(v, x, y, z);
+					rgbm[3] = 0xff;
 				}
-				// mask != 0 means solid, 1 is core (surrounded by others and not visible)
-				// TODO: const voxel::FaceBits faceBits = voxel::visibleFaces(v, x, y, z);
-				zipStream.writeUInt8(0xff);
+				wrapSave(zipStream.writeUInt8Array(column.data(), column.size()))
 			}
 		}
+
+		wrapSave(zipStream.flush())
 	}
 
-	zipStream.flush();
+	Log::debug("compressed matrix %s into %i bytes", node.name().c_str(), (int)bufferStream.size());
+	compressed.size = bufferStream.size();
+	compressed.data = bufferStream.release();
+	return true;
+}
+
+bool QBTFormat::saveMatrix(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
+						   const scenegraph::SceneGraphNode &node, const CompressedMatrices &matrices) const {
+	auto iter = matrices.find(node.id());
+	if (iter == matrices.end()) {
+		Log::error("Could not save qbt file: no voxel data for node %i", node.id());
+		return false;
+	}
+	const CompressedMatrix &compressed = iter->value;
+	const voxel::Region &region = sceneGraph.resolveRegion(node);
+	const glm::ivec3 size = region.getDimensionsInVoxels();
 
 	wrapSave(stream.writePascalStringUInt32LE(node.name()));
 	Log::debug("Save matrix with name %s", node.name().c_str());
@@ -199,9 +225,9 @@ bool QBTFormat::saveMatrix(io::SeekableWriteStream &stream, const scenegraph::Sc
 	wrapSave(stream.writeUInt32(size.y));
 	wrapSave(stream.writeUInt32(size.z));
 
-	Log::debug("save %i compressed bytes", (int)bufferStream.size());
-	wrapSave(stream.writeUInt32(bufferStream.size()));
-	if (stream.write(bufferStream.getBuffer(), bufferStream.size()) == -1) {
+	Log::debug("save %i compressed bytes", (int)compressed.size);
+	wrapSave(stream.writeUInt32(compressed.size));
+	if (stream.write(compressed.data, compressed.size) == -1) {
 		Log::error("Could not save qbt file: failed to write the compressed buffer");
 		return false;
 	}
@@ -223,39 +249,39 @@ bool QBTFormat::saveColorMap(io::SeekableWriteStream &stream, const palette::Pal
 }
 
 bool QBTFormat::saveCompound(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-							 const scenegraph::SceneGraphNode &node, bool colorMap) const {
-	wrapSave(saveMatrix(stream, sceneGraph, node, colorMap))
+							 const scenegraph::SceneGraphNode &node, const CompressedMatrices &matrices) const {
+	wrapSave(saveMatrix(stream, sceneGraph, node, matrices))
 	wrapSave(stream.writeUInt32((int)node.children().size()));
 	for (int nodeId : node.children()) {
 		const scenegraph::SceneGraphNode &cnode = sceneGraph.node(nodeId);
-		wrapSave(saveNode(stream, sceneGraph, cnode, colorMap))
+		wrapSave(saveNode(stream, sceneGraph, cnode, matrices))
 	}
 	return true;
 }
 
 bool QBTFormat::saveNode(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-						 const scenegraph::SceneGraphNode &node, bool colorMap) const {
+						 const scenegraph::SceneGraphNode &node, const CompressedMatrices &matrices) const {
 	const scenegraph::SceneGraphNodeType type = node.type();
 	if (node.isAnyModelNode()) {
 		if (node.children().empty()) {
 			qbt::ScopedQBTHeader header(stream, type);
-			wrapSave(saveMatrix(stream, sceneGraph, node, colorMap) && header.success())
+			wrapSave(saveMatrix(stream, sceneGraph, node, matrices) && header.success())
 		} else {
 			qbt::ScopedQBTHeader scoped(stream, qbt::NODE_TYPE_COMPOUND);
-			wrapSave(saveCompound(stream, sceneGraph, node, colorMap) && scoped.success())
+			wrapSave(saveCompound(stream, sceneGraph, node, matrices) && scoped.success())
 		}
 	} else if (type == scenegraph::SceneGraphNodeType::Group || type == scenegraph::SceneGraphNodeType::Root) {
-		wrapSave(saveModel(stream, sceneGraph, node, colorMap))
+		wrapSave(saveModel(stream, sceneGraph, node, matrices))
 	}
 	return true;
 }
 
 bool QBTFormat::saveModel(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-						  const scenegraph::SceneGraphNode &node, bool colorMap) const {
+						  const scenegraph::SceneGraphNode &node, const CompressedMatrices &matrices) const {
 	if (node.children().size() == 1) {
 		for (int nodeId : node.children()) {
 			const scenegraph::SceneGraphNode &cnode = sceneGraph.node(nodeId);
-			wrapSave(saveNode(stream, sceneGraph, cnode, colorMap))
+			wrapSave(saveNode(stream, sceneGraph, cnode, matrices))
 		}
 		return true;
 	}
@@ -264,7 +290,7 @@ bool QBTFormat::saveModel(io::SeekableWriteStream &stream, const scenegraph::Sce
 	wrapSave(stream.writeUInt32(children));
 	for (int nodeId : node.children()) {
 		const scenegraph::SceneGraphNode &cnode = sceneGraph.node(nodeId);
-		wrapSave(saveNode(stream, sceneGraph, cnode, colorMap))
+		wrapSave(saveNode(stream, sceneGraph, cnode, matrices))
 	}
 	return scoped.success();
 }
@@ -305,7 +331,28 @@ bool QBTFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core:
 	if (!stream->writeString("DATATREE", false)) {
 		return false;
 	}
-	return saveNode(*stream, sceneGraph, sceneGraph.root(), colorMap);
+
+	// compress the voxel data of all model nodes in parallel - the data tree is written in order afterwards
+	core::DynamicArray<const scenegraph::SceneGraphNode *> nodes;
+	for (auto iter = sceneGraph.beginAllModels(); iter != sceneGraph.end(); ++iter) {
+		nodes.push_back(&*iter);
+	}
+	core::DynamicArray<CompressedMatrix> compressed;
+	compressed.resize(nodes.size());
+	bool success = processPayloads((int)nodes.size(), [&](int i) {
+		return compressMatrix(sceneGraph, *nodes[i], colorMap, compressed[i]);
+	});
+	CompressedMatrices matrices;
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		matrices.put(nodes[i]->id(), compressed[i]);
+	}
+	if (success) {
+		success = saveNode(*stream, sceneGraph, sceneGraph.root(), matrices);
+	}
+	for (CompressedMatrix &matrix : compressed) {
+		core_free(matrix.data);
+	}
+	return success;
 }
 
 bool QBTFormat::skipNode(io::SeekableReadStream &stream) {
@@ -427,50 +474,134 @@ bool QBTFormat::loadMatrix(io::SeekableReadStream &stream, scenegraph::SceneGrap
 		Log::warn("Size of matrix results in empty space - voxelDataSize: %u", voxelDataSize);
 		return false;
 	}
-	io::ZipReadStream zipStream(stream, voxelDataSize);
-
 	const voxel::Region region(glm::ivec3(0), glm::ivec3(size) - 1);
 	if (!region.isValid()) {
 		Log::error("Invalid region");
 		return false;
 	}
-	core::ScopedPtr<voxel::RawVolume> volume(new voxel::RawVolume(region));
-	for (int32_t x = 0; x < (int)size.x; x++) {
-		for (int32_t z = 0; z < (int)size.z; z++) {
-			for (int32_t y = 0; y < (int)size.y; y++) {
-				uint8_t red;
-				wrap(zipStream.readUInt8(red))
-				uint8_t green;
-				wrap(zipStream.readUInt8(green))
-				uint8_t blue;
-				wrap(zipStream.readUInt8(blue))
-				uint8_t mask;
-				wrap(zipStream.readUInt8(mask))
-				if (mask == 0u) {
-					continue;
-				}
-				if (state.colorFormat == ColorFormat::Palette) {
-					const voxel::Voxel &voxel = voxel::createVoxel(palette, red);
-					volume->setVoxel(x, y, z, voxel);
-				} else {
-					const core::RGBA color = flattenRGB(red, green, blue);
-					uint8_t index = 1;
-					palette.tryAdd(color, false, &index);
-					const voxel::Voxel &voxel = voxel::createVoxel(palette, index);
-					volume->setVoxel(x, y, z, voxel);
-				}
-			}
-		}
-	}
+	// the voxel data is decoded in parallel once the whole data tree was read - see decodeMatrices()
+	MatrixPayload payload;
+	payload.data.resize(voxelDataSize);
+	wrap(stream.readUInt8Array(payload.data.data(), voxelDataSize))
+	payload.volume = new voxel::RawVolume(region);
+
 	scenegraph::SceneGraphNode node;
-	node.setVolume(volume.release(), true);
+	node.setVolume(payload.volume, true);
 	node.setName(name);
 	node.setPivot(pivot);
 	node.setPalette(palette);
 	const scenegraph::KeyFrameIndex keyFrameIdx = 0;
 	node.setTransform(keyFrameIdx, transform);
 	const int id = sceneGraph.emplace(core::move(node), parent);
-	return id != -1;
+	if (id == -1) {
+		return false;
+	}
+	state.payloads.push_back(core::move(payload));
+	return true;
+}
+
+bool QBTFormat::decodeMatrix(MatrixPayload &payload, ColorFormat colorFormat, const palette::Palette &palette) const {
+	const voxel::Region &region = payload.volume->region();
+	const glm::ivec3 &size = region.getDimensionsInVoxels();
+	core::Buffer<uint8_t> voxelData((size_t)size.x * (size_t)size.y * (size_t)size.z * 4);
+	{
+		io::MemoryReadStream memStream(payload.data.data(), payload.data.size());
+		io::ZipReadStream zipStream(memStream, (int)payload.data.size());
+		wrap(zipStream.readUInt8Array(voxelData.data(), voxelData.size()))
+	}
+	payload.data.release();
+
+	if (colorFormat == ColorFormat::RGBA) {
+		// the palette is built in the order of the file - remember the unique colors and replace every voxel with
+		// the index of its color in this list (plus one - 0 is air)
+		core::DynamicMap<core::RGBA, uint32_t, 1031, core::RGBAHasher> unique;
+		uint32_t *rgbm = (uint32_t *)voxelData.data();
+		for (size_t i = 0; i < voxelData.size() / 4; ++i) {
+			const uint8_t *bytes = (const uint8_t *)&rgbm[i];
+			if (bytes[3] == 0u) {
+				rgbm[i] = 0u;
+				continue;
+			}
+			const core::RGBA color = flattenRGB(bytes[0], bytes[1], bytes[2]);
+			auto iter = unique.find(color);
+			if (iter != unique.end()) {
+				rgbm[i] = iter->value;
+				continue;
+			}
+			payload.colors.push_back(color);
+			rgbm[i] = (uint32_t)payload.colors.size();
+			unique.put(color, rgbm[i]);
+		}
+		payload.data = core::move(voxelData);
+		return true;
+	}
+
+	voxel::RawVolume::Sampler sampler(payload.volume);
+	const uint8_t *rgbm = voxelData.data();
+	for (int32_t x = 0; x < size.x; x++) {
+		for (int32_t z = 0; z < size.z; z++) {
+			sampler.setPosition(x, 0, z);
+			for (int32_t y = 0; y < size.y; y++, rgbm += 4) {
+				// the mask is 0 for air
+				if (rgbm[3] != 0u) {
+					sampler.setVoxel(voxel::createVoxel(palette, rgbm[0]));
+				}
+				sampler.movePositiveY();
+			}
+		}
+	}
+	return true;
+}
+
+bool QBTFormat::decodeMatrices(Header &state, palette::Palette &palette) {
+	core::DynamicArray<MatrixPayload> &payloads = state.payloads;
+	const ColorFormat colorFormat = state.colorFormat;
+	const int n = (int)payloads.size();
+	// the inflated data of the rgba matrices is kept until the palette is complete - decode them in batches to
+	// not hold the inflated data of all matrices at once
+	const int batchSize = (int)core_max((size_t)1, app::App::getInstance()->threadPool().size());
+	bool success = true;
+	for (int start = 0; success && start < n; start += batchSize) {
+		const int count = core_min(batchSize, n - start);
+		success = processPayloads(count, [&](int i) {
+			return decodeMatrix(payloads[start + i], colorFormat, palette);
+		});
+		if (success && colorFormat == ColorFormat::RGBA) {
+			// the palette entries are added in the order of the file to get the same palette as a sequential load
+			for (int i = start; i < start + count; ++i) {
+				MatrixPayload &payload = payloads[i];
+				payload.indices.reserve(payload.colors.size());
+				for (const core::RGBA &color : payload.colors) {
+					uint8_t index = 1;
+					palette.tryAdd(color, false, &index);
+					payload.indices.push_back(index);
+				}
+			}
+			success = processPayloads(count, [&](int i) {
+				const MatrixPayload &payload = payloads[start + i];
+				const glm::ivec3 &size = payload.volume->region().getDimensionsInVoxels();
+				const uint32_t *colorIdx = (const uint32_t *)payload.data.data();
+				voxel::RawVolume::Sampler sampler(payload.volume);
+				for (int32_t x = 0; x < size.x; x++) {
+					for (int32_t z = 0; z < size.z; z++) {
+						sampler.setPosition(x, 0, z);
+						for (int32_t y = 0; y < size.y; y++, ++colorIdx) {
+							if (*colorIdx != 0u) {
+								sampler.setVoxel(voxel::createVoxel(palette, payload.indices[*colorIdx - 1]));
+							}
+							sampler.movePositiveY();
+						}
+					}
+				}
+				return true;
+			});
+		}
+		for (int i = start; i < start + count; ++i) {
+			payloads[i] = MatrixPayload();
+		}
+	}
+	payloads.clear();
+	return success;
 }
 
 /**
@@ -656,6 +787,10 @@ size_t QBTFormat::loadPalette(const core::String &filename, const io::ArchivePtr
 				Log::error("Failed to load node");
 				return 0u;
 			}
+			if (!decodeMatrices(state, palette)) {
+				Log::error("Failed to decode the matrices");
+				return 0u;
+			}
 		} else {
 			Log::error("Unknown section found: %c%c%c%c%c%c%c%c", buf[0], buf[1], buf[2], buf[3], buf[4], buf[5],
 					   buf[6], buf[7]);
@@ -697,6 +832,10 @@ bool QBTFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 				Log::error("Failed to load node");
 				return false;
 			}
+			if (!decodeMatrices(state, palette)) {
+				Log::error("Failed to decode the matrices");
+				return false;
+			}
 		} else {
 			Log::error("Unknown section found: %c%c%c%c%c%c%c%c", buf[0], buf[1], buf[2], buf[3], buf[4], buf[5],
 					   buf[6], buf[7]);
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include "core/collection/Buffer.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicMap.h"
 #include "voxelformat/Format.h"
 
 namespace voxelformat {
@@ -23,16 +26,41 @@ namespace voxelformat {
 class QBTFormat : public PaletteFormat {
 private:
 	enum class ColorFormat : uint8_t { RGBA, Palette };
+	/**
+	 * @brief The compressed voxel data of a matrix - the data tree is read first, the voxels of all matrices are
+	 * decoded in parallel afterwards
+	 */
+	struct MatrixPayload {
+		/** owned by the scene graph node */
+		voxel::RawVolume *volume = nullptr;
+		/** the zlib compressed voxel data - replaced by the inflated data while decoding */
+		core::Buffer<uint8_t> data;
+		/** the unique colors in the order of their first appearance - only used without a color map */
+		core::DynamicArray<core::RGBA> colors;
+		/** the palette indices of the unique colors */
+		core::DynamicArray<uint8_t> indices;
+	};
 	struct Header {
 		uint8_t versionMajor = 0;
 		uint8_t versionMinor = 0;
 		ColorFormat colorFormat = ColorFormat::RGBA;
 		glm::vec3 globalScale{0};
+		core::DynamicArray<MatrixPayload> payloads;
+	};
+	/**
+	 * @brief The zlib compressed voxel data of a node - the nodes are compressed in parallel before they are written
+	 */
+	struct CompressedMatrix {
+		uint8_t *data = nullptr;
+		int64_t size = 0;
 	};
+	using CompressedMatrices = core::DynamicMap<int, CompressedMatrix, 11>;
 
 	bool loadHeader(io::SeekableReadStream &stream, Header &state);
 
 	bool skipNode(io::SeekableReadStream &stream);
+	bool decodeMatrix(MatrixPayload &payload, ColorFormat colorFormat, const palette::Palette &palette) const;
+	bool decodeMatrices(Header &state, palette::Palette &palette);
 	bool loadMatrix(io::SeekableReadStream &stream, scenegraph::SceneGraph &sceneGraph, int parent,
 					palette::Palette &palette, Header &state);
 	bool loadCompound(io::SeekableReadStream &stream, scenegraph::SceneGraph &sceneGraph, int parent,
@@ -46,15 +74,17 @@ private:
 						   scenegraph::SceneGraph &sceneGraph, palette::Palette &palette,
 						   const LoadContext &ctx) override;
 
+	bool compressMatrix(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
+						bool colorMap, CompressedMatrix &compressed) const;
 	bool saveNode(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-				  const scenegraph::SceneGraphNode &node, bool colorMap) const;
+				  const scenegraph::SceneGraphNode &node, const CompressedMatrices &matrices) const;
 	bool saveCompound(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-					  const scenegraph::SceneGraphNode &node, bool colorMap) const;
+					  const scenegraph::SceneGraphNode &node, const CompressedMatrices &matrices) const;
 	bool saveMatrix(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-					const scenegraph::SceneGraphNode &node, bool colorMap) const;
+					const scenegraph::SceneGraphNode &node, const CompressedMatrices &matrices) const;
 	bool saveColorMap(io::SeekableWriteStream &stream, const palette::Palette &palette) const;
 	bool saveModel(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-				   const scenegraph::SceneGraphNode &node, bool colorMap) const;
+				   const scenegraph::SceneGraphNode &node, const CompressedMatrices &matrices) const;
 	bool saveGroups(const scenegraph::SceneGraph &sceneGraph, const core::String &filename,
 					const io::ArchivePtr &archive, const SaveContext &ctx) override;
 
@@ -558,7 +558,9 @@ bool VXMFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 		node.setProperty("filename", filename);
 		const scenegraph::KeyFrameIndex keyFrameIdx = 0;
 		node.setTransform(keyFrameIdx, transform);
-		sceneGraph.emplace(core::move(node));
+		if (!addNode(sceneGraph, core::move(node), sceneGraph.root().id(), ctx)) {
+			return false;
+		}
 	}
 
 	if (version >= 10) {
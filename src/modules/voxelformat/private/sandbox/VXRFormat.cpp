@@ -158,7 +158,7 @@ bool VXRFormat::loadChildVXM(const core::String &vxmPath, const io::ArchivePtr &
 							 scenegraph::SceneGraphNode &node, int version, const LoadContext &ctx) {
 	VXMFormat f;
 	scenegraph::SceneGraph childSceneGraph;
-	if (!f.load(vxmPath, archive, childSceneGraph, ctx)) {
+	if (!f.load(vxmPath, archive, childSceneGraph, ctx.withoutSink())) {
 		Log::error("Failed to load '%s'", vxmPath.c_str());
 		return false;
 	}
@@ -67,7 +67,7 @@ bool VXTFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 		wrapBool(stream.readString(sizeof(path), path, true))
 		VXMFormat f;
 		scenegraph::SceneGraph subGraph;
-		if (!f.load(path, archive, subGraph, ctx)) {
+		if (!f.load(path, archive, subGraph, ctx.withoutSink())) {
 			Log::warn("Failed to load vxm tile %s", path);
 			continue;
 		}
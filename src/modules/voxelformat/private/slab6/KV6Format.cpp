@@ -30,6 +30,10 @@ namespace voxelformat {
 namespace priv {
 
 constexpr uint32_t MAXVOXS = 1048576;
+/** the size of a voxel entry in the file */
+constexpr uint32_t VoxelRecordSize = 8;
+/** the amount of voxel entries that are read or written at once */
+constexpr uint32_t VoxelRecordBatch = 1024;
 
 struct VoxtypeKV6 {
 	/** z coordinate of this surface voxel (height - our y) */
@@ -220,11 +224,14 @@ size_t KV6Format::loadPalette(const core::String &filename, const io::ArchivePtr
 	// SPal not found, most likely slab5
 	stream->seek(headerSize);
 
-	for (uint32_t c = 0u; c < numvoxs; ++c) {
-		core::RGBA color;
-		wrapBool(priv::readBGRColor(*stream, color));
-		palette.tryAdd(color, false);
-		wrap2(stream->skip(5));
+	uint8_t records[priv::VoxelRecordBatch * priv::VoxelRecordSize];
+	for (uint32_t c = 0u; c < numvoxs;) {
+		const uint32_t n = core_min(numvoxs - c, priv::VoxelRecordBatch);
+		wrap(stream->readUInt8Array(records, n * priv::VoxelRecordSize))
+		for (uint32_t i = 0u; i < n; ++i, ++c) {
+			const uint8_t *record = &records[i * priv::VoxelRecordSize];
+			palette.tryAdd(core::RGBA(record[2], record[1], record[0]), false);
+		}
 	}
 
 	return palette.size();
@@ -452,34 +459,32 @@ bool KV6Format::loadGroupsPalette(const core::String &filename, const io::Archiv
 	stream->seek(headerSize);
 
 	core::ScopedPtr<priv::State> state(new priv::State());
-	for (uint32_t c = 0u; c < numvoxs; ++c) {
-		core::RGBA color;
-		wrapBool(priv::readBGRColor(*stream, color));
-		wrap2(stream->skip(1)) // slab6 always 128
-		wrap(stream->readUInt8(state->voxdata[c].z))
-		wrap2(stream->skip(1)) // slab6 always 0
-		wrap(stream->readUInt8((uint8_t &)state->voxdata[c].vis))
-		wrap(stream->readUInt8(state->voxdata[c].dir))
-
-		if (slab5) {
-			palette.tryAdd(color, false, &state->voxdata[c].col, false);
-		} else {
-			state->voxdata[c].col = palette.getClosestMatch(color);
+	uint8_t records[priv::VoxelRecordBatch * priv::VoxelRecordSize];
+	for (uint32_t c = 0u; c < numvoxs;) {
+		const uint32_t n = core_min(numvoxs - c, priv::VoxelRecordBatch);
+		wrap(stream->readUInt8Array(records, n * priv::VoxelRecordSize))
+		for (uint32_t i = 0u; i < n; ++i, ++c) {
+			// b, g, r, a (slab6 always 128), z, zhigh (slab6 always 0), vis, dir
+			const uint8_t *record = &records[i * priv::VoxelRecordSize];
+			const core::RGBA color(record[2], record[1], record[0]);
+			priv::VoxtypeKV6 &vox = state->voxdata[c];
+			vox.z = record[4];
+			vox.vis = (priv::SLABVisibility)record[6];
+			vox.dir = record[7];
+
+			if (slab5) {
+				palette.tryAdd(color, false, &vox.col, false);
+			} else {
+				vox.col = palette.getClosestMatch(color);
+			}
+			Log::debug("voxel %u/%u z: %u, vis: %i. dir: %u, pal: %u", c, numvoxs, vox.z, (uint8_t)vox.vis, vox.dir,
+					   vox.col);
 		}
-		Log::debug("voxel %u/%u z: %u, vis: %i. dir: %u, pal: %u", c, numvoxs, state->voxdata[c].z,
-				   (uint8_t)state->voxdata[c].vis, state->voxdata[c].dir, state->voxdata[c].col);
-	}
-
-	for (uint32_t x = 0u; x < width; ++x) {
-		wrap(stream->readInt32(state->xoffsets[x]))
-		Log::debug("xoffsets[%u]: %i", x, state->xoffsets[x]);
 	}
 
+	wrap(stream->readInt32Array(state->xoffsets, width))
 	for (uint32_t x = 0u; x < width; ++x) {
-		for (uint32_t y = 0u; y < depth; ++y) {
-			wrap(stream->readUInt16(state->xyoffsets[x][y]))
-			Log::debug("xyoffsets[%u][%u]: %u", x, y, state->xyoffsets[x][y]);
-		}
+		wrap(stream->readUInt16Array(state->xyoffsets[x], depth))
 	}
 
 	voxel::RawVolume *volume = new voxel::RawVolume(region);
@@ -587,27 +592,30 @@ bool KV6Format::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core:
 
 	wrapBool(stream->writeUInt32(numvoxs))
 
+	uint8_t records[priv::VoxelRecordBatch * priv::VoxelRecordSize];
+	uint32_t n = 0u;
 	for (const priv::VoxtypeKV6 &data : voxdata) {
 		const core::RGBA color = node->palette().color(data.col);
-		wrapBool(priv::writeBGRColor(*stream, color)) // range 0.255
-		wrapBool(stream->writeUInt8(128))			 // 128 as we save slab6
-		wrapBool(stream->writeUInt8(data.z))
-		wrapBool(stream->writeUInt8(0)) // 0 as we save slab6
-		wrapBool(stream->writeUInt8((uint8_t)data.vis))
-		wrapBool(stream->writeUInt8(data.dir))
+		uint8_t *record = &records[n * priv::VoxelRecordSize];
+		record[0] = color.b; // range 0.255
+		record[1] = color.g;
+		record[2] = color.r;
+		record[3] = 128; // 128 as we save slab6
+		record[4] = data.z;
+		record[5] = 0; // 0 as we save slab6
+		record[6] = (uint8_t)data.vis;
+		record[7] = data.dir;
 		Log::debug("voxel z-low: %u, vis: %i. dir: %u, pal: %u", data.z, (uint8_t)data.vis, data.dir, data.col);
+		if (++n == priv::VoxelRecordBatch) {
+			wrapBool(stream->writeUInt8Array(records, n * priv::VoxelRecordSize))
+			n = 0u;
+		}
 	}
+	wrapBool(stream->writeUInt8Array(records, n * priv::VoxelRecordSize))
 
-	for (int x = 0u; x < xsiz_w; ++x) {
-		wrapBool(stream->writeInt32(xoffsets[x]))
-		Log::debug("xoffsets[%u]: %i", x, xoffsets[x]);
-	}
-
+	wrapBool(stream->writeInt32Array(xoffsets, xsiz_w))
 	for (int x = 0; x < xsiz_w; ++x) {
-		for (int y = 0; y < ysiz_d; ++y) {
-			wrapBool(stream->writeUInt16(xyoffsets[x][y]))
-			Log::debug("xyoffsets[%u][%u]: %u", x, y, xyoffsets[x][y]);
-		}
+		wrapBool(stream->writeUInt16Array(xyoffsets[x], ysiz_d))
 	}
 
 	const uint32_t palMagic = FourCC('S', 'P', 'a', 'l');
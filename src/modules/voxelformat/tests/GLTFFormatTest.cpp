@@ -4,8 +4,12 @@
 
 #include "voxelformat/private/mesh/GLTFFormat.h"
 #include "AbstractFormatTest.h"
+#include "core/GameConfig.h"
+#include "core/StringUtil.h"
+#include "util/VarUtil.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphNode.h"
+#include "voxel/SurfaceExtractor.h"
 #include "voxel/Voxel.h"
 
 namespace voxelformat {
@@ -54,6 +58,15 @@ TEST_F(GLTFFormatTest, testSaveLoadVoxel) {
 	testSaveLoadVoxel("bv-smallvolumesavetest.gltf", &f, 0, 10, flags);
 }
 
+TEST_F(GLTFFormatTest, testSaveLoadVoxelBrickExtraction) {
+	util::ScopedVarChange scoped1(cfg::VoxformatAmbientocclusion, "true");
+	util::ScopedVarChange scoped2(cfg::VoxelMeshMode, core::string::toString((int)voxel::SurfaceExtractionType::Cubic));
+	GLTFFormat f;
+	const voxel::ValidateFlags flags = voxel::ValidateFlags::All & ~voxel::ValidateFlags::Palette;
+	// large enough to be extracted from a brick volume
+	testSaveLoadVoxel("bv-largevolumesavetest.gltf", &f, 0, 64, flags);
+}
+
 TEST_F(GLTFFormatTest, testVoxelizeLantern) {
 	scenegraph::SceneGraph sceneGraph;
 	testLoad(sceneGraph, "glTF/lantern/Lantern.gltf", 3u);
@@ -24,7 +24,7 @@ TEST_F(MD2FormatTest, testVoxelize) {
 	EXPECT_EQ(region.getUpperY(), 32);
 	EXPECT_EQ(region.getUpperZ(), 25);
 	const int cntVoxels = voxel::countVoxels(node->volume());
-	EXPECT_EQ(cntVoxels, 12158);
+	EXPECT_EQ(cntVoxels, 12368);
 }
 
 } // namespace voxelformat
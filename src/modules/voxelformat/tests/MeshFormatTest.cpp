@@ -19,16 +19,6 @@ namespace voxelformat {
 
 class MeshFormatTest : public AbstractFormatTest {};
 
-TEST_F(MeshFormatTest, testSubdivide) {
-	MeshFormat::TriCollection tinyTris;
-	voxelformat::TexturedTri tri;
-	tri.vertices[0] = glm::vec3(-8.77272797, -11.43335, -0.154544264);
-	tri.vertices[1] = glm::vec3(-8.77272701, 11.1000004, -0.154543981);
-	tri.vertices[2] = glm::vec3(8.77272701, 11.1000004, -0.154543981);
-	MeshFormat::subdivideTri(tri, tinyTris);
-	EXPECT_EQ(1024u, tinyTris.size());
-}
-
 TEST_F(MeshFormatTest, testColorAt) {
 	const image::ImagePtr &texture = image::loadImage("palette-nippon.png");
 	ASSERT_TRUE(texture);
@@ -171,4 +161,56 @@ TEST_F(MeshFormatTest, testVoxelizeColor) {
 	EXPECT_COLOR_NEAR(nipponGreen, node->palette().color(v->voxel(size - 1, size - 1, size - 1).getColor()), 0.01f);
 }
 
+TEST_F(MeshFormatTest, testVoxelizeMultipleTiles) {
+	class TestMesh : public MeshFormat {
+	public:
+		bool saveMeshes(const core::Map<int, int> &, const scenegraph::SceneGraph &, const Meshes &,
+						const core::String &, const io::ArchivePtr &, const glm::vec3 &, bool, bool, bool) override {
+			return false;
+		}
+		void voxelize(scenegraph::SceneGraph &sceneGraph, const MeshFormat::TriCollection &tris) {
+			voxelizeNode("test", sceneGraph, tris);
+			sceneGraph.updateTransforms();
+		}
+	};
+
+	// a slope that spans several voxelization tiles - the tiles must not leave gaps at their borders
+	const int size = MeshFormat::VoxelizeTileSize * 3 + 5;
+	const glm::vec3 v00(0.0f, 0.0f, 0.0f);
+	const glm::vec3 v10((float)size, 0.0f, 0.0f);
+	const glm::vec3 v01(0.0f, (float)size * 0.5f, (float)size);
+	const glm::vec3 v11((float)size, (float)size * 0.5f, (float)size);
+	MeshFormat::TriCollection tris;
+	voxelformat::TexturedTri tri;
+	tri.setColor(core::RGBA(255, 0, 0, 255));
+	tri.vertices[0] = v00;
+	tri.vertices[1] = v10;
+	tri.vertices[2] = v11;
+	tris.push_back(tri);
+	tri.vertices[0] = v00;
+	tri.vertices[1] = v11;
+	tri.vertices[2] = v01;
+	tris.push_back(tri);
+
+	TestMesh mesh;
+	scenegraph::SceneGraph sceneGraph;
+	mesh.voxelize(sceneGraph, tris);
+	scenegraph::SceneGraphNode *node = sceneGraph.findNodeByName("test");
+	ASSERT_NE(nullptr, node);
+	const voxel::RawVolume *v = node->volume();
+	const voxel::Region &region = v->region();
+	for (int x = region.getLowerX(); x < region.getUpperX(); ++x) {
+		for (int z = region.getLowerZ(); z < region.getUpperZ(); ++z) {
+			bool found = false;
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				if (!voxel::isAir(v->voxel(x, y, z).getMaterial())) {
+					found = true;
+					break;
+				}
+			}
+			ASSERT_TRUE(found) << "Missing voxel column at " << x << ":" << z;
+		}
+	}
+}
+
 } // namespace voxelformat
@@ -21,6 +21,15 @@ TEST_F(MinecraftPaletteMapTest, testParse) {
 				  "minecraft:dark_oak_stairs[facing=east,half=bottom,shape=outer_left,waterlogged=false][INT] = 554"));
 }
 
+TEST_F(MinecraftPaletteMapTest, testParseView) {
+	// not zero terminated after the block state
+	const char *name = "minecraft:dark_oak_stairs[facing=east]minecraft:stone";
+	EXPECT_EQ(164, findPaletteIndex(name, 38, -1));
+	EXPECT_EQ(164, findPaletteIndex(name + 10, 15, -1));
+	EXPECT_EQ(-1, findPaletteIndex(name, 0, -1));
+	EXPECT_EQ(7, findPaletteIndex("minecraft:unknown", 17, 7));
+}
+
 // parses a blocks.json file to find new colors
 // disabled because the blocks.json file is not available in the repository and was parsed already
 TEST_F(MinecraftPaletteMapTest, DISABLED_testNewColors) {
@@ -29,4 +29,61 @@ TEST_F(NamedBinaryTagTest, testWriteRead) {
 	}
 }
 
+TEST_F(NamedBinaryTagTest, testView) {
+	io::BufferedReadWriteStream stream;
+	{
+		priv::NBTCompound compound;
+		compound.put("Version", priv::NamedBinaryTag((int32_t)3465));
+		compound.put("Name", priv::NamedBinaryTag(core::String("minecraft:stone")));
+		compound.put("Scale", priv::NamedBinaryTag(2.5f));
+		priv::NBTList sections;
+		for (int8_t y = 0; y < 3; ++y) {
+			priv::NBTCompound section;
+			section.put("Y", priv::NamedBinaryTag(y));
+			core::DynamicArray<int64_t> data;
+			data.push_back(0x0102030405060708ll);
+			data.push_back(-(int64_t)y);
+			section.put("data", priv::NamedBinaryTag(core::move(data)));
+			sections.emplace_back(priv::NamedBinaryTag(core::move(section)));
+		}
+		compound.put("sections", priv::NamedBinaryTag(core::move(sections)));
+		priv::NamedBinaryTag root(core::move(compound));
+		ASSERT_TRUE(priv::NamedBinaryTag::write(root, "rootTagName", stream));
+	}
+	const priv::NBTView &root = priv::NBTView::parse(stream.getBuffer(), stream.size());
+	ASSERT_TRUE(root.valid());
+	EXPECT_EQ(3465, root.get("Version").int32());
+	EXPECT_FLOAT_EQ(2.5f, root.get("Scale").float32());
+	EXPECT_FALSE(root.get("Missing").valid());
+	EXPECT_EQ(42, root.get("Scale").int32(42));
+	priv::NBTStringView name;
+	ASSERT_TRUE(root.get("Name").string(name));
+	EXPECT_TRUE(name == "minecraft:stone");
+	EXPECT_TRUE(name != "minecraft:dirt");
+
+	const priv::NBTListView &sections = root.get("sections").list();
+	ASSERT_EQ(3u, sections.size());
+	EXPECT_EQ(priv::TagType::COMPOUND, sections.elementType());
+	int8_t y = 0;
+	for (const priv::NBTView &section : sections) {
+		EXPECT_EQ(y, section.get("Y").int8(-1));
+		const priv::NBTArrayView<int64_t> &data = section.get("data").longArray();
+		ASSERT_EQ(2u, data.size());
+		EXPECT_EQ(0x0102030405060708ll, data[0]);
+		EXPECT_EQ(-(int64_t)y, data[1]);
+		++y;
+	}
+	EXPECT_EQ(3, y);
+
+	// truncated data must not be read
+	const priv::NBTView &truncated = priv::NBTView::parse(stream.getBuffer(), stream.size() / 2);
+	ASSERT_TRUE(truncated.valid());
+	int elements = 0;
+	for (const priv::NBTView &section : truncated.get("sections").list()) {
+		(void)section.get("data").longArray();
+		++elements;
+	}
+	EXPECT_LT(elements, 3);
+}
+
 } // namespace voxelformat
@@ -3,6 +3,8 @@
  */
 
 #include "AbstractFormatTest.h"
+#include "core/GameConfig.h"
+#include "core/Var.h"
 #include "voxelformat/tests/TestHelper.h"
 #include "voxelformat/private/qubicle/QBFormat.h"
 
@@ -38,6 +40,14 @@ TEST_F(QBFormatTest, testSaveSmallVoxel) {
 	testSaveLoadVoxel("qubicle-smallvolumesavetest.qb", &f, 0, 1, flags);
 }
 
+TEST_F(QBFormatTest, testSaveSmallVoxelUncompressed) {
+	QBFormat f;
+	core::Var::getSafe(cfg::VoxformatQBSaveCompressed)->setVal(false);
+	const voxel::ValidateFlags flags = voxel::ValidateFlags::All & ~voxel::ValidateFlags::Palette;
+	testSaveLoadVoxel("qubicle-smallvolumesavetest-uncompressed.qb", &f, 0, 1, flags);
+	core::Var::getSafe(cfg::VoxformatQBSaveCompressed)->setVal(true);
+}
+
 TEST_F(QBFormatTest, testSaveMultipleModels) {
 	QBFormat f;
 	testSaveMultipleModels("qubicle-multiplemodelsavetest.qb", &f);
@@ -4,6 +4,9 @@
 
 #include "voxelformat/private/sandbox/VXMFormat.h"
 #include "AbstractFormatTest.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "voxelformat/VolumeFormat.h"
 
 namespace voxelformat {
 
@@ -39,4 +42,34 @@ TEST_F(VXMFormatTest, testSaveLoadVoxel) {
 	testSaveLoadVoxel("testSaveLoadVoxel.vxm", &f);
 }
 
+class CountingNodeSink : public NodeSink {
+public:
+	int nodes = 0;
+	int voxels = 0;
+
+	bool addNode(scenegraph::SceneGraphNode &&node) override {
+		++nodes;
+		voxels += node.region().voxels();
+		return true;
+	}
+};
+
+TEST_F(VXMFormatTest, testLoadStreamed) {
+	const io::ArchivePtr &archive = helper_filesystemarchive();
+	io::FileDescription fileDesc;
+	fileDesc.set("test.vxm");
+
+	scenegraph::SceneGraph expectedSceneGraph;
+	ASSERT_TRUE(voxelformat::loadFormat(fileDesc, archive, expectedSceneGraph, testLoadCtx));
+
+	CountingNodeSink sink;
+	LoadContext ctx = testLoadCtx;
+	ctx.nodeSink = &sink;
+	scenegraph::SceneGraph sceneGraph;
+	ASSERT_TRUE(voxelformat::loadFormat(fileDesc, archive, sceneGraph, ctx));
+	EXPECT_EQ(0u, sceneGraph.size(scenegraph::SceneGraphNodeType::Model));
+	EXPECT_EQ((int)expectedSceneGraph.size(scenegraph::SceneGraphNodeType::Model), sink.nodes);
+	EXPECT_EQ(expectedSceneGraph.firstModelNode()->region().voxels(), sink.voxels);
+}
+
 } // namespace voxelformat
@@ -3,8 +3,12 @@
  */
 
 #include "PathTracer.h"
+#include "app/App.h"
 #include "core/Color.h"
+#include "core/Hash.h"
 #include "core/Log.h"
+#include "core/Trace.h"
+#include "core/concurrent/TaskGroup.h"
 #include "core/Var.h"
 #include "core/collection/DynamicArray.h"
 #include "image/Image.h"
@@ -15,10 +19,12 @@
 #include "video/Camera.h"
 #include "voxel/ChunkMesh.h"
 #include "voxel/Mesh.h"
+#include "voxel/MeshState.h"
 #include "voxel/RawVolume.h"
 #include "voxel/SurfaceExtractor.h"
 #include "voxelrender/SceneGraphRenderer.h"
 #include "yocto_scene.h"
+#include <glm/ext/matrix_transform.hpp>
 
 namespace voxelpathtracer {
 
@@ -72,50 +78,27 @@ PathTracer::~PathTracer() {
 	stop();
 }
 
-bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
-							 const voxel::Mesh &mesh, bool opaque) {
-	// const palette::Palette &palette = node.palette();
-	scenegraph::KeyFrameIndex keyFrameIdx = 0;
-	const scenegraph::SceneGraphTransform &transform = node.transform(keyFrameIdx);
+static void createShapes(const voxel::Mesh &mesh, yocto::shape_data *shapes) {
 	const voxel::IndexArray &indices = mesh.getIndexVector();
 	if (indices.empty()) {
-		return true;
+		return;
 	}
 	core_assert((int)indices.size() % 3 == 0);
 	const int tris = (int)indices.size() / 3;
-	yocto::shape_data shapes[palette::PaletteMaxColors];
 	const voxel::VertexArray &vertices = mesh.getVertexVector();
 	const voxel::NormalArray &normals = mesh.getNormalVector();
 	const bool useNormals = normals.size() == vertices.size();
 
-	const voxel::Region &region = sceneGraph.resolveRegion(node);
-	const glm::vec3 size = glm::vec3(region.getDimensionsInVoxels());
-	const glm::vec3 pivot = node.pivot();
-
 	for (int i = 0; i < tris; i++) {
 		const voxel::VoxelVertex &vertex0 = vertices[indices[i * 3 + 0]];
 		const voxel::VoxelVertex &vertex1 = vertices[indices[i * 3 + 1]];
 		const voxel::VoxelVertex &vertex2 = vertices[indices[i * 3 + 2]];
 
-		const glm::vec3 pos0 = transform.apply(vertex0.position, pivot * size);
-		const glm::vec3 pos1 = transform.apply(vertex1.position, pivot * size);
-		const glm::vec3 pos2 = transform.apply(vertex2.position, pivot * size);
-		// uv is the same for all three vertices
-		// const glm::vec2 &uv = image::Image::uv(vertex0.colorIndex, 0, palette::PaletteMaxColors, 1);
+		// the positions stay in the space of the volume - the transform of the node is applied by the instance frame
 		yocto::shape_data *shape = &shapes[vertex0.colorIndex];
-
-		// const core::RGBA rgba = palette.color(vertex0.colorIndex);
-		// const glm::vec4 &color = core::Color::fromRGBA(rgba);
-		// shape->colors.push_back(priv::toColor(color, vertex0.ambientOcclusion));
-		// shape->colors.push_back(priv::toColor(color, vertex1.ambientOcclusion));
-		// shape->colors.push_back(priv::toColor(color, vertex2.ambientOcclusion));
-
-		shape->positions.push_back(priv::toVec3f(pos0));
-		shape->positions.push_back(priv::toVec3f(pos1));
-		shape->positions.push_back(priv::toVec3f(pos2));
-		// shape->texcoords.push_back({uv[0], uv[1]});
-		// shape->texcoords.push_back({uv[0], uv[1]});
-		// shape->texcoords.push_back({uv[0], uv[1]});
+		shape->positions.push_back(priv::toVec3f(vertex0.position));
+		shape->positions.push_back(priv::toVec3f(vertex1.position));
+		shape->positions.push_back(priv::toVec3f(vertex2.position));
 		if (useNormals) {
 			shape->normals.push_back(priv::toVec3f(normals[indices[i * 3 + 0]]));
 			shape->normals.push_back(priv::toVec3f(normals[indices[i * 3 + 1]]));
@@ -126,23 +109,78 @@ bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const sce
 		const yocto::vec3i vidx{offsetStart + 0, offsetStart + 1, offsetStart + 2};
 		shape->triangles.push_back(vidx);
 	}
-	// const glm::vec3 &mins = mesh.getOffset();
-	_state.scene.shapes.reserve(palette::PaletteMaxColors);
+}
+
+/**
+ * @return @c true if the mesh state holds the up to date meshes for the volume of the given node
+ */
+static bool useMeshState(const voxel::MeshState *meshState, const scenegraph::SceneGraphNode &node) {
+	if (meshState == nullptr) {
+		return false;
+	}
+	return meshState->volume(node.id()) == node.volume() &&
+		   meshState->palette(node.id()).hash() == node.palette().hash();
+}
+
+/**
+ * @brief Hash over everything the shapes of a model node depend on - the voxels, the palette and the mesh mode
+ *
+ * The mesh state already tracks the modified regions of its volumes - if it is up to date for the node, its change
+ * counter replaces the voxels. Otherwise the voxels are hashed in one pass.
+ */
+static uint64_t contentHash(const scenegraph::SceneGraphNode &node, voxel::SurfaceExtractionType type,
+							const voxel::MeshState *meshState) {
+	core_trace_scoped(PathTracerContentHash);
+	const voxel::RawVolume *v = node.volume();
+	const voxel::Region &region = v->region();
+	const int32_t bounds[] = {region.getLowerX(), region.getLowerY(), region.getLowerZ(), region.getUpperX(),
+							  region.getUpperY(), region.getUpperZ(), (int32_t)type};
+	const uint64_t hash = core::hash64(bounds, sizeof(bounds), node.palette().hash());
+	if (useMeshState(meshState, node)) {
+		const uint64_t changes[] = {(uint64_t)(uintptr_t)v, meshState->changes(node.id())};
+		return core::hash64(changes, sizeof(changes), hash);
+	}
+	const size_t len = (size_t)region.getWidthInVoxels() * region.getHeightInVoxels() * region.getDepthInVoxels();
+	return core::hash64(v->data(), len * sizeof(voxel::Voxel), hash);
+}
+
+/**
+ * @brief Creates one shape per palette color of the model node - either from the meshes of the mesh state or by
+ * extracting the volume
+ */
+static void createModel(const scenegraph::SceneGraphNode &node, voxel::SurfaceExtractionType type,
+						const voxel::MeshState *meshState, PathTracerModel &model,
+						std::vector<yocto::shape_data> &shapes) {
+	core_trace_scoped(PathTracerCreateModel);
+	std::vector<yocto::shape_data> colorShapes(palette::PaletteMaxColors);
+	if (useMeshState(meshState, node)) {
+		Log::debug("Use the extracted meshes of node %i", node.id());
+		for (int i = 0; i < voxel::MeshType_Max; ++i) {
+			for (const auto &entry : meshState->meshes((voxel::MeshType)i)) {
+				const voxel::Mesh *mesh = entry->value[node.id()];
+				if (mesh != nullptr) {
+					createShapes(*mesh, colorShapes.data());
+				}
+			}
+		}
+	} else {
+		const voxel::RawVolume *v = node.volume();
+		voxel::ChunkMesh mesh(65536, 65536, true);
+		const voxel::Region &region = v->region();
+		voxel::SurfaceExtractionContext ctx =
+			voxel::createContext(type, v, region, node.palette(), mesh, region.getLowerCorner());
+		voxel::extractSurface(ctx);
+		createShapes(mesh.mesh[0], colorShapes.data());
+		createShapes(mesh.mesh[1], colorShapes.data());
+	}
 	for (int i = 0; i < palette::PaletteMaxColors; ++i) {
-		yocto::shape_data &shape = shapes[i];
+		yocto::shape_data &shape = colorShapes[i];
 		if (shape.triangles.empty()) {
 			continue;
 		}
-		_state.scene.shapes.push_back(shape);
-
-		yocto::instance_data instance_data;
-		// instance_data.frame = yocto::translation_frame(priv::toVec3f(mins));
-		instance_data.material = _state.scene.materials.size() + i;
-		instance_data.shape = (int)_state.scene.shapes.size() - 1;
-		_state.scene.instances.push_back(instance_data);
+		shapes.push_back(core::move(shape));
+		model.colors.push_back((uint8_t)i);
 	}
-
-	return true;
 }
 
 void PathTracer::addCamera(const scenegraph::SceneGraphNodeCamera &node) {
@@ -263,47 +301,122 @@ static void addPaletteTexture(yocto::scene_data &scene, const palette::Palette &
 }
 #endif
 
-bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera) {
-	_state.scene = {};
-	_state.lights = {};
+static yocto::frame3f toFrame(const glm::mat4 &mat) {
+	return yocto::frame3f{priv::toVec3f(glm::vec3(mat[0])), priv::toVec3f(glm::vec3(mat[1])),
+						  priv::toVec3f(glm::vec3(mat[2])), priv::toVec3f(glm::vec3(mat[3]))};
+}
 
-	voxel::SurfaceExtractionType type = (voxel::SurfaceExtractionType)core::Var::getSafe(cfg::VoxelMeshMode)->intVal();
-	// TODO: support references
-	for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter) {
+bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera,
+							 const voxel::MeshState *meshState) {
+	core_trace_scoped(PathTracerCreateScene);
+	const voxel::SurfaceExtractionType type =
+		(voxel::SurfaceExtractionType)core::Var::getSafe(cfg::VoxelMeshMode)->intVal();
+	if (meshState != nullptr && (meshState->meshMode() != type || !meshState->upToDate())) {
+		meshState = nullptr;
+	}
+
+	// the visible model and reference nodes - and the model nodes that provide their shapes
+	core::DynamicArray<int> instanceNodes;
+	core::DynamicArray<int> modelNodes;
+	core::DynamicMap<int, int, 11> modelIndices;
+	for (auto iter = sceneGraph.beginAllModels(); iter != sceneGraph.end(); ++iter) {
 		const scenegraph::SceneGraphNode &node = *iter;
 		if (!node.visible()) {
 			continue;
 		}
-		const voxel::RawVolume *v = node.volume();
-		if (v == nullptr) {
+		const int modelId = node.type() == scenegraph::SceneGraphNodeType::ModelReference ? node.reference() : node.id();
+		if (!sceneGraph.hasNode(modelId) || sceneGraph.node(modelId).volume() == nullptr) {
 			continue;
 		}
-
-		voxel::ChunkMesh mesh(65536, 65536, true);
-		voxel::Region region = v->region();
-
-		const palette::Palette &palette = node.palette();
-		voxel::SurfaceExtractionContext ctx =
-			voxel::createContext(type, v, region, palette, mesh, region.getLowerCorner());
-
-		voxel::extractSurface(ctx);
-
-		// scenegraph::KeyFrameIndex keyFrameIdx = 0;
-		// const scenegraph::SceneGraphTransform &transform = node.transform(keyFrameIdx);
-		if (!createScene(sceneGraph, node, mesh.mesh[0], true)) {
-			return false;
+		instanceNodes.push_back(node.id());
+		if (!modelIndices.hasKey(modelId)) {
+			modelIndices.put(modelId, (int)modelNodes.size());
+			modelNodes.push_back(modelId);
 		}
-		if (!createScene(sceneGraph, node, mesh.mesh[1], false)) {
-			return false;
+	}
+
+	// the shapes of unchanged models are taken from the last scene - the others are created in parallel
+	std::vector<yocto::shape_data> oldShapes = core::move(_state.scene.shapes);
+	core::DynamicArray<PathTracerModel> models;
+	models.append(modelNodes.size(), [](size_t) { return PathTracerModel(); });
+	std::vector<std::vector<yocto::shape_data>> modelShapes(modelNodes.size());
+	{
+		core::TaskGroup taskGroup(app::App::getInstance()->threadPool());
+		for (size_t i = 0; i < modelNodes.size(); ++i) {
+			taskGroup.run([&, i]() {
+				const scenegraph::SceneGraphNode &node = sceneGraph.node(modelNodes[i]);
+				PathTracerModel &model = models[i];
+				model.hash = contentHash(node, type, meshState);
+				auto iter = _models.find(node.id());
+				if (iter != _models.end() && iter->value.hash == model.hash) {
+					const PathTracerModel &oldModel = iter->value;
+					for (size_t j = 0; j < oldModel.colors.size(); ++j) {
+						modelShapes[i].push_back(core::move(oldShapes[oldModel.firstShape + j]));
+					}
+					model.colors = oldModel.colors;
+					return;
+				}
+				createModel(node, type, meshState, model, modelShapes[i]);
+			});
 		}
+		taskGroup.wait();
+	}
 
-		// addPaletteTexture(_state.scene, palette);
-		// addEmissiveTexture(_state.scene, palette);
+	yocto::scene_data &scene = _state.scene;
+	scene.instances.clear();
+	scene.materials.clear();
+	scene.cameras.clear();
+	scene.camera_names.clear();
+
+	uint64_t geometryHash = 0u;
+	core::DynamicMap<int, PathTracerModel, 11> newModels;
+	core::DynamicArray<int> firstMaterials;
+	firstMaterials.reserve(models.size());
+	for (size_t i = 0; i < models.size(); ++i) {
+		PathTracerModel &model = models[i];
+		model.firstShape = (int)scene.shapes.size();
+		for (yocto::shape_data &shape : modelShapes[i]) {
+			scene.shapes.push_back(core::move(shape));
+		}
+		const int64_t layout[] = {modelNodes[i], (int64_t)model.colors.size()};
+		geometryHash = core::hash64(layout, sizeof(layout), geometryHash ^ model.hash);
 
-		for (int i = 0; i < palette.colorCount(); ++i) {
-			setupMaterial(_state.scene, palette, i);
+		firstMaterials.push_back((int)scene.materials.size());
+		const palette::Palette &palette = sceneGraph.node(modelNodes[i]).palette();
+		for (int c = 0; c < palette.colorCount(); ++c) {
+			setupMaterial(scene, palette, c);
+		}
+		newModels.emplace(modelNodes[i], core::move(model));
+	}
+	_models = core::move(newModels);
+
+	const scenegraph::FrameIndex frameIdx = 0;
+	uint64_t sceneHash = geometryHash;
+	for (int nodeId : instanceNodes) {
+		const scenegraph::SceneGraphNode &node = sceneGraph.node(nodeId);
+		const int modelId = node.type() == scenegraph::SceneGraphNodeType::ModelReference ? node.reference() : node.id();
+		const int modelIdx = modelIndices.find(modelId)->value;
+		const PathTracerModel &model = _models.find(modelId)->value;
+
+		const voxel::Region &region = sceneGraph.resolveRegion(node);
+		const glm::vec3 size = glm::vec3(region.getDimensionsInVoxels());
+		const scenegraph::FrameTransform &transform = sceneGraph.transformForFrame(node, frameIdx);
+		const glm::mat4 model2world = glm::translate(transform.worldMatrix(), -node.pivot() * size);
+		const yocto::frame3f frame = toFrame(model2world);
+		sceneHash = core::hash64(&frame, sizeof(frame), sceneHash);
+		const uint64_t paletteHash = node.palette().hash();
+		sceneHash = core::hash64(&paletteHash, sizeof(paletteHash), sceneHash);
+
+		for (size_t j = 0; j < model.colors.size(); ++j) {
+			yocto::instance_data &instance = scene.instances.emplace_back();
+			instance.frame = frame;
+			instance.shape = model.firstShape + (int)j;
+			instance.material = firstMaterials[modelIdx] + model.colors[j];
 		}
 	}
+	const bool bvhFlags[] = {_state.params.highqualitybvh, _state.params.embreebvh};
+	geometryHash = core::hash64(bvhFlags, sizeof(bvhFlags), geometryHash);
+	sceneHash = core::hash64(bvhFlags, sizeof(bvhFlags), sceneHash ^ geometryHash);
 
 	if (camera) {
 		addCamera("default", *camera);
@@ -314,19 +427,42 @@ bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const vid
 		addCamera(scenegraph::toCameraNode(node));
 	}
 
-	if (_state.scene.cameras.size() <= 1) {
-		yocto::add_camera(_state.scene);
+	if (scene.cameras.size() <= 1) {
+		yocto::add_camera(scene);
+	}
+	if (scene.environments.empty()) {
+		yocto::add_sky(scene);
 	}
-	yocto::add_sky(_state.scene);
 
+	createAccelerationStructure(geometryHash, sceneHash);
 	return true;
 }
 
-bool PathTracer::start(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera) {
+void PathTracer::createAccelerationStructure(uint64_t geometryHash, uint64_t sceneHash) {
+	core_trace_scoped(PathTracerCreateAccelerationStructure);
+	if (sceneHash == _sceneHash && geometryHash == _geometryHash) {
+		Log::debug("Reuse the bvh and lights of the last scene");
+		return;
+	}
+	const yocto::scene_data &scene = _state.scene;
+	const yocto::bvh_tree &instanceTree = _state.bvh.bvh.bvh;
+	if (geometryHash == _geometryHash && !_state.params.embreebvh && !scene.instances.empty() &&
+		instanceTree.primitives.size() == scene.instances.size()) {
+		// only the transforms or materials of the instances changed - the bvh of the shapes is still valid
+		Log::debug("Refit the bvh of the instances");
+		yocto::update_scene_bvh(_state.bvh.bvh, scene, {}, {});
+	} else {
+		_state.bvh = yocto::make_trace_bvh(scene, _state.params);
+	}
+	_state.lights = yocto::make_trace_lights(scene, _state.params);
+	_geometryHash = geometryHash;
+	_sceneHash = sceneHash;
+}
+
+bool PathTracer::start(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera,
+					   const voxel::MeshState *meshState) {
 	Log::debug("Create scene");
-	createScene(sceneGraph, camera);
-	_state.bvh = yocto::make_trace_bvh(_state.scene, _state.params);
-	_state.lights = yocto::make_trace_lights(_state.scene, _state.params);
+	createScene(sceneGraph, camera, meshState);
 	_state.state = yocto::make_trace_state(_state.scene, _state.params);
 	yocto::trace_start(_state.context, _state.state, _state.scene, _state.bvh, _state.lights, _state.params);
 	_state.started = true;
@@ -334,13 +470,14 @@ bool PathTracer::start(const scenegraph::SceneGraph &sceneGraph, const video::Ca
 	return true;
 }
 
-bool PathTracer::restart(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera) {
+bool PathTracer::restart(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera,
+						 const voxel::MeshState *meshState) {
 	if (!started()) {
 		return false;
 	}
 	Log::debug("Restart pathtracer");
 	stop();
-	return start(sceneGraph, camera);
+	return start(sceneGraph, camera, meshState);
 }
 
 bool PathTracer::stop() {
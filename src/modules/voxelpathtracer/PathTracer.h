@@ -6,6 +6,8 @@
 
 #include "core/SharedPtr.h"
 #include "core/GLM.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicMap.h"
 #include <yocto_scene.h>
 #include <yocto_trace.h>
 
@@ -24,6 +26,7 @@ class Palette;
 
 namespace voxel {
 class Mesh;
+class MeshState;
 } // namespace voxel
 
 namespace scenegraph {
@@ -47,24 +50,54 @@ struct PathTracerState {
 	}
 };
 
+/**
+ * @brief The shapes of a model node in the scene - they are in the space of the volume and shared by all instances of
+ * the model (the model node itself and its references)
+ */
+struct PathTracerModel {
+	/** content hash of the voxels, the palette and the mesh mode */
+	uint64_t hash = 0u;
+	/** index of the first shape of the model in @c yocto::scene_data::shapes */
+	int firstShape = 0;
+	/** the palette color index of each shape */
+	core::DynamicArray<uint8_t> colors;
+};
+
 class PathTracer {
 private:
 	PathTracerState _state;
+	/**
+	 * @brief The shapes of the last scene by model node id - a model with an unchanged content hash is not extracted
+	 * again
+	 */
+	core::DynamicMap<int, PathTracerModel, 11> _models;
+	/** hash over the shape layout of the current scene */
+	uint64_t _geometryHash = 0u;
+	/** hash over the shape layout, the instances and the materials of the current scene */
+	uint64_t _sceneHash = 0u;
 
 	void addCamera(const scenegraph::SceneGraphNodeCamera &node);
 	void addCamera(const char *name, const video::Camera &cam);
 
-	bool createScene(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
-					 const voxel::Mesh &mesh, bool opaque);
-	bool createScene(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera);
+	bool createScene(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera,
+					 const voxel::MeshState *meshState);
+	void createAccelerationStructure(uint64_t geometryHash, uint64_t sceneHash);
 
 public:
 	~PathTracer();
 	PathTracerState &state() {
 		return _state;
 	}
-	bool start(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera = nullptr);
-	bool restart(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera = nullptr);
+	/**
+	 * @param meshState If given, the already extracted meshes of the model nodes are used instead of extracting them
+	 * again - as long as the mesh state is up to date for the volume of the node
+	 * @note The shapes and the bvh of the last start are reused for all models that didn't change - a restart for a
+	 * different camera doesn't need to rebuild anything
+	 */
+	bool start(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera = nullptr,
+			   const voxel::MeshState *meshState = nullptr);
+	bool restart(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera = nullptr,
+				 const voxel::MeshState *meshState = nullptr);
 	bool stop();
 	bool started() const;
 
@@ -10,6 +10,9 @@
 #include "io/FormatDescription.h"
 #include "scenegraph/SceneGraph.h"
 #include "voxel/MaterialColor.h"
+#include "voxel/MeshState.h"
+#include "voxel/RawVolume.h"
+#include "voxel/SurfaceExtractor.h"
 #include "voxelformat/FormatConfig.h"
 #include "voxelformat/VolumeFormat.h"
 #include "core/GLM.h"
@@ -29,6 +32,32 @@ public:
 		voxel::getPalette().nippon();
 		return true;
 	}
+
+protected:
+	/**
+	 * @brief Creates a model node with two colors and a reference to it
+	 */
+	int createScene(scenegraph::SceneGraph &sceneGraph, voxel::RawVolume &volume) {
+		palette::Palette pal;
+		pal.nippon();
+		volume.setVoxel(0, 0, 0, voxel::createVoxel(pal, 1));
+		volume.setVoxel(1, 0, 0, voxel::createVoxel(pal, 1));
+		volume.setVoxel(0, 1, 0, voxel::createVoxel(pal, 2));
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(&volume, false);
+		node.setPalette(pal);
+		const int modelNodeId = sceneGraph.emplace(core::move(node));
+
+		scenegraph::SceneGraphNode reference(scenegraph::SceneGraphNodeType::ModelReference);
+		reference.setReference(modelNodeId);
+		reference.setPalette(pal);
+		scenegraph::SceneGraphTransform transform;
+		transform.setWorldTranslation(glm::vec3(10.0f, 0.0f, 0.0f));
+		reference.setTransform(0, transform);
+		sceneGraph.emplace(core::move(reference));
+		sceneGraph.updateTransforms();
+		return modelNodeId;
+	}
 };
 
 TEST_F(PathTracerTest, testHMec) {
@@ -55,3 +84,117 @@ TEST_F(PathTracerTest, testHMec) {
 	image::writeImage(img, "hmec.vxl.png");
 	ASSERT_TRUE(pathTracer.stop());
 }
+
+TEST_F(PathTracerTest, testReferencesShareShapes) {
+	scenegraph::SceneGraph sceneGraph;
+	voxel::RawVolume volume(voxel::Region(0, 3));
+	createScene(sceneGraph, volume);
+
+	voxelpathtracer::PathTracer pathTracer;
+	pathTracer.state().params.resolution = 32;
+	pathTracer.state().params.samples = 1;
+	ASSERT_TRUE(pathTracer.start(sceneGraph));
+	ASSERT_TRUE(pathTracer.stop());
+	const yocto::scene_data &scene = pathTracer.state().scene;
+	// one shape per color
+	EXPECT_EQ(2u, scene.shapes.size());
+	// the model and the reference
+	ASSERT_EQ(4u, scene.instances.size());
+	EXPECT_EQ(scene.instances[0].shape, scene.instances[2].shape);
+	EXPECT_EQ(scene.instances[1].shape, scene.instances[3].shape);
+	EXPECT_FLOAT_EQ(10.0f, scene.instances[2].frame.o.x - scene.instances[0].frame.o.x);
+}
+
+TEST_F(PathTracerTest, testRestartReusesBvh) {
+	scenegraph::SceneGraph sceneGraph;
+	voxel::RawVolume volume(voxel::Region(0, 3));
+	const int modelNodeId = createScene(sceneGraph, volume);
+
+	voxelpathtracer::PathTracer pathTracer;
+	pathTracer.state().params.resolution = 32;
+	pathTracer.state().params.samples = 1;
+	ASSERT_TRUE(pathTracer.start(sceneGraph));
+	const yocto::vec3f *positions = pathTracer.state().scene.shapes[0].positions.data();
+	const yocto::bvh_node *shapeNodes = pathTracer.state().bvh.bvh.shapes[0].bvh.nodes.data();
+	const yocto::bvh_node *instanceNodes = pathTracer.state().bvh.bvh.bvh.nodes.data();
+
+	// unchanged scene - e.g. a different camera
+	ASSERT_TRUE(pathTracer.restart(sceneGraph));
+	EXPECT_EQ(positions, pathTracer.state().scene.shapes[0].positions.data());
+	EXPECT_EQ(shapeNodes, pathTracer.state().bvh.bvh.shapes[0].bvh.nodes.data());
+	EXPECT_EQ(instanceNodes, pathTracer.state().bvh.bvh.bvh.nodes.data());
+
+	// moving a node only refits the bvh of the instances
+	scenegraph::SceneGraphTransform transform;
+	transform.setWorldTranslation(glm::vec3(0.0f, 5.0f, 0.0f));
+	sceneGraph.node(modelNodeId).setTransform(0, transform);
+	sceneGraph.updateTransforms();
+	ASSERT_TRUE(pathTracer.restart(sceneGraph));
+	EXPECT_EQ(positions, pathTracer.state().scene.shapes[0].positions.data());
+	EXPECT_EQ(shapeNodes, pathTracer.state().bvh.bvh.shapes[0].bvh.nodes.data());
+	EXPECT_FLOAT_EQ(5.0f, pathTracer.state().scene.instances[0].frame.o.y);
+
+	// changed voxels create new shapes
+	volume.setVoxel(2, 0, 0, voxel::createVoxel(voxel::VoxelType::Generic, 3));
+	ASSERT_TRUE(pathTracer.restart(sceneGraph));
+	EXPECT_EQ(3u, pathTracer.state().scene.shapes.size());
+	ASSERT_TRUE(pathTracer.stop());
+}
+
+TEST_F(PathTracerTest, testMeshState) {
+	scenegraph::SceneGraph sceneGraph;
+	voxel::RawVolume volume(voxel::Region(0, 31));
+	const int modelNodeId = createScene(sceneGraph, volume);
+	volume.setVoxel(20, 20, 20, voxel::createVoxel(voxel::VoxelType::Generic, 3));
+	scenegraph::SceneGraphNode &node = sceneGraph.node(modelNodeId);
+
+	core::Var::get(cfg::VoxelMeshSize, "16", core::CV_READONLY);
+	voxel::MeshState meshState;
+	meshState.construct();
+	ASSERT_TRUE(meshState.init());
+	bool deleted = false;
+	(void)meshState.setVolume(modelNodeId, &volume, &node.palette(), nullptr, true, deleted);
+	meshState.scheduleRegionExtraction(modelNodeId, volume.region());
+	meshState.extractAllPending();
+	while (meshState.pop() != -1) {
+	}
+	ASSERT_TRUE(meshState.upToDate());
+
+	voxelpathtracer::PathTracer extracted;
+	extracted.state().params.resolution = 32;
+	extracted.state().params.samples = 1;
+	ASSERT_TRUE(extracted.start(sceneGraph));
+	ASSERT_TRUE(extracted.stop());
+
+	voxelpathtracer::PathTracer reused;
+	reused.state().params.resolution = 32;
+	reused.state().params.samples = 1;
+	ASSERT_TRUE(reused.start(sceneGraph, nullptr, &meshState));
+	ASSERT_TRUE(reused.stop());
+
+	const yocto::scene_data &scene1 = extracted.state().scene;
+	const yocto::scene_data &scene2 = reused.state().scene;
+	ASSERT_EQ(scene1.shapes.size(), scene2.shapes.size());
+	const yocto::bbox3f bounds1 = yocto::compute_bounds(scene1);
+	const yocto::bbox3f bounds2 = yocto::compute_bounds(scene2);
+	for (int i = 0; i < 3; ++i) {
+		EXPECT_FLOAT_EQ(bounds1.min[i], bounds2.min[i]);
+		EXPECT_FLOAT_EQ(bounds1.max[i], bounds2.max[i]);
+	}
+
+	// the change counter of the mesh state detects modified voxels without hashing the volume
+	const size_t shapes = scene2.shapes.size();
+	const yocto::vec3f *positions = scene2.shapes[0].positions.data();
+	ASSERT_TRUE(reused.start(sceneGraph, nullptr, &meshState));
+	EXPECT_EQ(positions, reused.state().scene.shapes[0].positions.data());
+	volume.setVoxel(2, 2, 2, voxel::createVoxel(voxel::VoxelType::Generic, 4));
+	meshState.scheduleRegionExtraction(modelNodeId, voxel::Region(2, 2));
+	meshState.extractAllPending();
+	while (meshState.pop() != -1) {
+	}
+	ASSERT_TRUE(meshState.upToDate());
+	ASSERT_TRUE(reused.restart(sceneGraph, nullptr, &meshState));
+	EXPECT_EQ(shapes + 1u, reused.state().scene.shapes.size());
+	ASSERT_TRUE(reused.stop());
+	(void)meshState.shutdown();
+}
@@ -16,30 +16,13 @@
 #include "video/Texture.h"
 #include "voxelformat/Format.h"
 #include "voxelrender/SceneGraphRenderer.h"
+#include "voxelrender/RaycastRenderer.h"
+#include "voxelrender/SoftwareRenderer.h"
 #include "scenegraph/SceneGraph.h"
 
 namespace voxelrender {
 
-static image::ImagePtr volumeThumbnail(RenderContext &renderContext, voxelrender::SceneGraphRenderer &volumeRenderer, const voxelformat::ThumbnailContext &ctx) {
-	if (!renderContext.sceneGraph) {
-		Log::error("No scene graph set");
-		return image::ImagePtr();
-	}
-	const scenegraph::SceneGraph &sceneGraph = *renderContext.sceneGraph;
-	video::clearColor(ctx.clearColor);
-	video::enable(video::State::DepthTest);
-	video::depthFunc(video::CompareFunc::LessEqual);
-	video::enable(video::State::CullFace);
-	video::enable(video::State::DepthMask);
-	video::enable(video::State::Blend);
-	video::blendFunc(video::BlendMode::SourceAlpha, video::BlendMode::OneMinusSourceAlpha);
-
-	video::TextureConfig textureCfg;
-	textureCfg.wrap(video::TextureWrap::ClampToEdge);
-	textureCfg.format(video::TextureFormat::RGBA);
-
-	core_trace_scoped(EditorSceneRenderFramebuffer);
-
+static video::Camera thumbnailCamera(const scenegraph::SceneGraph &sceneGraph, const voxelformat::ThumbnailContext &ctx) {
 	video::Camera camera;
 
 	if (ctx.useSceneCamera && sceneGraph.size(scenegraph::SceneGraphNodeType::Camera) > 0) {
@@ -75,6 +58,31 @@ static image::ImagePtr volumeThumbnail(RenderContext &renderContext, voxelrender
 	}
 	camera.update(ctx.deltaFrameSeconds);
 
+	return camera;
+}
+
+static image::ImagePtr volumeThumbnail(RenderContext &renderContext, voxelrender::SceneGraphRenderer &volumeRenderer, const voxelformat::ThumbnailContext &ctx) {
+	if (!renderContext.sceneGraph) {
+		Log::error("No scene graph set");
+		return image::ImagePtr();
+	}
+	const scenegraph::SceneGraph &sceneGraph = *renderContext.sceneGraph;
+	video::clearColor(ctx.clearColor);
+	video::enable(video::State::DepthTest);
+	video::depthFunc(video::CompareFunc::LessEqual);
+	video::enable(video::State::CullFace);
+	video::enable(video::State::DepthMask);
+	video::enable(video::State::Blend);
+	video::blendFunc(video::BlendMode::SourceAlpha, video::BlendMode::OneMinusSourceAlpha);
+
+	video::TextureConfig textureCfg;
+	textureCfg.wrap(video::TextureWrap::ClampToEdge);
+	textureCfg.format(video::TextureFormat::RGBA);
+
+	core_trace_scoped(EditorSceneRenderFramebuffer);
+
+	const video::Camera &camera = thumbnailCamera(sceneGraph, ctx);
+
 	renderContext.frameBuffer.bind(true);
 	volumeRenderer.render(renderContext, camera, true, true);
 	renderContext.frameBuffer.unbind();
@@ -83,6 +91,21 @@ static image::ImagePtr volumeThumbnail(RenderContext &renderContext, voxelrender
 }
 
 image::ImagePtr volumeThumbnail(const scenegraph::SceneGraph &sceneGraph, const voxelformat::ThumbnailContext &ctx) {
+	return volumeThumbnail(sceneGraph, ctx, ThumbnailRenderer::OpenGL);
+}
+
+image::ImagePtr volumeThumbnail(const scenegraph::SceneGraph &sceneGraph, const voxelformat::ThumbnailContext &ctx,
+								ThumbnailRenderer renderer) {
+	if (renderer == ThumbnailRenderer::Software) {
+		SoftwareRenderer softwareRenderer;
+		softwareRenderer.setSceneGraph(sceneGraph);
+		return softwareRenderer.render(thumbnailCamera(sceneGraph, ctx), ctx.clearColor);
+	}
+	if (renderer == ThumbnailRenderer::Raycast) {
+		RaycastRenderer raycastRenderer;
+		raycastRenderer.setSceneGraph(sceneGraph);
+		return raycastRenderer.render(thumbnailCamera(sceneGraph, ctx), ctx.clearColor);
+	}
 	voxelrender::SceneGraphRenderer volumeRenderer;
 	volumeRenderer.construct();
 	RenderContext renderContext;
@@ -102,7 +125,53 @@ image::ImagePtr volumeThumbnail(const scenegraph::SceneGraph &sceneGraph, const
 	return image;
 }
 
-bool volumeTurntable(const scenegraph::SceneGraph &sceneGraph, const core::String &imageFile, voxelformat::ThumbnailContext ctx, int loops) {
+static bool writeTurntableImage(const core::String &filepath, const image::ImagePtr &image) {
+	const io::FilePtr &outfile = io::filesystem()->open(filepath, io::FileMode::SysWrite);
+	io::FileStream outStream(outfile);
+	if (!image::Image::writePng(outStream, image->data(), image->width(), image->height(), image->depth())) {
+		Log::error("Failed to write image %s", filepath.c_str());
+		return false;
+	}
+	Log::info("Write image %s", filepath.c_str());
+	return true;
+}
+
+/**
+ * @brief The scene graph is only prepared once for the cpu renderers - every frame just renders it from another camera
+ */
+template<class RENDERER>
+static bool cpuTurntable(RENDERER &renderer, const scenegraph::SceneGraph &sceneGraph, const core::String &imageFile,
+						 voxelformat::ThumbnailContext ctx, int loops) {
+	const core::String ext = core::string::extractExtension(imageFile);
+	const core::String baseFilePath = core::string::stripExtension(imageFile);
+	renderer.setSceneGraph(sceneGraph);
+	for (int i = 0; i < loops; ++i) {
+		const core::String &filepath = core::string::format("%s_%i.%s", baseFilePath.c_str(), i, ext.c_str());
+		const image::ImagePtr &image = renderer.render(thumbnailCamera(sceneGraph, ctx), ctx.clearColor);
+		if (!image) {
+			Log::error("Failed to create thumbnail for %s", imageFile.c_str());
+			return false;
+		}
+		if (!writeTurntableImage(filepath, image)) {
+			return false;
+		}
+		ctx.omega = glm::vec3(0.0f, glm::two_pi<float>() / (float)loops, 0.0f);
+		ctx.deltaFrameSeconds += 1000.0 / (double)loops;
+	}
+	return true;
+}
+
+bool volumeTurntable(const scenegraph::SceneGraph &sceneGraph, const core::String &imageFile,
+					 voxelformat::ThumbnailContext ctx, int loops, ThumbnailRenderer renderer) {
+	if (renderer == ThumbnailRenderer::Software) {
+		SoftwareRenderer softwareRenderer;
+		return cpuTurntable(softwareRenderer, sceneGraph, imageFile, ctx, loops);
+	}
+	if (renderer == ThumbnailRenderer::Raycast) {
+		RaycastRenderer raycastRenderer;
+		return cpuTurntable(raycastRenderer, sceneGraph, imageFile, ctx, loops);
+	}
+
 	voxelrender::SceneGraphRenderer volumeRenderer;
 	RenderContext renderContext;
 	renderContext.init(ctx.outputSize);
@@ -113,31 +182,25 @@ bool volumeTurntable(const scenegraph::SceneGraph &sceneGraph, const core::Strin
 	volumeRenderer.construct();
 	if (!volumeRenderer.init()) {
 		Log::error("Failed to initialize the renderer");
-		return image::ImagePtr();
+		return false;
 	}
 
 	const core::String ext = core::string::extractExtension(imageFile);
 	const core::String baseFilePath = core::string::stripExtension(imageFile);
 	for (int i = 0; i < loops; ++i) {
 		const core::String &filepath = core::string::format("%s_%i.%s", baseFilePath.c_str(), i, ext.c_str());
-		const io::FilePtr &outfile = io::filesystem()->open(filepath, io::FileMode::SysWrite);
-		io::FileStream outStream(outfile);
 		const image::ImagePtr &image = volumeThumbnail(renderContext, volumeRenderer, ctx);
-		if (image) {
-			if (!image::Image::writePng(outStream, image->data(), image->width(), image->height(), image->depth())) {
-				Log::error("Failed to write image %s", filepath.c_str());
-				volumeRenderer.shutdown();
-				renderContext.shutdown();
-				return false;
-			} else {
-				Log::info("Write image %s", filepath.c_str());
-			}
-		} else {
+		if (!image) {
 			Log::error("Failed to create thumbnail for %s", imageFile.c_str());
 			volumeRenderer.shutdown();
 			renderContext.shutdown();
 			return false;
 		}
+		if (!writeTurntableImage(filepath, image)) {
+			volumeRenderer.shutdown();
+			renderContext.shutdown();
+			return false;
+		}
 		ctx.omega = glm::vec3(0.0f, glm::two_pi<float>() / (float)loops, 0.0f);
 		ctx.deltaFrameSeconds += 1000.0 / (double)loops;
 	}
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "core/ArrayLength.h"
 #include "core/String.h"
 #include "voxelformat/FormatThumbnail.h"
 #include "io/Stream.h"
@@ -14,8 +15,25 @@ class SceneGraph;
 
 namespace voxelrender {
 
+enum class ThumbnailRenderer {
+	/** needs a graphics context */
+	OpenGL,
+	/** rasterizes on the cpu - can be used headless */
+	Software,
+	/** casts rays through the voxels on the cpu - no mesh extraction is needed */
+	Raycast,
+
+	Max
+};
+
+static constexpr const char *ThumbnailRendererStr[] = {"opengl", "software", "raycast"};
+static_assert(lengthof(ThumbnailRendererStr) == (int)ThumbnailRenderer::Max, "Array size doesn't match enum values");
+
 image::ImagePtr volumeThumbnail(const scenegraph::SceneGraph &sceneGraph, const voxelformat::ThumbnailContext &ctx);
-bool volumeTurntable(const scenegraph::SceneGraph &sceneGraph, const core::String &imageFile, voxelformat::ThumbnailContext ctx, int loops);
+image::ImagePtr volumeThumbnail(const scenegraph::SceneGraph &sceneGraph, const voxelformat::ThumbnailContext &ctx,
+								ThumbnailRenderer renderer);
+bool volumeTurntable(const scenegraph::SceneGraph &sceneGraph, const core::String &imageFile,
+					 voxelformat::ThumbnailContext ctx, int loops, ThumbnailRenderer renderer = ThumbnailRenderer::OpenGL);
 
 
 } // namespace voxelrender
@@ -106,7 +106,7 @@ void RawVolumeRenderer::construct() {
 
 bool RawVolumeRenderer::initStateBuffers() {
 	const voxel::SurfaceExtractionType meshMode = _meshState->meshMode();
-	const bool normals = meshMode != voxel::SurfaceExtractionType::Cubic;
+	const bool normals = meshMode == voxel::SurfaceExtractionType::MarchingCubes;
 	for (int idx = 0; idx < voxel::MAX_VOLUMES; ++idx) {
 		State &state = _state[idx];
 		_meshState->setModel(idx, glm::mat4(1.0f));
@@ -687,7 +687,7 @@ void RawVolumeRenderer::render(RenderContext &renderContext, const video::Camera
 	core_assert_always(_voxelData.update(_voxelShaderFragData));
 
 	const voxel::SurfaceExtractionType meshMode = _meshState->meshMode();
-	const bool normals = meshMode != voxel::SurfaceExtractionType::Cubic;
+	const bool normals = meshMode == voxel::SurfaceExtractionType::MarchingCubes;
 	video::Id oldShader = video::getProgram();
 	if (normals) {
 		_voxelNormShader.activate();
@@ -0,0 +1,419 @@
+/**
+ * @file
+ */
+
+#include "RaycastRenderer.h"
+#include "app/App.h"
+#include "core/Common.h"
+#include "core/Log.h"
+#include "core/RGBA.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicMap.h"
+#include "core/concurrent/TaskGroup.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "video/Camera.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Voxel.h"
+#include <float.h>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+
+namespace voxelrender {
+
+// see _sharedvert.glsl
+static const float AmbientOcclusionValues[] = {0.15f, 0.6f, 0.8f, 1.0f};
+static constexpr float AmbientLight = 0.55f;
+static constexpr float DiffuseLight = 0.45f;
+// stop the traversal if the accumulated color doesn't let anything through anymore
+static constexpr float OpaqueAlpha = 0.99f;
+// the amount of image rows that are traced by one task
+static constexpr int RowsPerTask = 8;
+
+static inline size_t cellIndex(const glm::ivec3 &dim, const glm::ivec3 &cell) {
+	return ((size_t)cell.z * (size_t)dim.y + (size_t)cell.y) * (size_t)dim.x + (size_t)cell.x;
+}
+
+void RaycastRenderer::OccupancyMip::build(const voxel::RawVolume *v) {
+	core_trace_scoped(OccupancyMipBuild);
+	volume = v;
+	region = v->region();
+	dimensions.clear();
+	levels.clear();
+	dimensions.push_back(region.getDimensionsInVoxels());
+	levels.emplace_back();
+
+	const glm::ivec3 lower = region.getLowerCorner();
+	while (glm::any(glm::greaterThan(dimensions.back(), glm::ivec3(1)))) {
+		const int level = (int)levels.size();
+		const glm::ivec3 prevDim = dimensions.back();
+		const glm::ivec3 dim = (prevDim + 1) / 2;
+		dimensions.push_back(dim);
+		levels.emplace_back();
+		core::DynamicArray<uint8_t> &cells = levels.back();
+		cells.resize((size_t)dim.x * (size_t)dim.y * (size_t)dim.z);
+
+		core::TaskGroup group(app::App::getInstance()->threadPool());
+		for (int z = 0; z < dim.z; ++z) {
+			group.run([this, &cells, &prevDim, &dim, &lower, level, z]() {
+				for (int y = 0; y < dim.y; ++y) {
+					for (int x = 0; x < dim.x; ++x) {
+						const glm::ivec3 cell(x, y, z);
+						const glm::ivec3 first = cell * 2;
+						const glm::ivec3 last = glm::min(first + 1, prevDim - 1);
+						uint8_t occupied = 0u;
+						for (int cz = first.z; cz <= last.z && !occupied; ++cz) {
+							for (int cy = first.y; cy <= last.y && !occupied; ++cy) {
+								for (int cx = first.x; cx <= last.x && !occupied; ++cx) {
+									const glm::ivec3 child(cx, cy, cz);
+									if (level == 1) {
+										occupied = !voxel::isAir(volume->voxel(lower + child).getMaterial());
+									} else {
+										occupied = levels[level - 1][cellIndex(prevDim, child)];
+									}
+								}
+							}
+						}
+						cells[cellIndex(dim, cell)] = occupied;
+					}
+				}
+			});
+		}
+		group.wait();
+	}
+}
+
+bool RaycastRenderer::OccupancyMip::occupied(int level, const glm::ivec3 &cell) const {
+	return levels[level][cellIndex(dimensions[level], cell)] != 0u;
+}
+
+bool RaycastRenderer::OccupancyMip::solid(const glm::ivec3 &pos) const {
+	if (!region.containsPoint(pos)) {
+		return false;
+	}
+	return !voxel::isAir(volume->voxel(pos).getMaterial());
+}
+
+int RaycastRenderer::OccupancyMip::maxLevel() const {
+	return (int)levels.size() - 1;
+}
+
+RaycastRenderer::RaycastRenderer() : _lightDir(glm::normalize(glm::vec3(0.5f, 1.0f, 0.75f))) {
+}
+
+void RaycastRenderer::setLightDirection(const glm::vec3 &lightDir) {
+	_lightDir = glm::normalize(lightDir);
+}
+
+void RaycastRenderer::clear() {
+	_mips.clear();
+	_instances.clear();
+}
+
+void RaycastRenderer::setSceneGraph(const scenegraph::SceneGraph &sceneGraph, scenegraph::FrameIndex frameIdx) {
+	core_trace_scoped(RaycastRendererSetSceneGraph);
+	clear();
+
+	// the model nodes that are rendered directly or via a reference node
+	core::DynamicArray<const scenegraph::SceneGraphNode *> models;
+	core::DynamicMap<int, int, 31> mipIndices;
+	auto mipIndex = [&models, &mipIndices](const scenegraph::SceneGraphNode &node) {
+		int idx;
+		if (mipIndices.get(node.id(), idx)) {
+			return idx;
+		}
+		idx = (int)models.size();
+		models.push_back(&node);
+		mipIndices.put(node.id(), idx);
+		return idx;
+	};
+
+	for (const auto &entry : sceneGraph.nodes()) {
+		const scenegraph::SceneGraphNode &node = entry->second;
+		if (!node.visible()) {
+			continue;
+		}
+		const scenegraph::SceneGraphNode *modelNode = nullptr;
+		if (node.isModelNode()) {
+			modelNode = &node;
+		} else if (node.isReference() && sceneGraph.hasNode(node.reference())) {
+			modelNode = &sceneGraph.node(node.reference());
+		}
+		if (modelNode == nullptr || !modelNode->isModelNode() || modelNode->volume() == nullptr) {
+			continue;
+		}
+		const scenegraph::FrameTransform &transform = sceneGraph.transformForFrame(node, frameIdx);
+		const voxel::Region &region = modelNode->region();
+		Instance instance;
+		instance.mipIdx = mipIndex(*modelNode);
+		instance.invModel = glm::inverse(transform.worldMatrix());
+		instance.normalMatrix = glm::transpose(glm::mat3(instance.invModel));
+		instance.pivot = transform.scale() * node.pivot() * glm::vec3(region.getDimensionsInVoxels());
+		_instances.push_back(instance);
+	}
+
+	_mips.resize(models.size());
+	core::TaskGroup group(app::App::getInstance()->threadPool());
+	for (size_t i = 0; i < models.size(); ++i) {
+		group.run([this, &models, i]() {
+			const scenegraph::SceneGraphNode &node = *models[i];
+			_mips[i].palette = node.palette();
+			_mips[i].build(node.volume());
+		});
+	}
+	group.wait();
+	Log::debug("Built %i occupancy mips for %i instances", (int)_mips.size(), (int)_instances.size());
+}
+
+/**
+ * @brief Interpolates the ambient occlusion of the four corners of the hit face - the same way the mesh extractor
+ * computes them for the vertices
+ */
+static float ambientOcclusion(const RaycastRenderer::OccupancyMip &mip, const glm::ivec3 &pos, int axis, int sign,
+							  const glm::vec3 &hitPos) {
+	const int u = (axis + 1) % 3;
+	const int w = (axis + 2) % 3;
+	glm::ivec3 base = pos;
+	base[axis] += sign;
+	float corners[2][2];
+	for (int iu = 0; iu < 2; ++iu) {
+		for (int iw = 0; iw < 2; ++iw) {
+			glm::ivec3 du(0);
+			glm::ivec3 dw(0);
+			du[u] = iu ? 1 : -1;
+			dw[w] = iw ? 1 : -1;
+			const int side1 = mip.solid(base + du);
+			const int side2 = mip.solid(base + dw);
+			const int corner = mip.solid(base + du + dw);
+			const int ao = (side1 && side2) ? 0 : 3 - (side1 + side2 + corner);
+			corners[iu][iw] = AmbientOcclusionValues[ao];
+		}
+	}
+	const float fu = glm::clamp(hitPos[u] - (float)pos[u], 0.0f, 1.0f);
+	const float fw = glm::clamp(hitPos[w] - (float)pos[w], 0.0f, 1.0f);
+	return glm::mix(glm::mix(corners[0][0], corners[1][0], fu), glm::mix(corners[0][1], corners[1][1], fu), fw);
+}
+
+bool RaycastRenderer::trace(const Instance &instance, const glm::vec3 &origin, const glm::vec3 &dir, float maxT,
+							Hit &hit) const {
+	const OccupancyMip &mip = _mips[instance.mipIdx];
+	// the affine transform keeps the ray parameter - the hits of different instances can be compared
+	const glm::vec3 o = glm::vec3(instance.invModel * glm::vec4(origin, 1.0f)) + instance.pivot;
+	const glm::vec3 d = glm::mat3(instance.invModel) * dir;
+	const glm::ivec3 lower = mip.region.getLowerCorner();
+	const glm::ivec3 upper = mip.region.getUpperCorner();
+	const glm::vec3 boxMins(lower);
+	const glm::vec3 boxMaxs(glm::vec3(upper) + 1.0f);
+
+	glm::vec3 invDir;
+	float t = 0.0f;
+	float tExit = maxT;
+	int axis = -1;
+	for (int i = 0; i < 3; ++i) {
+		if (d[i] == 0.0f) {
+			if (o[i] < boxMins[i] || o[i] >= boxMaxs[i]) {
+				return false;
+			}
+			invDir[i] = FLT_MAX;
+			continue;
+		}
+		invDir[i] = 1.0f / d[i];
+		float t0 = (boxMins[i] - o[i]) * invDir[i];
+		float t1 = (boxMaxs[i] - o[i]) * invDir[i];
+		if (t0 > t1) {
+			core::exchange(t0, t1);
+		}
+		if (t0 > t) {
+			t = t0;
+			axis = i;
+		}
+		tExit = glm::min(tExit, t1);
+	}
+	if (t >= tExit) {
+		return false;
+	}
+
+	const int maxLevel = mip.maxLevel();
+	glm::vec4 color(0.0f);
+	float firstHit = -1.0f;
+	while (t < tExit) {
+		const glm::vec3 p = o + d * t;
+		glm::ivec3 pos = glm::floor(p);
+		if (axis >= 0) {
+			// we are exactly on the boundary of the cell that was left
+			const int boundary = (int)glm::round(p[axis]);
+			pos[axis] = d[axis] > 0.0f ? boundary : boundary - 1;
+		}
+		pos = glm::clamp(pos, lower, upper);
+		const glm::ivec3 rel = pos - lower;
+
+		// find the largest empty cell that contains the position
+		int level = 0;
+		while (level < maxLevel && !mip.occupied(level + 1, rel >> (level + 1))) {
+			++level;
+		}
+		if (level == 0) {
+			const voxel::Voxel &voxel = mip.volume->voxel(pos);
+			if (!voxel::isAir(voxel.getMaterial())) {
+				int hitAxis = axis;
+				if (hitAxis < 0) {
+					// the ray started inside of the voxel
+					const glm::vec3 absDir = glm::abs(d);
+					hitAxis = absDir.x > absDir.y ? (absDir.x > absDir.z ? 0 : 2) : (absDir.y > absDir.z ? 1 : 2);
+				}
+				const int sign = d[hitAxis] > 0.0f ? -1 : 1;
+				glm::vec3 normal(0.0f);
+				normal[hitAxis] = (float)sign;
+				normal = glm::normalize(instance.normalMatrix * normal);
+				const float shade = AmbientLight + DiffuseLight * glm::abs(glm::dot(normal, _lightDir));
+				const float ao = ambientOcclusion(mip, pos, hitAxis, sign, p);
+				const core::RGBA rgba = mip.palette.color(voxel.getColor());
+				const float alpha = (float)rgba.a / 255.0f;
+				const glm::vec3 rgb = glm::vec3(rgba.r, rgba.g, rgba.b) / 255.0f * shade * ao;
+				color += (1.0f - color.a) * glm::vec4(rgb * alpha, alpha);
+				if (firstHit < 0.0f) {
+					firstHit = t;
+				}
+				if (color.a >= OpaqueAlpha) {
+					break;
+				}
+			}
+		}
+
+		// step to the exit of the current cell
+		const glm::vec3 cellMins(lower + ((rel >> level) << level));
+		const glm::vec3 cellMaxs = cellMins + (float)(1 << level);
+		float tNext = FLT_MAX;
+		for (int i = 0; i < 3; ++i) {
+			if (d[i] == 0.0f) {
+				continue;
+			}
+			const float bound = d[i] > 0.0f ? cellMaxs[i] : cellMins[i];
+			const float ti = (bound - o[i]) * invDir[i];
+			if (ti < tNext) {
+				tNext = ti;
+				axis = i;
+			}
+		}
+		// make sure that we don't get stuck because of precision issues at cell corners
+		t = tNext > t ? tNext : t + 1e-4f;
+	}
+	if (firstHit < 0.0f) {
+		return false;
+	}
+	hit.t = firstHit;
+	hit.color = color;
+	return true;
+}
+
+/**
+ * @return The inclusive pixel rect that the instance covers on the screen
+ */
+static glm::ivec4 screenRect(const glm::mat4 &viewProjection, const glm::mat4 &model, const voxel::Region &region,
+							 const glm::vec3 &pivot, const glm::ivec2 &size) {
+	const glm::ivec4 fullscreen(0, 0, size.x - 1, size.y - 1);
+	const glm::vec3 mins = glm::vec3(region.getLowerCorner()) - pivot;
+	const glm::vec3 maxs = glm::vec3(region.getUpperCorner()) + 1.0f - pivot;
+	glm::vec2 screenMins(FLT_MAX);
+	glm::vec2 screenMaxs(-FLT_MAX);
+	for (int i = 0; i < 8; ++i) {
+		const glm::vec3 corner(i & 1 ? maxs.x : mins.x, i & 2 ? maxs.y : mins.y, i & 4 ? maxs.z : mins.z);
+		const glm::vec4 clip = viewProjection * model * glm::vec4(corner, 1.0f);
+		if (clip.w <= 0.0f) {
+			// the box intersects the camera plane
+			return fullscreen;
+		}
+		const glm::vec2 ndc = glm::vec2(clip) / clip.w;
+		const glm::vec2 screen((ndc.x * 0.5f + 0.5f) * (float)size.x, (0.5f - ndc.y * 0.5f) * (float)size.y);
+		screenMins = glm::min(screenMins, screen);
+		screenMaxs = glm::max(screenMaxs, screen);
+	}
+	return glm::ivec4(glm::clamp((int)screenMins.x - 1, 0, size.x), glm::clamp((int)screenMins.y - 1, 0, size.y),
+					  glm::clamp((int)screenMaxs.x + 1, -1, size.x - 1),
+					  glm::clamp((int)screenMaxs.y + 1, -1, size.y - 1));
+}
+
+image::ImagePtr RaycastRenderer::render(const video::Camera &camera, const glm::vec4 &clearColor) const {
+	core_trace_scoped(RaycastRendererRender);
+	const glm::ivec2 &size = camera.size();
+	if (size.x <= 0 || size.y <= 0) {
+		Log::error("Invalid camera size: %i:%i", size.x, size.y);
+		return image::ImagePtr();
+	}
+
+	const glm::mat4 &viewProjection = camera.viewProjectionMatrix();
+	const glm::mat4 invViewProjection = glm::inverse(viewProjection);
+	core::DynamicArray<glm::ivec4> rects;
+	rects.reserve(_instances.size());
+	for (const Instance &instance : _instances) {
+		rects.push_back(screenRect(viewProjection, glm::inverse(instance.invModel), _mips[instance.mipIdx].region,
+								   instance.pivot, size));
+	}
+
+	const size_t pixels = (size_t)size.x * (size_t)size.y;
+	core::DynamicArray<core::RGBA> rgba;
+	rgba.resize(pixels);
+	core::TaskGroup group(app::App::getInstance()->threadPool());
+	for (int startY = 0; startY < size.y; startY += RowsPerTask) {
+		group.run([this, &rgba, &rects, &size, &invViewProjection, &clearColor, startY]() {
+			core::DynamicArray<Hit> hits;
+			hits.reserve(_instances.size());
+			const int endY = glm::min(size.y, startY + RowsPerTask);
+			for (int y = startY; y < endY; ++y) {
+				for (int x = 0; x < size.x; ++x) {
+					const glm::vec2 ndc(((float)x + 0.5f) / (float)size.x * 2.0f - 1.0f,
+										1.0f - ((float)y + 0.5f) / (float)size.y * 2.0f);
+					const glm::vec4 nearPlane = invViewProjection * glm::vec4(ndc, -1.0f, 1.0f);
+					const glm::vec4 farPlane = invViewProjection * glm::vec4(ndc, 1.0f, 1.0f);
+					const glm::vec3 origin = glm::vec3(nearPlane) / nearPlane.w;
+					glm::vec3 dir = glm::vec3(farPlane) / farPlane.w - origin;
+					const float maxT = glm::length(dir);
+					dir /= maxT;
+
+					// the hits are sorted front to back
+					hits.clear();
+					for (size_t i = 0; i < _instances.size(); ++i) {
+						const glm::ivec4 &rect = rects[i];
+						if (x < rect.x || y < rect.y || x > rect.z || y > rect.w) {
+							continue;
+						}
+						Hit hit;
+						if (!trace(_instances[i], origin, dir, maxT, hit)) {
+							continue;
+						}
+						size_t insertIdx = hits.size();
+						while (insertIdx > 0 && hits[insertIdx - 1].t > hit.t) {
+							--insertIdx;
+						}
+						hits.insert(hits.begin() + insertIdx, hit);
+					}
+
+					glm::vec4 color(0.0f);
+					for (const Hit &hit : hits) {
+						color += (1.0f - color.a) * hit.color;
+						if (color.a >= OpaqueAlpha) {
+							break;
+						}
+					}
+					color += (1.0f - color.a) * glm::vec4(glm::vec3(clearColor) * clearColor.a, clearColor.a);
+					if (color.a > 0.0f) {
+						color = glm::vec4(glm::vec3(color) / color.a, color.a);
+					}
+					const glm::vec4 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+					rgba[(size_t)y * size.x + x] = core::RGBA((uint8_t)c.r, (uint8_t)c.g, (uint8_t)c.b, (uint8_t)c.a);
+				}
+			}
+		});
+	}
+	group.wait();
+
+	image::ImagePtr image = image::createEmptyImage("thumbnail");
+	if (!image->loadRGBA((const uint8_t *)rgba.data(), size.x, size.y)) {
+		Log::error("Failed to create the thumbnail image");
+		return image::ImagePtr();
+	}
+	return image;
+}
+
+} // namespace voxelrender
@@ -0,0 +1,109 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/DynamicArray.h"
+#include "image/Image.h"
+#include "palette/Palette.h"
+#include "scenegraph/SceneGraphAnimation.h"
+#include "voxel/Region.h"
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace scenegraph {
+class SceneGraph;
+}
+
+namespace video {
+class Camera;
+}
+
+namespace voxel {
+class RawVolume;
+}
+
+namespace voxelrender {
+
+/**
+ * @brief Renders the model nodes of a scene graph by casting a ray per pixel through the voxels - there is neither a
+ * graphics context nor a mesh extraction needed
+ *
+ * The rays are traversed through the volumes with a DDA (see @c voxelutil::raycastWithDirection()) in the local space
+ * of every node. Each volume gets an occupancy mip hierarchy to skip empty space: level @c n stores whether any voxel
+ * in a cell of @c 2^n voxels per axis is set. The rendering costs scale with the amount of pixels instead of the
+ * amount of surfaces.
+ *
+ * @sa SoftwareRenderer
+ * @sa volumeThumbnail()
+ */
+class RaycastRenderer {
+public:
+	/**
+	 * @brief The occupancy of a volume - level @c 0 is the volume itself
+	 */
+	struct OccupancyMip {
+		const voxel::RawVolume *volume = nullptr;
+		palette::Palette palette;
+		voxel::Region region;
+		/** the dimensions of every level in cells */
+		core::DynamicArray<glm::ivec3> dimensions;
+		/** the occupancy of every level - index @c 0 is unused */
+		core::DynamicArray<core::DynamicArray<uint8_t>> levels;
+
+		void build(const voxel::RawVolume *v);
+		bool occupied(int level, const glm::ivec3 &cell) const;
+		bool solid(const glm::ivec3 &pos) const;
+		int maxLevel() const;
+	};
+
+private:
+	struct Instance {
+		int mipIdx;
+		glm::mat4 invModel;
+		/** transforms the normals of the local volume space into world space */
+		glm::mat3 normalMatrix;
+		glm::vec3 pivot;
+	};
+
+	struct Hit {
+		float t;
+		/** premultiplied color */
+		glm::vec4 color;
+	};
+
+	core::DynamicArray<OccupancyMip> _mips;
+	core::DynamicArray<Instance> _instances;
+	glm::vec3 _lightDir;
+
+	bool trace(const Instance &instance, const glm::vec3 &origin, const glm::vec3 &dir, float maxT, Hit &hit) const;
+
+public:
+	RaycastRenderer();
+
+	/**
+	 * @brief Builds the occupancy hierarchies of the visible model nodes and collects the transforms of the model and
+	 * reference nodes for the given frame
+	 * @note The volumes of the scene graph are not copied - they must stay valid while rendering
+	 */
+	void setSceneGraph(const scenegraph::SceneGraph &sceneGraph, scenegraph::FrameIndex frameIdx = 0);
+	void clear();
+
+	/**
+	 * @return The image in the size of the camera - @c nullptr if the camera size is invalid
+	 */
+	image::ImagePtr render(const video::Camera &camera, const glm::vec4 &clearColor) const;
+
+	void setLightDirection(const glm::vec3 &lightDir);
+
+	size_t instances() const;
+};
+
+inline size_t RaycastRenderer::instances() const {
+	return _instances.size();
+}
+
+} // namespace voxelrender
@@ -53,6 +53,8 @@ public:
 	void setAmbientColor(const glm::vec3 &color);
 	void setDiffuseColor(const glm::vec3 &color);
 
+	voxel::MeshStatePtr meshState() const;
+
 	void nodeRemove(int nodeId);
 	/**
 	 * @brief Checks whether the given model node is visible
@@ -72,4 +74,8 @@ public:
 	void clear();
 };
 
+inline voxel::MeshStatePtr SceneGraphRenderer::meshState() const {
+	return _volumeRenderer.meshState();
+}
+
 } // namespace voxelrender
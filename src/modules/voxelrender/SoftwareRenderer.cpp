@@ -0,0 +1,449 @@
+/**
+ * @file
+ */
+
+#include "SoftwareRenderer.h"
+#include "app/App.h"
+#include "core/Algorithm.h"
+#include "core/ArrayLength.h"
+#include "core/Log.h"
+#include "core/RGBA.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicMap.h"
+#include "core/concurrent/TaskGroup.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "video/Camera.h"
+#include "voxel/RawVolume.h"
+#include "voxel/SurfaceExtractor.h"
+#include <float.h>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+namespace voxelrender {
+
+// see _sharedvert.glsl
+static const float AmbientOcclusionValues[] = {0.15f, 0.6f, 0.8f, 1.0f};
+static constexpr float AmbientLight = 0.55f;
+static constexpr float DiffuseLight = 0.45f;
+// the amount of indices that are transformed by one task
+static constexpr size_t IndicesPerTask = 3u * 16384u;
+// triangles that reach further outside of the image are dropped - the fixed point edge functions would overflow
+static constexpr float MaxScreenCoordinate = (float)(1 << 22);
+
+struct ClipVertex {
+	glm::vec4 pos;
+	float ambientOcclusion;
+};
+
+SoftwareRenderer::SoftwareRenderer() : _lightDir(glm::normalize(glm::vec3(0.5f, 1.0f, 0.75f))) {
+}
+
+void SoftwareRenderer::setLightDirection(const glm::vec3 &lightDir) {
+	_lightDir = glm::normalize(lightDir);
+}
+
+void SoftwareRenderer::clear() {
+	_meshes.clear();
+	_instances.clear();
+}
+
+void SoftwareRenderer::setSceneGraph(const scenegraph::SceneGraph &sceneGraph, scenegraph::FrameIndex frameIdx) {
+	core_trace_scoped(SoftwareRendererSetSceneGraph);
+	clear();
+
+	// the model nodes that are rendered directly or via a reference node
+	core::DynamicArray<const scenegraph::SceneGraphNode *> models;
+	core::DynamicMap<int, int, 31> meshIndices;
+	auto meshIndex = [&models, &meshIndices](const scenegraph::SceneGraphNode &node) {
+		int idx;
+		if (meshIndices.get(node.id(), idx)) {
+			return idx;
+		}
+		idx = (int)models.size();
+		models.push_back(&node);
+		meshIndices.put(node.id(), idx);
+		return idx;
+	};
+
+	for (const auto &entry : sceneGraph.nodes()) {
+		const scenegraph::SceneGraphNode &node = entry->second;
+		if (!node.visible()) {
+			continue;
+		}
+		const scenegraph::SceneGraphNode *modelNode = nullptr;
+		if (node.isModelNode()) {
+			modelNode = &node;
+		} else if (node.isReference() && sceneGraph.hasNode(node.reference())) {
+			modelNode = &sceneGraph.node(node.reference());
+		}
+		if (modelNode == nullptr || !modelNode->isModelNode() || modelNode->volume() == nullptr) {
+			continue;
+		}
+		const scenegraph::FrameTransform &transform = sceneGraph.transformForFrame(node, frameIdx);
+		const voxel::Region &region = modelNode->region();
+		const glm::vec3 scale = transform.scale();
+		const int negative =
+			(int)std::signbit(scale.x) + (int)std::signbit(scale.y) + (int)std::signbit(scale.z);
+		Instance instance;
+		instance.meshIdx = meshIndex(*modelNode);
+		instance.model = transform.worldMatrix();
+		instance.pivot = scale * node.pivot() * glm::vec3(region.getDimensionsInVoxels());
+		instance.mirrored = negative == 1 || negative == 3;
+		_instances.push_back(instance);
+	}
+
+	_meshes.resize(models.size());
+	core::TaskGroup group(app::App::getInstance()->threadPool());
+	for (size_t i = 0; i < models.size(); ++i) {
+		group.run([this, &models, i]() {
+			const scenegraph::SceneGraphNode &node = *models[i];
+			NodeMesh &nodeMesh = _meshes[i];
+			nodeMesh.palette = node.palette();
+			const voxel::RawVolume *volume = node.volume();
+			const voxel::Region &region = volume->region();
+			voxel::SurfaceExtractionContext ctx =
+				voxel::createContext(voxel::SurfaceExtractionType::Cubic, volume, region, nodeMesh.palette,
+									 nodeMesh.mesh, region.getLowerCorner());
+			voxel::extractSurfaceParallel(ctx);
+		});
+	}
+	group.wait();
+	Log::debug("Extracted %i meshes for %i instances", (int)_meshes.size(), (int)_instances.size());
+}
+
+/**
+ * @brief Clips the polygon against the near plane of the clip space
+ * @return The amount of vertices in the output polygon
+ */
+static int clipNearPlane(const ClipVertex *in, int n, ClipVertex *out) {
+	int outCnt = 0;
+	for (int i = 0; i < n; ++i) {
+		const ClipVertex &a = in[i];
+		const ClipVertex &b = in[(i + 1) % n];
+		const float da = a.pos.z + a.pos.w;
+		const float db = b.pos.z + b.pos.w;
+		if (da >= 0.0f) {
+			out[outCnt++] = a;
+		}
+		if ((da >= 0.0f) != (db >= 0.0f)) {
+			const float t = da / (da - db);
+			out[outCnt].pos = glm::mix(a.pos, b.pos, t);
+			out[outCnt].ambientOcclusion = glm::mix(a.ambientOcclusion, b.ambientOcclusion, t);
+			++outCnt;
+		}
+	}
+	return outCnt;
+}
+
+static inline float edgeFunction(const glm::vec2 &a, const glm::vec2 &b, const glm::vec2 &p) {
+	return (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+}
+
+/**
+ * @brief The integer version is exact - two triangles that share an edge get the same values with opposite signs
+ */
+static inline int64_t edgeFunction(const glm::i64vec2 &a, const glm::i64vec2 &b, const glm::i64vec2 &p) {
+	return (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+}
+
+/**
+ * @brief Top edges are horizontal with the triangle below them, left edges have the triangle on their right side.
+ * Pixel centers that are exactly on an edge are only covered if it's a top or a left edge.
+ * @note Expects the clockwise order of the screen space vertices (the y axis points down)
+ */
+static inline bool isTopLeftEdge(const glm::i64vec2 &a, const glm::i64vec2 &b) {
+	const int64_t dx = b.x - a.x;
+	const int64_t dy = b.y - a.y;
+	return dy < 0 || (dy == 0 && dx > 0);
+}
+
+/**
+ * @return @c false if the triangle is not visible
+ */
+static bool projectTriangle(const ClipVertex &v0, const ClipVertex &v1, const ClipVertex &v2, const glm::ivec2 &size,
+							bool backfaceCulling, bool mirrored, SoftwareRenderer::Triangle &triangle) {
+	const ClipVertex *vertices[] = {&v0, &v1, &v2};
+	glm::vec2 mins(FLT_MAX);
+	glm::vec2 maxs(-FLT_MAX);
+	for (int i = 0; i < 3; ++i) {
+		const glm::vec4 &pos = vertices[i]->pos;
+		if (pos.w <= 0.0f) {
+			return false;
+		}
+		const glm::vec3 ndc = glm::vec3(pos) / pos.w;
+		// the image rows are top down
+		triangle.pos[i] = glm::vec2((ndc.x * 0.5f + 0.5f) * (float)size.x, (0.5f - ndc.y * 0.5f) * (float)size.y);
+		if (glm::any(glm::greaterThan(glm::abs(triangle.pos[i]), glm::vec2(MaxScreenCoordinate)))) {
+			return false;
+		}
+		triangle.fixedPos[i] = glm::i64vec2(glm::round(triangle.pos[i] * (float)SoftwareRenderer::SubPixelScale));
+		triangle.depth[i] = ndc.z;
+		triangle.ambientOcclusion[i] = vertices[i]->ambientOcclusion;
+		mins = glm::min(mins, triangle.pos[i]);
+		maxs = glm::max(maxs, triangle.pos[i]);
+	}
+	if (maxs.x < 0.0f || maxs.y < 0.0f || mins.x >= (float)size.x || mins.y >= (float)size.y) {
+		return false;
+	}
+	const float area = edgeFunction(triangle.pos[0], triangle.pos[1], triangle.pos[2]);
+	if (area == 0.0f) {
+		return false;
+	}
+	if (backfaceCulling) {
+		// counter clockwise triangles are front facing - the y axis is flipped in screen space
+		const bool frontFacing = mirrored ? area > 0.0f : area < 0.0f;
+		if (!frontFacing) {
+			return false;
+		}
+	}
+	const int64_t fixedArea = edgeFunction(triangle.fixedPos[0], triangle.fixedPos[1], triangle.fixedPos[2]);
+	if (fixedArea == 0) {
+		return false;
+	}
+	if (fixedArea < 0) {
+		// the rasterizer expects a clockwise order on the screen
+		core::exchange(triangle.pos[1], triangle.pos[2]);
+		core::exchange(triangle.fixedPos[1], triangle.fixedPos[2]);
+		core::exchange(triangle.depth[1], triangle.depth[2]);
+		core::exchange(triangle.ambientOcclusion[1], triangle.ambientOcclusion[2]);
+	}
+	triangle.bounds.x = glm::clamp((int)mins.x, 0, size.x - 1);
+	triangle.bounds.y = glm::clamp((int)mins.y, 0, size.y - 1);
+	triangle.bounds.z = glm::clamp((int)maxs.x, 0, size.x - 1);
+	triangle.bounds.w = glm::clamp((int)maxs.y, 0, size.y - 1);
+	return true;
+}
+
+void SoftwareRenderer::setupTriangles(const video::Camera &camera, core::DynamicArray<Triangle> &triangles,
+									  size_t &firstTransparent) const {
+	core_trace_scoped(SoftwareRendererSetupTriangles);
+	struct SetupJob {
+		int instanceIdx;
+		int meshType;
+		size_t firstIndex;
+		size_t endIndex;
+	};
+	// the opaque meshes are rendered first
+	core::DynamicArray<SetupJob> jobs;
+	for (int meshType = 0; meshType < voxel::ChunkMesh::Meshes; ++meshType) {
+		for (size_t i = 0; i < _instances.size(); ++i) {
+			const voxel::Mesh &mesh = _meshes[_instances[i].meshIdx].mesh.mesh[meshType];
+			const size_t indices = mesh.getNoOfIndices();
+			for (size_t first = 0; first < indices; first += IndicesPerTask) {
+				jobs.push_back({(int)i, meshType, first, glm::min(indices, first + IndicesPerTask)});
+			}
+		}
+	}
+
+	const glm::ivec2 &size = camera.size();
+	core::DynamicArray<core::DynamicArray<Triangle>> results;
+	results.resize(jobs.size());
+	core::TaskGroup group(app::App::getInstance()->threadPool());
+	for (size_t j = 0; j < jobs.size(); ++j) {
+		group.run([this, &jobs, &results, &camera, &size, j]() {
+			const SetupJob &job = jobs[j];
+			const Instance &instance = _instances[job.instanceIdx];
+			const NodeMesh &nodeMesh = _meshes[instance.meshIdx];
+			const voxel::Mesh &mesh = nodeMesh.mesh.mesh[job.meshType];
+			const voxel::IndexArray &indices = mesh.getIndexVector();
+			const voxel::VertexArray &vertices = mesh.getVertexVector();
+			const glm::mat4 mvp = camera.viewProjectionMatrix() * instance.model;
+			core::DynamicArray<Triangle> &out = results[j];
+			out.reserve((job.endIndex - job.firstIndex) / 3);
+
+			for (size_t i = job.firstIndex; i + 2 < job.endIndex; i += 3) {
+				ClipVertex in[3];
+				glm::vec3 world[3];
+				for (int k = 0; k < 3; ++k) {
+					const voxel::VoxelVertex &vertex = vertices[indices[i + k]];
+					const glm::vec4 local(vertex.position - instance.pivot, 1.0f);
+					world[k] = glm::vec3(instance.model * local);
+					in[k].pos = mvp * local;
+					in[k].ambientOcclusion = AmbientOcclusionValues[vertex.ambientOcclusion];
+				}
+				const glm::vec3 normal = glm::cross(world[1] - world[0], world[2] - world[0]);
+				const float length = glm::length(normal);
+				if (length <= 0.0f) {
+					continue;
+				}
+				const float shade = AmbientLight + DiffuseLight * glm::abs(glm::dot(normal / length, _lightDir));
+				const core::RGBA rgba = nodeMesh.palette.color(vertices[indices[i]].colorIndex);
+				const glm::vec4 color(glm::vec3(rgba.r, rgba.g, rgba.b) / 255.0f * shade, (float)rgba.a / 255.0f);
+
+				ClipVertex clipped[4];
+				const int n = clipNearPlane(in, 3, clipped);
+				for (int k = 1; k + 1 < n; ++k) {
+					Triangle triangle;
+					if (projectTriangle(clipped[0], clipped[k], clipped[k + 1], size, _backfaceCulling,
+										instance.mirrored, triangle)) {
+						triangle.color = color;
+						out.push_back(triangle);
+					}
+				}
+			}
+		});
+	}
+	group.wait();
+
+	size_t total = 0u;
+	for (const core::DynamicArray<Triangle> &result : results) {
+		total += result.size();
+	}
+	triangles.clear();
+	triangles.reserve(total);
+	firstTransparent = 0u;
+	for (size_t j = 0; j < jobs.size(); ++j) {
+		if (jobs[j].meshType == 0) {
+			firstTransparent += results[j].size();
+		}
+		triangles.append(results[j].data(), results[j].size());
+	}
+	// blending needs the transparent triangles in back to front order
+	core::sort(triangles.begin() + firstTransparent, triangles.end(), [](const Triangle &a, const Triangle &b) {
+		return a.depth[0] + a.depth[1] + a.depth[2] > b.depth[0] + b.depth[1] + b.depth[2];
+	});
+}
+
+/**
+ * @brief Rasterizes the triangles of a tile into the depth and color buffers. The opaque triangles write into the
+ * depth buffer, the transparent triangles are depth tested and blended in the order they were submitted.
+ */
+static void rasterizeTile(const core::DynamicArray<SoftwareRenderer::Triangle> &triangles,
+						  const core::DynamicArray<uint32_t> &bin, size_t firstTransparent, const glm::ivec4 &tile,
+						  int width, float *depthBuffer, glm::vec4 *colorBuffer) {
+	const int64_t scale = SoftwareRenderer::SubPixelScale;
+	for (uint32_t triIdx : bin) {
+		const SoftwareRenderer::Triangle &triangle = triangles[triIdx];
+		const bool transparent = triIdx >= firstTransparent;
+		const int minX = glm::max(triangle.bounds.x, tile.x);
+		const int minY = glm::max(triangle.bounds.y, tile.y);
+		const int maxX = glm::min(triangle.bounds.z, tile.z);
+		const int maxY = glm::min(triangle.bounds.w, tile.w);
+		const glm::i64vec2 &p0 = triangle.fixedPos[0];
+		const glm::i64vec2 &p1 = triangle.fixedPos[1];
+		const glm::i64vec2 &p2 = triangle.fixedPos[2];
+		const float invArea = 1.0f / (float)edgeFunction(p0, p1, p2);
+		// the pixel centers on edges that are not top or left edges are excluded
+		const int64_t bias0 = isTopLeftEdge(p1, p2) ? 0 : -1;
+		const int64_t bias1 = isTopLeftEdge(p2, p0) ? 0 : -1;
+		const int64_t bias2 = isTopLeftEdge(p0, p1) ? 0 : -1;
+
+		// the edge functions are evaluated incrementally - these are the steps in x and y direction
+		const int64_t stepX0 = (p1.y - p2.y) * scale;
+		const int64_t stepX1 = (p2.y - p0.y) * scale;
+		const int64_t stepX2 = (p0.y - p1.y) * scale;
+		const int64_t stepY0 = (p2.x - p1.x) * scale;
+		const int64_t stepY1 = (p0.x - p2.x) * scale;
+		const int64_t stepY2 = (p1.x - p0.x) * scale;
+		const glm::i64vec2 start((int64_t)minX * scale + scale / 2, (int64_t)minY * scale + scale / 2);
+		int64_t row0 = edgeFunction(p1, p2, start);
+		int64_t row1 = edgeFunction(p2, p0, start);
+		int64_t row2 = edgeFunction(p0, p1, start);
+
+		for (int y = minY; y <= maxY; ++y) {
+			int64_t w0 = row0;
+			int64_t w1 = row1;
+			int64_t w2 = row2;
+			float *depth = depthBuffer + (size_t)y * width;
+			glm::vec4 *color = colorBuffer + (size_t)y * width;
+			for (int x = minX; x <= maxX; ++x, w0 += stepX0, w1 += stepX1, w2 += stepX2) {
+				if (w0 + bias0 < 0 || w1 + bias1 < 0 || w2 + bias2 < 0) {
+					continue;
+				}
+				const float b0 = (float)w0 * invArea;
+				const float b1 = (float)w1 * invArea;
+				const float b2 = (float)w2 * invArea;
+				const float z = b0 * triangle.depth[0] + b1 * triangle.depth[1] + b2 * triangle.depth[2];
+				if (z < -1.0f || z > depth[x]) {
+					continue;
+				}
+				const float ao = b0 * triangle.ambientOcclusion[0] + b1 * triangle.ambientOcclusion[1] +
+								 b2 * triangle.ambientOcclusion[2];
+				const glm::vec3 rgb = glm::vec3(triangle.color) * ao;
+				if (transparent) {
+					const float alpha = triangle.color.a;
+					color[x] = glm::vec4(glm::mix(glm::vec3(color[x]), rgb, alpha),
+										 glm::min(1.0f, color[x].a + alpha * (1.0f - color[x].a)));
+				} else {
+					depth[x] = z;
+					color[x] = glm::vec4(rgb, 1.0f);
+				}
+			}
+			row0 += stepY0;
+			row1 += stepY1;
+			row2 += stepY2;
+		}
+	}
+}
+
+image::ImagePtr SoftwareRenderer::render(const video::Camera &camera, const glm::vec4 &clearColor) const {
+	core_trace_scoped(SoftwareRendererRender);
+	const glm::ivec2 &size = camera.size();
+	if (size.x <= 0 || size.y <= 0) {
+		Log::error("Invalid camera size: %i:%i", size.x, size.y);
+		return image::ImagePtr();
+	}
+
+	core::DynamicArray<Triangle> triangles;
+	size_t firstTransparent = 0u;
+	setupTriangles(camera, triangles, firstTransparent);
+
+	const int tilesX = (size.x + TileSize - 1) / TileSize;
+	const int tilesY = (size.y + TileSize - 1) / TileSize;
+	core::DynamicArray<core::DynamicArray<uint32_t>> bins;
+	bins.append((size_t)tilesX * (size_t)tilesY, [](size_t) { return core::DynamicArray<uint32_t>(); });
+	{
+		core_trace_scoped(SoftwareRendererBinning);
+		for (size_t i = 0; i < triangles.size(); ++i) {
+			const glm::ivec4 &bounds = triangles[i].bounds;
+			for (int ty = bounds.y / TileSize; ty <= bounds.w / TileSize; ++ty) {
+				for (int tx = bounds.x / TileSize; tx <= bounds.z / TileSize; ++tx) {
+					bins[ty * tilesX + tx].push_back((uint32_t)i);
+				}
+			}
+		}
+	}
+
+	const size_t pixels = (size_t)size.x * (size_t)size.y;
+	core::DynamicArray<float> depthBuffer;
+	depthBuffer.resize(pixels);
+	depthBuffer.fill(FLT_MAX);
+	core::DynamicArray<glm::vec4> colorBuffer;
+	colorBuffer.resize(pixels);
+	colorBuffer.fill(clearColor);
+	{
+		core_trace_scoped(SoftwareRendererRasterize);
+		core::TaskGroup group(app::App::getInstance()->threadPool());
+		for (int ty = 0; ty < tilesY; ++ty) {
+			for (int tx = 0; tx < tilesX; ++tx) {
+				const core::DynamicArray<uint32_t> &bin = bins[ty * tilesX + tx];
+				if (bin.empty()) {
+					continue;
+				}
+				const glm::ivec4 tile(tx * TileSize, ty * TileSize, glm::min(size.x, (tx + 1) * TileSize) - 1,
+									  glm::min(size.y, (ty + 1) * TileSize) - 1);
+				group.run([&triangles, &bin, firstTransparent, tile, &size, &depthBuffer, &colorBuffer]() {
+					rasterizeTile(triangles, bin, firstTransparent, tile, size.x, depthBuffer.data(),
+								  colorBuffer.data());
+				});
+			}
+		}
+		group.wait();
+	}
+
+	core::DynamicArray<core::RGBA> rgba;
+	rgba.resize(pixels);
+	for (size_t i = 0; i < pixels; ++i) {
+		const glm::vec4 c = glm::clamp(colorBuffer[i], 0.0f, 1.0f) * 255.0f + 0.5f;
+		rgba[i] = core::RGBA((uint8_t)c.r, (uint8_t)c.g, (uint8_t)c.b, (uint8_t)c.a);
+	}
+	image::ImagePtr image = image::createEmptyImage("thumbnail");
+	if (!image->loadRGBA((const uint8_t *)rgba.data(), size.x, size.y)) {
+		Log::error("Failed to create the thumbnail image");
+		return image::ImagePtr();
+	}
+	return image;
+}
+
+} // namespace voxelrender
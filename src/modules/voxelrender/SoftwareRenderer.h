@@ -0,0 +1,118 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/DynamicArray.h"
+#include "image/Image.h"
+#include "palette/Palette.h"
+#include "scenegraph/SceneGraphAnimation.h"
+#include "voxel/ChunkMesh.h"
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/ext/vector_int2_sized.hpp>
+
+namespace scenegraph {
+class SceneGraph;
+}
+
+namespace video {
+class Camera;
+}
+
+namespace voxelrender {
+
+/**
+ * @brief Renders the model nodes of a scene graph on the cpu - there is no graphics context needed
+ *
+ * The meshes of the nodes are extracted once and can be rendered from different cameras afterwards (e.g. for a
+ * turntable). The image is split into tiles - the triangles are binned into the tiles they overlap and each tile is
+ * rasterized on its own worker thread with its part of the z-buffer. The colors are taken from the node palettes and
+ * shaded by a directional light and the ambient occlusion values of the vertices.
+ *
+ * The edge functions are evaluated in fixed point with the top-left fill rule - pixels on an edge that is shared by
+ * two triangles are only drawn once. The transparent triangles are sorted back to front and blended after the opaque
+ * ones.
+ *
+ * @sa volumeThumbnail()
+ */
+class SoftwareRenderer {
+public:
+	static constexpr int TileSize = 32;
+	static constexpr int SubPixelBits = 8;
+	static constexpr int64_t SubPixelScale = (int64_t)1 << SubPixelBits;
+
+	/**
+	 * @brief A triangle in screen space
+	 */
+	struct Triangle {
+		glm::vec2 pos[3];
+		/** the positions snapped to the sub pixel grid - the vertices are in clockwise order on the screen */
+		glm::i64vec2 fixedPos[3];
+		/** normalized device depth */
+		float depth[3];
+		float ambientOcclusion[3];
+		/** shaded color and alpha of the triangle */
+		glm::vec4 color;
+		/** the inclusive pixel bounds */
+		glm::ivec4 bounds;
+	};
+
+private:
+	struct NodeMesh {
+		voxel::ChunkMesh mesh{0, 0, true};
+		palette::Palette palette;
+	};
+
+	struct Instance {
+		int meshIdx;
+		glm::mat4 model;
+		glm::vec3 pivot;
+		/** an odd amount of negative scale axes changes the winding order of the triangles */
+		bool mirrored;
+	};
+
+	core::DynamicArray<NodeMesh> _meshes;
+	core::DynamicArray<Instance> _instances;
+	glm::vec3 _lightDir;
+	bool _backfaceCulling = true;
+
+	void setupTriangles(const video::Camera &camera, core::DynamicArray<Triangle> &triangles,
+						size_t &firstTransparent) const;
+
+public:
+	SoftwareRenderer();
+
+	/**
+	 * @brief Extracts the meshes of the visible model nodes and collects the transforms of the model and reference
+	 * nodes for the given frame
+	 */
+	void setSceneGraph(const scenegraph::SceneGraph &sceneGraph, scenegraph::FrameIndex frameIdx = 0);
+	void clear();
+
+	/**
+	 * @return The image in the size of the camera - @c nullptr if the camera size is invalid
+	 */
+	image::ImagePtr render(const video::Camera &camera, const glm::vec4 &clearColor) const;
+
+	/**
+	 * @brief The back faces are not visible for closed meshes - skipping them is just an optimization
+	 */
+	void setBackfaceCulling(bool backfaceCulling);
+	void setLightDirection(const glm::vec3 &lightDir);
+
+	size_t instances() const;
+};
+
+inline void SoftwareRenderer::setBackfaceCulling(bool backfaceCulling) {
+	_backfaceCulling = backfaceCulling;
+}
+
+inline size_t SoftwareRenderer::instances() const {
+	return _instances.size();
+}
+
+} // namespace voxelrender
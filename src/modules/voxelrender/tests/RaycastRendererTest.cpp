@@ -0,0 +1,116 @@
+/**
+ * @file
+ */
+
+#include "voxelrender/RaycastRenderer.h"
+#include "app/tests/AbstractTest.h"
+#include "palette/Palette.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "video/Camera.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Voxel.h"
+#include "voxelrender/SceneGraphRenderer.h"
+#include "voxelrender/SoftwareRenderer.h"
+
+namespace voxelrender {
+
+class RaycastRendererTest : public app::AbstractTest {
+protected:
+	const glm::vec4 _clearColor{0.0f, 0.0f, 1.0f, 1.0f};
+	const core::RGBA _clearRGBA{0, 0, 255, 255};
+
+	void createSceneGraph(scenegraph::SceneGraph &sceneGraph, voxel::RawVolume *volume) {
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(volume, true);
+		palette::Palette palette;
+		palette.nippon();
+		node.setPalette(palette);
+		sceneGraph.emplace(core::move(node));
+	}
+
+	video::Camera camera(const scenegraph::SceneGraph &sceneGraph, int size) {
+		video::Camera camera;
+		camera.setSize(glm::ivec2(size));
+		camera.setMode(video::CameraMode::Perspective);
+		camera.setType(video::CameraType::Free);
+		configureCamera(camera, sceneGraph.sceneRegion(), SceneCameraMode::Free, 5000.0f, {0.0f, 0.0f, 0.0f});
+		camera.update(0.001);
+		return camera;
+	}
+};
+
+TEST_F(RaycastRendererTest, testOccupancyMip) {
+	voxel::RawVolume volume(voxel::Region(0, 0, 0, 9, 4, 2));
+	volume.setVoxel(7, 3, 1, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	RaycastRenderer::OccupancyMip mip;
+	mip.build(&volume);
+	ASSERT_EQ(4, mip.maxLevel());
+	EXPECT_EQ(glm::ivec3(5, 3, 2), mip.dimensions[1]);
+	EXPECT_EQ(glm::ivec3(1, 1, 1), mip.dimensions[4]);
+	EXPECT_TRUE(mip.occupied(1, glm::ivec3(3, 1, 0)));
+	EXPECT_FALSE(mip.occupied(1, glm::ivec3(2, 1, 0)));
+	EXPECT_TRUE(mip.occupied(2, glm::ivec3(1, 0, 0)));
+	EXPECT_FALSE(mip.occupied(2, glm::ivec3(0, 0, 0)));
+	EXPECT_TRUE(mip.occupied(4, glm::ivec3(0, 0, 0)));
+	EXPECT_TRUE(mip.solid(glm::ivec3(7, 3, 1)));
+	EXPECT_FALSE(mip.solid(glm::ivec3(7, 3, 2)));
+	EXPECT_FALSE(mip.solid(glm::ivec3(-1, 0, 0)));
+}
+
+TEST_F(RaycastRendererTest, testEmptyVolume) {
+	scenegraph::SceneGraph sceneGraph;
+	createSceneGraph(sceneGraph, new voxel::RawVolume(voxel::Region(0, 7)));
+	RaycastRenderer renderer;
+	renderer.setSceneGraph(sceneGraph);
+	EXPECT_EQ(1u, renderer.instances());
+	const image::ImagePtr &image = renderer.render(camera(sceneGraph, 16), _clearColor);
+	ASSERT_TRUE(image);
+	for (int y = 0; y < image->height(); ++y) {
+		for (int x = 0; x < image->width(); ++x) {
+			ASSERT_EQ(_clearRGBA, image->colorAt(x, y)) << "pixel " << x << ":" << y;
+		}
+	}
+}
+
+TEST_F(RaycastRendererTest, testCoverageMatchesSoftwareRenderer) {
+	scenegraph::SceneGraph sceneGraph;
+	voxel::RawVolume *volume = new voxel::RawVolume(voxel::Region(0, 15));
+	for (int z = 2; z < 12; ++z) {
+		for (int y = 0; y < 6; ++y) {
+			for (int x = 4; x < 14; ++x) {
+				if ((x + y + z) % 3 != 0) {
+					volume->setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+				}
+			}
+		}
+	}
+	createSceneGraph(sceneGraph, volume);
+	const video::Camera &cam = camera(sceneGraph, 64);
+
+	RaycastRenderer raycastRenderer;
+	raycastRenderer.setSceneGraph(sceneGraph);
+	const image::ImagePtr &raycast = raycastRenderer.render(cam, _clearColor);
+	ASSERT_TRUE(raycast);
+
+	SoftwareRenderer softwareRenderer;
+	softwareRenderer.setSceneGraph(sceneGraph);
+	const image::ImagePtr &software = softwareRenderer.render(cam, _clearColor);
+	ASSERT_TRUE(software);
+
+	// the pixel centers at the silhouette might be sampled differently
+	int covered = 0;
+	int mismatches = 0;
+	for (int y = 0; y < raycast->height(); ++y) {
+		for (int x = 0; x < raycast->width(); ++x) {
+			const bool raycastCovered = raycast->colorAt(x, y) != _clearRGBA;
+			const bool softwareCovered = software->colorAt(x, y) != _clearRGBA;
+			covered += raycastCovered;
+			mismatches += raycastCovered != softwareCovered;
+		}
+	}
+	EXPECT_GT(covered, 100);
+	EXPECT_LT(mismatches, covered / 20);
+}
+
+} // namespace voxelrender
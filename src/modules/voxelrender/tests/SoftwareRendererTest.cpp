@@ -0,0 +1,161 @@
+/**
+ * @file
+ */
+
+#include "voxelrender/SoftwareRenderer.h"
+#include "app/tests/AbstractTest.h"
+#include "palette/Palette.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "video/Camera.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Voxel.h"
+#include "voxelrender/SceneGraphRenderer.h"
+
+namespace voxelrender {
+
+class SoftwareRendererTest : public app::AbstractTest {
+protected:
+	const glm::vec4 _clearColor{0.0f, 0.0f, 1.0f, 1.0f};
+
+	void createSceneGraph(scenegraph::SceneGraph &sceneGraph) {
+		voxel::RawVolume *volume = new voxel::RawVolume(voxel::Region(0, 3));
+		volume->setVoxel(1, 1, 1, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+		volume->setVoxel(2, 1, 1, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+		volume->setVoxel(1, 2, 1, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+		volume->setVoxel(1, 1, 2, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(volume, true);
+		palette::Palette palette;
+		palette.nippon();
+		node.setPalette(palette);
+		sceneGraph.emplace(core::move(node));
+	}
+
+	video::Camera camera(const scenegraph::SceneGraph &sceneGraph, int size) {
+		video::Camera camera;
+		camera.setSize(glm::ivec2(size));
+		camera.setMode(video::CameraMode::Perspective);
+		camera.setType(video::CameraType::Free);
+		configureCamera(camera, sceneGraph.sceneRegion(), SceneCameraMode::Free, 5000.0f, {0.0f, 0.0f, 0.0f});
+		camera.update(0.001);
+		return camera;
+	}
+
+	void addTransparentNode(scenegraph::SceneGraph &sceneGraph, const voxel::Region &region, const core::RGBA &color) {
+		voxel::RawVolume *volume = new voxel::RawVolume(voxel::Region(0, 3));
+		const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Transparent, 1);
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					volume->setVoxel(x, y, z, voxel);
+				}
+			}
+		}
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(volume, true);
+		palette::Palette palette;
+		palette.nippon();
+		palette.setColor(1, color);
+		node.setPalette(palette);
+		sceneGraph.emplace(core::move(node));
+	}
+
+	core::RGBA pixel(const image::ImagePtr &image, int x, int y) const {
+		return image->colorAt(x, y);
+	}
+};
+
+TEST_F(SoftwareRendererTest, testEmptySceneGraph) {
+	scenegraph::SceneGraph sceneGraph;
+	SoftwareRenderer renderer;
+	renderer.setSceneGraph(sceneGraph);
+	EXPECT_EQ(0u, renderer.instances());
+	const video::Camera &cam = camera(sceneGraph, 16);
+	const image::ImagePtr &image = renderer.render(cam, _clearColor);
+	ASSERT_TRUE(image);
+	ASSERT_EQ(16, image->width());
+	ASSERT_EQ(16, image->height());
+	EXPECT_EQ(core::RGBA(0, 0, 255, 255), pixel(image, 8, 8));
+}
+
+TEST_F(SoftwareRendererTest, testRender) {
+	scenegraph::SceneGraph sceneGraph;
+	createSceneGraph(sceneGraph);
+	SoftwareRenderer renderer;
+	renderer.setSceneGraph(sceneGraph);
+	EXPECT_EQ(1u, renderer.instances());
+	const video::Camera &cam = camera(sceneGraph, 64);
+	const image::ImagePtr &image = renderer.render(cam, _clearColor);
+	ASSERT_TRUE(image);
+	EXPECT_NE(core::RGBA(0, 0, 255, 255), pixel(image, 32, 32));
+	EXPECT_EQ(core::RGBA(0, 0, 255, 255), pixel(image, 0, 0));
+}
+
+TEST_F(SoftwareRendererTest, testBackfaceCulling) {
+	scenegraph::SceneGraph sceneGraph;
+	createSceneGraph(sceneGraph);
+	SoftwareRenderer renderer;
+	renderer.setSceneGraph(sceneGraph);
+	const video::Camera &cam = camera(sceneGraph, 64);
+	const image::ImagePtr &culled = renderer.render(cam, _clearColor);
+	renderer.setBackfaceCulling(false);
+	const image::ImagePtr &unculled = renderer.render(cam, _clearColor);
+	ASSERT_TRUE(culled);
+	ASSERT_TRUE(unculled);
+	// the mesh is closed - the back faces are hidden by the depth test anyway
+	for (int y = 0; y < culled->height(); ++y) {
+		for (int x = 0; x < culled->width(); ++x) {
+			ASSERT_EQ(pixel(culled, x, y), pixel(unculled, x, y)) << "pixel " << x << ":" << y;
+		}
+	}
+}
+
+TEST_F(SoftwareRendererTest, testTransparentFillRule) {
+	scenegraph::SceneGraph sceneGraph;
+	addTransparentNode(sceneGraph, voxel::Region(1, 1), core::RGBA(255, 0, 0, 128));
+	SoftwareRenderer renderer;
+	renderer.setSceneGraph(sceneGraph);
+	const video::Camera &cam = camera(sceneGraph, 64);
+	const image::ImagePtr &image = renderer.render(cam, glm::vec4(0.0f));
+	ASSERT_TRUE(image);
+	const uint8_t alpha = pixel(image, 32, 32).a;
+	ASSERT_NE(0u, alpha);
+	// the front faces of the voxel cover every pixel exactly once - shared edges must not be blended twice
+	for (int y = 0; y < image->height(); ++y) {
+		for (int x = 0; x < image->width(); ++x) {
+			const uint8_t a = pixel(image, x, y).a;
+			ASSERT_TRUE(a == 0u || a == alpha) << "pixel " << x << ":" << y << " has alpha " << (int)a;
+		}
+	}
+}
+
+TEST_F(SoftwareRendererTest, testTransparentSorting) {
+	// the inner cube is always behind the front faces of the outer cube
+	const voxel::Region outer(0, 3);
+	const voxel::Region inner(1, 2);
+	scenegraph::SceneGraph sceneGraph1;
+	addTransparentNode(sceneGraph1, outer, core::RGBA(255, 0, 0, 128));
+	addTransparentNode(sceneGraph1, inner, core::RGBA(0, 255, 0, 128));
+	scenegraph::SceneGraph sceneGraph2;
+	addTransparentNode(sceneGraph2, inner, core::RGBA(0, 255, 0, 128));
+	addTransparentNode(sceneGraph2, outer, core::RGBA(255, 0, 0, 128));
+
+	SoftwareRenderer renderer1;
+	renderer1.setSceneGraph(sceneGraph1);
+	SoftwareRenderer renderer2;
+	renderer2.setSceneGraph(sceneGraph2);
+	const video::Camera &cam = camera(sceneGraph1, 64);
+	const image::ImagePtr &image1 = renderer1.render(cam, _clearColor);
+	const image::ImagePtr &image2 = renderer2.render(cam, _clearColor);
+	ASSERT_TRUE(image1);
+	ASSERT_TRUE(image2);
+	// the transparent triangles are blended back to front - the order of the nodes doesn't matter
+	for (int y = 0; y < image1->height(); ++y) {
+		for (int x = 0; x < image1->width(); ++x) {
+			ASSERT_EQ(pixel(image1, x, y), pixel(image2, x, y)) << "pixel " << x << ":" << y;
+		}
+	}
+}
+
+} // namespace voxelrender
@@ -9,6 +9,7 @@
 #include "math/Axis.h"
 #include "voxel/Face.h"
 #include "voxel/Region.h"
+#include <type_traits>
 
 namespace voxelutil {
 
@@ -102,21 +103,38 @@ struct EmptyVisitor {
 		++cnt;                                                                                                         \
 	}
 
-template<class Volume, class Visitor, typename Condition = SkipEmpty>
-int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int yOff, int zOff, Visitor &&visitor,
-				Condition condition = Condition(), VisitorOrder order = VisitorOrder::ZYX) {
+namespace priv {
+
+/**
+ * @brief Resolves to the @c InteriorSampler of the volume if there is one - e.g. @c voxel::RawVolume::InteriorSampler
+ */
+template<class Volume, class = void>
+struct InteriorSampler {
+	using type = typename Volume::Sampler;
+};
+
+template<class Volume>
+struct InteriorSampler<Volume, std::void_t<typename Volume::InteriorSampler>> {
+	using type = typename Volume::InteriorSampler;
+};
+
+} // namespace priv
+
+template<class Sampler, class Volume, class Visitor, typename Condition>
+int visitVolumeSampler(const Volume &volume, const voxel::Region &region, int xOff, int yOff, int zOff,
+					   Visitor &&visitor, Condition condition, VisitorOrder order) {
 	core_trace_scoped(VisitVolume);
 	int cnt = 0;
 
-	typename Volume::Sampler sampler(volume);
+	Sampler sampler(volume);
 
 	switch (order) {
 	case VisitorOrder::XYZ:
 		sampler.setPosition(region.getLowerCorner());
 		for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x += xOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y += yOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z += zOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.movePositiveZ(zOff);
@@ -130,9 +148,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::ZYX:
 		sampler.setPosition(region.getLowerCorner());
 		for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z += zOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y += yOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x += xOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.movePositiveX(xOff);
@@ -146,9 +164,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::ZXY:
 		sampler.setPosition(region.getLowerCorner());
 		for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z += zOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x += xOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y += yOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.movePositiveY(yOff);
@@ -162,9 +180,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::XZY:
 		sampler.setPosition(region.getLowerCorner());
 		for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x += xOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z += zOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y += yOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.movePositiveY(yOff);
@@ -178,9 +196,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::XZmY:
 		sampler.setPosition(region.getLowerX(), region.getUpperY(), region.getLowerZ());
 		for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x += xOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z += zOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t y = region.getUpperY(); y >= region.getLowerY(); y -= yOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.moveNegativeY(yOff);
@@ -194,9 +212,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::mXmZY:
 		sampler.setPosition(region.getUpperX(), region.getLowerY(), region.getUpperZ());
 		for (int32_t x = region.getUpperX(); x >= region.getLowerX(); x -= xOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t z = region.getUpperZ(); z >= region.getLowerZ(); z -= zOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y += yOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.movePositiveY(yOff);
@@ -210,9 +228,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::mXZY:
 		sampler.setPosition(region.getUpperX(), region.getLowerY(), region.getLowerZ());
 		for (int32_t x = region.getUpperX(); x >= region.getLowerX(); x -= xOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z += zOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y += yOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.movePositiveY(yOff);
@@ -226,9 +244,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::XmZY:
 		sampler.setPosition(region.getLowerX(), region.getLowerY(), region.getUpperZ());
 		for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x += xOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t z = region.getUpperZ(); z >= region.getLowerZ(); z -= zOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y += yOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.movePositiveY(yOff);
@@ -242,9 +260,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::XmZmY:
 		sampler.setPosition(region.getLowerX(), region.getUpperY(), region.getUpperZ());
 		for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x += xOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t z = region.getUpperZ(); z >= region.getLowerZ(); z -= zOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t y = region.getUpperY(); y >= region.getLowerY(); y -= yOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.moveNegativeY(yOff);
@@ -258,9 +276,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::mXmZmY:
 		sampler.setPosition(region.getUpperX(), region.getUpperY(), region.getUpperZ());
 		for (int32_t x = region.getUpperX(); x >= region.getLowerX(); x -= xOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t z = region.getUpperZ(); z >= region.getLowerZ(); z -= zOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t y = region.getUpperY(); y >= region.getLowerY(); y -= yOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.moveNegativeY(yOff);
@@ -274,9 +292,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::mXZmY:
 		sampler.setPosition(region.getUpperX(), region.getUpperY(), region.getLowerZ());
 		for (int32_t x = region.getUpperX(); x >= region.getLowerX(); x -= xOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z += zOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t y = region.getUpperY(); y >= region.getLowerY(); y -= yOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.moveNegativeY(yOff);
@@ -290,9 +308,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::YXZ:
 		sampler.setPosition(region.getLowerCorner());
 		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y += yOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x += xOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z += zOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.movePositiveZ(zOff);
@@ -306,9 +324,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::YZX:
 		sampler.setPosition(region.getLowerCorner());
 		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y += yOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z += zOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x += xOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.movePositiveX(xOff);
@@ -322,9 +340,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::YZmX:
 		sampler.setPosition(region.getUpperX(), region.getLowerY(), region.getLowerZ());
 		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y += yOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z += zOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t x = region.getUpperX(); x >= region.getLowerX(); x -= xOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.moveNegativeX(xOff);
@@ -338,9 +356,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::mYZX:
 		sampler.setPosition(region.getLowerX(), region.getUpperY(), region.getLowerZ());
 		for (int32_t y = region.getUpperY(); y >= region.getLowerY(); y -= yOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z += zOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x += xOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.movePositiveX(xOff);
@@ -354,9 +372,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::mYmXZ:
 		sampler.setPosition(region.getUpperX(), region.getUpperY(), region.getLowerZ());
 		for (int32_t y = region.getUpperY(); y >= region.getLowerY(); y -= yOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t x = region.getUpperX(); x >= region.getLowerX(); x -= xOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z += zOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.movePositiveZ(zOff);
@@ -370,9 +388,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::mYXmZ:
 		sampler.setPosition(region.getLowerX(), region.getUpperY(), region.getUpperZ());
 		for (int32_t y = region.getUpperY(); y >= region.getLowerY(); y -= yOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x += xOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t z = region.getUpperZ(); z >= region.getLowerZ(); z -= zOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.moveNegativeZ(zOff);
@@ -386,9 +404,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::mYmZmX:
 		sampler.setPosition(region.getUpperX(), region.getUpperY(), region.getUpperZ());
 		for (int32_t y = region.getUpperY(); y >= region.getLowerY(); y -= yOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t z = region.getUpperZ(); z >= region.getLowerZ(); z -= zOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t x = region.getUpperX(); x >= region.getLowerX(); x -= xOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.moveNegativeX(xOff);
@@ -402,9 +420,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::mZmXmY:
 		sampler.setPosition(region.getUpperX(), region.getUpperY(), region.getUpperZ());
 		for (int32_t z = region.getUpperZ(); z >= region.getLowerZ(); z -= zOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t x = region.getUpperX(); x >= region.getLowerX(); x -= xOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t y = region.getUpperY(); y >= region.getLowerY(); y -= yOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.moveNegativeY(yOff);
@@ -418,9 +436,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::ZmXY:
 		sampler.setPosition(region.getUpperX(), region.getLowerY(), region.getLowerZ());
 		for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z += zOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t x = region.getUpperX(); x >= region.getLowerX(); x -= xOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y += yOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.movePositiveY(yOff);
@@ -434,9 +452,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::YXmZ:
 		sampler.setPosition(region.getLowerX(), region.getLowerY(), region.getUpperZ());
 		for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y += yOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x += xOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t z = region.getUpperZ(); z >= region.getLowerZ(); z -= zOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.moveNegativeZ(zOff);
@@ -450,9 +468,9 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	case VisitorOrder::ZXmY:
 		sampler.setPosition(region.getLowerX(), region.getUpperY(), region.getLowerZ());
 		for (int32_t z = region.getLowerZ(); z <= region.getUpperZ(); z += zOff) {
-			typename Volume::Sampler sampler2 = sampler;
+			Sampler sampler2 = sampler;
 			for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x += xOff) {
-				typename Volume::Sampler sampler3 = sampler2;
+				Sampler sampler3 = sampler2;
 				for (int32_t y = region.getUpperY(); y >= region.getLowerY(); y -= yOff) {
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.moveNegativeY(yOff);
@@ -471,6 +489,20 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	return cnt;
 }
 
+/**
+ * @brief Visit all voxels of the given region - if the region is inside the volume region, the sampler is moved
+ * without any bounds checks
+ */
+template<class Volume, class Visitor, typename Condition = SkipEmpty>
+int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int yOff, int zOff, Visitor &&visitor,
+				Condition condition = Condition(), VisitorOrder order = VisitorOrder::ZYX) {
+	if (volume.region().containsRegion(region)) {
+		return visitVolumeSampler<typename priv::InteriorSampler<Volume>::type>(volume, region, xOff, yOff, zOff,
+																				 visitor, condition, order);
+	}
+	return visitVolumeSampler<typename Volume::Sampler>(volume, region, xOff, yOff, zOff, visitor, condition, order);
+}
+
 template<class Volume, class Visitor, typename Condition = SkipEmpty>
 int visitVolume(const Volume &volume, int xOff, int yOff, int zOff, Visitor &&visitor,
 				Condition condition = Condition(), VisitorOrder order = VisitorOrder::ZYX) {
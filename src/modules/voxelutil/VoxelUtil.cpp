@@ -5,16 +5,19 @@
 #include "VoxelUtil.h"
 #include "core/GLM.h"
 #include "core/Log.h"
+#include "core/Trace.h"
 #include "core/collection/Array3DView.h"
 #include "core/collection/Buffer.h"
 #include "core/collection/DynamicArray.h"
 #include "core/collection/Set.h"
+#include "core/concurrent/Lock.h"
 #include <glm/geometric.hpp>
 #include "math/Axis.h"
 #include "palette/Palette.h"
 #include "palette/PaletteLookup.h"
 #include "voxel/Face.h"
 #include "voxel/ModificationRecorder.h"
+#include "voxel/ParallelFor.h"
 #include "voxel/RawVolume.h"
 #include "voxel/RawVolumeWrapper.h"
 #include "voxel/Region.h"
@@ -636,17 +639,38 @@ voxel::Region remapToPalette(voxel::RawVolume *volume, const palette::Palette &o
 	if (volume == nullptr) {
 		return voxel::Region::InvalidRegion;
 	}
-	voxel::RawVolumeWrapper wrapper(volume);
-	voxelutil::visitVolume(
-		wrapper, [&wrapper, &newPalette, skipColorIndex, &oldPalette](int x, int y, int z, const voxel::Voxel &voxel) {
-			const core::RGBA rgba = oldPalette.color(voxel.getColor());
-			const int newColor = newPalette.getClosestMatch(rgba, skipColorIndex);
-			if (newColor != palette::PaletteColorNotFound) {
-				voxel::Voxel newVoxel(voxel::VoxelType::Generic, newColor, voxel.getNormal(), voxel.getFlags());
-				wrapper.setVoxel(x, y, z, newVoxel);
+	core_trace_scoped(RemapToPalette);
+	// the closest match only depends on the color index - look it up once per palette color
+	int newColors[palette::PaletteMaxColors];
+	for (int i = 0; i < palette::PaletteMaxColors; ++i) {
+		newColors[i] = newPalette.getClosestMatch(oldPalette.color(i), skipColorIndex);
+	}
+	core_trace_mutex(core::Lock, lock, "RemapToPalette");
+	voxel::Region dirtyRegion = voxel::Region::InvalidRegion;
+	voxel::parallelFor(
+		volume->region(),
+		[volume, &newColors, &lock, &dirtyRegion](const voxel::Region &slab) {
+			voxel::RawVolumeWrapper wrapper(volume);
+			voxelutil::visitVolume(wrapper, slab, [&wrapper, &newColors](int x, int y, int z, const voxel::Voxel &voxel) {
+				const int newColor = newColors[voxel.getColor()];
+				if (newColor != palette::PaletteColorNotFound) {
+					voxel::Voxel newVoxel(voxel::VoxelType::Generic, newColor, voxel.getNormal(), voxel.getFlags());
+					wrapper.setVoxel(x, y, z, newVoxel);
+				}
+			});
+			const voxel::Region &slabDirtyRegion = wrapper.dirtyRegion();
+			if (!slabDirtyRegion.isValid()) {
+				return;
+			}
+			core::ScopedLock scoped(lock);
+			if (dirtyRegion.isValid()) {
+				dirtyRegion.accumulate(slabDirtyRegion);
+			} else {
+				dirtyRegion = slabDirtyRegion;
 			}
-		});
-	return wrapper.dirtyRegion();
+		},
+		16);
+	return dirtyRegion;
 }
 
 voxel::RawVolume *diffVolumes(const voxel::RawVolume *v1, const voxel::RawVolume *v2) {
@@ -235,4 +235,25 @@ TEST_F(VoxelUtilTest, testFillPlaneWithImage) {
 	}
 }
 
+TEST_F(VoxelUtilTest, testRemapToPalette) {
+	palette::Palette oldPalette;
+	oldPalette.setSize(2);
+	oldPalette.setColor(0, core::RGBA(255, 0, 0));
+	oldPalette.setColor(1, core::RGBA(0, 255, 0));
+	palette::Palette newPalette;
+	newPalette.setSize(2);
+	newPalette.setColor(0, core::RGBA(0, 250, 0));
+	newPalette.setColor(1, core::RGBA(250, 0, 0));
+
+	// deep enough to get split into several slabs
+	voxel::RawVolume volume(voxel::Region(glm::ivec3(0), glm::ivec3(3, 3, 63)));
+	volume.setVoxel(0, 0, 0, voxel::createVoxel(oldPalette, 0));
+	volume.setVoxel(1, 2, 40, voxel::createVoxel(oldPalette, 1));
+	const voxel::Region dirtyRegion = voxelutil::remapToPalette(&volume, oldPalette, newPalette);
+	EXPECT_EQ(voxel::Region(glm::ivec3(0, 0, 0), glm::ivec3(1, 2, 40)), dirtyRegion);
+	EXPECT_EQ(1, volume.voxel(0, 0, 0).getColor());
+	EXPECT_EQ(0, volume.voxel(1, 2, 40).getColor());
+	EXPECT_TRUE(voxel::isAir(volume.voxel(1, 1, 1).getMaterial()));
+}
+
 } // namespace voxelutil
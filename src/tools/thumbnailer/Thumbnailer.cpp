@@ -70,11 +70,28 @@ app::AppState Thumbnailer::onConstruct() {
 	for (int i = 0; i < (int)voxelrender::SceneCameraMode::Max; ++i) {
 		cameraMode.addValidValue(voxelrender::SceneCameraModeStr[i]);
 	}
+	Argument &renderer =
+		registerArg("--renderer")
+			.setShort("-r")
+			.setDefaultValue(voxelrender::ThumbnailRendererStr[(int)voxelrender::ThumbnailRenderer::OpenGL])
+			.setDescription("The software and raycast renderers don't need a graphics context and can be used headless");
+	for (int i = 0; i < (int)voxelrender::ThumbnailRenderer::Max; ++i) {
+		renderer.addValidValue(voxelrender::ThumbnailRendererStr[i]);
+	}
 
 	return state;
 }
 
 app::AppState Thumbnailer::onInit() {
+	const core::String &renderer = getArgVal("--renderer", voxelrender::ThumbnailRendererStr[(int)_renderer]);
+	for (int i = 0; i < (int)voxelrender::ThumbnailRenderer::Max; ++i) {
+		if (core::string::iequals(renderer, voxelrender::ThumbnailRendererStr[i])) {
+			_renderer = (voxelrender::ThumbnailRenderer)i;
+			break;
+		}
+	}
+	// the cpu renderers don't need a window or a graphics context
+	_headless = _renderer != voxelrender::ThumbnailRenderer::OpenGL;
 	const app::AppState state = Super::onInit();
 
 	if (state != app::AppState::Running) {
@@ -99,7 +116,7 @@ app::AppState Thumbnailer::onInit() {
 }
 
 static image::ImagePtr volumeThumbnail(const core::String &fileName, const io::ArchivePtr &archive,
-									   voxelformat::ThumbnailContext &ctx) {
+									   voxelformat::ThumbnailContext &ctx, voxelrender::ThumbnailRenderer renderer) {
 	voxelformat::LoadContext loadctx;
 	image::ImagePtr image = voxelformat::loadScreenshot(fileName, archive, loadctx);
 	if (image && image->isLoaded()) {
@@ -114,11 +131,11 @@ static image::ImagePtr volumeThumbnail(const core::String &fileName, const io::A
 		return image::ImagePtr();
 	}
 
-	return voxelrender::volumeThumbnail(sceneGraph, ctx);
+	return voxelrender::volumeThumbnail(sceneGraph, ctx, renderer);
 }
 
 static bool volumeTurntable(const core::String &fileName, const core::String &imageFile,
-							voxelformat::ThumbnailContext ctx, int loops) {
+							voxelformat::ThumbnailContext ctx, int loops, voxelrender::ThumbnailRenderer renderer) {
 	scenegraph::SceneGraph sceneGraph;
 	const io::ArchivePtr &archive = io::openFilesystemArchive(io::filesystem());
 	voxelformat::LoadContext loadctx;
@@ -130,12 +147,13 @@ static bool volumeTurntable(const core::String &fileName, const core::String &im
 	}
 
 	Log::info("Render turntable");
-	return voxelrender::volumeTurntable(sceneGraph, imageFile, ctx, loops);
+	return voxelrender::volumeTurntable(sceneGraph, imageFile, ctx, loops, renderer);
 }
 
 app::AppState Thumbnailer::onRunning() {
 	app::AppState state = Super::onRunning();
-	if (state != app::AppState::Running) {
+	// without a window there is only one frame - like for the other console applications
+	if (state != app::AppState::Running && !(_headless && state == app::AppState::Cleanup)) {
 		return state;
 	}
 
@@ -185,14 +203,14 @@ app::AppState Thumbnailer::onRunning() {
 
 	const bool renderTurntable = hasArg("--turntable");
 	if (renderTurntable) {
-		volumeTurntable(_infile->name(), _outfile, ctx, 16);
+		volumeTurntable(_infile->name(), _outfile, ctx, 16, _renderer);
 	} else {
 		const io::ArchivePtr &archive = io::openFilesystemArchive(_filesystem);
 		if (!archive) {
 			Log::error("Failed to open %s for reading", _infile->name().c_str());
 			return app::AppState::Cleanup;
 		}
-		const image::ImagePtr &image = volumeThumbnail(_infile->name(), archive, ctx);
+		const image::ImagePtr &image = volumeThumbnail(_infile->name(), archive, ctx, _renderer);
 		saveImage(image);
 	}
 
@@ -7,6 +7,7 @@
 #include "image/Image.h"
 #include "video/WindowedApp.h"
 #include "io/File.h"
+#include "voxelrender/ImageGenerator.h"
 
 /**
  * @brief This tool is able to generate thumbnails for all supported voxel formats
@@ -24,6 +25,7 @@ private:
 
 	io::FilePtr _infile;
 	core::String _outfile;
+	voxelrender::ThumbnailRenderer _renderer = voxelrender::ThumbnailRenderer::OpenGL;
 
 protected:
 	virtual bool saveImage(const image::ImagePtr &image);
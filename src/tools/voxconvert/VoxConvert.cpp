@@ -13,7 +13,12 @@
 #include "core/collection/DynamicArray.h"
 #include "core/collection/Set.h"
 #include "core/collection/StringSet.h"
+#include "core/concurrent/Atomic.h"
 #include "core/concurrent/Concurrency.h"
+#include "core/concurrent/ConditionVariable.h"
+#include "core/concurrent/Lock.h"
+#include "core/concurrent/TaskGroup.h"
+#include "core/concurrent/ThreadPool.h"
 #include "engine-git.h"
 #include "image/Image.h"
 #include "io/Archive.h"
@@ -86,6 +91,22 @@ app::AppState VoxConvert::onConstruct() {
 		.setDefaultValue("1")
 		.setDescription("Set the palette index that is given to the color script parameters of the main function");
 	registerArg("--split").setDescription("Slices the models into pieces of the given size <x:y:z>");
+	registerArg("--stream").setDescription(
+		"Write the models to the output as soon as they are loaded - the output is split into several files. This "
+		"allows to convert scenes that don't fit into memory (minecraft regions and worlds, sandbox vxm)");
+	registerArg("--memory-budget")
+		.setDefaultValue("512")
+		.setDescription("The amount of voxel data in MB that is kept in memory before --stream writes the next "
+						"output file or --jobs starts the next file. Without these options the volumes of the "
+						"models that were loaded first are compressed if the loaded models exceed the budget");
+	registerArg("--jobs")
+		.setShort("-j")
+		.setDescription("Convert every input file into its own output file with the given amount of parallel jobs. "
+						"A * in --output is replaced by the name of the input file - e.g. 'out/*.qb'");
+	registerArg("--summary")
+		.setDescription("Write a json summary with timings, voxel counts and errors of the --jobs conversion to the "
+						"given file")
+		.addFlag(ARGUMENT_FLAG_FILE);
 	registerArg("--surface-only")
 		.setDescription("Remove any non surface voxel. If you are meshing with this, you get also faces on the inner "
 						"side of your mesh.");
@@ -316,6 +337,7 @@ app::AppState VoxConvert::onInit() {
 	_splitModels = hasArg("--split");
 	_printSceneGraph = hasArg("--json");
 	_resizeModels = hasArg("--resize");
+	_streamModels = hasArg("--stream");
 
 	Log::info("Options");
 	if (inputIsMesh || outputIsMesh) {
@@ -358,6 +380,7 @@ app::AppState VoxConvert::onInit() {
 	Log::info("* export palette:    - %s", (_exportPalette ? "true" : "false"));
 	Log::info("* export models:     - %s", (_exportModels ? "true" : "false"));
 	Log::info("* resize models:     - %s", (_resizeModels ? "true" : "false"));
+	Log::info("* stream models:     - %s", (_streamModels ? "true" : "false"));
 
 	if (core::Var::getSafe(cfg::MetricFlavor)->strVal().empty()) {
 		Log::info(
@@ -380,6 +403,39 @@ app::AppState VoxConvert::onInit() {
 		return app::AppState::InitFailure;
 	}
 
+	if (_streamModels) {
+		if (_exportModels || _exportPalette || _printSceneGraph || _splitModels || outfiles.empty()) {
+			Log::error("--stream needs an output file and doesn't work with --export-models, --export-palette, "
+					   "--json or --split");
+			return app::AppState::InitFailure;
+		}
+		const size_t memoryBudget = (size_t)core_max(1, getArgVal("--memory-budget", "512").toInt()) * 1024u * 1024u;
+		if (!streamInputFiles(infiles, outfiles, scriptParameters, memoryBudget)) {
+			return app::AppState::InitFailure;
+		}
+		return state;
+	}
+
+	if (hasArg("--jobs")) {
+		if (_exportModels || _exportPalette || _printSceneGraph || outfiles.size() != 1u ||
+			!outfiles[0].contains("*")) {
+			Log::error("--jobs needs exactly one output with a * wildcard for the input file name and doesn't work "
+					   "with --export-models, --export-palette or --json");
+			return app::AppState::InitFailure;
+		}
+		const int jobs = core_max(1, getArgVal("--jobs", "1").toInt());
+		const size_t memoryBudget = (size_t)core_max(1, getArgVal("--memory-budget", "512").toInt()) * 1024u * 1024u;
+		if (!batchInputFiles(infiles, outfiles[0], scriptParameters, jobs, memoryBudget)) {
+			return app::AppState::InitFailure;
+		}
+		return state;
+	}
+
+	if (hasArg("--memory-budget")) {
+		_coldStorageBudget = (size_t)core_max(1, getArgVal("--memory-budget", "512").toInt()) * 1024u * 1024u;
+		scenegraph::SceneGraphNode::setColdStorage(true);
+	}
+
 	const io::ArchivePtr &fsArchive = io::openFilesystemArchive(filesystem());
 	scenegraph::SceneGraph sceneGraph;
 	for (const core::String &infile : infiles) {
@@ -500,18 +556,48 @@ app::AppState VoxConvert::onInit() {
 		return state;
 	}
 
+	if (!processSceneGraph(sceneGraph, infilesstr, scriptParameters)) {
+		return app::AppState::InitFailure;
+	}
+
+	for (const core::String &outfile : outfiles) {
+		if (_exportPalette || (!io::isA(outfile, voxelformat::voxelSave()) && io::isA(outfile, io::format::palettes()))) {
+			// if the given format is a palette only format (some voxel formats might have the same
+			// extension - so we check that here)
+			const palette::Palette &palette = sceneGraph.mergePalettes(false);
+			if (!palette.save(outfile.c_str())) {
+				Log::error("Failed to save palette to %s", outfile.c_str());
+				return app::AppState::InitFailure;
+			}
+			Log::info("Saved palette with %i colors to %s", palette.colorCount(), outfile.c_str());
+		} else {
+			Log::debug("Save %i models", (int)sceneGraph.size());
+			voxelformat::SaveContext saveCtx;
+			const io::ArchivePtr &archive = io::openFilesystemArchive(filesystem());
+			if (!voxelformat::saveFormat(sceneGraph, outfile, nullptr, archive, saveCtx)) {
+				Log::error("Failed to write to output file '%s'", outfile.c_str());
+				return app::AppState::InitFailure;
+			}
+			Log::info("Wrote output file %s", outfile.c_str());
+		}
+	}
+	return state;
+}
+
+bool VoxConvert::processSceneGraph(scenegraph::SceneGraph &sceneGraph, const core::String &name,
+								   const core::String &scriptParameters) {
 	if (_mergeModels) {
 		Log::info("Merge models");
 		const scenegraph::SceneGraph::MergedVolumePalette &merged = sceneGraph.merge();
 		if (merged.first == nullptr) {
 			Log::error("Failed to merge models");
-			return app::AppState::InitFailure;
+			return false;
 		}
 		sceneGraph.clear();
 		scenegraph::SceneGraphNode node;
 		node.setPalette(merged.second);
 		node.setVolume(merged.first, true);
-		node.setName(infilesstr);
+		node.setName(name);
 		sceneGraph.emplace(core::move(node));
 	}
 
@@ -551,29 +637,7 @@ app::AppState VoxConvert::onInit() {
 	if (_splitModels) {
 		split(getArgIvec3("--split"), sceneGraph);
 	}
-
-	for (const core::String &outfile : outfiles) {
-		if (_exportPalette || (!io::isA(outfile, voxelformat::voxelSave()) && io::isA(outfile, io::format::palettes()))) {
-			// if the given format is a palette only format (some voxel formats might have the same
-			// extension - so we check that here)
-			const palette::Palette &palette = sceneGraph.mergePalettes(false);
-			if (!palette.save(outfile.c_str())) {
-				Log::error("Failed to save palette to %s", outfile.c_str());
-				return app::AppState::InitFailure;
-			}
-			Log::info("Saved palette with %i colors to %s", palette.colorCount(), outfile.c_str());
-		} else {
-			Log::debug("Save %i models", (int)sceneGraph.size());
-			voxelformat::SaveContext saveCtx;
-			const io::ArchivePtr &archive = io::openFilesystemArchive(filesystem());
-			if (!voxelformat::saveFormat(sceneGraph, outfile, nullptr, archive, saveCtx)) {
-				Log::error("Failed to write to output file '%s'", outfile.c_str());
-				return app::AppState::InitFailure;
-			}
-			Log::info("Wrote output file %s", outfile.c_str());
-		}
-	}
-	return state;
+	return true;
 }
 
 core::String VoxConvert::getFilenameForModelName(const core::String &inputfile, const core::String &modelName,
@@ -619,6 +683,13 @@ bool VoxConvert::handleInputFile(const core::String &infile, const io::ArchivePt
 		parent = sceneGraph.emplace(core::move(groupNode), parent);
 	}
 	scenegraph::addSceneGraphNodes(sceneGraph, newSceneGraph, parent);
+	if (_coldStorageBudget > 0u) {
+		// nobody holds a volume pointer between two input files - the volumes are decompressed again on access
+		const int compressed = sceneGraph.compressInactiveVolumes(_coldStorageBudget);
+		if (compressed > 0) {
+			Log::info("Compressed the volumes of %i models to stay in the memory budget", compressed);
+		}
+	}
 	if (_printSceneGraph) {
 		sceneGraphJson(sceneGraph, getArgVal("--json", "") == "full");
 	}
@@ -626,6 +697,386 @@ bool VoxConvert::handleInputFile(const core::String &infile, const io::ArchivePt
 	return true;
 }
 
+/**
+ * @brief Collects the streamed model nodes until the memory budget is exceeded and writes them into the next part of
+ * the output files
+ */
+class VoxConvert::StreamSink : public voxelformat::NodeSink {
+private:
+	VoxConvert &_app;
+	const core::DynamicArray<core::String> &_outfiles;
+	const core::String &_scriptParameters;
+	const size_t _memoryBudget;
+	scenegraph::SceneGraph _sceneGraph;
+	size_t _bytes = 0;
+	int _part = 0;
+	int _nodes = 0;
+	bool _failed = false;
+
+public:
+	StreamSink(VoxConvert &app, const core::DynamicArray<core::String> &outfiles,
+			   const core::String &scriptParameters, size_t memoryBudget)
+		: _app(app), _outfiles(outfiles), _scriptParameters(scriptParameters), _memoryBudget(memoryBudget) {
+	}
+
+	bool addNode(scenegraph::SceneGraphNode &&node) override {
+		if (_failed || _app.shouldQuit()) {
+			return false;
+		}
+		const voxel::RawVolume *volume = node.volume();
+		if (volume != nullptr) {
+			_bytes += (size_t)volume->region().voxels() * sizeof(voxel::Voxel);
+		}
+		_sceneGraph.emplace(core::move(node));
+		++_nodes;
+		if (_bytes >= _memoryBudget) {
+			return flush();
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Takes over the model nodes of formats that don't support streaming
+	 */
+	bool addSceneGraph(scenegraph::SceneGraph &sceneGraph) {
+		for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter) {
+			scenegraph::SceneGraphNode &node = *iter;
+			scenegraph::SceneGraphNode newNode(scenegraph::SceneGraphNodeType::Model);
+			scenegraph::copyNode(node, newNode, !node.owns());
+			if (node.owns()) {
+				node.releaseOwnership();
+				newNode.setVolume(node.volume(), true);
+			}
+			if (!addNode(core::move(newNode))) {
+				return false;
+			}
+		}
+		sceneGraph.clear();
+		return true;
+	}
+
+	/**
+	 * @brief Writes the collected nodes into the next part of the output files and releases them
+	 */
+	bool flush() {
+		if (_sceneGraph.empty()) {
+			return !_failed;
+		}
+		if (!_app.processSceneGraph(_sceneGraph, core::string::format("part-%i", _part), _scriptParameters)) {
+			_failed = true;
+			return false;
+		}
+		const bool force = _app.hasArg("--force");
+		for (const core::String &outfile : _outfiles) {
+			const core::String &filename =
+				core::string::format("%s-%i.%s", core::string::stripExtension(outfile).c_str(), _part,
+									 core::string::extractExtension(outfile).c_str());
+			if (!force && _app.filesystem()->open(filename)->exists()) {
+				Log::error("Given output file '%s' already exists", filename.c_str());
+				_failed = true;
+				return false;
+			}
+			voxelformat::SaveContext saveCtx;
+			const io::ArchivePtr &archive = io::openFilesystemArchive(_app.filesystem());
+			if (!voxelformat::saveFormat(_sceneGraph, filename, nullptr, archive, saveCtx)) {
+				Log::error("Failed to write to output file '%s'", filename.c_str());
+				_failed = true;
+				return false;
+			}
+			Log::info("Wrote output file %s with %i models", filename.c_str(),
+					  (int)_sceneGraph.size(scenegraph::SceneGraphNodeType::Model));
+		}
+		_sceneGraph.clear();
+		_bytes = 0;
+		++_part;
+		return true;
+	}
+
+	inline int nodes() const {
+		return _nodes;
+	}
+};
+
+bool VoxConvert::streamInputFiles(const core::DynamicArray<core::String> &infiles,
+								  const core::DynamicArray<core::String> &outfiles,
+								  const core::String &scriptParameters, size_t memoryBudget) {
+	Log::info("Stream models with a memory budget of %i MB", (int)(memoryBudget / 1024u / 1024u));
+	core::DynamicArray<core::String> inputs;
+	for (const core::String &infile : infiles) {
+		if (filesystem()->sysIsReadableDir(infile)) {
+			core::DynamicArray<io::FilesystemEntry> entities;
+			filesystem()->list(infile, entities, getArgVal("--wildcard", ""));
+			for (const io::FilesystemEntry &entry : entities) {
+				if (entry.type == io::FilesystemEntry::Type::file) {
+					inputs.push_back(core::string::path(infile, entry.name));
+				}
+			}
+		} else if (io::isZipArchive(infile)) {
+			Log::error("Archives are not supported in streaming mode: %s", infile.c_str());
+			return false;
+		} else {
+			inputs.push_back(infile);
+		}
+	}
+
+	StreamSink sink(*this, outfiles, scriptParameters, memoryBudget);
+	const io::ArchivePtr &fsArchive = io::openFilesystemArchive(filesystem());
+	for (const core::String &infile : inputs) {
+		if (shouldQuit()) {
+			break;
+		}
+		Log::info("-- current input file: %s", infile.c_str());
+		scenegraph::SceneGraph newSceneGraph;
+		voxelformat::LoadContext loadCtx;
+		loadCtx.monitor = printProgress;
+		loadCtx.nodeSink = &sink;
+		loadCtx.memoryBudget = memoryBudget;
+		io::FileDescription fileDesc;
+		fileDesc.set(infile);
+		if (!voxelformat::loadFormat(fileDesc, fsArchive, newSceneGraph, loadCtx)) {
+			Log::error("Failed to stream input file %s", infile.c_str());
+			return false;
+		}
+		if (!sink.addSceneGraph(newSceneGraph)) {
+			return false;
+		}
+	}
+	if (!sink.flush()) {
+		return false;
+	}
+	if (sink.nodes() == 0) {
+		Log::error("No valid input found to operate on.");
+		return false;
+	}
+	Log::info("Streamed %i models", sink.nodes());
+	return true;
+}
+
+/**
+ * @brief The result of the conversion of a single input file in batch mode
+ */
+struct BatchJob {
+	core::String input;
+	core::String output;
+	core::String error;
+	bool success = false;
+	double loadMillis = 0.0;
+	double processMillis = 0.0;
+	double saveMillis = 0.0;
+	int models = 0;
+	int voxels = 0;
+};
+
+static double millisSince(uint64_t start) {
+	const uint64_t end = core::TimeProvider::highResTime();
+	return (double)(end - start) * 1000.0 / (double)core::TimeProvider::highResTimeResolution();
+}
+
+static core::String jsonEscape(const core::String &str) {
+	return core::string::replaceAll(core::string::replaceAll(str, "\\", "\\\\"), "\"", "\\\"");
+}
+
+/**
+ * @brief Memory that is reserved by the running batch jobs
+ *
+ * A job reserves an estimate before it loads its file and corrects the reservation to the voxel data that was really
+ * loaded. Jobs that don't fit into the budget are blocked until other jobs released their memory - one job is always
+ * allowed to run, even if it exceeds the budget on its own.
+ */
+class VoxConvert::BatchMemory {
+private:
+	const size_t _budget;
+	size_t _reserved = 0u;
+	core_trace_mutex(core::Lock, _lock, "BatchMemory");
+	core::ConditionVariable _released;
+
+public:
+	// voxel formats are usually compressed or sparse - the dense volumes are assumed to be this much bigger than the
+	// file
+	static constexpr size_t FileSizeFactor = 16u;
+
+	explicit BatchMemory(size_t budget) : _budget(budget) {
+	}
+
+	void reserve(size_t bytes) {
+		core::ScopedLock lock(_lock);
+		_released.wait(_lock, [this, bytes] { return _reserved == 0u || _reserved + bytes <= _budget; });
+		_reserved += bytes;
+	}
+
+	void update(size_t reservedBytes, size_t bytes) {
+		core::ScopedLock lock(_lock);
+		_reserved = _reserved - reservedBytes + bytes;
+		if (bytes < reservedBytes) {
+			_released.notify_all();
+		}
+	}
+
+	void release(size_t bytes) {
+		update(bytes, 0u);
+	}
+};
+
+bool VoxConvert::convertBatchJob(BatchJob &job, const core::String &scriptParameters, BatchMemory &memory) {
+	// don't start loading as long as the memory of the running jobs doesn't leave room for this file
+	const long fileSize = filesystem()->open(job.input)->length();
+	size_t bytes = (size_t)core_max(1l, fileSize) * BatchMemory::FileSizeFactor;
+	memory.reserve(bytes);
+
+	const io::ArchivePtr &archive = io::openFilesystemArchive(filesystem());
+	scenegraph::SceneGraph sceneGraph;
+	uint64_t start = core::TimeProvider::highResTime();
+	voxelformat::LoadContext loadCtx;
+	io::FileDescription fileDesc;
+	fileDesc.set(job.input);
+	if (!voxelformat::loadFormat(fileDesc, archive, sceneGraph, loadCtx)) {
+		memory.release(bytes);
+		job.error = "Failed to load the input file";
+		return false;
+	}
+	job.loadMillis = millisSince(start);
+
+	// the memory of the loaded volumes is accounted until the job is finished
+	size_t loadedBytes = 0u;
+	for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter) {
+		loadedBytes += (size_t)(*iter).region().voxels() * sizeof(voxel::Voxel);
+	}
+	memory.update(bytes, loadedBytes);
+	bytes = loadedBytes;
+
+	start = core::TimeProvider::highResTime();
+	const bool processed = processSceneGraph(sceneGraph, core::string::extractFilename(job.input), scriptParameters);
+	job.processMillis = millisSince(start);
+	if (!processed) {
+		memory.release(bytes);
+		job.error = "Failed to process the models";
+		return false;
+	}
+	for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter) {
+		const voxel::RawVolume *volume = (*iter).volume();
+		++job.models;
+		if (volume != nullptr) {
+			voxelutil::visitVolume(*volume, [&job](int, int, int, const voxel::Voxel &) { ++job.voxels; });
+		}
+	}
+
+	bool saved = false;
+	if (!hasArg("--force") && filesystem()->open(job.output)->exists()) {
+		job.error = "The output file already exists";
+	} else {
+		start = core::TimeProvider::highResTime();
+		voxelformat::SaveContext saveCtx;
+		saved = voxelformat::saveFormat(sceneGraph, job.output, nullptr, archive, saveCtx);
+		job.saveMillis = millisSince(start);
+		if (!saved) {
+			job.error = "Failed to write the output file";
+		}
+	}
+	sceneGraph.clear();
+	memory.release(bytes);
+	return saved;
+}
+
+bool VoxConvert::batchInputFiles(const core::DynamicArray<core::String> &infiles, const core::String &outfile,
+								 const core::String &scriptParameters, int jobs, size_t memoryBudget) {
+	core::DynamicArray<BatchJob> batchJobs;
+	for (const core::String &infile : infiles) {
+		core::DynamicArray<core::String> inputs;
+		if (filesystem()->sysIsReadableDir(infile)) {
+			core::DynamicArray<io::FilesystemEntry> entities;
+			filesystem()->list(infile, entities, getArgVal("--wildcard", ""));
+			for (const io::FilesystemEntry &entry : entities) {
+				if (entry.type == io::FilesystemEntry::Type::file) {
+					inputs.push_back(core::string::path(infile, entry.name));
+				}
+			}
+		} else if (io::isZipArchive(infile)) {
+			Log::error("Archives are not supported in batch mode: %s", infile.c_str());
+			return false;
+		} else {
+			inputs.push_back(infile);
+		}
+		for (const core::String &input : inputs) {
+			BatchJob job;
+			job.input = input;
+			const core::String &name = core::string::extractFilename(input);
+			job.output = core::string::replaceAll(outfile, "*", name);
+			batchJobs.push_back(job);
+		}
+	}
+	if (batchJobs.empty()) {
+		Log::error("No valid input found to operate on.");
+		return false;
+	}
+	Log::info("Convert %i files with %i jobs", (int)batchJobs.size(), jobs);
+
+	// the global palette is loaded once here - and not by the jobs that are waiting for the lock. The closest color
+	// lookup structures are cached per thread, so every job reuses the palette lookups of the previous files of the
+	// same worker
+	voxel::getPalette();
+
+	BatchMemory memory(memoryBudget);
+	core::AtomicInt nextJob{0};
+	core::AtomicInt failedJobs{0};
+	const uint64_t start = core::TimeProvider::highResTime();
+	auto worker = [&]() {
+		for (;;) {
+			const int idx = nextJob.increment(1);
+			if (idx >= (int)batchJobs.size() || shouldQuit()) {
+				break;
+			}
+			BatchJob &job = batchJobs[idx];
+			job.success = convertBatchJob(job, scriptParameters, memory);
+			if (job.success) {
+				Log::info("Converted %s to %s", job.input.c_str(), job.output.c_str());
+			} else {
+				failedJobs.increment(1);
+				Log::error("Failed to convert %s: %s", job.input.c_str(), job.error.c_str());
+			}
+		}
+	};
+	{
+		// the jobs are running on their own threads - the app thread pool stays free for the tasks that the formats
+		// are scheduling while loading or saving a file (e.g. the mesh extraction). A job that waits for the memory
+		// budget or for such a task doesn't block a worker of the app pool this way.
+		core::ThreadPool jobPool(jobs - 1, "BatchJobs");
+		jobPool.init();
+		core::TaskGroup group(jobPool);
+		for (int i = 1; i < jobs; ++i) {
+			group.run(worker);
+		}
+		worker();
+		group.wait();
+	}
+	const double totalMillis = millisSince(start);
+	const int failed = failedJobs;
+	Log::info("Converted %i of %i files in %.2f ms", (int)batchJobs.size() - failed, (int)batchJobs.size(),
+			  totalMillis);
+
+	if (hasArg("--summary")) {
+		const core::String &summaryFile = getArgVal("--summary");
+		io::FileStream stream(filesystem()->open(summaryFile, io::FileMode::SysWrite));
+		if (!stream.valid()) {
+			Log::error("Failed to open summary file %s", summaryFile.c_str());
+			return false;
+		}
+		stream.writeStringFormat(false, "{\"jobs\":%i,\"total_ms\":%f,\"succeeded\":%i,\"failed\":%i,\"files\":[", jobs,
+								 totalMillis, (int)batchJobs.size() - failed, failed);
+		for (size_t i = 0; i < batchJobs.size(); ++i) {
+			const BatchJob &job = batchJobs[i];
+			stream.writeStringFormat(false,
+									 "%s{\"input\":\"%s\",\"output\":\"%s\",\"success\":%s,\"error\":\"%s\","
+									 "\"load_ms\":%f,\"process_ms\":%f,\"save_ms\":%f,\"models\":%i,\"voxels\":%i}",
+									 i > 0 ? "," : "", jsonEscape(job.input).c_str(), jsonEscape(job.output).c_str(),
+									 job.success ? "true" : "false", jsonEscape(job.error).c_str(), job.loadMillis,
+									 job.processMillis, job.saveMillis, job.models, job.voxels);
+		}
+		stream.writeStringFormat(false, "]}\n");
+		Log::info("Wrote summary to %s", summaryFile.c_str());
+	}
+	return failed == 0;
+}
+
 static bool hasUniqueModelNames(const scenegraph::SceneGraph &sceneGraph) {
 	core::StringSet names;
 	for (const auto &entry : sceneGraph.nodes()) {
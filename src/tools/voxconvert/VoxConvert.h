@@ -8,6 +8,8 @@
 #include "io/Archive.h"
 #include "scenegraph/SceneGraph.h"
 
+struct BatchJob;
+
 /**
  * @brief This tool is able to convert voxel volumes between different formats
  *
@@ -39,6 +41,15 @@ private:
 	bool _splitModels = false;
 	bool _printSceneGraph = false;
 	bool _resizeModels = false;
+	bool _streamModels = false;
+	/**
+	 * @brief The uncompressed voxel data of the loaded models in bytes before the least recently used volumes are
+	 * moved into the cold storage - @c 0 disables the cold storage
+	 */
+	size_t _coldStorageBudget = 0u;
+
+	class StreamSink;
+	class BatchMemory;
 
 	struct NodeStats {
 		int voxels = 0;
@@ -66,6 +77,30 @@ protected:
 										 const core::String &outExt, int id, bool uniqueNames);
 	bool handleInputFile(const core::String &infile, const io::ArchivePtr &archive, scenegraph::SceneGraph &sceneGraph,
 						 bool multipleInputs);
+	/**
+	 * @brief Converts the input files without loading them into one scene graph. Formats that support it hand over
+	 * their models while they are loaded - the models are collected until the memory budget is reached and then
+	 * written into the next part of the output files.
+	 * @param memoryBudget The max amount of voxel data in bytes that is collected before it is written
+	 */
+	bool streamInputFiles(const core::DynamicArray<core::String> &infiles,
+						  const core::DynamicArray<core::String> &outfiles, const core::String &scriptParameters,
+						  size_t memoryBudget);
+	/**
+	 * @brief Converts every input file into its own output file. The given amount of files are converted in parallel.
+	 * @param outfile The output file name - a @c * is replaced by the file name of the input file
+	 * @param memoryBudget A file is only loaded if its estimated voxel data fits into this together with the voxel
+	 * data of the running jobs
+	 */
+	bool batchInputFiles(const core::DynamicArray<core::String> &infiles, const core::String &outfile,
+						 const core::String &scriptParameters, int jobs, size_t memoryBudget);
+	bool convertBatchJob(BatchJob &job, const core::String &scriptParameters, BatchMemory &memory);
+	/**
+	 * @brief Applies the model operations that were given on the command line to the scene graph
+	 * @param name The name of the node if the models are merged
+	 */
+	bool processSceneGraph(scenegraph::SceneGraph &sceneGraph, const core::String &name,
+						   const core::String &scriptParameters);
 
 	void usage() const override;
 	void printUsageHeader() const override;
@@ -46,7 +46,7 @@ void MenuBar::viewportOptions() {
 	ImGui::IconCheckboxVar(ICON_LC_LOCK, _("Show locked axis"), cfg::VoxEditShowlockedaxis);
 	ImGui::IconCheckboxVar(ICON_LC_BOX, _("Bounding box"), cfg::VoxEditShowaabb);
 	ImGui::IconCheckboxVar(ICON_LC_BONE, _("Bones"), cfg::VoxEditShowBones);
-	ImGui::BeginDisabled(core::Var::get(cfg::VoxelMeshMode)->intVal() != (int)voxel::SurfaceExtractionType::Cubic);
+	ImGui::BeginDisabled(core::Var::get(cfg::VoxelMeshMode)->intVal() == (int)voxel::SurfaceExtractionType::MarchingCubes);
 	ImGui::IconCheckboxVar(ICON_LC_BOX, _("Outlines"), cfg::RenderOutline);
 	ImGui::IconCheckboxVar(ICON_LC_BOX, _("Normals"), cfg::RenderNormals);
 	ImGui::IconCheckboxVar(ICON_LC_BRICK_WALL, _("Checkerboard"), cfg::RenderCheckerBoard);
@@ -124,10 +124,14 @@ bool MenuBar::update(ui::IMGUIApp *app, command::CommandExecutionListener &liste
 				_app->languageOption();
 
 				static const core::Array<core::String, (int)voxel::SurfaceExtractionType::Max> meshModes = {
-					_("Cubes"), _("Marching cubes")};
+					_("Cubes"), _("Marching cubes"), _("Binary cubes")};
 				ImGui::ComboVar(_("Mesh mode"), cfg::VoxelMeshMode, meshModes);
 				ImGui::InputVarInt(_("Model animation speed"), cfg::VoxEditAnimationSpeed);
 				ImGui::InputVarInt(_("Autosave delay in seconds"), cfg::VoxEditAutoSaveSeconds);
+				ImGui::InputVarInt(_("Undo memory in MB"), cfg::VoxEditUndoMemory);
+				static const core::Array<core::String, (int)memento::MementoCompression::Max> undoCompressions = {
+					_("Zip"), _("LZFSE")};
+				ImGui::ComboVar(_("Undo compression"), cfg::VoxEditUndoCompression, undoCompressions);
 				ImGui::InputVarInt(_("Viewports"), cfg::VoxEditViewports, 1, 1);
 				ImGui::SliderVarFloat(_("Zoom speed"), cfg::ClientCameraZoomSpeed, 0.1f, 200.0f);
 				ImGui::SliderVarInt(_("View distance"), cfg::VoxEditViewdistance, 10, 5000);
@@ -44,7 +44,7 @@ void RenderPanel::renderMenuBar(const scenegraph::SceneGraph &sceneGraph) {
 			}
 		} else {
 			if (ImGui::Button(_("Start path tracer"))) {
-				_pathTracer.start(sceneGraph, _sceneMgr->activeCamera());
+				_pathTracer.start(sceneGraph, _sceneMgr->activeCamera(), _sceneMgr->meshState());
 			}
 		}
 		ImGui::EndMenuBar();
@@ -60,7 +60,7 @@ void RenderPanel::update(const char *id, const scenegraph::SceneGraph &sceneGrap
 			yocto::trace_params &params = state.params;
 			if (params.resolution != ImGui::GetContentRegionAvail().x) {
 				params.resolution = ImGui::GetContentRegionAvail().x;
-				_pathTracer.restart(sceneGraph, _sceneMgr->activeCamera());
+				_pathTracer.restart(sceneGraph, _sceneMgr->activeCamera(), _sceneMgr->meshState());
 			}
 		}
 		renderMenuBar(sceneGraph);
@@ -125,7 +125,7 @@ void RenderPanel::updateSettings(const char *id, const scenegraph::SceneGraph &s
 			changed += ImGui::ComboItems(_("Camera"), &params.camera, state.scene.camera_names);
 		}
 		if (changed > 0) {
-			_pathTracer.restart(sceneGraph, _sceneMgr->activeCamera());
+			_pathTracer.restart(sceneGraph, _sceneMgr->activeCamera(), _sceneMgr->meshState());
 		}
 	}
 	ImGui::End();
@@ -4,7 +4,7 @@
 
 #include "Clipboard.h"
 #include "core/Log.h"
-#include "voxedit-util/modifier/Selection.h"
+#include "voxedit-util/modifier/SelectionVolume.h"
 #include "voxel/RawVolumeWrapper.h"
 #include "voxelutil/VolumeMerger.h"
 #include <glm/common.hpp>
@@ -12,50 +12,63 @@
 namespace voxedit {
 namespace tool {
 
-voxel::VoxelData copy(const voxel::VoxelData &voxelData, const Selections &selections) {
+static voxel::RawVolume *copySelection(const voxel::RawVolume *volume, const SelectionVolume &selection) {
+	voxel::Region region = selection.region();
+	if (!region.cropTo(volume->region())) {
+		return nullptr;
+	}
+	voxel::RawVolume *v = new voxel::RawVolume(region);
+	v->setBorderValue(volume->borderValue());
+	selection.visit([&](int32_t x, int32_t y, int32_t z) {
+		if (region.containsPoint(x, y, z)) {
+			v->setVoxel(x, y, z, volume->voxel(x, y, z));
+		}
+	});
+	return v;
+}
+
+voxel::VoxelData copy(const voxel::VoxelData &voxelData, const SelectionVolume &selection) {
 	if (!voxelData) {
 		Log::debug("Copy failed: no voxel data");
 		return {};
 	}
-	if (selections.empty()) {
+	if (selection.empty()) {
 		Log::debug("Copy failed: no selection active");
 		return {};
 	}
 
-	voxel::RawVolume *v = new voxel::RawVolume(voxelData.volume, selections);
+	voxel::RawVolume *v = copySelection(voxelData.volume, selection);
+	if (v == nullptr) {
+		Log::debug("Copy failed: selection is outside of the volume");
+		return {};
+	}
 	return voxel::VoxelData(v, voxelData.palette, true);
 }
 
-voxel::VoxelData cut(voxel::VoxelData &voxelData, const Selections &selections, voxel::Region &modifiedRegion) {
+voxel::VoxelData cut(voxel::VoxelData &voxelData, const SelectionVolume &selection, voxel::Region &modifiedRegion) {
 	if (!voxelData) {
 		Log::debug("Copy failed: no voxel data");
 		return {};
 	}
 
-	if (selections.empty()) {
+	if (selection.empty()) {
 		Log::debug("Cut failed: no selection active");
 		return {};
 	}
 
-	voxel::RawVolume *v = new voxel::RawVolume(voxelData.volume, selections);
-	for (const Selection &selection : selections) {
-		const glm::ivec3 &mins = selection.getLowerCorner();
-		const glm::ivec3 &maxs = selection.getUpperCorner();
-		static constexpr voxel::Voxel AIR;
-		voxel::RawVolumeWrapper wrapper(voxelData.volume, selection);
-		for (int32_t x = mins.x; x <= maxs.x; ++x) {
-			for (int32_t y = mins.y; y <= maxs.y; ++y) {
-				for (int32_t z = mins.z; z <= maxs.z; ++z) {
-					wrapper.setVoxel(x, y, z, AIR);
-				}
-			}
-		}
-		if (wrapper.dirtyRegion().isValid()) {
-			if (modifiedRegion.isValid()) {
-				modifiedRegion.accumulate(wrapper.dirtyRegion());
-			} else {
-				modifiedRegion = wrapper.dirtyRegion();
-			}
+	voxel::RawVolume *v = copySelection(voxelData.volume, selection);
+	if (v == nullptr) {
+		Log::debug("Cut failed: selection is outside of the volume");
+		return {};
+	}
+	static constexpr voxel::Voxel AIR;
+	voxel::RawVolumeWrapper wrapper(voxelData.volume, v->region());
+	selection.visit([&](int32_t x, int32_t y, int32_t z) { wrapper.setVoxel(x, y, z, AIR); });
+	if (wrapper.dirtyRegion().isValid()) {
+		if (modifiedRegion.isValid()) {
+			modifiedRegion.accumulate(wrapper.dirtyRegion());
+		} else {
+			modifiedRegion = wrapper.dirtyRegion();
 		}
 	}
 	return {v, voxelData.palette, true};
@@ -4,14 +4,17 @@
 
 #pragma once
 
-#include "modifier/Selection.h"
+#include "modifier/SelectionVolume.h"
 #include "voxel/VoxelData.h"
 
 namespace voxedit {
 namespace tool {
 
-voxel::VoxelData copy(const voxel::VoxelData &voxelData, const Selections &selections);
-voxel::VoxelData cut(voxel::VoxelData &voxelData, const Selections &selections, voxel::Region &modifiedRegion);
+/**
+ * @brief Copies the selected voxels into a new volume - voxels that are not selected stay air
+ */
+voxel::VoxelData copy(const voxel::VoxelData &voxelData, const SelectionVolume &selection);
+voxel::VoxelData cut(voxel::VoxelData &voxelData, const SelectionVolume &selection, voxel::Region &modifiedRegion);
 void paste(voxel::VoxelData &out, const voxel::VoxelData &in, const glm::ivec3 &referencePosition,
 		   voxel::Region &modifiedRegion);
 
@@ -44,6 +44,13 @@ public:
 	}
 	virtual void renderScene(voxelrender::RenderContext &renderContext, const video::Camera &camera) {
 	}
+	/**
+	 * @return The mesh state with the extracted meshes of the scene - or @c nullptr if there is none or if it is not
+	 * up to date
+	 */
+	virtual const voxel::MeshState *meshState() const {
+		return nullptr;
+	}
 };
 
 using SceneRendererPtr = core::SharedPtr<ISceneRenderer>;
@@ -822,7 +822,8 @@ bool SceneManager::mementoModification(const memento::MementoState& s) {
 		}
 		node->setName(s.name);
 		node->setPalette(s.palette);
-		modified(node->id(), s.data.region(), false);
+		// for deltas only the modified region of the volume changed
+		modified(node->id(), s.modifiedRegion(), false);
 		return true;
 	}
 	Log::warn("Failed to handle memento state - node id %s not found (%s)", s.nodeUUID.c_str(), s.name.c_str());
@@ -1001,14 +1002,17 @@ bool SceneManager::saveSelection(const io::FileDescription& file) {
 
 	const io::ArchivePtr &archive = io::openFilesystemArchive(_filesystem);
 
-	const voxel::RawVolume *volume = _sceneGraph.resolveVolume(*node);
+	const voxel::VoxelData voxelData(_sceneGraph.resolveVolume(*node), node->palette(), false);
+	voxel::VoxelData selected = voxedit::tool::copy(voxelData, _modifierFacade.selectionMgr().selectionVolume());
+	if (!selected) {
+		Log::warn("Nothing of node %i is selected", nodeId);
+		return false;
+	}
 	scenegraph::SceneGraph newSceneGraph;
-	_modifierFacade.selectionMgr().visitSelections([&] (const Selection &selection) {
-		scenegraph::SceneGraphNode newNode(scenegraph::SceneGraphNodeType::Model);
-		scenegraph::copyNode(*node, newNode, false);
-		newNode.setVolume(new voxel::RawVolume(volume, selection), true);
-		newSceneGraph.emplace(core::move(newNode));
-	});
+	scenegraph::SceneGraphNode newNode(scenegraph::SceneGraphNodeType::Model);
+	scenegraph::copyNode(*node, newNode, false);
+	newNode.setVolume(new voxel::RawVolume(*selected.volume), true);
+	newSceneGraph.emplace(core::move(newNode));
 	if (!voxelformat::saveFormat(newSceneGraph, file.name, &file.desc, archive, saveCtx)) {
 		Log::warn("Failed to save node %i to %s", nodeId, file.name.c_str());
 		return false;
@@ -1028,8 +1032,7 @@ bool SceneManager::copy() {
 		return false;
 	}
 	voxel::VoxelData voxelData(node->volume(), node->palette(), false);
-	const Selections& selections = _modifierFacade.selectionMgr().selections();
-	_copy = voxedit::tool::copy(voxelData, selections);
+	_copy = voxedit::tool::copy(voxelData, _modifierFacade.selectionMgr().selectionVolume());
 	return _copy;
 }
 
@@ -1084,8 +1087,7 @@ bool SceneManager::cut() {
 	}
 	voxel::Region modifiedRegion;
 	voxel::VoxelData voxelData(node.volume(), node.palette(), false);
-	const Selections& selections = _modifierFacade.selectionMgr().selections();
-	_copy = voxedit::tool::cut(voxelData, selections, modifiedRegion);
+	_copy = voxedit::tool::cut(voxelData, _modifierFacade.selectionMgr().selectionVolume(), modifiedRegion);
 	if (!_copy) {
 		Log::debug("Failed to cut");
 		return false;
@@ -1556,6 +1558,8 @@ void SceneManager::construct() {
 	_movementSpeed = core::Var::get(cfg::VoxEditMovementSpeed, "180.0f");
 	_transformUpdateChildren = core::Var::get(cfg::VoxEditTransformUpdateChildren, "true", -1, _("Update the children of a node when the transform of the node changes"));
 	_maxSuggestedVolumeSize = core::Var::getSafe(cfg::VoxEditMaxSuggestedVolumeSize);
+	_undoMemory = core::Var::get(cfg::VoxEditUndoMemory, "512", -1, _("The max memory in MB for the undo states - 0 disables the limit"), core::Var::minMaxValidator<0, 65536>);
+	_undoCompression = core::Var::get(cfg::VoxEditUndoCompression, "0", -1, _("The compression of the undo states - 0 is zip, 1 is the faster lzfse"), core::Var::minMaxValidator<0, (int)memento::MementoCompression::Max - 1>);
 
 	command::Command::registerCommand("resizetoselection", [&](const command::CmdArgs &args) {
 		const voxel::Region &region = modifier().selectionMgr().region();
@@ -2364,6 +2368,7 @@ bool SceneManager::init() {
 
 	voxel::Region maxUndoRegion(0, _maxSuggestedVolumeSize->intVal() - 1);
 	_mementoHandler.setMaxUndoRegion(maxUndoRegion);
+	updateMementoSettings();
 
 	_modifierFacade.setLockedAxis(math::Axis::None, true);
 	return true;
@@ -2459,6 +2464,10 @@ bool SceneManager::update(double nowSeconds) {
 		_mementoHandler.setMaxUndoRegion(maxUndoRegion);
 		_maxSuggestedVolumeSize->markClean();
 	}
+	if (_undoMemory->isDirty() || _undoCompression->isDirty()) {
+		updateMementoSettings();
+	}
+	_mementoHandler.update();
 
 	_movement.update(nowSeconds);
 	voxelgenerator::ScriptState state = _luaApi.update(nowSeconds);
@@ -3204,6 +3213,13 @@ bool SceneManager::nodeRemove(int nodeId, bool recursive) {
 	return false;
 }
 
+void SceneManager::updateMementoSettings() {
+	_mementoHandler.setMaxMemory((size_t)_undoMemory->intVal() * 1024u * 1024u);
+	_mementoHandler.setCompression((memento::MementoCompression)_undoCompression->intVal());
+	_undoMemory->markClean();
+	_undoCompression->markClean();
+}
+
 bool SceneManager::exceedsMaxSuggestedVolumeSize() const {
 	const int maxDim = _maxSuggestedVolumeSize->intVal();
 	const int maxVoxels = maxDim * maxDim * maxDim;
@@ -79,6 +79,8 @@ private:
 	core::VarPtr _movementSpeed;
 	core::VarPtr _transformUpdateChildren;
 	core::VarPtr _maxSuggestedVolumeSize;
+	core::VarPtr _undoMemory;
+	core::VarPtr _undoCompression;
 
 	bool _dirty = false;
 	// this is basically the same as the dirty state, but we stop
@@ -231,6 +233,7 @@ public:
 	bool supportsEditMode() const;
 
 	bool exceedsMaxSuggestedVolumeSize() const;
+	void updateMementoSettings();
 
 	bool cameraRotate() const;
 	bool cameraPan() const;
@@ -245,6 +248,10 @@ public:
 
 	void setActiveCamera(video::Camera *camera);
 	video::Camera *activeCamera() const;
+	/**
+	 * @sa ISceneRenderer::meshState()
+	 */
+	const voxel::MeshState *meshState() const;
 
 	const core::String &filename() const;
 	const voxel::Voxel &hitCursorVoxel() const;
@@ -536,6 +543,10 @@ inline video::Camera *SceneManager::activeCamera() const {
 	return _camera;
 }
 
+inline const voxel::MeshState *SceneManager::meshState() const {
+	return _sceneRenderer->meshState();
+}
+
 inline const memento::MementoHandler &SceneManager::mementoHandler() const {
 	return _mementoHandler;
 }
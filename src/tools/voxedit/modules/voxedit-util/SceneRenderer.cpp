@@ -268,6 +268,14 @@ bool SceneRenderer::isVisible(int nodeId, bool hideEmpty) const {
 	return _volumeRenderer.isVisible(nodeId, hideEmpty);
 }
 
+const voxel::MeshState *SceneRenderer::meshState() const {
+	if (!_extractRegions.empty()) {
+		// there are modifications that were not yet handed over to the mesh state
+		return nullptr;
+	}
+	return _volumeRenderer.meshState().get();
+}
+
 void SceneRenderer::removeNode(int nodeId) {
 	_volumeRenderer.nodeRemove(nodeId);
 }
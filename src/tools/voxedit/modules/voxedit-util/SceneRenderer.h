@@ -76,6 +76,7 @@ public:
 	bool isVisible(int nodeId, bool hideEmpty = true) const override;
 	void renderUI(voxelrender::RenderContext &renderContext, const video::Camera &camera) override;
 	void renderScene(voxelrender::RenderContext &renderContext, const video::Camera &camera) override;
+	const voxel::MeshState *meshState() const override;
 };
 
 } // namespace voxedit
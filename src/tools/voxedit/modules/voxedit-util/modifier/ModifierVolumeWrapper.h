@@ -5,7 +5,7 @@
 #pragma once
 
 #include "ModifierType.h"
-#include "Selection.h"
+#include "SelectionVolume.h"
 #include "scenegraph/SceneGraphNode.h"
 #include "voxel/RawVolumeWrapper.h"
 
@@ -15,13 +15,13 @@ namespace voxedit {
  * @brief A wrapper for a @c voxel::RawVolume that performs a sanity check for
  * the @c setVoxel() call and uses the @c ModifierType value to perform the
  * desired action for the @c setVoxel() call.
- * The sanity check also includes the @c Selections that are used to limit the
+ * The sanity check also includes the @c SelectionVolume that is used to limit the
  * area of the @c voxel::RawVolume that is affected by the @c setVoxel() call.
  */
 class ModifierVolumeWrapper : public voxel::RawVolumeWrapper {
 private:
 	using Super = voxel::RawVolumeWrapper;
-	const Selections _selections;
+	const SelectionVolume *_selection;
 	const ModifierType _modifierType;
 	scenegraph::SceneGraphNode &_node;
 
@@ -30,28 +30,24 @@ private:
 	bool _paint;
 	bool _force;
 
-	static bool contains(const Selections &selections, int x, int y, int z) {
-		for (const Selection &sel : selections) {
-			if (sel.containsPoint(x, y, z)) {
-				return true;
-			}
-		}
-		return false;
-	}
-
 	bool skip(int x, int y, int z) const {
 		if (!_region.containsPoint(x, y, z)) {
 			return true;
 		}
-		if (_selections.empty()) {
+		if (_selection == nullptr || _selection->empty()) {
 			return false;
 		}
-		return !contains(_selections, x, y, z);
+		return !_selection->contains(x, y, z);
 	}
 
 public:
-	ModifierVolumeWrapper(scenegraph::SceneGraphNode &node, ModifierType modifierType, const Selections &selections = {})
-		: Super(node.volume()), _selections(selections), _modifierType(modifierType), _node(node) {
+	/**
+	 * @param selection The selected voxels - @c nullptr or an empty selection doesn't limit the modification. The
+	 * selection must outlive the wrapper.
+	 */
+	ModifierVolumeWrapper(scenegraph::SceneGraphNode &node, ModifierType modifierType,
+						  const SelectionVolume *selection = nullptr)
+		: Super(node.volume()), _selection(selection), _modifierType(modifierType), _node(node) {
 		_erase = _modifierType == ModifierType::Erase;
 		_override = _modifierType == ModifierType::Override;
 		_paint = _modifierType == ModifierType::Paint;
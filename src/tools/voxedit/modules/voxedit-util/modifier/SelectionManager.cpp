@@ -4,7 +4,6 @@
 
 #include "SelectionManager.h"
 #include "voxel/RawVolume.h"
-#include "voxel/SparseVolume.h"
 
 namespace voxedit {
 
@@ -15,9 +14,10 @@ const Selections &SelectionManager::selections() const {
 void SelectionManager::invert(voxel::RawVolume &volume) {
 	if (!hasSelection()) {
 		select(volume, volume.region().getLowerCorner(), volume.region().getUpperCorner());
-	} else {
-		// TODO: SELECTION
+		return;
 	}
+	_selectionVolume.invert(volume.region());
+	_selections = _selectionVolume.toBoxes();
 }
 
 void SelectionManager::unselect(voxel::RawVolume &volume) {
@@ -26,17 +26,11 @@ void SelectionManager::unselect(voxel::RawVolume &volume) {
 
 void SelectionManager::reset() {
 	_selections.clear();
+	_selectionVolume.clear();
 }
 
 voxel::Region SelectionManager::region() const {
-	if (_selections.empty()) {
-		return voxel::Region::InvalidRegion;
-	}
-	voxel::Region r = _selections[0];
-	for (const Selection &selection : _selections) {
-		r.accumulate(selection);
-	}
-	return r;
+	return _selectionVolume.region();
 }
 
 bool SelectionManager::select(voxel::RawVolume &volume, const glm::ivec3 &mins, const glm::ivec3 &maxs) {
@@ -44,6 +38,7 @@ bool SelectionManager::select(voxel::RawVolume &volume, const glm::ivec3 &mins,
 	if (!sel.isValid()) {
 		return false;
 	}
+	_selectionVolume.select(sel);
 	for (size_t i = 0; i < _selections.size(); ++i) {
 		const Selection &s = _selections[i];
 		if (s.containsRegion(sel)) {
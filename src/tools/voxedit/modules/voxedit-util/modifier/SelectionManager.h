@@ -5,6 +5,7 @@
 #pragma once
 
 #include "Selection.h"
+#include "SelectionVolume.h"
 
 namespace voxel {
 class RawVolume;
@@ -12,14 +13,18 @@ class RawVolume;
 
 namespace voxedit {
 
+/**
+ * @brief The selected voxels are tracked in a @c SelectionVolume - the boxes are only kept to render the selection
+ */
 class SelectionManager {
 private:
 	Selections _selections;
-	// voxel::SparseVolume _selectionVolume;
+	SelectionVolume _selectionVolume;
 
 public:
 	// TODO: SELECTION: reduce access to this as much as possible
 	const Selections &selections() const;
+	const SelectionVolume &selectionVolume() const;
 
 	template <typename F>
 	void visitSelections(F &&f) const {
@@ -31,7 +36,9 @@ public:
 	voxel::Region region() const;
 	bool hasSelection() const;
 
-	// TODO: SELECTION: the plan here is to move the selected voxels into the sparse volume to allow copy/cut/move operations
+	/**
+	 * @brief Selects every voxel of the volume region that is not yet selected
+	 */
 	void invert(voxel::RawVolume &volume);
 	bool select(voxel::RawVolume &volume, const glm::ivec3 &mins, const glm::ivec3 &maxs);
 	void unselect(voxel::RawVolume &volume);
@@ -40,7 +47,11 @@ public:
 };
 
 inline bool SelectionManager::hasSelection() const {
-	return !_selections.empty();
+	return !_selectionVolume.empty();
+}
+
+inline const SelectionVolume &SelectionManager::selectionVolume() const {
+	return _selectionVolume;
 }
 
 } // namespace voxedit
@@ -0,0 +1,318 @@
+/**
+ * @file
+ */
+
+#include "SelectionVolume.h"
+#include "core/Algorithm.h"
+#include "core/collection/DynamicArray.h"
+
+namespace voxedit {
+
+void SelectionVolume::setBits(core::BitSet &bits, const voxel::Region &region, bool value) {
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	for (int32_t z = mins.z; z <= maxs.z; ++z) {
+		for (int32_t y = mins.y; y <= maxs.y; ++y) {
+			for (int32_t x = mins.x; x <= maxs.x; ++x) {
+				bits.set(bitIndex(x, y, z), value);
+			}
+		}
+	}
+}
+
+void SelectionVolume::markDirty() {
+	_regionDirty = true;
+}
+
+void SelectionVolume::removeEmptyBricks() {
+	core::DynamicArray<glm::ivec3> empty;
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		if (!iter->value.any()) {
+			empty.push_back(iter->key);
+		}
+	}
+	for (const glm::ivec3 &pos : empty) {
+		_bricks.remove(pos);
+	}
+}
+
+void SelectionVolume::select(const voxel::Region &region) {
+	if (!region.isValid()) {
+		return;
+	}
+	const glm::ivec3 minBrick = brickPos(region.getLowerX(), region.getLowerY(), region.getLowerZ());
+	const glm::ivec3 maxBrick = brickPos(region.getUpperX(), region.getUpperY(), region.getUpperZ());
+	for (int32_t bz = minBrick.z; bz <= maxBrick.z; ++bz) {
+		for (int32_t by = minBrick.y; by <= maxBrick.y; ++by) {
+			for (int32_t bx = minBrick.x; bx <= maxBrick.x; ++bx) {
+				const glm::ivec3 pos(bx, by, bz);
+				auto iter = _bricks.find(pos);
+				if (iter == _bricks.end()) {
+					_bricks.emplace(pos, createBrick());
+					iter = _bricks.find(pos);
+				}
+				const voxel::Region brick = brickRegion(pos);
+				if (region.containsRegion(brick)) {
+					iter->value.fill();
+					continue;
+				}
+				voxel::Region part = brick;
+				part.cropTo(region);
+				setBits(iter->value, part, true);
+			}
+		}
+	}
+	markDirty();
+}
+
+void SelectionVolume::unselect(const voxel::Region &region) {
+	if (!region.isValid() || _bricks.empty()) {
+		return;
+	}
+	const glm::ivec3 minBrick = brickPos(region.getLowerX(), region.getLowerY(), region.getLowerZ());
+	const glm::ivec3 maxBrick = brickPos(region.getUpperX(), region.getUpperY(), region.getUpperZ());
+	for (int32_t bz = minBrick.z; bz <= maxBrick.z; ++bz) {
+		for (int32_t by = minBrick.y; by <= maxBrick.y; ++by) {
+			for (int32_t bx = minBrick.x; bx <= maxBrick.x; ++bx) {
+				const glm::ivec3 pos(bx, by, bz);
+				auto iter = _bricks.find(pos);
+				if (iter == _bricks.end()) {
+					continue;
+				}
+				const voxel::Region brick = brickRegion(pos);
+				if (region.containsRegion(brick)) {
+					_bricks.remove(pos);
+					continue;
+				}
+				voxel::Region part = brick;
+				part.cropTo(region);
+				setBits(iter->value, part, false);
+				if (!iter->value.any()) {
+					_bricks.remove(pos);
+				}
+			}
+		}
+	}
+	markDirty();
+}
+
+void SelectionVolume::merge(const SelectionVolume &other) {
+	for (auto iter = other._bricks.begin(); iter != other._bricks.end(); ++iter) {
+		auto own = _bricks.find(iter->key);
+		if (own == _bricks.end()) {
+			_bricks.put(iter->key, iter->value);
+		} else {
+			own->value |= iter->value;
+		}
+	}
+	markDirty();
+}
+
+void SelectionVolume::intersect(const SelectionVolume &other) {
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		auto otherIter = other._bricks.find(iter->key);
+		if (otherIter == other._bricks.end()) {
+			iter->value.clear();
+		} else {
+			iter->value &= otherIter->value;
+		}
+	}
+	removeEmptyBricks();
+	markDirty();
+}
+
+void SelectionVolume::invert(const voxel::Region &region) {
+	if (!region.isValid()) {
+		clear();
+		return;
+	}
+	Bricks inverted;
+	const glm::ivec3 minBrick = brickPos(region.getLowerX(), region.getLowerY(), region.getLowerZ());
+	const glm::ivec3 maxBrick = brickPos(region.getUpperX(), region.getUpperY(), region.getUpperZ());
+	for (int32_t bz = minBrick.z; bz <= maxBrick.z; ++bz) {
+		for (int32_t by = minBrick.y; by <= maxBrick.y; ++by) {
+			for (int32_t bx = minBrick.x; bx <= maxBrick.x; ++bx) {
+				const glm::ivec3 pos(bx, by, bz);
+				auto iter = _bricks.find(pos);
+				const voxel::Region brick = brickRegion(pos);
+				if (region.containsRegion(brick)) {
+					if (iter == _bricks.end()) {
+						core::BitSet bits = createBrick();
+						bits.fill();
+						inverted.emplace(pos, core::move(bits));
+					} else if (!iter->value.all()) {
+						core::BitSet bits(iter->value);
+						bits.flip();
+						inverted.emplace(pos, core::move(bits));
+					}
+					continue;
+				}
+				voxel::Region part = brick;
+				part.cropTo(region);
+				core::BitSet bits = createBrick();
+				const glm::ivec3 &mins = part.getLowerCorner();
+				const glm::ivec3 &maxs = part.getUpperCorner();
+				for (int32_t z = mins.z; z <= maxs.z; ++z) {
+					for (int32_t y = mins.y; y <= maxs.y; ++y) {
+						for (int32_t x = mins.x; x <= maxs.x; ++x) {
+							const int idx = bitIndex(x, y, z);
+							if (iter == _bricks.end() || !iter->value[idx]) {
+								bits.set(idx, true);
+							}
+						}
+					}
+				}
+				if (bits.any()) {
+					inverted.emplace(pos, core::move(bits));
+				}
+			}
+		}
+	}
+	_bricks = core::move(inverted);
+	markDirty();
+}
+
+void SelectionVolume::clear() {
+	_bricks.clear();
+	_region = voxel::Region::InvalidRegion;
+	_regionDirty = false;
+}
+
+const voxel::Region &SelectionVolume::region() const {
+	if (!_regionDirty) {
+		return _region;
+	}
+	_regionDirty = false;
+	_region = voxel::Region::InvalidRegion;
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		const core::BitSet &bits = iter->value;
+		voxel::Region bounds;
+		if (bits.all()) {
+			bounds = brickRegion(iter->key);
+		} else {
+			glm::ivec3 mins(BrickSize);
+			glm::ivec3 maxs(-1);
+			for (int i = 0; i < BrickVoxels; ++i) {
+				if (!bits[i]) {
+					continue;
+				}
+				const glm::ivec3 local(i & BrickMask, (i >> BrickShift) & BrickMask, i >> (BrickShift * 2));
+				mins = glm::min(mins, local);
+				maxs = glm::max(maxs, local);
+			}
+			const glm::ivec3 offset = iter->key * BrickSize;
+			bounds = voxel::Region(offset + mins, offset + maxs);
+		}
+		if (_region.isValid()) {
+			_region.accumulate(bounds);
+		} else {
+			_region = bounds;
+		}
+	}
+	return _region;
+}
+
+void SelectionVolume::mergeFullBricks(Selections &boxes) const {
+	core::DynamicArray<glm::ivec3> full;
+	FullBricks open;
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		if (iter->value.all()) {
+			full.push_back(iter->key);
+			open.insert(iter->key);
+		}
+	}
+	if (full.empty()) {
+		return;
+	}
+	// start with the lowest brick of each box to only grow into the positive directions
+	core::sort(full.begin(), full.end(), [](const glm::ivec3 &lhs, const glm::ivec3 &rhs) {
+		if (lhs.z != rhs.z) {
+			return lhs.z < rhs.z;
+		}
+		if (lhs.y != rhs.y) {
+			return lhs.y < rhs.y;
+		}
+		return lhs.x < rhs.x;
+	});
+	auto allOpen = [&open](const glm::ivec3 &mins, const glm::ivec3 &maxs) {
+		for (int32_t z = mins.z; z <= maxs.z; ++z) {
+			for (int32_t y = mins.y; y <= maxs.y; ++y) {
+				for (int32_t x = mins.x; x <= maxs.x; ++x) {
+					if (!open.has(glm::ivec3(x, y, z))) {
+						return false;
+					}
+				}
+			}
+		}
+		return true;
+	};
+	for (const glm::ivec3 &start : full) {
+		if (!open.has(start)) {
+			continue;
+		}
+		glm::ivec3 end = start;
+		while (open.has(glm::ivec3(end.x + 1, start.y, start.z))) {
+			++end.x;
+		}
+		while (allOpen(glm::ivec3(start.x, end.y + 1, start.z), glm::ivec3(end.x, end.y + 1, start.z))) {
+			++end.y;
+		}
+		while (allOpen(glm::ivec3(start.x, start.y, end.z + 1), glm::ivec3(end.x, end.y, end.z + 1))) {
+			++end.z;
+		}
+		for (int32_t z = start.z; z <= end.z; ++z) {
+			for (int32_t y = start.y; y <= end.y; ++y) {
+				for (int32_t x = start.x; x <= end.x; ++x) {
+					open.remove(glm::ivec3(x, y, z));
+				}
+			}
+		}
+		boxes.emplace_back(start * BrickSize, end * BrickSize + BrickMask);
+	}
+}
+
+Selections SelectionVolume::toBoxes() const {
+	Selections boxes;
+	mergeFullBricks(boxes);
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		const core::BitSet &bits = iter->value;
+		if (bits.all()) {
+			continue;
+		}
+		const glm::ivec3 offset = iter->key * BrickSize;
+		for (int z = 0; z < BrickSize; ++z) {
+			// the boxes of this slice that might still grow along the y axis
+			const size_t sliceStart = boxes.size();
+			for (int y = 0; y < BrickSize; ++y) {
+				int x = 0;
+				while (x < BrickSize) {
+					if (!bits[bitIndex(x, y, z)]) {
+						++x;
+						continue;
+					}
+					const int startX = x;
+					while (x < BrickSize && bits[bitIndex(x, y, z)]) {
+						++x;
+					}
+					const glm::ivec3 mins(offset.x + startX, offset.y + y, offset.z + z);
+					const glm::ivec3 maxs(offset.x + x - 1, offset.y + y, offset.z + z);
+					bool extended = false;
+					for (size_t i = sliceStart; i < boxes.size(); ++i) {
+						Selection &box = boxes[i];
+						if (box.getUpperY() == maxs.y - 1 && box.getLowerX() == mins.x && box.getUpperX() == maxs.x) {
+							box.setUpperCorner(glm::ivec3(box.getUpperX(), maxs.y, box.getUpperZ()));
+							extended = true;
+							break;
+						}
+					}
+					if (!extended) {
+						boxes.emplace_back(mins, maxs);
+					}
+				}
+			}
+		}
+	}
+	return boxes;
+}
+
+} // namespace voxedit
@@ -0,0 +1,149 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Selection.h"
+#include "core/GLM.h"
+#include "core/collection/BitSet.h"
+#include "core/collection/DynamicMap.h"
+#include "core/collection/DynamicSet.h"
+#include "voxel/Region.h"
+
+namespace voxedit {
+
+/**
+ * @brief Sparse bit volume that marks the selected voxels
+ *
+ * The volume is split into bricks of @c BrickSize^3 voxels - only bricks that contain at least one selected voxel are
+ * allocated. Each brick is a @c core::BitSet with one bit per voxel. Boolean operations with another selection are
+ * done brick by brick and word by word - the costs scale with the amount of bricks and not with the amount of selected
+ * voxels.
+ *
+ * @sa SelectionManager
+ */
+class SelectionVolume {
+public:
+	static constexpr int BrickShift = 4;
+	static constexpr int BrickSize = 1 << BrickShift;
+	static constexpr int BrickMask = BrickSize - 1;
+	static constexpr int BrickVoxels = BrickSize * BrickSize * BrickSize;
+
+private:
+	using Bricks = core::DynamicMap<glm::ivec3, core::BitSet, 1031, glm::hash<glm::ivec3>>;
+	using FullBricks = core::DynamicSet<glm::ivec3, 1031, glm::hash<glm::ivec3>>;
+	Bricks _bricks;
+
+	/** lazily computed bounds of the selected voxels */
+	mutable voxel::Region _region = voxel::Region::InvalidRegion;
+	mutable bool _regionDirty = false;
+
+	static inline glm::ivec3 brickPos(int32_t x, int32_t y, int32_t z) {
+		return glm::ivec3(x >> BrickShift, y >> BrickShift, z >> BrickShift);
+	}
+
+	static inline int bitIndex(int32_t x, int32_t y, int32_t z) {
+		return (x & BrickMask) | ((y & BrickMask) << BrickShift) | ((z & BrickMask) << (BrickShift * 2));
+	}
+
+	static inline voxel::Region brickRegion(const glm::ivec3 &brick) {
+		const glm::ivec3 mins = brick * BrickSize;
+		return voxel::Region(mins, mins + BrickMask);
+	}
+
+	static inline core::BitSet createBrick() {
+		return core::BitSet(BrickVoxels);
+	}
+
+	/**
+	 * @brief Sets or clears the bits of the given region inside the brick
+	 */
+	static void setBits(core::BitSet &bits, const voxel::Region &region, bool value);
+	void removeEmptyBricks();
+	/**
+	 * @brief Merges neighbouring fully selected bricks into as few boxes as possible
+	 */
+	void mergeFullBricks(Selections &boxes) const;
+	void markDirty();
+
+public:
+	/**
+	 * @brief Adds all voxels of the given region to the selection
+	 */
+	void select(const voxel::Region &region);
+	/**
+	 * @brief Removes all voxels of the given region from the selection
+	 */
+	void unselect(const voxel::Region &region);
+	/**
+	 * @brief Union with the other selection
+	 */
+	void merge(const SelectionVolume &other);
+	/**
+	 * @brief Only keeps the voxels that are selected in both selections
+	 */
+	void intersect(const SelectionVolume &other);
+	/**
+	 * @brief Selects all voxels of the given region that were not selected before - everything outside of the region
+	 * is unselected
+	 */
+	void invert(const voxel::Region &region);
+	void clear();
+
+	bool empty() const;
+	bool contains(int32_t x, int32_t y, int32_t z) const;
+	inline bool contains(const glm::ivec3 &pos) const {
+		return contains(pos.x, pos.y, pos.z);
+	}
+	/**
+	 * @return The amount of allocated bricks
+	 */
+	size_t bricks() const;
+
+	/**
+	 * @return The bounding box of all selected voxels or @c voxel::Region::InvalidRegion if nothing is selected
+	 */
+	const voxel::Region &region() const;
+
+	/**
+	 * @brief Converts the selection into boxes. Neighbouring fully selected bricks are merged into larger boxes,
+	 * partially selected bricks are split into boxes of rows along the x axis that are merged along the y axis.
+	 */
+	Selections toBoxes() const;
+
+	/**
+	 * @brief Calls the given functor with the coordinates of every selected voxel
+	 */
+	template<class FUNC>
+	void visit(FUNC &&func) const {
+		for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+			const glm::ivec3 mins = iter->key * BrickSize;
+			const core::BitSet &bits = iter->value;
+			for (int i = 0; i < BrickVoxels; ++i) {
+				if (bits[i]) {
+					func(mins.x + (i & BrickMask), mins.y + ((i >> BrickShift) & BrickMask),
+						 mins.z + (i >> (BrickShift * 2)));
+				}
+			}
+		}
+	}
+};
+
+inline bool SelectionVolume::empty() const {
+	return _bricks.empty();
+}
+
+inline size_t SelectionVolume::bricks() const {
+	return _bricks.size();
+}
+
+inline bool SelectionVolume::contains(int32_t x, int32_t y, int32_t z) const {
+	auto iter = _bricks.find(brickPos(x, y, z));
+	if (iter == _bricks.end()) {
+		return false;
+	}
+	return iter->value[bitIndex(x, y, z)];
+}
+
+} // namespace voxedit
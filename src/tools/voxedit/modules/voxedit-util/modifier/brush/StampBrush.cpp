@@ -55,9 +55,11 @@ void StampBrush::construct() {
 		if (modifier.selectionMgr().hasSelection()) {
 			if (const scenegraph::SceneGraphNode *node =
 					_sceneMgr->sceneGraphModelNode(_sceneMgr->sceneGraph().activeNode())) {
-				const Selections &selections = modifier.selectionMgr().selections();
-				const voxel::RawVolume stampVolume(node->volume(), selections);
-				setVolume(stampVolume, node->palette());
+				const voxel::VoxelData voxelData(node->volume(), node->palette(), false);
+				const voxel::VoxelData stamp = tool::copy(voxelData, modifier.selectionMgr().selectionVolume());
+				if (stamp) {
+					setVolume(*stamp.volume, node->palette());
+				}
 				// we unselect here as it's not obvious for the user that the stamp also only operates in the selection
 				// this can sometimes lead to confusion if you e.g. created a stamp from a fully filled selected area
 				command::executeCommands("select none");
@@ -4,6 +4,7 @@
 
 #include "../modifier/SelectionManager.h"
 #include "app/tests/AbstractTest.h"
+#include "voxel/RawVolume.h"
 
 namespace voxedit {
 
@@ -15,7 +16,31 @@ private:
 TEST_F(SelectionManagerTest, test) {
 	SelectionManager mgr;
 	EXPECT_FALSE(mgr.hasSelection());
-	// TODO: SELECTION: implement test
+	voxel::RawVolume volume(voxel::Region(0, 31));
+	EXPECT_TRUE(mgr.select(volume, glm::ivec3(1), glm::ivec3(2)));
+	EXPECT_TRUE(mgr.hasSelection());
+	EXPECT_EQ(voxel::Region(1, 2), mgr.region());
+	EXPECT_TRUE(mgr.selectionVolume().contains(2, 2, 2));
+	mgr.unselect(volume);
+	EXPECT_FALSE(mgr.hasSelection());
+}
+
+TEST_F(SelectionManagerTest, testInvert) {
+	SelectionManager mgr;
+	voxel::RawVolume volume(voxel::Region(0, 31));
+	mgr.invert(volume);
+	EXPECT_EQ(volume.region(), mgr.region());
+	ASSERT_EQ(1u, mgr.selections().size());
+
+	mgr.reset();
+	mgr.select(volume, glm::ivec3(0), glm::ivec3(15));
+	mgr.invert(volume);
+	EXPECT_EQ(volume.region(), mgr.region());
+	EXPECT_FALSE(mgr.selectionVolume().contains(0, 0, 0));
+	EXPECT_FALSE(mgr.selectionVolume().contains(15, 15, 15));
+	EXPECT_TRUE(mgr.selectionVolume().contains(16, 15, 15));
+	// the seven fully selected bricks are merged into three boxes
+	EXPECT_EQ(3u, mgr.selections().size());
 }
 
 } // namespace voxedit
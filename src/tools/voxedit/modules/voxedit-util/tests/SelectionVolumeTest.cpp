@@ -0,0 +1,124 @@
+/**
+ * @file
+ */
+
+#include "../modifier/SelectionVolume.h"
+#include "app/tests/AbstractTest.h"
+
+namespace voxedit {
+
+class SelectionVolumeTest : public app::AbstractTest {};
+
+TEST_F(SelectionVolumeTest, testSelect) {
+	SelectionVolume sel;
+	EXPECT_TRUE(sel.empty());
+	EXPECT_FALSE(sel.region().isValid());
+	sel.select(voxel::Region(glm::ivec3(-3, 0, 2), glm::ivec3(20, 1, 2)));
+	EXPECT_FALSE(sel.empty());
+	EXPECT_EQ(3u, sel.bricks());
+	EXPECT_TRUE(sel.contains(-3, 0, 2));
+	EXPECT_TRUE(sel.contains(20, 1, 2));
+	EXPECT_FALSE(sel.contains(-4, 0, 2));
+	EXPECT_FALSE(sel.contains(21, 0, 2));
+	EXPECT_FALSE(sel.contains(0, 0, 3));
+	EXPECT_EQ(glm::ivec3(-3, 0, 2), sel.region().getLowerCorner());
+	EXPECT_EQ(glm::ivec3(20, 1, 2), sel.region().getUpperCorner());
+}
+
+TEST_F(SelectionVolumeTest, testUnselect) {
+	SelectionVolume sel;
+	sel.select(voxel::Region(0, 31));
+	EXPECT_EQ(8u, sel.bricks());
+	sel.unselect(voxel::Region(glm::ivec3(0), glm::ivec3(15, 31, 31)));
+	EXPECT_EQ(4u, sel.bricks());
+	EXPECT_FALSE(sel.contains(15, 0, 0));
+	EXPECT_TRUE(sel.contains(16, 0, 0));
+	EXPECT_EQ(glm::ivec3(16, 0, 0), sel.region().getLowerCorner());
+	sel.unselect(voxel::Region(0, 31));
+	EXPECT_TRUE(sel.empty());
+}
+
+TEST_F(SelectionVolumeTest, testMergeIntersect) {
+	SelectionVolume a;
+	a.select(voxel::Region(0, 9));
+	SelectionVolume b;
+	b.select(voxel::Region(5, 40));
+
+	SelectionVolume merged = a;
+	merged.merge(b);
+	EXPECT_TRUE(merged.contains(0, 0, 0));
+	EXPECT_TRUE(merged.contains(40, 40, 40));
+	EXPECT_FALSE(merged.contains(0, 40, 0));
+	EXPECT_EQ(voxel::Region(0, 40), merged.region());
+
+	a.intersect(b);
+	EXPECT_FALSE(a.contains(4, 4, 4));
+	EXPECT_TRUE(a.contains(5, 5, 5));
+	EXPECT_TRUE(a.contains(9, 9, 9));
+	EXPECT_EQ(voxel::Region(5, 9), a.region());
+
+	SelectionVolume c;
+	c.select(voxel::Region(100, 101));
+	a.intersect(c);
+	EXPECT_TRUE(a.empty());
+}
+
+TEST_F(SelectionVolumeTest, testInvert) {
+	SelectionVolume sel;
+	sel.select(voxel::Region(2, 3));
+	sel.select(voxel::Region(40, 50));
+	const voxel::Region region(0, 19);
+	sel.invert(region);
+	EXPECT_FALSE(sel.contains(2, 2, 2));
+	EXPECT_FALSE(sel.contains(3, 3, 3));
+	EXPECT_TRUE(sel.contains(1, 2, 2));
+	EXPECT_TRUE(sel.contains(19, 19, 19));
+	EXPECT_FALSE(sel.contains(20, 19, 19));
+	EXPECT_FALSE(sel.contains(40, 40, 40));
+	EXPECT_EQ(region, sel.region());
+
+	sel.invert(region);
+	EXPECT_TRUE(sel.contains(2, 2, 2));
+	EXPECT_FALSE(sel.contains(1, 2, 2));
+	EXPECT_EQ(voxel::Region(2, 3), sel.region());
+}
+
+TEST_F(SelectionVolumeTest, testToBoxes) {
+	SelectionVolume sel;
+	sel.select(voxel::Region(0, 15));
+	sel.select(voxel::Region(glm::ivec3(16, 0, 0), glm::ivec3(17, 3, 0)));
+	const Selections &boxes = sel.toBoxes();
+	ASSERT_EQ(2u, boxes.size());
+	int voxels = 0;
+	for (const Selection &box : boxes) {
+		voxels += box.voxels();
+	}
+	EXPECT_EQ(16 * 16 * 16 + 2 * 4, voxels);
+}
+
+TEST_F(SelectionVolumeTest, testToBoxesMergesFullBricks) {
+	SelectionVolume sel;
+	sel.select(voxel::Region(0, 1));
+	sel.invert(voxel::Region(0, 255));
+	const Selections &boxes = sel.toBoxes();
+	// the partially selected brick is split into rows, all full bricks end up in a few large boxes
+	EXPECT_LT(boxes.size(), 32u);
+	int voxels = 0;
+	for (const Selection &box : boxes) {
+		voxels += box.voxels();
+	}
+	EXPECT_EQ(256 * 256 * 256 - 2 * 2 * 2, voxels);
+}
+
+TEST_F(SelectionVolumeTest, testVisit) {
+	SelectionVolume sel;
+	sel.select(voxel::Region(glm::ivec3(-1), glm::ivec3(1)));
+	int count = 0;
+	sel.visit([&](int32_t x, int32_t y, int32_t z) {
+		EXPECT_TRUE(voxel::Region(glm::ivec3(-1), glm::ivec3(1)).containsPoint(x, y, z));
+		++count;
+	});
+	EXPECT_EQ(27, count);
+}
+
+} // namespace voxedit